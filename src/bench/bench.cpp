@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+
+struct BenchEntry {
+    const char* name;
+    int (*run)(int argc, char* argv[]);
+    const char* description;
+};
+
+static const BenchEntry BENCHES[] = {
+    {"tokenizer", run_tokenizer_bench, "SQL 语句切分与词法分析吞吐 (MB/s)"},
+    {"scan", run_scan_bench, "列存与行存的过滤扫描吞吐对比"},
+    {"exec", run_exec_bench, "批执行过滤聚合吞吐：逐行 / 标量 / AVX2 (Mrow/s/核)"},
+    {"btree", run_btree_bench, "B+ 树多线程点查、插入、混合与范围扫描吞吐"},
+    {"wal", run_wal_bench, "预写日志提交吞吐：组提交与逐次 fdatasync 对比 (1/8/64 客户端)"},
+    {"pages", run_page_bench, "页缓冲池：pread 自管缓存与 mmap 的扫描与随机读对比"},
+    {"mvcc", run_mvcc_bench, "多版本并发：混合读写负载下吞吐随客户端数的变化，对照表级读写锁"},
+    {"parallel", run_parallel_bench, "单条大查询按片段并行：过滤聚合与分组聚合的延迟随线程数的变化"},
+    {"plancache", run_plancache_bench, "语句缓存与预备语句：每次解析、规范化后查缓存、按句柄执行的吞吐与命中率"},
+    {"compression", run_compression_bench, "列压缩：字典、游程与位打包的压缩比，压缩数据上直接过滤的扫描速度"},
+    {"copy", run_copy_bench, "批量导入：CSV 数据块直接写入列存储与逐条 INSERT 语句的导入速度"},
+    {"checkpoint", run_checkpoint_bench, "重启恢复：只回放预写日志与映射检查点加回放日志尾部的启动时间随数据量的变化"},
+    {"log", run_log_bench, "异步日志：无锁环形缓冲区与互斥锁队列的吞吐随生产者线程数的变化，调用方格式化与延迟格式化的开销"},
+    {"logfilter", run_log_filter_bench, "关闭的日志调用点的开销：运行时按模块级别关闭、编译时删除与改造前的做法对比空循环"},
+    {"logstack", run_log_stack_bench, "ERROR 日志的调用栈：调用方只收集帧地址、写入线程按地址缓存解析符号，与调用方同步解析对比"},
+};
+
+static void print_usage(const char* program) {
+    std::cout << "用法: " << program << " <测试名> [选项]\n可用测试:\n";
+    for (const auto& bench : BENCHES) {
+        std::cout << "  " << bench.name << "\t" << bench.description << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    std::string name = argv[1];
+    for (const auto& bench : BENCHES) {
+        if (name == bench.name) {
+            return bench.run(argc - 1, argv + 1);
+        }
+    }
+
+    print_usage(argv[0]);
+    return name == "--help" ? 0 : -1;
+}
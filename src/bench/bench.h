@@ -0,0 +1,41 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// 各组件基准测试入口，argv[0] 为测试名
+int run_tokenizer_bench(int argc, char* argv[]);
+int run_scan_bench(int argc, char* argv[]);
+int run_exec_bench(int argc, char* argv[]);
+int run_btree_bench(int argc, char* argv[]);
+int run_wal_bench(int argc, char* argv[]);
+int run_page_bench(int argc, char* argv[]);
+int run_mvcc_bench(int argc, char* argv[]);
+int run_parallel_bench(int argc, char* argv[]);
+int run_plancache_bench(int argc, char* argv[]);
+int run_compression_bench(int argc, char* argv[]);
+int run_copy_bench(int argc, char* argv[]);
+int run_checkpoint_bench(int argc, char* argv[]);
+int run_log_bench(int argc, char* argv[]);
+int run_log_filter_bench(int argc, char* argv[]);
+int run_log_stack_bench(int argc, char* argv[]);
+
+// 解析 --name=value 形式的整数选项，不匹配时返回 false
+inline bool bench_option(const std::string& arg, const char* name, long& value) {
+    std::string prefix = std::string("--") + name + "=";
+    if (!arg.starts_with(prefix)) {
+        return false;
+    }
+    value = atol(arg.c_str() + prefix.size());
+    return true;
+}
+
+// 自 start 以来经过的秒数
+inline double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // BENCH_H
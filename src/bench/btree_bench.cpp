@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/bench.h"
+#include "storage/btree.h"
+
+namespace {
+
+using Index = BTree<int64_t, uint64_t>;
+
+// 可逆的 64 位混洗：不同的序号得到不同且分布均匀的键
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+inline int64_t key_of(uint64_t i) {
+    return static_cast<int64_t>(mix(i));
+}
+
+enum class Workload {
+    LOOKUP,         // 随机点查已有的键
+    INSERT,         // 各线程插入互不相同的新键
+    MIXED,          // 90% 点查 + 10% 插入
+    SCAN            // 从随机位置起扫描 100 个键
+};
+
+const char* workload_name(Workload workload) {
+    switch (workload) {
+        case Workload::LOOKUP: return "lookup";
+        case Workload::INSERT: return "insert";
+        case Workload::MIXED: return "mixed 90/10";
+        case Workload::SCAN: return "scan 100";
+    }
+    return "";
+}
+
+// 对照组：std::map 加读写锁，读者需要修改锁内的计数器
+struct LockedMap {
+    std::map<int64_t, uint64_t> map;
+    mutable std::shared_mutex latch;
+
+    bool insert(int64_t key, uint64_t value) {
+        std::unique_lock<std::shared_mutex> lock(latch);
+        return map.emplace(key, value).second;
+    }
+
+    bool lookup(int64_t key, uint64_t& value) const {
+        std::shared_lock<std::shared_mutex> lock(latch);
+        auto it = map.find(key);
+        if (it == map.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    template<typename Fn>
+    void scan(int64_t from, Fn fn) const {
+        std::shared_lock<std::shared_mutex> lock(latch);
+        for (auto it = map.lower_bound(from); it != map.end() && fn(it->first, it->second); ++it) {
+        }
+    }
+};
+
+struct BenchOptions {
+    uint64_t keys;
+    uint64_t ops;
+};
+
+std::atomic<uint64_t> bench_sink{0};
+
+// 一个线程的工作：第 thread 个线程执行 ops 次操作，插入的新键序号为 keys + thread + k * threads
+template<typename Tree>
+void run_worker(Tree& tree, Workload workload, const BenchOptions& options, unsigned thread,
+                unsigned threads, const std::atomic<bool>& start) {
+    while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    uint64_t found = 0;
+    uint64_t next_insert = options.keys + thread;
+    uint64_t seed = mix(thread + 1);
+    for (uint64_t k = 0; k < options.ops; ++k) {
+        uint64_t r = mix(seed + k);
+        bool insert = workload == Workload::INSERT || (workload == Workload::MIXED && r % 10 == 0);
+        if (insert) {
+            tree.insert(key_of(next_insert), next_insert);
+            next_insert += threads;
+        } else if (workload == Workload::SCAN) {
+            int remaining = 100;
+            tree.scan(key_of(r % options.keys), [&](int64_t, uint64_t value) {
+                found += value;
+                return --remaining > 0;
+            });
+        } else {
+            uint64_t value = 0;
+            found += tree.lookup(key_of(r % options.keys), value) ? 1u : 0u;
+        }
+    }
+    bench_sink.fetch_add(found, std::memory_order_relaxed);
+}
+
+// 预先装入 keys 个键后，用 threads 个线程执行负载，返回每秒操作数
+template<typename Tree>
+double run_round(Workload workload, const BenchOptions& options, unsigned threads) {
+    auto tree = std::make_unique<Tree>();
+    for (uint64_t i = 0; i < options.keys; ++i) {
+        tree->insert(key_of(i), i);
+    }
+
+    std::atomic<bool> start{false};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() { run_worker(*tree, workload, options, t, threads, start); });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = seconds_since(begin);
+    return static_cast<double>(options.ops) * threads / seconds;
+}
+
+// 并发插入后检查所有键都能查到且扫描有序
+bool verify(const BenchOptions& options, unsigned threads) {
+    Index tree;
+    std::atomic<bool> start{true};
+    std::vector<std::thread> workers;
+    BenchOptions verify_options{0, options.ops};
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            run_worker(tree, Workload::INSERT, verify_options, t, threads, start);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    uint64_t total = options.ops * threads;
+    for (uint64_t i = 0; i < total; ++i) {
+        uint64_t value = 0;
+        if (!tree.lookup(key_of(i), value) || value != i) {
+            std::cerr << "B+ 树校验失败: 找不到第 " << i << " 个键" << std::endl;
+            return false;
+        }
+    }
+    uint64_t scanned = 0;
+    bool ordered = true;
+    int64_t last = INT64_MIN;
+    tree.scan(INT64_MIN, [&](int64_t key, uint64_t) {
+        ordered = ordered && (scanned == 0 || last < key);
+        last = key;
+        ++scanned;
+        return true;
+    });
+    if (!ordered || scanned != total) {
+        std::cerr << "B+ 树校验失败: 扫描到 " << scanned << " 个键，期望 " << total << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// 选项: --keys=N 预装键数（默认 1000000），--ops=N 每线程操作数（默认 1000000），
+//       --threads=N 最大线程数（默认为 CPU 核数），线程数从 1 起倍增
+int run_btree_bench(int argc, char* argv[]) {
+    long keys = 1000000;
+    long ops = 1000000;
+    long max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "keys", keys) && !bench_option(arg, "ops", ops) &&
+            !bench_option(arg, "threads", max_threads)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    BenchOptions options{static_cast<uint64_t>(std::max(1L, keys)), static_cast<uint64_t>(std::max(1L, ops))};
+    auto thread_limit = static_cast<unsigned>(std::max(1L, max_threads));
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < thread_limit; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(thread_limit);
+
+    if (!verify(options, thread_limit)) {
+        return -1;
+    }
+
+    std::cout << "B+ 树基准测试: 预装 " << options.keys << " 个键, 每线程 " << options.ops
+              << " 次操作, " << std::thread::hardware_concurrency() << " 个 CPU" << std::endl;
+    printf("%-12s %8s %14s %10s %16s\n", "workload", "threads", "olc(Mops/s)", "scaling",
+           "map+rwlock(Mops/s)");
+    for (Workload workload : {Workload::LOOKUP, Workload::INSERT, Workload::MIXED, Workload::SCAN}) {
+        double single = 0;
+        for (unsigned threads : thread_counts) {
+            double olc = run_round<Index>(workload, options, threads);
+            double locked = run_round<LockedMap>(workload, options, threads);
+            if (threads == 1) {
+                single = olc;
+            }
+            printf("%-12s %8u %14.2f %9.2fx %16.2f\n", workload_name(workload), threads, olc / 1e6,
+                   olc / single, locked / 1e6);
+        }
+    }
+    return 0;
+}
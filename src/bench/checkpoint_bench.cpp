@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "bench/bench.h"
+#include "sql/executor.h"
+#include "storage/catalog.h"
+#include "storage/wal.h"
+
+namespace {
+
+class StringSink : public ResultSink {
+public:
+    void write(std::string_view text) override { text_.append(text); }
+    const std::string& text() const { return text_; }
+    void clear() { text_.clear(); }
+
+private:
+    std::string text_;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+const char* const STATUSES[] = {"pending", "paid", "shipped", "delivered", "returned", "cancelled"};
+
+const char* const SCHEMA = "(id BIGINT, status CHAR(12), city VARCHAR(24), note VARCHAR(64), qty BIGINT, "
+                           "price DOUBLE)";
+
+// 覆盖压缩列块、VARCHAR、已删除的行与检查点之后追加的行
+const char* const QUERIES[] = {
+    "SELECT count(*), sum(qty), sum(price), min(city), max(note) FROM t",
+    "SELECT status, count(*), max(city) FROM t GROUP BY status",
+    "SELECT count(*), min(id), max(id) FROM t WHERE city = 'city_042' AND qty > 50",
+};
+
+#define LOAD_BATCH_ROWS 100000      // 每次 COPY 的行数
+
+void remove_directory(const std::string& path) {
+    if (DIR* dir = opendir(path.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                unlink((path + "/" + entry->d_name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path.c_str());
+}
+
+// 把目录下的文件逐出页缓存，模拟冷启动（文件都已同步，页面是干净的）
+size_t evict_directory(const std::string& path) {
+    size_t bytes = 0;
+    if (DIR* dir = opendir(path.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            int fd = open((path + "/" + entry->d_name).c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                continue;
+            }
+            off_t size = lseek(fd, 0, SEEK_END);
+            bytes += size > 0 ? static_cast<size_t>(size) : 0;
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+        closedir(dir);
+    }
+    return bytes;
+}
+
+void load(Catalog& catalog, size_t first, size_t rows) {
+    std::string csv;
+    char line[160];
+    for (size_t i = first; i < first + rows; ++i) {
+        uint64_t r = mix(i);
+        snprintf(line, sizeof(line), "%zu,%s,city_%03llu,note %llu for order %zu,%llu,%.2f\n", i, STATUSES[r % 6],
+                 static_cast<unsigned long long>((r >> 8) % 500), static_cast<unsigned long long>((r >> 16) % 100000),
+                 i, static_cast<unsigned long long>(1 + (r >> 20) % 100),
+                 static_cast<double>((r >> 32) % 100000) / 100.0);
+        csv += line;
+        if ((i + 1 - first) % LOAD_BATCH_ROWS == 0 || i + 1 == first + rows) {
+            copy_csv(catalog, "t", csv);
+            csv.clear();
+        }
+    }
+}
+
+std::string run_queries(Catalog& catalog) {
+    StringSink sink;
+    for (const char* query : QUERIES) {
+        execute_sql(catalog, query, sink);
+        sink.write("\n");
+    }
+    return sink.text();
+}
+
+std::unique_ptr<WriteAheadLog> open_log(Catalog& catalog, const std::string& dir, uint64_t start_lsn) {
+    WalOptions options;
+    options.directory = dir;
+    options.start_lsn = start_lsn;
+    auto wal = std::make_unique<WriteAheadLog>(options, [&catalog](uint8_t type, std::string_view payload) {
+        catalog.replay(type, payload);
+    });
+    catalog.attachLog(wal.get());
+    return wal;
+}
+
+struct Startup {
+    double open_seconds;        // 恢复到可以接受查询
+    double query_seconds;       // 恢复后第一轮查询（映射的页面此时才载入）
+    size_t disk_bytes;          // 启动时目录中的文件大小
+};
+
+// 冷启动一个目录：只有日志时回放全部日志，有检查点时映射检查点再回放之后的日志
+Startup start(const std::string& dir, bool use_checkpoint, bool cold, const std::string& expected) {
+    Startup startup{};
+    startup.disk_bytes = cold ? evict_directory(dir) : 0;
+    auto begin = std::chrono::steady_clock::now();
+    Catalog catalog;
+    CheckpointStats stats;
+    if (use_checkpoint && !catalog.loadCheckpoint(dir + "/" + CHECKPOINT_FILE_NAME, stats)) {
+        throw std::runtime_error("检查点文件不存在");
+    }
+    auto wal = open_log(catalog, dir, stats.lsn);
+    startup.open_seconds = seconds_since(begin);
+    begin = std::chrono::steady_clock::now();
+    std::string result = run_queries(catalog);
+    startup.query_seconds = seconds_since(begin);
+    if (result != expected) {
+        throw std::runtime_error("恢复后的查询结果不一致:\n" + result + "\n应为:\n" + expected);
+    }
+    catalog.attachLog(nullptr);
+    return startup;
+}
+
+} // namespace
+
+// 选项: --rows=N 最大的数据量（默认 4000000），--steps=N 数据量的档数，从 rows / 2^(steps-1) 起每档翻倍（默认 4），
+//       --tail=N 写检查点之后再插入的行数，重启时从日志回放（默认 10000），--cold=0|1 启动前把文件逐出页缓存（默认 1），
+//       --dir=PATH 数据目录（默认在 /tmp 下新建临时目录）
+// 同一份数据分别只靠预写日志与靠检查点加日志尾部重启，比较恢复时间与恢复后第一轮查询的时间
+int run_checkpoint_bench(int argc, char* argv[]) {
+    std::string base;
+    long rows = 4000000;
+    long steps = 4;
+    long tail = 10000;
+    long cold = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--dir=")) {
+            base = arg.substr(strlen("--dir="));
+        } else if (!bench_option(arg, "rows", rows) && !bench_option(arg, "steps", steps) &&
+                   !bench_option(arg, "tail", tail) && !bench_option(arg, "cold", cold)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    bool temporary = base.empty();
+    if (temporary) {
+        char pattern[] = "/tmp/simpledb-checkpoint-XXXXXX";
+        if (!mkdtemp(pattern)) {
+            std::cerr << "无法创建临时目录: " << strerror(errno) << std::endl;
+            return -1;
+        }
+        base = pattern;
+    }
+    steps = std::max(1L, steps);
+    auto tail_rows = static_cast<size_t>(std::max(0L, tail));
+
+    std::cout << "检查点基准测试: 目录 " << base << ", 检查点之后追加 " << tail_rows << " 行"
+              << (cold ? ", 启动前逐出页缓存" : "") << std::endl;
+    printf("%10s %9s | %9s %9s %9s | %9s %9s %9s %9s %9s | %8s\n", "rows", "log(MB)", "open(ms)", "query(ms)",
+           "total(ms)", "ckpt(ms)", "file(MB)", "open(ms)", "query(ms)", "total(ms)", "open x");
+    int round_id = 0;
+    for (long step = steps - 1; step >= 0; --step) {
+        auto count = static_cast<size_t>(std::max(1L, rows >> step));
+        std::string dir = base + "/round-" + std::to_string(round_id++);
+        try {
+            std::string expected;
+            {
+                Catalog catalog;
+                auto wal = open_log(catalog, dir, 0);
+                StringSink sink;
+                execute_sql(catalog, std::string("CREATE TABLE t ") + SCHEMA, sink);
+                load(catalog, 0, count);
+                execute_sql(catalog, "DELETE FROM t WHERE qty = 7", sink);
+                expected = run_queries(catalog);
+                catalog.attachLog(nullptr);
+            }
+            Startup replay = start(dir, false, cold != 0, expected);
+
+            // 回放得到的表写检查点，之后的插入只在日志中
+            double checkpoint_seconds = 0;
+            size_t file_bytes = 0;
+            {
+                Catalog catalog;
+                auto wal = open_log(catalog, dir, 0);
+                auto begin = std::chrono::steady_clock::now();
+                CheckpointStats stats = catalog.checkpoint(dir + "/" + CHECKPOINT_FILE_NAME);
+                checkpoint_seconds = seconds_since(begin);
+                file_bytes = stats.bytes;
+                load(catalog, count, tail_rows);
+                expected = run_queries(catalog);
+                catalog.attachLog(nullptr);
+            }
+            Startup mapped = start(dir, true, cold != 0, expected);
+
+            double replay_total = replay.open_seconds + replay.query_seconds;
+            double mapped_total = mapped.open_seconds + mapped.query_seconds;
+            printf("%10zu %9zu | %9.1f %9.1f %9.1f | %9.1f %9zu %9.1f %9.1f %9.1f | %7.1fx\n", count,
+                   replay.disk_bytes >> 20, replay.open_seconds * 1e3, replay.query_seconds * 1e3,
+                   replay_total * 1e3, checkpoint_seconds * 1e3, file_bytes >> 20, mapped.open_seconds * 1e3,
+                   mapped.query_seconds * 1e3, mapped_total * 1e3, replay.open_seconds / mapped.open_seconds);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            remove_directory(dir);
+            return -1;
+        }
+        remove_directory(dir);
+    }
+    if (temporary) {
+        rmdir(base.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "sql/executor.h"
+#include "storage/catalog.h"
+
+namespace {
+
+class StringSink : public ResultSink {
+public:
+    void write(std::string_view text) override { text_.append(text); }
+    const std::string& text() const { return text_; }
+    void clear() { text_.clear(); }
+
+private:
+    std::string text_;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+const char* const STATUSES[] = {"pending", "paid", "shipped", "delivered", "returned", "cancelled"};
+
+// 各列对应一种典型分布：递增的主键、低基数的状态与城市、小范围整数、成段重复的地区与折扣、随机的价格
+const char* const SCHEMA = "(id BIGINT, status CHAR(12), city VARCHAR(24), qty BIGINT, region BIGINT, "
+                           "price DOUBLE, discount DOUBLE)";
+
+// {t} 替换为表名
+const char* const QUERIES[] = {
+    "SELECT count(*) FROM {t} WHERE status = 'returned'",
+    "SELECT count(*), sum(qty) FROM {t} WHERE qty < 10",
+    "SELECT count(*) FROM {t} WHERE city >= 'city_400'",
+    "SELECT count(*), sum(price) FROM {t} WHERE region = 7",
+    "SELECT min(id), max(id) FROM {t} WHERE id >= 1000000 AND id < 1100000",
+    "SELECT sum(qty), sum(discount) FROM {t}",
+    "SELECT status, count(*), avg(qty) FROM {t} GROUP BY status",
+    "SELECT min(status), max(status) FROM {t} WHERE qty > 50",
+    "SELECT region, min(status), max(city) FROM {t} GROUP BY region",
+};
+
+void load(Catalog& catalog, const std::string& name, size_t rows) {
+    StringSink sink;
+    execute_sql(catalog, "CREATE TABLE " + name + " " + SCHEMA, sink);
+    Table* table = catalog.findTable(name);
+    std::vector<std::string> cities;
+    for (int i = 0; i < 500; ++i) {
+        char city[16];
+        snprintf(city, sizeof(city), "city_%03d", i);
+        cities.emplace_back(city);
+    }
+    std::lock_guard<std::mutex> lock(table->latch());
+    MvccManager::Commit commit(catalog.mvcc());
+    for (size_t i = 0; i < rows; ++i) {
+        uint64_t r = mix(i);
+        Value values[7];
+        values[0].integer = static_cast<int64_t>(i);
+        values[1].text = STATUSES[r % 6];
+        values[2].text = cities[(r >> 8) % cities.size()];
+        values[3].integer = static_cast<int64_t>(1 + (r >> 20) % 100);
+        values[4].integer = static_cast<int64_t>(i / 20000);
+        values[5].real = static_cast<double>((r >> 32) % 100000) / 100.0;
+        values[6].real = static_cast<double>(i / 5000 % 4) * 0.25;
+        table->appendRow(values, commit.ts());
+    }
+}
+
+std::string replace_table(std::string query, const std::string& name) {
+    size_t pos = query.find("{t}");
+    return query.replace(pos, 3, name);
+}
+
+double run_query(Catalog& catalog, const std::string& sql, long reps, StringSink& sink) {
+    std::vector<double> samples;
+    for (long rep = 0; rep < reps; ++rep) {
+        sink.clear();
+        auto begin = std::chrono::steady_clock::now();
+        execute_sql(catalog, sql, sink);
+        samples.push_back(seconds_since(begin));
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+// 选项: --rows=N 表的行数（默认 2000000），--reps=N 每个查询的重复次数，取中位数（默认 5）
+// 同样的数据装入两张表，只压缩其中一张，比较存储占用与单线程扫描速度
+int run_compression_bench(int argc, char* argv[]) {
+    long rows = 2000000;
+    long reps = 5;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "rows", rows) && !bench_option(arg, "reps", reps)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    auto row_count = static_cast<size_t>(std::max(1L, rows));
+    reps = std::max(1L, reps);
+
+    Catalog catalog;
+    load(catalog, "plain", row_count);
+    load(catalog, "packed", row_count);
+    Table* packed = catalog.findTable("packed");
+    auto begin = std::chrono::steady_clock::now();
+    catalog.collectGarbage(*packed);
+    double encode_seconds = seconds_since(begin);
+
+    std::vector<ColumnStorage> storage;
+    {
+        std::lock_guard<std::mutex> lock(packed->latch());
+        storage = packed->storage();
+    }
+    std::cout << "列压缩基准测试: " << row_count << " 行, 列块 " << CHUNK_ROWS << " 行, 压缩用时 "
+              << static_cast<long>(encode_seconds * 1e3) << " ms" << std::endl;
+    printf("%-10s %-28s %12s %12s %8s\n", "column", "encodings (chunks)", "plain(KB)", "encoded(KB)", "ratio");
+    size_t total_plain = 0;
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < storage.size(); ++i) {
+        std::string encodings;
+        for (size_t e = 0; e < ENCODING_COUNT; ++e) {
+            if (storage[i].chunks[e] > 0) {
+                encodings += std::string(encodings.empty() ? "" : " ") + encoding_name(static_cast<Encoding>(e)) +
+                             ":" + std::to_string(storage[i].chunks[e]);
+            }
+        }
+        printf("%-10s %-28s %12zu %12zu %7.1fx\n", packed->columnDef(i).name.c_str(), encodings.c_str(),
+               storage[i].plain_bytes / 1024, storage[i].bytes / 1024,
+               static_cast<double>(storage[i].plain_bytes) / static_cast<double>(storage[i].bytes));
+        total_plain += storage[i].plain_bytes;
+        total_bytes += storage[i].bytes;
+    }
+    printf("%-10s %-28s %12zu %12zu %7.1fx\n", "total", "", total_plain / 1024, total_bytes / 1024,
+           static_cast<double>(total_plain) / static_cast<double>(total_bytes));
+
+    printf("\n%-4s %14s %14s %9s\n", "query", "plain(Mrow/s)", "packed(Mrow/s)", "speedup");
+    bool ok = true;
+    StringSink plain_result;
+    StringSink packed_result;
+    for (size_t q = 0; q < sizeof(QUERIES) / sizeof(QUERIES[0]); ++q) {
+        double plain_seconds = run_query(catalog, replace_table(QUERIES[q], "plain"), reps, plain_result);
+        double packed_seconds = run_query(catalog, replace_table(QUERIES[q], "packed"), reps, packed_result);
+        if (plain_result.text() != packed_result.text()) {
+            std::cerr << "Q" << q + 1 << " 在压缩表上的结果不一致:\n" << packed_result.text() << "\n未压缩:\n"
+                      << plain_result.text() << std::endl;
+            ok = false;
+        }
+        double n = static_cast<double>(row_count);
+        printf("Q%-3zu %14.0f %14.0f %8.2fx  %s\n", q + 1, n / plain_seconds / 1e6, n / packed_seconds / 1e6,
+               plain_seconds / packed_seconds, QUERIES[q]);
+    }
+    return ok ? 0 : -1;
+}
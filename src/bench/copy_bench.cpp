@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/bench.h"
+#include "protocol/protocol.h"
+#include "sql/executor.h"
+#include "storage/catalog.h"
+
+namespace {
+
+class StringSink : public ResultSink {
+public:
+    void write(std::string_view text) override { text_.append(text); }
+    const std::string& text() const { return text_; }
+    void clear() { text_.clear(); }
+
+private:
+    std::string text_;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+const char* const STATUSES[] = {"pending", "paid", "shipped", "delivered", "returned", "cancelled"};
+
+const char* const SCHEMA = "(id BIGINT, status CHAR(12), city VARCHAR(24), qty BIGINT, price DOUBLE, note VARCHAR(40))";
+
+// 第 i 行的 CSV 记录；每 64 行有一个带逗号与转义引号的字段
+void append_record(std::string& out, uint64_t i) {
+    uint64_t r = mix(i);
+    char line[160];
+    int size = snprintf(line, sizeof(line), "%llu,%s,city_%03llu,%llu,%llu.%02llu,%s\n",
+                        static_cast<unsigned long long>(i), STATUSES[r % 6],
+                        static_cast<unsigned long long>((r >> 8) % 500),
+                        static_cast<unsigned long long>(1 + (r >> 20) % 100),
+                        static_cast<unsigned long long>((r >> 32) % 10000),
+                        static_cast<unsigned long long>((r >> 48) % 100),
+                        i % 64 == 0 ? "\"fragile, \"\"handle with care\"\"\"" : "standard");
+    out.append(line, static_cast<size_t>(size));
+}
+
+// 同样的行写成多行 INSERT 语句，每条 rows_per_statement 行
+void append_insert(std::string& out, uint64_t first, uint64_t count) {
+    out += "INSERT INTO t VALUES ";
+    for (uint64_t i = first; i < first + count; ++i) {
+        uint64_t r = mix(i);
+        char row[160];
+        int size = snprintf(row, sizeof(row), "%s(%llu, '%s', 'city_%03llu', %llu, %llu.%02llu, '%s')",
+                            i == first ? "" : ", ", static_cast<unsigned long long>(i), STATUSES[r % 6],
+                            static_cast<unsigned long long>((r >> 8) % 500),
+                            static_cast<unsigned long long>(1 + (r >> 20) % 100),
+                            static_cast<unsigned long long>((r >> 32) % 10000),
+                            static_cast<unsigned long long>((r >> 48) % 100),
+                            i % 64 == 0 ? "fragile, \"handle with care\"" : "standard");
+        out.append(row, static_cast<size_t>(size));
+    }
+}
+
+// 由 threads 个线程依次领取并执行 work(i)，i 取遍 [0, count)，返回用时
+template<typename Work>
+double run_parallel(size_t count, size_t threads, Work work) {
+    std::atomic<size_t> next{0};
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                work(i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return seconds_since(begin);
+}
+
+std::string count_rows(Catalog& catalog) {
+    StringSink sink;
+    execute_sql(catalog, "SELECT count(*), sum(qty), max(note) FROM t", sink);
+    return sink.text();
+}
+
+} // namespace
+
+// 选项: --rows=N 行数（默认 2000000），--threads=N 同时导入的数据块数，相当于一个连接上流水线中
+//       同时执行的 COPY 帧（默认 1），--query-threads=N 单个数据块内并行解析的线程数（默认 1）
+// 同样的行分别按客户端 COPY 的方式切成 COPY_CHUNK_SIZE 的 CSV 数据块导入，和写成每条 1000 行的
+// INSERT 语句执行，比较导入速度
+int run_copy_bench(int argc, char* argv[]) {
+    long rows = 2000000;
+    long threads = 1;
+    long query_threads = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "rows", rows) && !bench_option(arg, "threads", threads) &&
+            !bench_option(arg, "query-threads", query_threads)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    auto row_count = static_cast<uint64_t>(std::max(1L, rows));
+    auto thread_count = static_cast<size_t>(std::max(1L, threads));
+    init_query_parallelism(static_cast<size_t>(std::max(1L, query_threads)), false);
+
+    // 按记录切成数据块，与客户端一样记下每块的起始行号
+    std::vector<std::string> chunks(1);
+    std::vector<uint64_t> first_lines{1};
+    size_t csv_bytes = 0;
+    for (uint64_t i = 0; i < row_count; ++i) {
+        if (chunks.back().size() >= COPY_CHUNK_SIZE) {
+            csv_bytes += chunks.back().size();
+            chunks.emplace_back();
+            first_lines.push_back(i + 1);
+        }
+        append_record(chunks.back(), i);
+    }
+    csv_bytes += chunks.back().size();
+
+    std::vector<std::string> statements;
+    for (uint64_t i = 0; i < row_count; i += 1000) {
+        statements.emplace_back();
+        append_insert(statements.back(), i, std::min<uint64_t>(1000, row_count - i));
+    }
+
+    std::cout << "批量导入基准测试: " << row_count << " 行, CSV " << csv_bytes / 1000000 << " MB, "
+              << chunks.size() << " 个数据块, " << thread_count << " 个导入线程, " << std::max(1L, query_threads)
+              << " 个解析线程" << std::endl;
+    printf("%-8s %10s %12s %10s\n", "mode", "seconds", "rows/s", "MB/s");
+
+    std::string expected;
+    {
+        Catalog catalog;
+        StringSink sink;
+        execute_sql(catalog, std::string("CREATE TABLE t ") + SCHEMA, sink);
+        double seconds = run_parallel(statements.size(), thread_count, [&](size_t i) {
+            StringSink local;
+            execute_sql(catalog, statements[i], local);
+        });
+        printf("%-8s %10.2f %12.0f %10.1f\n", "insert", seconds, static_cast<double>(row_count) / seconds,
+               static_cast<double>(csv_bytes) / 1e6 / seconds);
+        expected = count_rows(catalog);
+    }
+    {
+        Catalog catalog;
+        StringSink sink;
+        execute_sql(catalog, std::string("CREATE TABLE t ") + SCHEMA, sink);
+        std::atomic<uint64_t> loaded{0};
+        double seconds = run_parallel(chunks.size(), thread_count, [&](size_t i) {
+            loaded += copy_csv(catalog, "t", chunks[i], first_lines[i]);
+        });
+        printf("%-8s %10.2f %12.0f %10.1f\n", "copy", seconds, static_cast<double>(row_count) / seconds,
+               static_cast<double>(csv_bytes) / 1e6 / seconds);
+        if (loaded != row_count || count_rows(catalog) != expected) {
+            std::cerr << "COPY 导入的结果与 INSERT 不一致:\n" << count_rows(catalog) << "\nINSERT:\n" << expected
+                      << std::endl;
+            shutdown_query_parallelism();
+            return -1;
+        }
+    }
+    shutdown_query_parallelism();
+    return 0;
+}
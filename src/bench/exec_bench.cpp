@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "sql/executor.h"
+#include "sql/operators.h"
+#include "storage/catalog.h"
+
+namespace {
+
+struct BenchPredicate {
+    size_t column;
+    CompareOp op;
+    Value value;
+};
+
+// 一个无分组的过滤聚合查询，columns 为扫描的表列，谓词与聚合中的 slot 指向其中的位置
+struct BenchQuery {
+    const char* name;
+    std::vector<size_t> columns;
+    std::vector<std::pair<size_t, BenchPredicate>> predicates;     // slot, 谓词
+    std::vector<AggregateSpec> specs;
+};
+
+class NullSink : public ResultSink {
+public:
+    void write(std::string_view text) override { bytes += text.size(); }
+    size_t bytes = 0;
+};
+
+template<typename Fn>
+double best_of(int rounds, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, seconds_since(start));
+    }
+    return best;
+}
+
+volatile int64_t exec_sink;
+
+// 批执行：与执行器相同的算子组合，指定核函数的指令集
+int64_t run_batch(const Table& table, const BenchQuery& query, ScanIsa isa, int64_t snapshot) {
+    const TableData& data = table.data();
+    std::unique_ptr<Operator> plan =
+        std::make_unique<ScanOperator>(data, query.columns, 0, data.visibleEnd(snapshot), snapshot);
+    for (const auto& [slot, predicate] : query.predicates) {
+        plan = make_filter(std::move(plan), slot, table.columnDef(predicate.column),
+                           predicate.op, predicate.value, isa);
+    }
+    AggregateOperator aggregation(std::move(plan), query.specs, isa);
+    aggregation.run();
+    return aggregation.states()[0].count;
+}
+
+// 逐行执行的对照：每行经过一次虚调用，比较符与列类型在每行上判断
+class TupleOperator {
+public:
+    virtual ~TupleOperator() = default;
+    virtual bool next(size_t& row) = 0;
+};
+
+class TupleScan final : public TupleOperator {
+public:
+    explicit TupleScan(size_t rows) : rows_(rows) {}
+    bool next(size_t& row) override {
+        if (position_ >= rows_) {
+            return false;
+        }
+        row = position_++;
+        return true;
+    }
+
+private:
+    size_t rows_;
+    size_t position_ = 0;
+};
+
+class TupleFilter final : public TupleOperator {
+public:
+    TupleFilter(std::unique_ptr<TupleOperator> child, const Column& column, const BenchPredicate& predicate)
+        : child_(std::move(child)), column_(column), predicate_(predicate) {}
+
+    bool next(size_t& row) override {
+        while (child_->next(row)) {
+            bool pass = column_.type() == ColumnType::INT64
+                ? compare(column_.integerAt(row), predicate_.value.integer)
+                : compare(column_.realAt(row), predicate_.value.real);
+            if (pass) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::unique_ptr<TupleOperator> child_;
+    const Column& column_;
+    BenchPredicate predicate_;
+
+    template<typename T>
+    bool compare(T left, T right) const {
+        switch (predicate_.op) {
+            case CompareOp::EQ: return left == right;
+            case CompareOp::NE: return left != right;
+            case CompareOp::LT: return left < right;
+            case CompareOp::LE: return left <= right;
+            case CompareOp::GT: return left > right;
+            case CompareOp::GE: return left >= right;
+        }
+        return false;
+    }
+};
+
+int64_t run_tuple(const Table& table, const BenchQuery& query) {
+    const TableData& data = table.data();
+    std::unique_ptr<TupleOperator> plan = std::make_unique<TupleScan>(data.rowCount());
+    for (const auto& [slot, predicate] : query.predicates) {
+        plan = std::make_unique<TupleFilter>(std::move(plan), data.column(predicate.column), predicate);
+    }
+    int64_t count = 0;
+    double sum = 0;
+    size_t row;
+    while (plan->next(row)) {
+        ++count;
+        for (const auto& spec : query.specs) {
+            if (spec.star) {
+                continue;
+            }
+            const Column& column = data.column(query.columns[spec.slot]);
+            sum += column.type() == ColumnType::INT64 ? static_cast<double>(column.integerAt(row))
+                                                      : column.realAt(row);
+        }
+    }
+    exec_sink = static_cast<int64_t>(sum);
+    return count;
+}
+
+} // namespace
+
+// 选项: --rows=N 行数（默认 10000000），--rounds=N 重复次数（取最快一次）
+// 所有测试单线程运行，吞吐即每核的行数/秒
+int run_exec_bench(int argc, char* argv[]) {
+    long rows = 10000000;
+    long rounds = 3;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "rows", rows) && !bench_option(arg, "rounds", rounds)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    auto row_count = static_cast<size_t>(std::max(1L, rows));
+    int repeat = static_cast<int>(std::max(1L, rounds));
+
+    Catalog catalog;
+    Table* table = catalog.createTable("t", {
+        {"a", ColumnType::INT64, 0},
+        {"b", ColumnType::DOUBLE, 0},
+        {"c", ColumnType::INT64, 0},
+    });
+    {
+        std::mt19937_64 rng(11);
+        std::lock_guard<std::mutex> lock(table->latch());
+        MvccManager::Commit commit(catalog.mvcc());
+        for (size_t i = 0; i < row_count; ++i) {
+            Value values[3];
+            values[0].integer = static_cast<int64_t>(rng() % 1000);
+            values[1].real = static_cast<double>(rng() % 100000) / 100.0;
+            values[2].integer = static_cast<int64_t>(rng() % 1000000);
+            table->appendRow(values, commit.ts());
+        }
+    }
+
+    auto integer_value = [](int64_t v) { Value value; value.integer = v; return value; };
+    auto real_value = [](double v) { Value value; value.real = v; return value; };
+    AggregateSpec count_star{AggregateKind::COUNT, 0, ColumnType::INT64, 0, true};
+
+    std::vector<BenchQuery> queries = {
+        {"count(*) where a<500", {0},
+         {{0, {0, CompareOp::LT, integer_value(500)}}},
+         {count_star}},
+        {"sum(b) where a<500", {0, 1},
+         {{0, {0, CompareOp::LT, integer_value(500)}}},
+         {{AggregateKind::SUM, 1, ColumnType::DOUBLE, 0, false}}},
+        {"sum/min/max(c) where a<100 and b>500", {0, 1, 2},
+         {{0, {0, CompareOp::LT, integer_value(100)}}, {1, {1, CompareOp::GT, real_value(500.0)}}},
+         {{AggregateKind::SUM, 2, ColumnType::INT64, 0, false},
+          {AggregateKind::MIN, 2, ColumnType::INT64, 0, false},
+          {AggregateKind::MAX, 2, ColumnType::INT64, 0, false}}},
+        {"sum(c)", {2}, {},
+         {{AggregateKind::SUM, 0, ColumnType::INT64, 0, false}}},
+    };
+
+    bool avx2 = scan_isa_supported(ScanIsa::AVX2);
+    std::cout << "批执行基准测试: " << row_count << " 行, 批大小 " << BATCH_SIZE
+              << ", 单线程 (Mrow/s/核)" << std::endl;
+    printf("%-38s %10s %10s %10s %10s\n", "query", "tuple", "scalar", "avx2", "avx2/scalar");
+
+    MvccManager::Snapshot snapshot = catalog.mvcc().snapshot();
+    int64_t ts = snapshot.ts();
+    double n = static_cast<double>(row_count);
+    for (const auto& query : queries) {
+        int64_t expected = run_tuple(*table, query);
+        double tuple = best_of(repeat, [&]() { exec_sink = run_tuple(*table, query); });
+        double scalar = best_of(repeat, [&]() { exec_sink = run_batch(*table, query, ScanIsa::SCALAR, ts); });
+        if (run_batch(*table, query, ScanIsa::SCALAR, ts) != expected) {
+            std::cerr << query.name << ": 标量批执行结果与逐行执行不一致" << std::endl;
+            return -1;
+        }
+        if (!avx2) {
+            printf("%-38s %10.1f %10.1f %10s %10s\n", query.name, n / tuple / 1e6, n / scalar / 1e6, "-", "-");
+            continue;
+        }
+        double simd = best_of(repeat, [&]() { exec_sink = run_batch(*table, query, ScanIsa::AVX2, ts); });
+        if (run_batch(*table, query, ScanIsa::AVX2, ts) != expected) {
+            std::cerr << query.name << ": AVX2 批执行结果与逐行执行不一致" << std::endl;
+            return -1;
+        }
+        printf("%-38s %10.1f %10.1f %10.1f %9.1fx\n", query.name, n / tuple / 1e6, n / scalar / 1e6,
+               n / simd / 1e6, scalar / simd);
+    }
+
+    // 经过 SQL 解析与执行器的完整路径
+    NullSink sink;
+    double sql_seconds = best_of(repeat, [&]() {
+        execute_sql(catalog, "SELECT SUM(b) FROM t WHERE a < 500;", sink);
+    });
+    printf("%-38s %32.1f\n", "sql: select sum(b) where a<500", n / sql_seconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "bench/bench.h"
+#include "log/log.h"
+
+namespace {
+
+// 改造前的记录方式作为对照：每条消息一个 shared_ptr 放入互斥锁保护的队列并 notify_one，
+// 写入线程逐条取出、格式化时间戳、写入 ofstream 并 flush
+class MutexQueueLogger {
+public:
+    explicit MutexQueueLogger(const std::string& path) : file_(path, std::ios::out | std::ios::app) {
+        writer_ = std::thread([this]() { run(); });
+    }
+
+    ~MutexQueueLogger() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        writer_.join();
+    }
+
+    void log(LogLevel level, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        char buffer[LOG_FORMAT_BUFFER];
+        int size = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        auto message = std::make_shared<Message>(Message{std::chrono::system_clock::now(), level,
+                                                         std::string(buffer, static_cast<size_t>(std::max(size, 0)))});
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push(std::move(message));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    struct Message {
+        std::chrono::system_clock::time_point timestamp;
+        LogLevel level;
+        std::string content;
+    };
+
+    std::ofstream file_;
+    std::queue<std::shared_ptr<Message>> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread writer_;
+
+    void run() {
+        for (;;) {
+            std::shared_ptr<Message> message;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return !queue_.empty() || stop_; });
+                if (queue_.empty()) {
+                    return;
+                }
+                message = queue_.front();
+                queue_.pop();
+            }
+            auto time = std::chrono::system_clock::to_time_t(message->timestamp);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(message->timestamp.time_since_epoch()) % 1000;
+            std::tm tm_info;
+            localtime_r(&time, &tm_info);
+            char buffer[32];
+            strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm_info);
+            file_ << std::format("[{}.{:03d}] [{}] {}\n", buffer, static_cast<int>(ms.count()),
+                                 levelToString(message->level), message->content);
+            file_.flush();
+        }
+    }
+};
+
+struct Result {
+    double seconds;     // 从开始记录到全部写出
+    uint64_t dropped;
+};
+
+// threads 个线程共记录 messages 条日志（典型长度的一行网络日志）
+template<typename LogFn>
+double produce(int threads, size_t messages, LogFn&& log_fn) {
+    size_t per_thread = messages / static_cast<size_t>(threads);
+    std::vector<std::thread> producers;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([&log_fn, t, per_thread]() {
+            for (size_t i = 0; i < per_thread; ++i) {
+                log_fn(t, i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    return seconds_since(begin);
+}
+
+Result run_ring(Logger& logger, LogOverflow policy, int threads, size_t messages) {
+    using enum LogModule;
+    using enum LogLevel;
+    logger.setOverflowPolicy(policy);
+    uint64_t dropped = logger.droppedLogs();
+    auto begin = std::chrono::steady_clock::now();
+    produce(threads, messages, [](int t, size_t i) {
+        LOG(INFO, NETWORK, "连接 %d 收到请求 %zu: SELECT count(*) FROM orders WHERE status = 'paid'", t, i);
+    });
+    logger.flush();
+    return Result{seconds_since(begin), logger.droppedLogs() - dropped};
+}
+
+Result run_baseline(const std::string& path, int threads, size_t messages) {
+    auto begin = std::chrono::steady_clock::now();
+    {
+        MutexQueueLogger logger(path);
+        produce(threads, messages, [&logger](int t, size_t i) {
+            logger.log(LogLevel::INFO, "连接 %d 收到请求 %zu: SELECT count(*) FROM orders WHERE status = 'paid'", t, i);
+        });
+    }
+    return Result{seconds_since(begin), 0};
+}
+
+// 在 /tmp 下新建一个空的日志文件，失败时返回空串
+std::string temporary_log_path() {
+    char pattern[] = "/tmp/simpledb-log-XXXXXX";
+    int fd = mkstemp(pattern);
+    if (fd < 0) {
+        std::cerr << "无法创建临时文件: " << strerror(errno) << std::endl;
+        return {};
+    }
+    close(fd);
+    return pattern;
+}
+
+#define CALLER_BURST 4096    // 测调用方开销时每轮连续记录的条数，小于缓冲区槽数，不会等待写入线程
+
+const char* const QUERY = "SELECT count(*) FROM orders WHERE status = 'paid'";
+
+// 单线程每条日志在调用方花费的时间：每轮连续记录 CALLER_BURST 条后计时，再等写入线程写完（不计时）
+template<typename LogFn>
+double caller_nanos(Logger& logger, size_t messages, LogFn&& log_fn) {
+    double seconds = 0;
+    size_t done = 0;
+    while (done < messages) {
+        size_t burst = std::min<size_t>(CALLER_BURST, messages - done);
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < burst; ++i) {
+            log_fn(static_cast<int>(i & 63), done + i);
+        }
+        seconds += seconds_since(begin);
+        done += burst;
+        logger.flush();
+    }
+    return seconds * 1e9 / static_cast<double>(messages);
+}
+
+} // namespace
+
+// 选项: --messages=N 每一档记录的日志条数（默认 1000000），--threads=N 最多的生产者线程数，从 1 起翻倍（默认 32），
+//       --baseline=0|1 是否测改造前的互斥锁队列作为对照（默认 1），--file=PATH 日志文件（默认在 /tmp 下新建，测完删除）
+// 多个线程同时记录日志，比较无锁环形缓冲区（满时等待 / 丢弃）与互斥锁队列逐行 flush 的吞吐，
+// 吞吐按从开始记录到全部写出文件计算；最后比较单线程调用方格式化与延迟格式化每条日志在调用方的开销
+int run_log_bench(int argc, char* argv[]) {
+    long messages = 1000000;
+    long max_threads = 32;
+    long baseline = 1;
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--file=")) {
+            path = arg.substr(strlen("--file="));
+        } else if (!bench_option(arg, "messages", messages) && !bench_option(arg, "threads", max_threads) &&
+                   !bench_option(arg, "baseline", baseline)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    bool temporary = path.empty();
+    if (temporary && (path = temporary_log_path()).empty()) {
+        return -1;
+    }
+    auto count = static_cast<size_t>(std::max(1L, messages));
+
+    Logger& logger = Logger::getInstance();
+    logger.setLogFile(path);
+    std::cout << "日志基准测试: 每档 " << count << " 条, 写入 " << path << ", 缓冲区 " << LOG_RING_SLOTS << " 槽 x "
+              << LOG_SLOT_BYTES << " 字节" << std::endl;
+    printf("%8s | %14s | %14s %9s | %14s | %8s\n", "threads", "block(msg/s)", "drop(msg/s)", "dropped", "mutex(msg/s)",
+           "block x");
+    for (long threads = 1; threads <= std::max(1L, max_threads); threads *= 2) {
+        int n = static_cast<int>(threads);
+        size_t total = count / static_cast<size_t>(n) * static_cast<size_t>(n);
+        Result block = run_ring(logger, LogOverflow::BLOCK, n, total);
+        Result drop = run_ring(logger, LogOverflow::DROP, n, total);
+        double block_rate = static_cast<double>(total) / block.seconds;
+        double drop_rate = static_cast<double>(total) / drop.seconds;
+        if (baseline) {
+            Result mutex = run_baseline(path, n, total);
+            double mutex_rate = static_cast<double>(total) / mutex.seconds;
+            printf("%8d | %14.0f | %14.0f %8.1f%% | %14.0f | %7.1fx\n", n, block_rate, drop_rate,
+                   100.0 * static_cast<double>(drop.dropped) / static_cast<double>(total), mutex_rate,
+                   block_rate / mutex_rate);
+        } else {
+            printf("%8d | %14.0f | %14.0f %8.1f%% | %14s | %8s\n", n, block_rate, drop_rate,
+                   100.0 * static_cast<double>(drop.dropped) / static_cast<double>(total), "-", "-");
+        }
+        fflush(stdout);
+    }
+    logger.setOverflowPolicy(LogOverflow::BLOCK);
+
+    // 调用方开销：在调用线程格式化（LOG）与只复制参数（LOG_DEFERRED，写入文本或二进制日志）
+    using enum LogModule;
+    using enum LogLevel;
+    std::string_view query = QUERY;
+    double eager = caller_nanos(logger, count, [query](int t, size_t i) {
+        LOG(INFO, NETWORK, "连接 %d 收到请求 %zu: %.*s", t, i, static_cast<int>(query.size()), query.data());
+    });
+    auto deferred_fn = [query](int t, size_t i) {
+        LOG_DEFERRED(INFO, NETWORK, "连接 {} 收到请求 {}: {}", t, i, query);
+    };
+    double deferred_text = caller_nanos(logger, count, deferred_fn);
+    std::string binary_path = path + ".bin";
+    logger.setLogFile(binary_path, LogFileFormat::BINARY);
+    double deferred_binary = caller_nanos(logger, count, deferred_fn);
+    off_t binary_bytes = 0;
+    if (FILE* file = fopen(binary_path.c_str(), "rb")) {
+        fseeko(file, 0, SEEK_END);
+        binary_bytes = ftello(file);
+        fclose(file);
+    }
+    unlink(binary_path.c_str());
+    printf("\n调用方开销 (ns/条, 单线程, 每轮 %d 条): LOG %.1f | LOG_DEFERRED 文本 %.1f | LOG_DEFERRED 二进制 %.1f "
+           "(%.1f 字节/条)\n",
+           CALLER_BURST, eager, deferred_text, deferred_binary,
+           static_cast<double>(binary_bytes) / static_cast<double>(count));
+
+    logger.setLogFile("simple.log");
+    if (temporary) {
+        unlink(path.c_str());
+    }
+    return 0;
+}
+
+namespace {
+
+#define FILTER_LOOPS 200000000L     // 每种调用点默认执行的次数
+
+// 参数中的“昂贵”计算：关闭的调用点不应求值它，evaluated 记录实际求值的次数
+std::atomic<size_t> evaluated{0};
+
+std::string expensive(size_t i) {
+    evaluated.fetch_add(1, std::memory_order_relaxed);
+    return "value " + std::to_string(i);
+}
+
+// 每次迭代都有一个编译器不能删除的寄存器依赖，空循环与日志调用点的循环结构相同
+inline void keep(size_t value) {
+    asm volatile("" : : "r"(value));
+}
+
+template<typename Fn>
+double loop_nanos(long loops, Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < static_cast<size_t>(loops); ++i) {
+        fn(i);
+        keep(i);
+    }
+    return seconds_since(begin) * 1e9 / static_cast<double>(loops);
+}
+
+} // namespace
+
+// 选项: --loops=N 每种调用点执行的次数（默认 200000000）
+// 关闭的日志调用点的开销：运行时按模块级别关闭（LOG / LOG_DEFERRED，一次 relaxed 读与比较，参数不求值）、
+// 编译时删除（级别低于 LOG_MIN_LEVEL）与改造前的做法（经过 getInstance()、求值参数后在 log() 中返回）对比空循环
+int run_log_filter_bench(int argc, char* argv[]) {
+    long loops = FILTER_LOOPS;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "loops", loops)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    loops = std::max(1L, loops);
+
+    using enum LogModule;
+    using enum LogLevel;
+    Logger& logger = Logger::getInstance();
+    LogLevel saved = logger.moduleLevel(PLANNER);
+    logger.setModuleLevel(PLANNER, INFO);
+
+    std::cout << "关闭的日志调用点: 每种 " << loops << " 次, 编译时保留的最低级别 " << levelToString(LOG_COMPILED_LEVEL)
+              << ", PLANNER 模块运行时级别 INFO" << std::endl;
+    printf("%-44s %10s %10s %12s\n", "调用点", "ns/次", "减空循环", "参数求值次数");
+    double empty = loop_nanos(loops, [](size_t) {});
+    auto report = [&](const char* name, double nanos, size_t evaluations) {
+        printf("%-44s %10.2f %10.2f %12zu\n", name, nanos, nanos - empty, evaluations);
+    };
+    report("空循环", empty, 0);
+
+    evaluated = 0;
+    double runtime = loop_nanos(loops, [](size_t i) {
+        LOG(DEBUG, PLANNER, "计划 %zu: %s", i, expensive(i).c_str());
+    });
+    report("LOG(DEBUG) 运行时关闭", runtime, evaluated.load());
+
+    evaluated = 0;
+    double deferred = loop_nanos(loops, [](size_t i) {
+        LOG_DEFERRED(DEBUG, PLANNER, "计划 {}: {}", i, expensive(i));
+    });
+    report("LOG_DEFERRED(DEBUG) 运行时关闭", deferred, evaluated.load());
+
+    if constexpr (LOG_COMPILED_LEVEL > DEBUG5) {
+        evaluated = 0;
+        double stripped = loop_nanos(loops, [](size_t i) {
+            LOG(DEBUG5, PLANNER, "计划 %zu: %s", i, expensive(i).c_str());
+        });
+        report("LOG(DEBUG5) 编译时删除", stripped, evaluated.load());
+    } else {
+        printf("%-44s %10s %10s %12s\n", "LOG(DEBUG5) 编译时删除", "-", "-", "-");
+        printf("  （以 -DLOG_MIN_LEVEL=DEBUG4 或更高配置构建时测量）\n");
+    }
+
+    // 改造前的宏直接调用 getInstance().log()：先求值参数，在 log() 中判断后返回；次数减少到 1/20
+    long direct_loops = std::max(1L, loops / 20);
+    evaluated = 0;
+    double direct = loop_nanos(direct_loops, [&logger](size_t i) {
+        logger.log(DEBUG, PLANNER, "计划 %zu: %s", i, expensive(i).c_str());
+    });
+    report("改造前: getInstance().log() 内判断", direct, evaluated.load() * static_cast<size_t>(loops / direct_loops));
+
+    logger.setModuleLevel(PLANNER, saved);
+    return 0;
+}
+
+namespace {
+
+#define STACK_BURST 256     // 测调用栈开销时每轮连续记录的 ERROR 条数
+
+// 在 depth 层调用之下执行 fn，模拟服务器中执行出错时较深的调用栈
+template<typename Fn>
+__attribute__((noinline)) void at_depth(int depth, Fn& fn) {
+    if (depth <= 0) {
+        fn();
+    } else {
+        at_depth(depth - 1, fn);
+    }
+    asm volatile("");   // 防止尾调用优化把各层合并
+}
+
+} // namespace
+
+// 选项: --errors=N 记录的 ERROR 条数（默认 10000），--depth=N 出错处之上额外的调用层数（默认 16）
+// ERROR 日志的调用栈：调用方只收集帧地址、写入线程解析符号（按地址缓存）与改造前在调用方同步解析对比，
+// 每轮连续记录 STACK_BURST 条（含抛出并捕获异常），分别计时调用方与到这一轮全部写出；第一轮符号缓存是冷的。
+// 只有一个 CPU 时写入线程与调用方交替运行，调用方的时间也包括写入线程
+int run_log_stack_bench(int argc, char* argv[]) {
+    long errors = 10000;
+    long depth = 16;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "errors", errors) && !bench_option(arg, "depth", depth)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    std::string path = temporary_log_path();
+    if (path.empty()) {
+        return -1;
+    }
+    auto count = static_cast<size_t>(std::max(1L, errors));
+    int levels = static_cast<int>(std::max(0L, depth));
+
+    using enum LogModule;
+    Logger& logger = Logger::getInstance();
+    logger.setLogFile(path);
+    std::cout << "ERROR 日志调用栈: " << count << " 条, 额外调用层数 " << levels << ", 写入 " << path << std::endl;
+
+    size_t i = 0;
+    auto log_error = [&i]() {
+        try {
+            LOG_ERROR(EXECUTOR, "语句 %zu 执行失败: 表 orders 不存在", i);
+        } catch (const std::runtime_error&) {
+        }
+    };
+    double caller = 0;
+    double written_cold = 0;
+    double written_warm = 0;
+    for (size_t done = 0; done < count; done += STACK_BURST) {
+        size_t burst = std::min<size_t>(STACK_BURST, count - done);
+        auto begin = std::chrono::steady_clock::now();
+        for (i = done; i < done + burst; ++i) {
+            at_depth(levels, log_error);
+        }
+        caller += seconds_since(begin);
+        logger.flush();
+        (done == 0 ? written_cold : written_warm) += seconds_since(begin);
+    }
+    size_t first = std::min<size_t>(STACK_BURST, count);
+
+    // 改造前：调用方格式化消息、同步解析整个调用栈再写入缓冲区，然后抛出异常
+    size_t old_count = std::max<size_t>(1, count / 10);
+    auto log_error_before = [&logger, &i]() {
+        try {
+            char message[LOG_FORMAT_BUFFER];
+            snprintf(message, sizeof(message), "语句 %zu 执行失败: 表 orders 不存在", i);
+            std::string full = std::string(message) + "\nStack trace:\n";
+            full += boost::stacktrace::to_string(boost::stacktrace::stacktrace());
+            // 以 WARNING 写入已拼好的文本，避免再收集一次调用栈
+            logger.log(LogLevel::WARNING, EXECUTOR, "%s", full.c_str());
+            throw std::runtime_error(message);
+        } catch (const std::runtime_error&) {
+        }
+    };
+    double before_caller = 0;
+    double before_written = 0;
+    for (size_t done = 0; done < old_count; done += STACK_BURST) {
+        size_t burst = std::min<size_t>(STACK_BURST, old_count - done);
+        auto begin = std::chrono::steady_clock::now();
+        for (i = done; i < done + burst; ++i) {
+            at_depth(levels, log_error_before);
+        }
+        before_caller += seconds_since(begin);
+        logger.flush();
+        before_written += seconds_since(begin);
+    }
+
+    auto per = [](double seconds, size_t n) { return seconds * 1e6 / static_cast<double>(n); };
+    printf("%-40s %12s %12s\n", "us/条", "调用方", "全部写出");
+    printf("%-40s %12.2f %12.2f\n", "收集帧地址，写入线程解析（全部）", per(caller, count),
+           per(written_cold + written_warm, count));
+    printf("%-40s %12s %12.2f\n", "  第一轮（符号缓存为空）", "", per(written_cold, first));
+    if (count > first) {
+        printf("%-40s %12s %12.2f\n", "  之后各轮（缓存命中）", "", per(written_warm, count - first));
+    }
+    printf("%-40s %12.2f %12.2f  (%zu 条)\n", "改造前: 调用方同步解析", per(before_caller, old_count),
+           per(before_written, old_count), old_count);
+
+    logger.setLogFile("simple.log");
+    unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/bench.h"
+#include "sql/executor.h"
+#include "storage/catalog.h"
+
+namespace {
+
+class StringSink : public ResultSink {
+public:
+    void write(std::string_view text) override { text_.append(text); }
+    const std::string& text() const { return text_; }
+    void clear() { text_.clear(); }
+
+private:
+    std::string text_;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+struct RoundResult {
+    double reads_per_second = 0;
+    double writes_per_second = 0;
+    uint32_t read_p99_us = 0;
+    uint32_t write_p99_us = 0;
+    uint64_t anomalies = 0;         // 读到的行数比同一客户端上次读到的少
+};
+
+uint32_t p99(std::vector<uint32_t>& samples) {
+    if (samples.empty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() * 99 / 100];
+}
+
+// clients 个客户端在 duration_ms 内执行混合负载：
+// 读为全表过滤聚合，写为插入一行或按 id 更新一行（更新不改变行数）。
+// table_lock 为 true 时用一把表级读写锁包住每条语句，作为没有多版本时的对照。
+RoundResult run_round(size_t rows, int clients, long duration_ms, long write_pct, bool table_lock) {
+    Catalog catalog;
+    StringSink setup;
+    execute_sql(catalog, "CREATE TABLE t (id BIGINT, a BIGINT, b DOUBLE)", setup);
+    Table* table = catalog.findTable("t");
+    {
+        std::lock_guard<std::mutex> lock(table->latch());
+        MvccManager::Commit commit(catalog.mvcc());
+        for (size_t i = 0; i < rows; ++i) {
+            Value values[3];
+            values[0].integer = static_cast<int64_t>(i);
+            values[1].integer = static_cast<int64_t>(mix(i) % 1000);
+            values[2].real = static_cast<double>(mix(i + rows) % 10000) / 100.0;
+            table->appendRow(values, commit.ts());
+        }
+    }
+
+    std::shared_mutex big_lock;
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> next_id{static_cast<int64_t>(rows)};
+    std::vector<std::vector<uint32_t>> read_latency(static_cast<size_t>(clients));
+    std::vector<std::vector<uint32_t>> write_latency(static_cast<size_t>(clients));
+    std::atomic<uint64_t> anomalies{0};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c]() {
+            StringSink sink;
+            std::string sql;
+            int64_t last_count = 0;
+            uint64_t seed = mix(static_cast<uint64_t>(c) + 1);
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (uint64_t k = 0; !stop.load(std::memory_order_relaxed); ++k) {
+                uint64_t r = mix(seed + k);
+                bool write = static_cast<long>(r % 100) < write_pct;
+                if (write) {
+                    if (r & 0x100) {
+                        sql = "INSERT INTO t VALUES (" + std::to_string(next_id.fetch_add(1)) + ", " +
+                              std::to_string((r >> 16) % 1000) + ", 1.5)";
+                    } else {
+                        sql = "UPDATE t SET b = " + std::to_string((r >> 16) % 10000) + " WHERE id = " +
+                              std::to_string((r >> 32) % rows);
+                    }
+                } else {
+                    sql = "SELECT count(*), sum(b) FROM t WHERE a < 500";
+                }
+
+                sink.clear();
+                auto begin = std::chrono::steady_clock::now();
+                if (table_lock && write) {
+                    std::unique_lock<std::shared_mutex> lock(big_lock);
+                    execute_sql(catalog, sql, sink);
+                } else if (table_lock) {
+                    std::shared_lock<std::shared_mutex> lock(big_lock);
+                    execute_sql(catalog, sql, sink);
+                } else {
+                    execute_sql(catalog, sql, sink);
+                }
+                auto micros = static_cast<uint32_t>(seconds_since(begin) * 1e6);
+                (write ? write_latency : read_latency)[static_cast<size_t>(c)].push_back(micros);
+
+                if (!write) {
+                    // 结果第二行为 count | sum；插入只增加行数，更新不改变行数
+                    size_t line = sink.text().find('\n');
+                    int64_t count = atoll(sink.text().c_str() + line + 1);
+                    if (count < last_count) {
+                        anomalies.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    last_count = count;
+                }
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = seconds_since(begin);
+
+    std::vector<uint32_t> reads;
+    std::vector<uint32_t> writes;
+    for (int c = 0; c < clients; ++c) {
+        reads.insert(reads.end(), read_latency[static_cast<size_t>(c)].begin(),
+                     read_latency[static_cast<size_t>(c)].end());
+        writes.insert(writes.end(), write_latency[static_cast<size_t>(c)].begin(),
+                      write_latency[static_cast<size_t>(c)].end());
+    }
+    RoundResult result;
+    result.reads_per_second = static_cast<double>(reads.size()) / seconds;
+    result.writes_per_second = static_cast<double>(writes.size()) / seconds;
+    result.read_p99_us = p99(reads);
+    result.write_p99_us = p99(writes);
+    result.anomalies = anomalies.load();
+    return result;
+}
+
+} // namespace
+
+// 选项: --rows=N 初始行数（默认 200000），--ms=N 每轮时长（默认 1000），
+//       --clients=N 最大客户端数（默认 64，从 1 起倍增），--write-pct=N 写语句比例（默认 50）
+int run_mvcc_bench(int argc, char* argv[]) {
+    long rows = 200000;
+    long duration_ms = 1000;
+    long max_clients = 64;
+    long write_pct = 50;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "rows", rows) && !bench_option(arg, "ms", duration_ms) &&
+            !bench_option(arg, "clients", max_clients) && !bench_option(arg, "write-pct", write_pct)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    auto row_count = static_cast<size_t>(std::max(1L, rows));
+    duration_ms = std::max(1L, duration_ms);
+    write_pct = std::clamp(write_pct, 0L, 100L);
+
+    std::cout << "多版本并发基准测试: 初始 " << row_count << " 行, 写语句 " << write_pct << "%, 每轮 "
+              << duration_ms << " ms, " << std::thread::hardware_concurrency() << " 个 CPU" << std::endl;
+    printf("%-10s %8s %12s %12s %14s %14s\n", "mode", "clients", "reads/s", "writes/s", "read p99(us)",
+           "write p99(us)");
+    bool ok = true;
+    for (bool table_lock : {false, true}) {
+        for (long clients = 1; clients <= std::max(1L, max_clients); clients *= 2) {
+            RoundResult result = run_round(row_count, static_cast<int>(clients), duration_ms, write_pct, table_lock);
+            printf("%-10s %8ld %12.0f %12.0f %14u %14u\n", table_lock ? "table lock" : "mvcc", clients,
+                   result.reads_per_second, result.writes_per_second, result.read_p99_us, result.write_p99_us);
+            if (result.anomalies != 0) {
+                std::cerr << "快照不一致: " << result.anomalies << " 次读到的行数少于之前" << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "bench/bench.h"
+#include "storage/page_cache.h"
+
+namespace {
+
+enum class Workload {
+    SCAN,       // 各线程顺序扫描文件的一段，读取页内每个缓存行
+    UNIFORM,    // 均匀随机读页
+    HOT         // 90% 访问落在缓冲池一半大小的热点页上，其余均匀随机
+};
+
+const char* workload_name(Workload workload) {
+    switch (workload) {
+        case Workload::SCAN: return "scan";
+        case Workload::UNIFORM: return "uniform";
+        case Workload::HOT: return "hot 90/10";
+    }
+    return "";
+}
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t load_word(const char* data) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::atomic<uint64_t> bench_sink{0};
+
+struct RoundResult {
+    double seconds = 0;
+    uint64_t pages = 0;
+    uint64_t corrupt = 0;
+};
+
+// 每页的第一个字为页号，读到的页号不符说明缓冲池返回了错误的页
+RoundResult run_round(PageCache& cache, Workload workload, unsigned threads, uint64_t ops, uint64_t hot_pages) {
+    uint64_t page_count = cache.pageCount();
+    std::atomic<bool> start{false};
+    std::atomic<uint64_t> pages{0};
+    std::atomic<uint64_t> corrupt{0};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            uint64_t sum = 0;
+            uint64_t bad = 0;
+            uint64_t done = 0;
+            auto check = [&](uint64_t page, size_t stride) {
+                PageRef ref = cache.pin(page);
+                bad += load_word(ref.data()) != page ? 1u : 0u;
+                for (size_t offset = 0; offset < PAGE_BYTES; offset += stride) {
+                    sum += load_word(ref.data() + offset);
+                }
+                ++done;
+            };
+            if (workload == Workload::SCAN) {
+                uint64_t begin = page_count * t / threads;
+                uint64_t end = page_count * (t + 1) / threads;
+                for (uint64_t page = begin; page < end; ++page) {
+                    check(page, 64);
+                }
+            } else {
+                uint64_t seed = mix(t + 1);
+                for (uint64_t k = 0; k < ops; ++k) {
+                    uint64_t r = mix(seed + k);
+                    bool hot = workload == Workload::HOT && r % 10 != 0;
+                    check((r >> 8) % (hot ? hot_pages : page_count), 1024);
+                }
+            }
+            pages.fetch_add(done, std::memory_order_relaxed);
+            corrupt.fetch_add(bad, std::memory_order_relaxed);
+            bench_sink.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    RoundResult result;
+    result.seconds = seconds_since(begin);
+    result.pages = pages.load();
+    result.corrupt = corrupt.load();
+    return result;
+}
+
+// 通过缓冲池写入全部页：缓冲池小于文件，写入过程中脏页被淘汰写回
+void fill(PageCache& cache, uint64_t pages) {
+    cache.allocate(pages);
+    for (uint64_t page = 0; page < pages; ++page) {
+        PageRef ref = cache.pin(page);
+        for (size_t offset = 0; offset < PAGE_BYTES; offset += sizeof(uint64_t)) {
+            uint64_t value = offset == 0 ? page : mix(page * PAGE_BYTES + offset);
+            memcpy(ref.data() + offset, &value, sizeof(value));
+        }
+        ref.markDirty();
+    }
+    cache.flush();
+}
+
+} // namespace
+
+// 选项: --file=PATH 数据文件（默认在 /tmp 下新建，测试后删除），--file-mb=N 文件大小（默认 512），
+//       --pool-mb=N PREAD 模式的缓冲池大小（默认 64），--threads=N 线程数（默认为 CPU 核数），
+//       --ops=N 随机读每线程操作数（默认 200000），--readahead=N 预读页数（默认 16），
+//       --cold=1 每轮前丢弃内核中该文件的页缓存
+int run_page_bench(int argc, char* argv[]) {
+    std::string path;
+    long file_mb = 512;
+    long pool_mb = 64;
+    long threads = std::max(1u, std::thread::hardware_concurrency());
+    long ops = 200000;
+    long readahead = PAGE_DEFAULT_READAHEAD;
+    long cold = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--file=")) {
+            path = arg.substr(strlen("--file="));
+        } else if (!bench_option(arg, "file-mb", file_mb) && !bench_option(arg, "pool-mb", pool_mb) &&
+                   !bench_option(arg, "threads", threads) && !bench_option(arg, "ops", ops) &&
+                   !bench_option(arg, "readahead", readahead) && !bench_option(arg, "cold", cold)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    if (path.empty()) {
+        char pattern[] = "/tmp/simpledb-pages-XXXXXX";
+        int fd = mkstemp(pattern);
+        if (fd < 0) {
+            std::cerr << "无法创建临时文件: " << strerror(errno) << std::endl;
+            return -1;
+        }
+        close(fd);
+        path = pattern;
+    } else {
+        unlink(path.c_str());
+    }
+
+    PageCacheOptions options;
+    options.path = path;
+    options.frames = static_cast<size_t>(std::max(1L, pool_mb)) * (1 << 20) / PAGE_BYTES;
+    options.readahead = static_cast<unsigned>(std::max(0L, readahead));
+    auto pages = static_cast<uint64_t>(std::max(1L, file_mb)) * (1 << 20) / PAGE_BYTES;
+    auto thread_count = static_cast<unsigned>(std::max(1L, threads));
+
+    int ret = 0;
+    try {
+        PageCache cache(options);
+        fill(cache, pages);
+        std::cout << "页缓冲池基准测试: 文件 " << path << " " << file_mb << " MB, 缓冲池 " << pool_mb
+                  << " MB, " << thread_count << " 线程, 预读 " << options.readahead << " 页"
+                  << (cold ? ", 冷缓存" : "") << std::endl;
+        printf("%-6s %-10s %12s %10s %10s %10s %10s %12s\n", "mode", "workload", "Kpages/s", "MB/s",
+               "hit ratio", "evictions", "read MB", "major faults");
+        for (PageIoMode mode : {PageIoMode::PREAD, PageIoMode::MMAP}) {
+            cache.setIoMode(mode);
+            for (Workload workload : {Workload::SCAN, Workload::UNIFORM, Workload::HOT}) {
+                if (cold) {
+                    // 来回切换一次以清空缓冲池与映射
+                    cache.setIoMode(mode == PageIoMode::PREAD ? PageIoMode::MMAP : PageIoMode::PREAD);
+                    cache.setIoMode(mode);
+                    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                    if (fd >= 0) {
+                        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                        close(fd);
+                    }
+                }
+                cache.resetStats();
+                RoundResult result = run_round(cache, workload, thread_count, static_cast<uint64_t>(std::max(1L, ops)),
+                                               std::max<uint64_t>(1, options.frames / 2));
+                if (result.corrupt != 0) {
+                    std::cerr << "校验失败: " << result.corrupt << " 次读到错误的页" << std::endl;
+                    ret = -1;
+                }
+                PageCacheStats stats = cache.stats();
+                double pages_per_second = static_cast<double>(result.pages) / result.seconds;
+                // MMAP 模式下缓存由内核管理，命中率以主缺页数代替
+                char hit_ratio[16] = "-";
+                if (mode == PageIoMode::PREAD) {
+                    snprintf(hit_ratio, sizeof(hit_ratio), "%.1f%%", stats.hitRatio() * 100);
+                }
+                printf("%-6s %-10s %12.1f %10.1f %10s %10llu %10.1f %12llu\n",
+                       mode == PageIoMode::PREAD ? "pread" : "mmap", workload_name(workload),
+                       pages_per_second / 1e3, pages_per_second * PAGE_BYTES / (1 << 20),
+                       hit_ratio, static_cast<unsigned long long>(stats.evictions),
+                       static_cast<double>(stats.read_bytes) / (1 << 20),
+                       static_cast<unsigned long long>(stats.major_faults));
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ret = -1;
+    }
+    unlink(path.c_str());
+    return ret;
+}
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "common/morsel_scheduler.h"
+#include "sql/executor.h"
+#include "sql/operators.h"
+#include "storage/catalog.h"
+
+namespace {
+
+class StringSink : public ResultSink {
+public:
+    void write(std::string_view text) override { text_.append(text); }
+    const std::string& text() const { return text_; }
+    void clear() { text_.clear(); }
+
+private:
+    std::string text_;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+const char* const QUERIES[] = {
+    "SELECT count(*), sum(b), min(a), max(a) FROM t WHERE a < 500",
+    "SELECT g, count(*), sum(b), avg(a) FROM t GROUP BY g",
+    "SELECT k, count(*), max(b) FROM t WHERE a >= 100 GROUP BY k LIMIT 5",
+};
+
+} // namespace
+
+// 选项: --rows=N 表的行数（默认 8000000），--threads=N 最大并行度（默认按 CPU 数，从 1 起倍增），
+//       --reps=N 每个查询的重复次数，取中位数（默认 5）
+int run_parallel_bench(int argc, char* argv[]) {
+    long rows = 8000000;
+    long max_threads = static_cast<long>(MorselScheduler::availableCpus());
+    long reps = 5;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "rows", rows) && !bench_option(arg, "threads", max_threads) &&
+            !bench_option(arg, "reps", reps)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    auto row_count = static_cast<size_t>(std::max(1L, rows));
+    max_threads = std::max(1L, max_threads);
+    reps = std::max(1L, reps);
+
+    // a 取 0..999，g 有 64 组，k 有 10 万组；b 为 0.25 的倍数，求和没有舍入误差，结果与合并顺序无关
+    Catalog catalog;
+    StringSink sink;
+    execute_sql(catalog, "CREATE TABLE t (a BIGINT, b DOUBLE, g BIGINT, k BIGINT)", sink);
+    Table* table = catalog.findTable("t");
+    {
+        std::lock_guard<std::mutex> lock(table->latch());
+        MvccManager::Commit commit(catalog.mvcc());
+        for (size_t i = 0; i < row_count; ++i) {
+            uint64_t r = mix(i);
+            Value values[4];
+            values[0].integer = static_cast<int64_t>(r % 1000);
+            values[1].real = static_cast<double>((r >> 10) % 10000) / 4.0;
+            values[2].integer = static_cast<int64_t>((r >> 24) % 64);
+            values[3].integer = static_cast<int64_t>((r >> 32) % 100000);
+            table->appendRow(values, commit.ts());
+        }
+    }
+
+    std::vector<long> thread_counts;
+    for (long threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    MorselScheduler probe(0);
+    std::cout << "单查询并行基准测试: " << row_count << " 行, 片段 " << MORSEL_ROWS << " 行, "
+              << MorselScheduler::availableCpus() << " 个 CPU, " << probe.nodeCount() << " 个 NUMA 节点"
+              << std::endl;
+    printf("%-6s %8s %12s %10s %10s\n", "query", "threads", "latency(ms)", "Mrow/s", "speedup");
+
+    bool ok = true;
+    for (size_t q = 0; q < sizeof(QUERIES) / sizeof(QUERIES[0]); ++q) {
+        std::cout << "Q" << q + 1 << ": " << QUERIES[q] << std::endl;
+        std::string expected;
+        double serial_ms = 0;
+        for (long threads : thread_counts) {
+            init_query_parallelism(static_cast<size_t>(threads), true);
+            std::vector<double> samples;
+            for (long rep = 0; rep < reps; ++rep) {
+                sink.clear();
+                auto begin = std::chrono::steady_clock::now();
+                execute_sql(catalog, QUERIES[q], sink);
+                samples.push_back(seconds_since(begin) * 1e3);
+            }
+            std::sort(samples.begin(), samples.end());
+            double ms = samples[samples.size() / 2];
+            if (threads == 1) {
+                expected = sink.text();
+                serial_ms = ms;
+            } else if (sink.text() != expected) {
+                std::cerr << threads << " 线程的结果与串行执行不一致:\n" << sink.text() << "\n串行:\n"
+                          << expected << std::endl;
+                ok = false;
+            }
+            printf("Q%-5zu %8ld %12.2f %10.0f %9.2fx\n", q + 1, threads, ms,
+                   static_cast<double>(row_count) / ms / 1e3, serial_ms / ms);
+        }
+    }
+    shutdown_query_parallelism();
+    return ok ? 0 : -1;
+}
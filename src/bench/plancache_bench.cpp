@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/bench.h"
+#include "sql/executor.h"
+#include "sql/plan_cache.h"
+#include "storage/catalog.h"
+
+namespace {
+
+class StringSink : public ResultSink {
+public:
+    void write(std::string_view text) override { text_.append(text); }
+    const std::string& text() const { return text_; }
+    void clear() { text_.clear(); }
+
+private:
+    std::string text_;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+enum class Mode {
+    PARSE,          // 每条语句都完整解析（execute_sql）
+    CACHED,         // 规范化后查语句缓存（execute_cached）
+    PREPARED        // 客户端持有句柄，只传参数（execute_parsed）
+};
+
+const char* mode_name(Mode mode) {
+    switch (mode) {
+        case Mode::PARSE: return "parse";
+        case Mode::CACHED: return "cached";
+        case Mode::PREPARED: return "prepared";
+    }
+    return "";
+}
+
+// 第 shape 种语句形状的一个实例：三个模板，LIMIT 不同即为不同的形状
+std::string make_statement(size_t shape, uint64_t r) {
+    std::string limit = " LIMIT " + std::to_string(shape / 3 + 1);
+    switch (shape % 3) {
+        case 0:
+            return "SELECT * FROM t WHERE id = " + std::to_string(r % 256) + limit;
+        case 1:
+            return "SELECT id, b FROM t WHERE a > " + std::to_string(r % 1000) + " AND b < " +
+                   std::to_string(static_cast<double>((r >> 16) % 4000) / 4.0) + limit;
+        default:
+            return "SELECT count(*), max(b) FROM t WHERE id >= " + std::to_string(r % 256) + limit;
+    }
+}
+
+struct Workload {
+    std::vector<std::string> sql;
+    std::vector<size_t> shape;
+    std::vector<std::vector<Literal>> literals;                     // 每条语句规范化得到的参数
+    std::vector<std::shared_ptr<const PreparedStatement>> prepared; // 每种形状准备一次
+};
+
+void execute_one(Catalog& catalog, PlanCache& cache, const Workload& workload, Mode mode, size_t i,
+                 ResultSink& sink) {
+    switch (mode) {
+        case Mode::PARSE:
+            execute_sql(catalog, workload.sql[i], sink);
+            break;
+        case Mode::CACHED:
+            execute_cached(catalog, cache, workload.sql[i], sink);
+            break;
+        case Mode::PREPARED:
+            execute_parsed(catalog, workload.prepared[workload.shape[i]]->statement, sink, workload.literals[i]);
+            break;
+    }
+}
+
+} // namespace
+
+// 选项: --statements=N 语句条数（默认 200000），--shapes=N 语句形状数（默认 300），
+//       --threads=N 执行线程数（默认 1），--capacity=N 语句缓存容量（默认 PLAN_CACHE_CAPACITY，
+//       小于形状数时可以观察淘汰对命中率的影响）
+int run_plancache_bench(int argc, char* argv[]) {
+    long statements = 200000;
+    long shapes = 300;
+    long threads = 1;
+    long capacity = PLAN_CACHE_CAPACITY;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "statements", statements) && !bench_option(arg, "shapes", shapes) &&
+            !bench_option(arg, "threads", threads) && !bench_option(arg, "capacity", capacity)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    auto count = static_cast<size_t>(std::max(1L, statements));
+    auto shape_count = static_cast<size_t>(std::max(1L, shapes));
+    auto thread_count = static_cast<size_t>(std::max(1L, threads));
+
+    // 小表，执行代价很低，解析在每条语句的开销中占主要部分
+    Catalog catalog;
+    StringSink sink;
+    execute_sql(catalog, "CREATE TABLE t (id BIGINT, a BIGINT, b DOUBLE)", sink);
+    for (uint64_t id = 0; id < 256; ++id) {
+        uint64_t r = mix(id);
+        execute_sql(catalog, "INSERT INTO t VALUES (" + std::to_string(id) + ", " + std::to_string(r % 1000) + ", " +
+                                 std::to_string(static_cast<double>((r >> 16) % 4000) / 4.0) + ")",
+                    sink);
+    }
+
+    Workload workload;
+    workload.prepared.resize(shape_count);
+    std::string key;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t r = mix(i + 1000003);
+        size_t shape = (r >> 40) % shape_count;
+        workload.sql.push_back(make_statement(shape, r));
+        workload.shape.push_back(shape);
+        workload.literals.emplace_back();
+        normalize_statement(workload.sql.back(), key, workload.literals.back());
+        if (!workload.prepared[shape]) {
+            auto prepared = std::make_shared<PreparedStatement>();
+            prepared->statement = parse_statement(key, &prepared->parameters);
+            workload.prepared[shape] = std::move(prepared);
+        }
+    }
+
+    // 三种方式的结果必须一致
+    {
+        PlanCache cache(static_cast<size_t>(std::max(1L, capacity)));
+        for (size_t i = 0; i < std::min<size_t>(count, 2000); ++i) {
+            std::string expected;
+            for (Mode mode : {Mode::PARSE, Mode::CACHED, Mode::PREPARED}) {
+                sink.clear();
+                execute_one(catalog, cache, workload, mode, i, sink);
+                if (mode == Mode::PARSE) {
+                    expected = sink.text();
+                } else if (sink.text() != expected) {
+                    std::cerr << mode_name(mode) << " 的结果与完整解析不一致: " << workload.sql[i] << "\n"
+                              << sink.text() << "\n完整解析:\n" << expected << std::endl;
+                    return -1;
+                }
+            }
+        }
+    }
+
+    std::cout << "语句缓存基准测试: " << count << " 条语句, " << shape_count << " 种形状, " << thread_count
+              << " 个线程, 缓存容量 " << capacity << std::endl;
+    printf("%-10s %12s %10s %10s %10s\n", "mode", "stmts/s", "us/stmt", "hit rate", "evictions");
+    for (Mode mode : {Mode::PARSE, Mode::CACHED, Mode::PREPARED}) {
+        PlanCache cache(static_cast<size_t>(std::max(1L, capacity)));
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < thread_count; ++t) {
+            workers.emplace_back([&, t]() {
+                StringSink local;
+                for (size_t i = count * t / thread_count; i < count * (t + 1) / thread_count; ++i) {
+                    local.clear();
+                    execute_one(catalog, cache, workload, mode, i, local);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double seconds = seconds_since(begin);
+        PlanCacheStats stats = cache.stats();
+        double per_second = static_cast<double>(count) / seconds;
+        if (mode == Mode::CACHED) {
+            printf("%-10s %12.0f %10.2f %9.1f%% %10llu\n", mode_name(mode), per_second,
+                   1e6 * static_cast<double>(thread_count) / per_second, stats.hitRatio() * 100,
+                   static_cast<unsigned long long>(stats.evictions));
+        } else {
+            printf("%-10s %12.0f %10.2f %10s %10s\n", mode_name(mode), per_second,
+                   1e6 * static_cast<double>(thread_count) / per_second, "-", "-");
+        }
+    }
+    return 0;
+}
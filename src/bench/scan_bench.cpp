@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "sql/executor.h"
+#include "storage/catalog.h"
+
+namespace {
+
+// 行存基线：同样的数据按行连续存放（64 字节一行）
+struct Row {
+    int64_t id;
+    int64_t a;
+    double b;
+    int64_t c;
+    char code[16];
+    StringRef name;
+};
+
+// 丢弃结果的输出
+class NullSink : public ResultSink {
+public:
+    void write(std::string_view text) override { bytes += text.size(); }
+    size_t bytes = 0;
+};
+
+struct ScanTiming {
+    const char* name;
+    double column_seconds;
+    double row_seconds;
+    size_t column_bytes_per_row;   // 列存每行实际读取的字节数
+};
+
+template<typename Fn>
+double best_of(int rounds, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, seconds_since(start));
+    }
+    return best;
+}
+
+// 防止结果被优化掉
+volatile double scan_sink;
+
+} // namespace
+
+// 选项: --rows=N 行数（默认 10000000），--rounds=N 重复次数（取最快一次）
+int run_scan_bench(int argc, char* argv[]) {
+    long rows = 10000000;
+    long rounds = 3;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "rows", rows) && !bench_option(arg, "rounds", rounds)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    auto row_count = static_cast<size_t>(std::max(1L, rows));
+    int repeat = static_cast<int>(std::max(1L, rounds));
+
+    Catalog catalog;
+    Table* table = catalog.createTable("t", {
+        {"id", ColumnType::INT64, 0},
+        {"a", ColumnType::INT64, 0},
+        {"b", ColumnType::DOUBLE, 0},
+        {"c", ColumnType::INT64, 0},
+        {"code", ColumnType::CHAR, 16},
+        {"name", ColumnType::VARCHAR, 0},
+    });
+
+    // 生成相同的数据分别写入列存表与行存数组
+    std::vector<Row> row_store(row_count);
+    std::mt19937_64 rng(7);
+    const char* names[] = {"alpha", "beta", "gamma", "delta"};
+    {
+        std::lock_guard<std::mutex> lock(table->latch());
+        MvccManager::Commit commit(catalog.mvcc());
+        for (size_t i = 0; i < row_count; ++i) {
+            Row& row = row_store[i];
+            row.id = static_cast<int64_t>(i);
+            row.a = static_cast<int64_t>(rng() % 1000);
+            row.b = static_cast<double>(rng() % 100000) / 100.0;
+            row.c = static_cast<int64_t>(rng() % 1000000);
+            memset(row.code, 0, sizeof(row.code));
+            memcpy(row.code, "CODE", 4);
+
+            Value values[6];
+            values[0].integer = row.id;
+            values[1].integer = row.a;
+            values[2].real = row.b;
+            values[3].integer = row.c;
+            values[4].text = "CODE";
+            values[5].text = names[i % 4];
+            table->appendRow(values, commit.ts());
+            row.name = StringRef{names[i % 4], static_cast<uint32_t>(strlen(names[i % 4]))};
+        }
+    }
+
+    const TableData& data = table->data();
+    const Column& col_a = data.column(1);
+    const Column& col_b = data.column(2);
+    const Column& col_c = data.column(3);
+    size_t chunks = col_a.chunkCount();
+    auto chunk_rows = [&](size_t k) { return std::min<size_t>(CHUNK_ROWS, row_count - k * CHUNK_ROWS); };
+
+    std::vector<ScanTiming> timings;
+
+    // Q1: COUNT(*) WHERE a < 100
+    timings.push_back({"count where a<100",
+        best_of(repeat, [&]() {
+            size_t count = 0;
+            for (size_t k = 0; k < chunks; ++k) {
+                const int64_t* a = col_a.values<int64_t>(k);
+                size_t n = chunk_rows(k);
+                for (size_t i = 0; i < n; ++i) {
+                    count += a[i] < 100 ? 1u : 0u;
+                }
+            }
+            scan_sink = static_cast<double>(count);
+        }),
+        best_of(repeat, [&]() {
+            size_t count = 0;
+            for (const Row& row : row_store) {
+                count += row.a < 100 ? 1u : 0u;
+            }
+            scan_sink = static_cast<double>(count);
+        }),
+        sizeof(int64_t)});
+
+    // Q2: SUM(b) WHERE a < 500
+    timings.push_back({"sum(b) where a<500",
+        best_of(repeat, [&]() {
+            double sum = 0;
+            for (size_t k = 0; k < chunks; ++k) {
+                const int64_t* a = col_a.values<int64_t>(k);
+                const double* b = col_b.values<double>(k);
+                size_t n = chunk_rows(k);
+                for (size_t i = 0; i < n; ++i) {
+                    sum += a[i] < 500 ? b[i] : 0.0;
+                }
+            }
+            scan_sink = sum;
+        }),
+        best_of(repeat, [&]() {
+            double sum = 0;
+            for (const Row& row : row_store) {
+                sum += row.a < 500 ? row.b : 0.0;
+            }
+            scan_sink = sum;
+        }),
+        sizeof(int64_t) + sizeof(double)});
+
+    // Q3: SUM(b) WHERE a < 100 AND c > 500000
+    timings.push_back({"sum(b) where a<100 and c>500000",
+        best_of(repeat, [&]() {
+            double sum = 0;
+            for (size_t k = 0; k < chunks; ++k) {
+                const int64_t* a = col_a.values<int64_t>(k);
+                const double* b = col_b.values<double>(k);
+                const int64_t* c = col_c.values<int64_t>(k);
+                size_t n = chunk_rows(k);
+                for (size_t i = 0; i < n; ++i) {
+                    sum += (a[i] < 100 && c[i] > 500000) ? b[i] : 0.0;
+                }
+            }
+            scan_sink = sum;
+        }),
+        best_of(repeat, [&]() {
+            double sum = 0;
+            for (const Row& row : row_store) {
+                sum += (row.a < 100 && row.c > 500000) ? row.b : 0.0;
+            }
+            scan_sink = sum;
+        }),
+        sizeof(int64_t) * 2 + sizeof(double)});
+
+    std::cout << "列存扫描基准测试: " << row_count << " 行, 列存 "
+              << table->bytes() / (1 << 20) << " MB, 行存 "
+              << row_count * sizeof(Row) / (1 << 20) << " MB" << std::endl;
+    printf("%-34s %14s %12s %14s %12s %8s\n", "query", "column(Mrow/s)", "column(GB/s)",
+           "row(Mrow/s)", "row(GB/s)", "speedup");
+    double n = static_cast<double>(row_count);
+    for (const auto& t : timings) {
+        printf("%-34s %14.1f %12.2f %14.1f %12.2f %7.1fx\n", t.name,
+               n / t.column_seconds / 1e6,
+               n * static_cast<double>(t.column_bytes_per_row) / t.column_seconds / 1e9,
+               n / t.row_seconds / 1e6,
+               n * static_cast<double>(sizeof(Row)) / t.row_seconds / 1e9,
+               t.row_seconds / t.column_seconds);
+    }
+
+    // 经过 SQL 解析与执行器的完整路径（结果为空，只测扫描与过滤）
+    NullSink sink;
+    double sql_seconds = best_of(repeat, [&]() {
+        execute_sql(catalog, "SELECT id FROM t WHERE a < 0 AND c > 0;", sink);
+    });
+    printf("%-34s %14.1f\n", "sql: select where a<0 and c>0", n / sql_seconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "sql/tokenizer.h"
+
+namespace {
+
+// 生成多语句脚本：混合插入、查询、注释、含转义引号与分号的字符串
+std::string make_script(size_t target_bytes) {
+    std::mt19937 rng(42);
+    const char* words[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"};
+    auto word = [&]() { return words[rng() % 8]; };
+
+    std::string script;
+    script.reserve(target_bytes + 1024);
+    while (script.size() < target_bytes) {
+        switch (rng() % 4) {
+            case 0: {
+                // 长字符串体：SIMD 扫描的主要收益来源
+                std::string text;
+                size_t words_in_text = 8 + rng() % 64;
+                for (size_t i = 0; i < words_in_text; ++i) {
+                    text += word();
+                    text += (i % 16 == 15) ? "; " : " ";
+                }
+                script += "INSERT INTO articles VALUES (" + std::to_string(rng() % 100000) +
+                          ", 'O''Brien said: " + text + "', \"tag\"\"" + word() + "\");\n";
+                break;
+            }
+            case 1:
+                script += "SELECT id, name, price * 1.08 FROM items WHERE name = '" +
+                          std::string(word()) + "' AND price >= " + std::to_string(rng() % 1000) +
+                          " ORDER BY id;\n";
+                break;
+            case 2:
+                script += "-- 注释中的分号; 与 'quote 不影响切分\n"
+                          "UPDATE accounts SET balance = balance - 10 WHERE id = " +
+                          std::to_string(rng() % 5000) + ";\n";
+                break;
+            default:
+                script += "INSERT INTO t (a, b, c) VALUES (" + std::to_string(rng()) + ", " +
+                          std::to_string(rng() % 100) + ".5, '" + word() + "');\n";
+                break;
+        }
+    }
+    return script;
+}
+
+struct ScanResult {
+    size_t statements = 0;
+    size_t tokens = 0;
+    double split_seconds = 0;
+    double token_seconds = 0;
+};
+
+ScanResult run_isa(ScanIsa isa, const std::string& script, int rounds) {
+    ScanResult result;
+    result.split_seconds = 1e30;
+    result.token_seconds = 1e30;
+
+    for (int r = 0; r < rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        StatementSplitter splitter(script, isa);
+        std::string_view statement;
+        size_t statements = 0;
+        while (splitter.next(statement)) {
+            ++statements;
+        }
+        result.split_seconds = std::min(result.split_seconds, seconds_since(start));
+        result.statements = statements;
+
+        start = std::chrono::steady_clock::now();
+        SqlTokenizer tokenizer(script, isa);
+        size_t tokens = 0;
+        while (tokenizer.next().type != TokenType::END) {
+            ++tokens;
+        }
+        result.token_seconds = std::min(result.token_seconds, seconds_since(start));
+        result.tokens = tokens;
+    }
+    return result;
+}
+
+} // namespace
+
+// 选项: --size-mb=N 脚本大小（默认 64），--rounds=N 每种实现的重复次数（取最快一次）
+int run_tokenizer_bench(int argc, char* argv[]) {
+    long size_mb = 64;
+    long rounds = 3;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!bench_option(arg, "size-mb", size_mb) && !bench_option(arg, "rounds", rounds)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::string script = make_script(static_cast<size_t>(std::max(1L, size_mb)) << 20);
+    double mb = static_cast<double>(script.size()) / (1 << 20);
+    std::cout << "SQL 词法分析基准测试: 脚本 " << script.size() << " 字节" << std::endl;
+    printf("%-8s %12s %14s %12s %14s\n", "isa", "statements", "split(MB/s)", "tokens", "tokenize(MB/s)");
+
+    ScanResult baseline;
+    bool have_baseline = false;
+    for (ScanIsa isa : {ScanIsa::SCALAR, ScanIsa::SSE42, ScanIsa::AVX2}) {
+        if (!scan_isa_supported(isa)) {
+            printf("%-8s %12s\n", scan_isa_name(isa), "不支持");
+            continue;
+        }
+        ScanResult result = run_isa(isa, script, static_cast<int>(std::max(1L, rounds)));
+        printf("%-8s %12zu %14.1f %12zu %14.1f\n", scan_isa_name(isa), result.statements,
+               mb / result.split_seconds, result.tokens, mb / result.token_seconds);
+
+        // 各实现的切分与词法结果必须一致
+        if (!have_baseline) {
+            baseline = result;
+            have_baseline = true;
+        } else if (result.statements != baseline.statements || result.tokens != baseline.tokens) {
+            std::cerr << scan_isa_name(isa) << " 的结果与标量实现不一致" << std::endl;
+            return -1;
+        }
+    }
+    return 0;
+}
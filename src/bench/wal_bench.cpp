@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+#include "bench/bench.h"
+#include "storage/wal.h"
+
+namespace {
+
+void remove_directory(const std::string& path) {
+    if (DIR* dir = opendir(path.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                unlink((path + "/" + entry->d_name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path.c_str());
+}
+
+struct WalRound {
+    double commits_per_second;
+    double records_per_sync;
+    uint64_t p50_us;
+    uint64_t p99_us;
+};
+
+// clients 个线程在 duration_ms 内不断提交 record_bytes 字节的记录，每次提交都等待持久化
+WalRound run_round(WalOptions options, int clients, long duration_ms, size_t record_bytes) {
+    auto wal = std::make_unique<WriteAheadLog>(options, [](uint8_t, std::string_view) {});
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::vector<std::vector<uint32_t>> latencies(static_cast<size_t>(clients));
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c]() {
+            std::string record(record_bytes, static_cast<char>('a' + c % 26));
+            auto& samples = latencies[static_cast<size_t>(c)];
+            samples.reserve(1 << 16);
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto begin = std::chrono::steady_clock::now();
+                wal->commit(1, record);
+                samples.push_back(static_cast<uint32_t>(seconds_since(begin) * 1e6));
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = seconds_since(begin);
+    WalStats stats = wal->stats();
+    wal.reset();
+
+    std::vector<uint32_t> all;
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    WalRound round{};
+    round.commits_per_second = static_cast<double>(stats.records) / seconds;
+    round.records_per_sync = stats.syncs ? static_cast<double>(stats.records) / static_cast<double>(stats.syncs) : 0;
+    if (!all.empty()) {
+        round.p50_us = all[all.size() / 2];
+        round.p99_us = all[all.size() * 99 / 100];
+    }
+    return round;
+}
+
+} // namespace
+
+// 选项: --dir=PATH 日志目录（默认在 /tmp 下新建临时目录，应指向待测的磁盘），
+//       --ms=N 每轮时长（默认 2000），--record-bytes=N 记录大小（默认 128），
+//       --delay-us=N 组提交的等待时间（默认 0）
+int run_wal_bench(int argc, char* argv[]) {
+    std::string base;
+    long duration_ms = 2000;
+    long record_bytes = 128;
+    long delay_us = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--dir=")) {
+            base = arg.substr(strlen("--dir="));
+        } else if (!bench_option(arg, "ms", duration_ms) && !bench_option(arg, "record-bytes", record_bytes) &&
+                   !bench_option(arg, "delay-us", delay_us)) {
+            std::cerr << "未知选项: " << arg << std::endl;
+            return -1;
+        }
+    }
+    bool temporary = base.empty();
+    if (temporary) {
+        char pattern[] = "/tmp/simpledb-wal-XXXXXX";
+        if (!mkdtemp(pattern)) {
+            std::cerr << "无法创建临时目录: " << strerror(errno) << std::endl;
+            return -1;
+        }
+        base = pattern;
+    }
+
+    std::cout << "预写日志基准测试: 目录 " << base << ", 记录 " << record_bytes << " 字节, 每轮 "
+              << duration_ms << " ms, 组提交等待 " << delay_us << " us" << std::endl;
+    printf("%-16s %8s %14s %14s %10s %10s\n", "mode", "clients", "commits/s", "records/sync",
+           "p50(us)", "p99(us)");
+
+    int round_id = 0;
+    for (WalSyncMode mode : {WalSyncMode::EACH, WalSyncMode::GROUP}) {
+        for (int clients : {1, 8, 64}) {
+            WalOptions options;
+            options.directory = base + "/round-" + std::to_string(round_id++);
+            options.sync = mode;
+            options.group_delay_us = static_cast<uint32_t>(std::max(0L, delay_us));
+            try {
+                WalRound round = run_round(options, clients, std::max(1L, duration_ms),
+                                           static_cast<size_t>(std::max(0L, record_bytes)));
+                printf("%-16s %8d %14.0f %14.1f %10llu %10llu\n",
+                       mode == WalSyncMode::EACH ? "fsync per commit" : "group commit", clients,
+                       round.commits_per_second, round.records_per_sync,
+                       static_cast<unsigned long long>(round.p50_us),
+                       static_cast<unsigned long long>(round.p99_us));
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                remove_directory(options.directory);
+                return -1;
+            }
+            remove_directory(options.directory);
+        }
+    }
+    if (temporary) {
+        rmdir(base.c_str());
+    }
+    return 0;
+}
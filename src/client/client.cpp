@@ -1,126 +1,577 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <cstring>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
+#include <strings.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <readline/readline.h>
 #include <readline/history.h>
+#include "client/simpledb_client.h"
+#include "client/client_bench.h"
 
-#define PORT 8123
-#define BUFFER_SIZE 1024
+#define COPY_WINDOW 8       // COPY 时已发送、尚未应答的数据块上限
 
-extern "C" {
-    #include "client.h"
-    extern int yylex();
-    extern void* yy_scan_string(const char* s);
-    extern void yy_delete_buffer(void* b);
+// 命令行客户端：交互模式逐行读入，批处理模式执行脚本；收发与语句切分都由 libsimpledb_client 完成
+static ClientConnection* connection = nullptr;
+
+// 打印服务器应答
+static void print_response(const ClientResponse& response) {
+    if (response.ok()) {
+        std::cout << "服务器回显: " << response.payload << std::endl;
+    } else {
+        std::cout << "服务器错误: " << response.payload << std::endl;
+    }
 }
 
-int sock = 0;
-char buffer[BUFFER_SIZE] = {0};
-enum ScannerState scanner_state = STATE_INITIAL;
+// 发送一帧并等待应答；连接断开时返回 false
+static bool request(FrameType type, std::string_view payload, ClientResponse& response) {
+    response = connection->send(type, payload).get();
+    if (response.disconnected) {
+        std::cerr << "服务器连接已断开" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-void send_to_server() {
-    if (sql_pos > 0) {
-        std::cout << "已发送消息: " << sql_buffer << std::endl;
-        send(sock, sql_buffer, sql_pos, 0);
-        add_history(sql_buffer);
-        reset_sql_buffer();
+// 发送一帧并打印服务器应答
+static bool request(FrameType type, std::string_view payload) {
+    ClientResponse response;
+    if (!request(type, payload, response)) {
+        return false;
+    }
+    print_response(response);
+    return true;
+}
 
-        // 接收服务器回显
-        memset(buffer, 0, BUFFER_SIZE);
-        auto valread = read(sock, buffer, BUFFER_SIZE);
-        
-        if (valread <= 0) {
-            std::cerr << "服务器连接已断开" << std::endl;
-            return;
+// 批处理模式的统计，由连接的读取线程在应答回调中更新，排空之后主线程读取
+struct BatchStats {
+    bool quiet = false;
+    uint64_t statements = 0;
+    uint64_t errors = 0;
+    std::vector<double> latencies;      // 从提交到收到应答的微秒数
+};
+
+// 批处理模式时不为空
+static BatchStats* batch = nullptr;
+
+// 交互模式发送一帧并打印应答；批处理模式只把请求追加到连接的发送缓冲区（攒批写出），
+// 应答在读取线程上按顺序打印。脚本中前后依赖的语句（建表、插入、更新、查询）可以放心流水线发送：
+// 服务器按到达顺序逐条执行同一连接上的语句，结果与逐条等待应答时相同
+static bool submit(FrameType type, std::string_view payload) {
+    if (!batch) {
+        return request(type, payload);
+    }
+    auto sent = std::chrono::steady_clock::now();
+    connection->send(type, payload, [sent](ClientResponse& response) {
+        batch->latencies.push_back(
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+        ++batch->statements;
+        if (response.disconnected) {
+            ++batch->errors;
+        } else if (!response.ok()) {
+            ++batch->errors;
+            std::cout << "第 " << batch->statements << " 条语句出错: " << response.payload << std::endl;
+        } else if (!batch->quiet) {
+            print_response(response);
         }
-        
-        std::cout << "服务器回显: " << buffer << std::endl;
+    }, false);
+    return true;
+}
+
+// 本连接上准备好的语句：名称 -> 服务器返回的句柄
+static std::unordered_map<std::string, uint32_t> prepared_statements;
+
+// text 是否以关键字 word 开头（大小写不敏感，其后为空白），是则去掉关键字与其后的空白
+static bool consume_word(std::string_view& text, std::string_view word) {
+    if (text.size() <= word.size() || !isspace(static_cast<unsigned char>(text[word.size()])) ||
+        strncasecmp(text.data(), word.data(), word.size()) != 0) {
+        return false;
+    }
+    text.remove_prefix(word.size());
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    return true;
+}
+
+// 取出开头的名称（到空白、括号或分号为止）
+static std::string take_name(std::string_view& text) {
+    size_t end = 0;
+    while (end < text.size() && !isspace(static_cast<unsigned char>(text[end])) && text[end] != '(' &&
+           text[end] != ';') {
+        ++end;
+    }
+    std::string name(text.substr(0, end));
+    text.remove_prefix(end);
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    return name;
+}
+
+// PREPARE 名称 AS 语句：语句中用 ? 或 $n 表示参数，服务器解析一次后返回句柄
+static bool prepare_statement(std::string_view text) {
+    std::string name = take_name(text);
+    if (name.empty() || !consume_word(text, "as")) {
+        std::cout << "用法: PREPARE 名称 AS 语句;" << std::endl;
+        return true;
+    }
+    ClientResponse response;
+    if (!request(FrameType::PREPARE, text, response)) {
+        return false;
+    }
+    if (response.type != FrameType::PREPARED || response.payload.size() != 6) {
+        std::cout << "服务器错误: " << response.payload << std::endl;
+        return true;
+    }
+    uint32_t handle = protocol::getU32(response.payload.data());
+    prepared_statements[name] = handle;
+    std::cout << "已准备语句 " << name << "（句柄 " << handle << "，" << protocol::getU16(response.payload.data() + 4)
+              << " 个参数）" << std::endl;
+    return true;
+}
+
+// 解析 EXECUTE 的参数列表 (值, ...)：整数、浮点数或单引号字符串（'' 为转义的引号）
+static bool parse_parameters(std::string_view text, std::string& payload, uint16_t& count) {
+    count = 0;
+    if (text.empty() || text.front() == ';') {
+        return true;
+    }
+    if (text.front() != '(') {
+        return false;
+    }
+    size_t pos = 1;
+    auto skip_space = [&]() {
+        while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    };
+    skip_space();
+    if (pos < text.size() && text[pos] == ')') {
+        return true;
+    }
+    while (pos < text.size()) {
+        skip_space();
+        if (pos < text.size() && text[pos] == '\'') {
+            std::string value;
+            for (++pos; pos < text.size(); ++pos) {
+                if (text[pos] == '\'') {
+                    if (pos + 1 < text.size() && text[pos + 1] == '\'') {
+                        ++pos;
+                    } else {
+                        break;
+                    }
+                }
+                value += text[pos];
+            }
+            if (pos >= text.size()) {
+                return false;
+            }
+            ++pos;
+            protocol::appendParam(payload, std::string_view(value));
+        } else {
+            size_t begin = pos;
+            while (pos < text.size() && (isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '.' ||
+                                         text[pos] == '-' || text[pos] == '+')) {
+                ++pos;
+            }
+            std::string_view number = text.substr(begin, pos - begin);
+            const char* first = number.data() + (number.starts_with('+') ? 1 : 0);
+            const char* last = number.data() + number.size();
+            std::from_chars_result result{};
+            if (number.find_first_of(".eE") != std::string_view::npos) {
+                double value = 0;
+                result = std::from_chars(first, last, value);
+                protocol::appendParam(payload, value);
+            } else {
+                int64_t value = 0;
+                result = std::from_chars(first, last, value);
+                protocol::appendParam(payload, value);
+            }
+            if (number.empty() || result.ec != std::errc() || result.ptr != last) {
+                return false;
+            }
+        }
+        ++count;
+        skip_space();
+        if (pos < text.size() && text[pos] == ')') {
+            return true;
+        }
+        if (pos >= text.size() || text[pos] != ',') {
+            return false;
+        }
+        ++pos;
+    }
+    return false;
+}
+
+// EXECUTE 名称 (参数, ...)：按句柄执行，请求中只有参数
+static bool execute_prepared(std::string_view text) {
+    std::string name = take_name(text);
+    auto it = prepared_statements.find(name);
+    if (it == prepared_statements.end()) {
+        if (batch) {
+            connection->drain();    // 保持输出顺序
+        }
+        std::cout << "未准备的语句: " << name << std::endl;
+        return true;
+    }
+    std::string parameters;
+    uint16_t count = 0;
+    if (!parse_parameters(text, parameters, count)) {
+        if (batch) {
+            connection->drain();
+        }
+        std::cout << "用法: EXECUTE 名称 (值, ...);  值为整数、浮点数或单引号字符串" << std::endl;
+        return true;
+    }
+    std::string payload;
+    protocol::beginExecute(payload, it->second, count);
+    payload += parameters;
+    return submit(FrameType::EXECUTE, payload);
+}
+
+// data 中最后一个完整记录的结束位置（引号之外的最后一个换行之后），没有完整记录时返回 0
+// 引号成对出现，换行之前的引号个数为偶数时换行在引号之外
+static size_t last_record_end(std::string_view data) {
+    auto quotes = static_cast<size_t>(std::count(data.begin(), data.end(), '"'));
+    for (size_t pos = data.size(); pos > 0; --pos) {
+        if (data[pos - 1] == '"') {
+            --quotes;
+        } else if (data[pos - 1] == '\n' && quotes % 2 == 0) {
+            return pos;
+        }
+    }
+    return 0;
+}
+
+// 等待最早的 COPY 数据块的应答：累加导入的行数，出错时记下第一条错误；连接断开时返回 false
+static bool receive_copied(std::deque<std::future<ClientResponse>>& in_flight, uint64_t& rows, std::string& error) {
+    ClientResponse response = in_flight.front().get();
+    in_flight.pop_front();
+    if (response.disconnected) {
+        return false;
+    }
+    if (response.type == FrameType::COPIED && response.payload.size() == 8) {
+        rows += protocol::getU64(response.payload.data());
+    } else if (error.empty()) {
+        error = response.payload.empty() ? "未知错误" : response.payload;
+    }
+    return true;
+}
+
+// COPY 表名 FROM '文件' [HEADER]：把 CSV 文件按记录边界切成 COPY_CHUNK_SIZE 左右的数据块流水线发送，
+// 最多 COPY_WINDOW 块未应答；服务器并行解析后直接写入列存储。每块各自提交，出错时停止发送，
+// 之前的数据块已经导入
+static bool copy_from_file(std::string_view text) {
+    std::string table = take_name(text);
+    std::string path;
+    bool quoted = consume_word(text, "from") && !text.empty() && text.front() == '\'';
+    if (quoted) {
+        size_t pos = 1;
+        for (; pos < text.size(); ++pos) {
+            if (text[pos] == '\'') {
+                if (pos + 1 < text.size() && text[pos + 1] == '\'') {
+                    ++pos;
+                } else {
+                    break;
+                }
+            }
+            path += text[pos];
+        }
+        quoted = pos < text.size();
+        text.remove_prefix(std::min(text.size(), pos + 1));
+    }
+    while (!text.empty() && (isspace(static_cast<unsigned char>(text.back())) || text.back() == ';')) {
+        text.remove_suffix(1);
+    }
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    bool header_line = text.size() == 6 && strncasecmp(text.data(), "header", 6) == 0;
+    if (table.empty() || !quoted || path.empty() || (!text.empty() && !header_line)) {
+        std::cout << "用法: COPY 表名 FROM '文件.csv' [HEADER];" << std::endl;
+        return true;
+    }
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "无法打开文件 " << path << ": " << strerror(errno) << std::endl;
+        return true;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    uint64_t line = 1;              // 下一个数据块的起始行号
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    std::deque<std::future<ClientResponse>> in_flight;
+    std::string error;
+    std::string block;
+    std::string payload;
+    bool connected = true;
+    bool skip_header = header_line;
+    while (connected && error.empty()) {
+        size_t old = block.size();
+        block.resize(old + COPY_CHUNK_SIZE);
+        ssize_t n = read(fd, block.data() + old, COPY_CHUNK_SIZE);
+        if (n < 0) {
+            error = std::string("读取文件失败: ") + strerror(errno);
+            break;
+        }
+        block.resize(old + static_cast<size_t>(n));
+        bool eof = n == 0;
+        if (skip_header) {
+            size_t newline = block.find('\n');
+            if (newline == std::string::npos && !eof) {
+                continue;
+            }
+            block.erase(0, newline == std::string::npos ? block.size() : newline + 1);
+            line = 2;
+            skip_header = false;
+        }
+        size_t end = eof ? block.size() : last_record_end(block);
+        if (end == 0 && !eof) {
+            if (block.size() + 1024 > MAX_FRAME_PAYLOAD) {
+                error = "第 " + std::to_string(line) + " 行起的记录超过帧大小上限";
+            }
+            continue;
+        }
+        if (end > 0) {
+            std::string_view records(block.data(), end);
+            payload.clear();
+            protocol::beginCopy(payload, line, table);
+            payload.append(records);
+            in_flight.push_back(connection->send(FrameType::COPY, payload));
+            bytes += end;
+            line += static_cast<uint64_t>(std::count(records.begin(), records.end(), '\n'));
+            block.erase(0, end);
+        }
+        if (eof) {
+            break;
+        }
+        if (in_flight.size() >= COPY_WINDOW) {
+            connected = receive_copied(in_flight, rows, error);
+        }
+    }
+    close(fd);
+    while (connected && !in_flight.empty()) {
+        connected = receive_copied(in_flight, rows, error);
+    }
+    if (!connected) {
+        std::cerr << "服务器连接已断开" << std::endl;
+        return false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (!error.empty()) {
+        std::cout << "导入失败: " << error << "（之前的数据块已导入 " << rows << " 行）" << std::endl;
+        return true;
     }
+    char rate[96];
+    snprintf(rate, sizeof(rate), "%.1f MB, %.2f 秒, %.1f MB/s", static_cast<double>(bytes) / 1e6, seconds,
+             static_cast<double>(bytes) / 1e6 / std::max(seconds, 1e-9));
+    std::cout << "已导入 " << rows << " 行 (" << rate << ")" << std::endl;
+    return true;
 }
 
-void process_input(std::string& input) {
-    if (input.empty()) {
+// 扫描器得到一条完整的语句
+static void handle_statement(std::string_view statement) {
+    if (!batch) {
+        std::string line(statement);
+        std::cout << "已发送消息: " << line << std::endl;
+        add_history(line.c_str());
+    } else if (!connection->connected()) {
         return;
     }
-    
-    // 构造带终止换行的临时字符串（readline 返回的不包含 '\n'）
-    std::string tmp = input + "\n";
 
-    void* buf = yy_scan_string(tmp.c_str());
-    yylex();
-    yy_delete_buffer(buf);
+    // 预备语句由客户端转换为 PREPARE / EXECUTE 帧，其余语句原样发送。
+    // 批处理模式下 PREPARE 与 COPY 等之前的应答都打印完再同步执行：PREPARE 需要拿到句柄才能发出之后的
+    // EXECUTE，COPY 的数据块在服务器上并行导入，由 copy_from_file 自己控制窗口
+    std::string_view text = statement;
+    if (consume_word(text, "prepare")) {
+        if (!batch || connection->drain()) {
+            prepare_statement(text);
+        }
+    } else if (consume_word(text, "execute")) {
+        execute_prepared(text);
+    } else if (consume_word(text, "copy")) {
+        if (!batch || connection->drain()) {
+            copy_from_file(text);
+        }
+    } else {
+        // 接收服务器回显
+        submit(FrameType::QUERY, statement);
+    }
 }
 
-int main() {
-    struct sockaddr_in serv_addr;
-    
-    // 创建socket
-    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
-        std::cerr << "Socket创建失败" << std::endl;
-        return -1;
+// 打印批处理的吞吐与延迟分位数
+static void print_batch_report(BatchStats& stats, size_t window, double seconds) {
+    std::sort(stats.latencies.begin(), stats.latencies.end());
+    auto percentile = [&stats](double p) {
+        if (stats.latencies.empty()) {
+            return 0.0;
+        }
+        return stats.latencies[static_cast<size_t>(p * static_cast<double>(stats.latencies.size() - 1) + 0.5)];
+    };
+    char line[256];
+    snprintf(line, sizeof(line), "流水线 %llu 条语句（窗口 %zu）, %.2f 秒, %.0f 条/秒, 出错 %llu 条",
+             static_cast<unsigned long long>(stats.statements), window, seconds,
+             static_cast<double>(stats.statements) / std::max(seconds, 1e-9),
+             static_cast<unsigned long long>(stats.errors));
+    std::cout << line << std::endl;
+    snprintf(line, sizeof(line), "延迟 (us): p50 %.0f | p90 %.0f | p99 %.0f | p99.9 %.0f | 最大 %.0f",
+             percentile(0.5), percentile(0.9), percentile(0.99), percentile(0.999),
+             stats.latencies.empty() ? 0.0 : stats.latencies.back());
+    std::cout << line << std::endl;
+}
+
+// 批处理模式：把脚本文件（path 为 "-" 时为标准输入）整个交给扫描器，按大块读入；
+// 语句攒批写出，最多 window 条未应答。连接断开或有语句出错时返回 false
+static bool run_script(SqlSplitter& splitter, const char* path, size_t window, bool quiet) {
+    FILE* file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!file) {
+        std::cerr << "无法打开脚本 " << path << ": " << strerror(errno) << std::endl;
+        return false;
     }
-    
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port = htons(PORT);
-    
-    // 转换IP地址
-    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
-        std::cerr << "无效地址/地址不支持" << std::endl;
-        return -1;
+    BatchStats stats;
+    stats.quiet = quiet;
+    batch = &stats;
+    auto begin = std::chrono::steady_clock::now();
+    splitter.feedFile(file);
+    if (file != stdin) {
+        fclose(file);
     }
-    
-    // 连接服务器
-    if (connect(sock, reinterpret_cast<sockaddr*>(&serv_addr), sizeof(serv_addr)) < 0) {
-        std::cerr << "连接服务器失败" << std::endl;
+    if (!splitter.pending().empty()) {
+        std::cerr << "忽略脚本末尾没有以分号结束的语句: " << splitter.pending() << std::endl;
+        splitter.reset();
+    }
+    bool connected = connection->drain();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    batch = nullptr;
+    print_batch_report(stats, window, seconds);
+    return connected && stats.errors == 0;
+}
+
+static void print_usage(const char* program) {
+    std::cout << "用法: " << program << " [选项]\n"
+              << "  --host=HOST     服务器地址（默认 127.0.0.1）\n"
+              << "  --port=N        服务器端口（默认 " << CLIENT_DEFAULT_PORT << "）\n"
+              << "  -f FILE         批处理模式：执行脚本中以分号结束的语句后退出，FILE 为 - 时读标准输入\n"
+              << "                  （标准输入不是终端时默认如此）\n"
+              << "  --window=N      批处理模式已发送、尚未应答的语句上限（默认 " << CLIENT_DEFAULT_WINDOW << "）\n"
+              << "  --quiet         批处理模式只打印出错的语句与最后的统计\n"
+              << "  --bench         对服务器运行客户端库（连接池）吞吐基准测试后退出\n"
+              << "  --bench-threads=N   基准测试的应用线程数（默认 64）\n"
+              << "  --bench-requests=N  基准测试每个线程的请求数（默认 2000）\n"
+              << "  --bench-pool=N      基准测试连接池的连接数（默认 4）\n"
+              << "  --bench-depth=N     基准测试异步模式每个线程未应答的请求数（默认 16）\n";
+}
+
+int main(int argc, char* argv[]) {
+    ClientOptions options;
+    const char* script = nullptr;
+    bool quiet = false;
+    bool bench = false;
+    ClientBenchOptions bench_options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-f" && i + 1 < argc) {
+            script = argv[++i];
+        } else if (arg.starts_with("--host=")) {
+            options.host = arg.substr(strlen("--host="));
+        } else if (arg.starts_with("--port=")) {
+            options.port = static_cast<uint16_t>(atoi(arg.c_str() + strlen("--port=")));
+        } else if (arg.starts_with("--window=")) {
+            options.window = static_cast<size_t>(std::max(1, atoi(arg.c_str() + strlen("--window="))));
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "--bench") {
+            bench = true;
+        } else if (arg.starts_with("--bench-threads=")) {
+            bench_options.threads = atoi(arg.c_str() + strlen("--bench-threads="));
+        } else if (arg.starts_with("--bench-requests=")) {
+            bench_options.requests = atoi(arg.c_str() + strlen("--bench-requests="));
+        } else if (arg.starts_with("--bench-pool=")) {
+            bench_options.pool_connections = atoi(arg.c_str() + strlen("--bench-pool="));
+        } else if (arg.starts_with("--bench-depth=")) {
+            bench_options.depth = atoi(arg.c_str() + strlen("--bench-depth="));
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+    if (bench) {
+        options.name = "bench";
+        return run_client_benchmark(options, bench_options);
+    }
+    if (!script && !isatty(STDIN_FILENO)) {
+        script = "-";
+    }
+
+    // 连接服务器并发送客户端名称
+    const char* user = getenv("USER");
+    options.name = user ? user : "client";
+    std::unique_ptr<ClientConnection> client;
+    try {
+        client = std::make_unique<ClientConnection>(options);
+    } catch (const ClientError& e) {
+        std::cerr << e.what() << std::endl;
         std::cerr << "请确保服务器已启动" << std::endl;
         return -1;
     }
-    
+    connection = client.get();
+    std::cout << "服务器回显: " << client->welcome() << std::endl;
+
+    SqlSplitter splitter(handle_statement);
+    if (script) {
+        return run_script(splitter, script, options.window, quiet) ? 0 : 1;
+    }
+
     std::cout << "已连接到服务器！" << std::endl;
     std::cout << "输入消息发送给服务器，输入 'quit' 或 'exit' 退出" << std::endl;
     std::cout << "==========================================" << std::endl;
     
     // 持续发送和接收消息
-    while (true) {
+    while (client->connected()) {
         const char* prompt = "SQL> ";
-        if (scanner_state == STATE_SINGLE) {
+        if (splitter.state() == STATE_SINGLE) {
             prompt = "SQL>' ";
-        } else if (scanner_state == STATE_DOUBLE) {
+        } else if (splitter.state() == STATE_DOUBLE) {
             prompt = "SQL>\" ";
         }
 
-        // 获取用户输入
+        // 获取用户输入，输入结束（Ctrl-D）时与 quit 相同
         char* line = readline(prompt);
-        std::string message = std::string(line);
+        std::string message = line ? std::string(line) : "quit";
         free(line);
         
         // 检查退出指令
         if (message == "quit" || message == "exit") {
-            send(sock, message.c_str(), message.length(), 0);
+            request(FrameType::QUERY, message);
             std::cout << "正在断开连接..." << std::endl;
             break;
         }
 
-        // 处理输入
-        process_input(message);
+        // 处理输入（readline 返回的不包含 '\n'）
+        if (!message.empty()) {
+            splitter.feed(message + "\n");
+        }
     }
     
-    // 关闭socket
-    close(sock);
+    // 断开连接
+    client.reset();
     std::cout << "连接已关闭" << std::endl;
     
     return 0;
 }
-
-// flex需要的其他函数
-extern "C" int yywrap() {
-    return 1; // 表示输入结束
-}
-
-extern "C" void yyerror(const char* s) {
-    fprintf(stderr, "解析错误: %s\n", s);
-}
\ No newline at end of file
@@ -1,16 +0,0 @@
-#ifndef CLIENT_H
-#define CLIENT_H
-
-enum ScannerState {
-    STATE_INITIAL,
-    STATE_SINGLE,
-    STATE_DOUBLE,
-    STATE_COMMENT
-};
-extern enum ScannerState scanner_state;
-extern char sql_buffer[];
-extern size_t sql_pos;
-extern void send_to_server();
-extern void reset_sql_buffer();
-
-#endif // CLIENT_H
\ No newline at end of file
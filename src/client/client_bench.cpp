@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <semaphore>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "client/client_bench.h"
+
+namespace {
+
+// 压测请求：非 SQL 消息走服务器的回显路径，一定成功，测的是客户端库与 I/O 路径而不是执行器
+constexpr std::string_view BENCH_MESSAGE = "ping";
+
+// 所有线程准备好后同时开始压测
+struct StartGate {
+    std::atomic<int> arrived{0};
+    std::atomic<bool> open{false};
+
+    void arrive() { arrived.fetch_add(1); }
+    void wait() const {
+        while (!open.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// 单个应用线程的统计：只记录得到成功应答的请求的延迟
+struct ThreadStats {
+    std::vector<uint64_t> latencies_ns;
+    uint64_t failed = 0;            // 服务器返回错误或连接断开的请求数
+};
+
+// 一轮测试的结果
+struct RoundResult {
+    double seconds = 0;
+    uint64_t requests = 0;          // 客户端发送的请求数
+    uint64_t writes = 0;            // 客户端写套接字的次数
+    uint64_t failed = 0;
+    std::vector<uint64_t> latencies_ns;
+};
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+double percentile_us(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[idx]) / 1000.0;
+}
+
+// 同步：提交一条后等待应答再提交下一条；own 为空时每条请求从连接池中取连接
+// 连接断开后剩余的请求都计为失败
+void sync_client(ClientConnection* own, ClientPool* pool, int requests, StartGate& gate, ThreadStats& stats) {
+    stats.latencies_ns.reserve(static_cast<size_t>(requests));
+    gate.arrive();
+    gate.wait();
+    for (int i = 0; i < requests; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        ClientResponse response;
+        try {
+            ClientConnection& connection = own ? *own : pool->connection();
+            response = connection.send(FrameType::QUERY, BENCH_MESSAGE).get();
+        } catch (const ClientError&) {
+            response.disconnected = true;
+        }
+        if (response.disconnected) {
+            stats.failed += static_cast<uint64_t>(requests - i);
+            return;
+        }
+        if (!response.ok()) {
+            ++stats.failed;
+            continue;
+        }
+        stats.latencies_ns.push_back(elapsed_ns(start));
+    }
+}
+
+// 异步：最多 depth 条未应答的请求，应答回调在连接的读取线程上记录延迟
+void async_client(ClientPool& pool, int requests, int depth, StartGate& gate, ThreadStats& stats) {
+    // 失败的请求不记延迟，槽位保持为 0，结束后剔除
+    std::vector<uint64_t> slots_ns(static_cast<size_t>(requests), 0);
+    std::atomic<uint64_t> failed{0};
+    std::counting_semaphore<> slots(depth);
+    gate.arrive();
+    gate.wait();
+    for (int i = 0; i < requests; ++i) {
+        slots.acquire();
+        auto start = std::chrono::steady_clock::now();
+        uint64_t* slot = &slots_ns[static_cast<size_t>(i)];
+        try {
+            pool.connection().send(FrameType::QUERY, BENCH_MESSAGE,
+                                   [start, slot, &slots, &failed](ClientResponse& response) {
+                if (response.ok()) {
+                    *slot = elapsed_ns(start);
+                } else {
+                    failed.fetch_add(1, std::memory_order_relaxed);
+                }
+                slots.release();
+            });
+        } catch (const ClientError&) {
+            // 连接池中的连接都已断开
+            failed.fetch_add(static_cast<uint64_t>(requests - i), std::memory_order_relaxed);
+            slots.release();
+            break;
+        }
+    }
+    for (int i = 0; i < depth; ++i) {
+        slots.acquire();
+    }
+    std::erase(slots_ns, 0);
+    stats.latencies_ns = std::move(slots_ns);
+    stats.failed = failed.load();
+}
+
+// 运行一轮测试：mode 为 blocking、sync 或 async
+bool run_round(const char* mode, const ClientOptions& server, const ClientBenchOptions& options,
+               RoundResult& result) {
+    bool blocking = std::string_view(mode) == "blocking";
+    std::vector<std::unique_ptr<ClientConnection>> own;
+    std::unique_ptr<ClientPool> pool;
+    try {
+        if (blocking) {
+            for (int i = 0; i < options.threads; ++i) {
+                own.push_back(std::make_unique<ClientConnection>(server));
+            }
+        } else {
+            ClientOptions pool_options = server;
+            pool_options.connections = static_cast<size_t>(options.pool_connections);
+            pool = std::make_unique<ClientPool>(pool_options);
+        }
+    } catch (const ClientError& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+
+    std::vector<ClientConnection*> connections;
+    for (auto& connection : own) {
+        connections.push_back(connection.get());
+    }
+    for (size_t i = 0; pool && i < pool->size(); ++i) {
+        connections.push_back(&pool->connection(i));
+    }
+
+    std::vector<ThreadStats> per_thread(static_cast<size_t>(options.threads));
+    StartGate gate;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < per_thread.size(); ++i) {
+        if (blocking) {
+            threads.emplace_back(sync_client, own[i].get(), nullptr, options.requests, std::ref(gate),
+                                 std::ref(per_thread[i]));
+        } else if (std::string_view(mode) == "sync") {
+            threads.emplace_back(sync_client, nullptr, pool.get(), options.requests, std::ref(gate),
+                                 std::ref(per_thread[i]));
+        } else {
+            threads.emplace_back(async_client, std::ref(*pool), options.requests, options.depth,
+                                 std::ref(gate), std::ref(per_thread[i]));
+        }
+    }
+    while (gate.arrived.load() < options.threads) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    uint64_t requests_before = 0;
+    uint64_t writes_before = 0;
+    for (ClientConnection* connection : connections) {
+        requests_before += connection->requestCount();
+        writes_before += connection->writeCount();
+    }
+    auto start = std::chrono::steady_clock::now();
+    gate.open.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (ClientConnection* connection : connections) {
+        result.requests += connection->requestCount();
+        result.writes += connection->writeCount();
+    }
+    result.requests -= requests_before;
+    result.writes -= writes_before;
+
+    for (auto& stats : per_thread) {
+        result.latencies_ns.insert(result.latencies_ns.end(), stats.latencies_ns.begin(),
+                                   stats.latencies_ns.end());
+        result.failed += stats.failed;
+    }
+    return true;
+}
+
+void print_round(const char* mode, int connections, RoundResult& result) {
+    std::sort(result.latencies_ns.begin(), result.latencies_ns.end());
+    char per_write[32] = "-";
+    if (result.writes > 0) {
+        snprintf(per_write, sizeof(per_write), "%.2f",
+                 static_cast<double>(result.requests) / static_cast<double>(result.writes));
+    }
+    printf("%-10s %6d %12.0f %10.2f %10.2f %10s %8llu\n", mode, connections,
+           static_cast<double>(result.latencies_ns.size()) / result.seconds,
+           percentile_us(result.latencies_ns, 0.50), percentile_us(result.latencies_ns, 0.99),
+           per_write, static_cast<unsigned long long>(result.failed));
+}
+
+} // namespace
+
+int run_client_benchmark(const ClientOptions& server, const ClientBenchOptions& input) {
+    ClientBenchOptions options = input;
+    options.threads = std::max(1, options.threads);
+    options.requests = std::max(1, options.requests);
+    options.pool_connections = std::max(1, options.pool_connections);
+    options.depth = std::max(1, options.depth);
+
+    std::cout << "客户端库基准测试 (" << server.host << ":" << server.port << "): " << options.threads
+              << " 个应用线程 × " << options.requests << " 条请求, 连接池 " << options.pool_connections
+              << " 个连接, 异步每线程 " << options.depth << " 条未应答" << std::endl;
+    printf("%-10s %6s %12s %10s %10s %10s %8s\n", "mode", "conns", "req/s", "p50(us)", "p99(us)",
+           "req/write", "failed");
+
+    uint64_t failed = 0;
+    // 每个线程独占一个连接逐条往返：应用自己管理连接时的基线
+    RoundResult blocking;
+    if (!run_round("blocking", server, options, blocking)) {
+        return -1;
+    }
+    print_round("blocking", options.threads, blocking);
+    failed += blocking.failed;
+    // 所有线程共享连接池，各自等待应答：多个线程的请求在同一连接上合并写出
+    RoundResult sync;
+    if (run_round("sync", server, options, sync)) {
+        print_round("pool-sync", options.pool_connections, sync);
+        failed += sync.failed;
+    }
+    // 共享连接池，每个线程保持多条未应答的请求
+    RoundResult async;
+    if (run_round("async", server, options, async)) {
+        print_round("pool-async", options.pool_connections, async);
+        failed += async.failed;
+    }
+    return failed == 0 ? 0 : 1;
+}
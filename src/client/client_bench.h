@@ -0,0 +1,19 @@
+#ifndef CLIENT_BENCH_H
+#define CLIENT_BENCH_H
+
+#include "client/simpledb_client.h"
+
+// 客户端库基准测试参数
+struct ClientBenchOptions {
+    int threads = 64;               // 应用线程数
+    int requests = 2000;            // 每个线程的请求数
+    int pool_connections = 4;       // 连接池的连接数
+    int depth = 16;                 // 异步测试中每个线程未应答的请求数
+};
+
+// 客户端库吞吐测试（client --bench）：连接 server 指定的服务器，
+// 多个应用线程每线程一个连接逐条往返，对比共享 ClientPool 的同步与异步提交，
+// 输出 QPS、p50/p99 延迟、客户端每次写合并的请求数与未得到成功应答的请求数
+int run_client_benchmark(const ClientOptions& server, const ClientBenchOptions& options);
+
+#endif // CLIENT_BENCH_H
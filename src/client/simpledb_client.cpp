@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include "client/simpledb_client.h"
+
+namespace {
+
+// 写出全部数据，处理部分写；连接断开时不产生 SIGPIPE
+bool write_full(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        auto sent = ::send(fd, data, len, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        len -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// 连接 host:port，失败时抛出 ClientError
+int connect_to(const std::string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    std::string service = std::to_string(port);
+    int rc = getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses);
+    if (rc != 0) {
+        throw ClientError("无法解析服务器地址 " + host + ": " + gai_strerror(rc));
+    }
+    int fd = -1;
+    int error = 0;
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd >= 0 && connect(fd, address->ai_addr, address->ai_addrlen) < 0) {
+            error = errno;
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+        throw ClientError("连接服务器 " + host + ":" + service + " 失败: " + strerror(error));
+    }
+    // 请求由发送缓冲区合并写出，关闭 Nagle 算法以免最后一批等待对方的延迟确认
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+ClientResponse disconnected_response() {
+    ClientResponse response;
+    response.payload = "服务器连接已断开";
+    response.disconnected = true;
+    return response;
+}
+
+} // namespace
+
+SqlSplitter::SqlSplitter(Callback callback) : callback_(std::move(callback)) {
+    scanner_.on_statement = &SqlSplitter::onStatement;
+    scanner_.context = this;
+    if (sqlscanlex_init_extra(&scanner_, &lexer_) != 0) {
+        throw std::bad_alloc();
+    }
+}
+
+SqlSplitter::~SqlSplitter() {
+    sqlscanlex_destroy(lexer_);
+    free(scanner_.sql);
+}
+
+void SqlSplitter::feed(std::string_view text) {
+    while (!text.empty()) {
+        size_t size = std::min<size_t>(text.size(), INT_MAX / 2);
+        void* buffer = sqlscan_scan_bytes(text.data(), static_cast<int>(size), lexer_);
+        sqlscanlex(lexer_);
+        sqlscan_delete_buffer(buffer, lexer_);
+        text.remove_prefix(size);
+    }
+}
+
+void SqlSplitter::feedFile(FILE* file) {
+    void* buffer = sqlscan_create_buffer(file, SQL_SCANNER_BUFFER, lexer_);
+    sqlscan_switch_to_buffer(buffer, lexer_);
+    sqlscanlex(lexer_);
+    sqlscan_delete_buffer(buffer, lexer_);
+}
+
+void SqlSplitter::onStatement(void* context, const char* sql, size_t size) {
+    static_cast<SqlSplitter*>(context)->callback_(std::string_view(sql, size));
+}
+
+ClientConnection::ClientConnection(const ClientOptions& options)
+    : fd_(connect_to(options.host, options.port)), window_(std::max<size_t>(1, options.window)) {
+    // 握手在启动读取线程之前同步完成
+    std::string frame;
+    protocol::appendFrame(frame, FrameType::HELLO, next_request_id_++, options.name);
+    FrameHeader header{};
+    if (!write_full(fd_, frame.data(), frame.size()) || !receive(header, welcome_)) {
+        close(fd_);
+        throw ClientError("与服务器握手失败");
+    }
+    if (header.type == FrameType::ERROR) {
+        close(fd_);
+        throw ClientError(welcome_);
+    }
+    reader_ = std::thread(&ClientConnection::readerLoop, this);
+}
+
+ClientConnection::~ClientConnection() {
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    reader_cv_.notify_all();
+    reader_.join();
+    close(fd_);
+}
+
+void ClientConnection::send(FrameType type, std::string_view payload, ClientCallback callback, bool flush) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (connected_ && pending_.size() >= window_) {
+        // 窗口满时先写出自己攒下的请求，否则它们的应答永远不会到来
+        if (!out_.empty() && !writing_) {
+            flushLocked(lock);
+        } else {
+            space_cv_.wait(lock);
+        }
+    }
+    if (!connected_) {
+        lock.unlock();
+        ClientResponse response = disconnected_response();
+        callback(response);
+        return;
+    }
+    // 已有写出的请求在等待应答时，读取线程收到应答后会写出本请求
+    bool answer_pending = pending_.size() > buffered_;
+    uint32_t request_id = next_request_id_++;
+    protocol::appendFrame(out_, type, request_id, payload);
+    pending_.push_back(Pending{request_id, std::move(callback)});
+    ++buffered_;
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    if (pending_.size() == 1) {
+        reader_cv_.notify_one();
+    }
+    // 正在写的线程写完本次后会接着写出新追加的请求
+    if (((flush && !answer_pending) || out_.size() >= CLIENT_FLUSH_BYTES) && !writing_) {
+        flushLocked(lock);
+    }
+}
+
+std::future<ClientResponse> ClientConnection::send(FrameType type, std::string_view payload, bool flush) {
+    auto promise = std::make_shared<std::promise<ClientResponse>>();
+    std::future<ClientResponse> future = promise->get_future();
+    send(type, payload, [promise](ClientResponse& response) { promise->set_value(std::move(response)); }, flush);
+    return future;
+}
+
+std::future<std::string> ClientConnection::query(std::string_view sql, bool flush) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    send(FrameType::QUERY, sql, [promise](ClientResponse& response) {
+        if (response.ok()) {
+            promise->set_value(std::move(response.payload));
+        } else {
+            promise->set_exception(std::make_exception_ptr(ClientError(response.payload)));
+        }
+    }, flush);
+    return future;
+}
+
+void ClientConnection::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!out_.empty() && !writing_) {
+        flushLocked(lock);
+    }
+}
+
+bool ClientConnection::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!out_.empty() && !writing_) {
+        flushLocked(lock);
+    }
+    space_cv_.wait(lock, [this] { return pending_.empty(); });
+    return connected_;
+}
+
+bool ClientConnection::connected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connected_;
+}
+
+size_t ClientConnection::inFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+// 调用方持有锁且没有其他线程在写：不持锁写出发送缓冲区，期间其他线程追加的请求在下一轮写出
+void ClientConnection::flushLocked(std::unique_lock<std::mutex>& lock) {
+    writing_ = true;
+    std::string batch;
+    while (!out_.empty() && connected_) {
+        batch.swap(out_);
+        buffered_ = 0;
+        lock.unlock();
+        bool written = write_full(fd_, batch.data(), batch.size());
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        batch.clear();
+        lock.lock();
+        if (!written) {
+            fail(lock);
+        }
+    }
+    // 留下较大的一块作为下一轮的发送缓冲区，稳态下追加请求不分配内存
+    if (batch.capacity() > out_.capacity() && out_.empty()) {
+        out_.swap(batch);
+    }
+    writing_ = false;
+}
+
+// 连接出错：之后的请求立即失败，读取线程把未应答的请求都以断开的应答结束
+void ClientConnection::fail(std::unique_lock<std::mutex>&) {
+    if (connected_) {
+        connected_ = false;
+        out_.clear();
+        buffered_ = 0;
+        shutdown(fd_, SHUT_RDWR);
+    }
+    reader_cv_.notify_all();
+    space_cv_.notify_all();
+}
+
+// 读取一帧，负载存入 payload；数据按 CLIENT_READ_CHUNK 大块读入，一次可能读到多条应答
+bool ClientConnection::receive(FrameHeader& header, std::string& payload) {
+    auto fill = [this]() {
+        if (in_pos_ > 0) {
+            in_.erase(0, in_pos_);
+            in_pos_ = 0;
+        }
+        size_t old = in_.size();
+        in_.resize(old + CLIENT_READ_CHUNK);
+        ssize_t n;
+        do {
+            n = read(fd_, in_.data() + old, CLIENT_READ_CHUNK);
+        } while (n < 0 && errno == EINTR);
+        in_.resize(old + static_cast<size_t>(std::max<ssize_t>(n, 0)));
+        return n > 0;
+    };
+    while (in_.size() - in_pos_ < FRAME_HEADER_SIZE) {
+        if (!fill()) {
+            return false;
+        }
+    }
+    header = protocol::decodeHeader(in_.data() + in_pos_);
+    if (header.length > MAX_FRAME_PAYLOAD) {
+        return false;
+    }
+    while (in_.size() - in_pos_ < FRAME_HEADER_SIZE + header.length) {
+        if (!fill()) {
+            return false;
+        }
+    }
+    payload.assign(in_.data() + in_pos_ + FRAME_HEADER_SIZE, header.length);
+    in_pos_ += FRAME_HEADER_SIZE + header.length;
+    return true;
+}
+
+// 读取线程：只在有等待应答的请求时读套接字，按发送顺序把应答交给各请求，
+// 每条应答之后写出等待期间攒下的请求。
+// 请求在回调返回之后才从 pending_ 中移除，drain() 返回时所有回调都已执行完
+void ClientConnection::readerLoop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            reader_cv_.wait(lock, [this] { return !pending_.empty() || stop_ || !connected_; });
+            if (pending_.empty() && connected_) {
+                return;
+            }
+        }
+        FrameHeader header{};
+        ClientResponse response;
+        bool received = connected() && receive(header, response.payload);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!received || header.request_id != pending_.front().request_id) {
+            // 连接断开或应答与请求对不上，之后的应答都不可信。断开之后不会再追加请求
+            fail(lock);
+            std::vector<ClientCallback> callbacks;
+            for (Pending& pending : pending_) {
+                callbacks.push_back(std::move(pending.callback));
+            }
+            lock.unlock();
+            for (ClientCallback& callback : callbacks) {
+                ClientResponse error = disconnected_response();
+                callback(error);
+            }
+            lock.lock();
+            pending_.clear();
+            lock.unlock();
+            space_cv_.notify_all();
+            return;
+        }
+        // 只有读取线程移除 pending_ 的元素，其他线程只在尾部追加，front() 在回调期间不变
+        ClientCallback callback = std::move(pending_.front().callback);
+        lock.unlock();
+        response.type = header.type;
+        callback(response);
+        lock.lock();
+        pending_.pop_front();
+        // 空出一个位置只放行一个提交者；全部应答时唤醒 drain() 与所有等待者
+        if (pending_.empty()) {
+            space_cv_.notify_all();
+        } else {
+            space_cv_.notify_one();
+        }
+        if (!out_.empty() && !writing_) {
+            flushLocked(lock);
+        }
+    }
+}
+
+ClientPool::ClientPool(const ClientOptions& options) {
+    for (size_t i = 0; i < std::max<size_t>(1, options.connections); ++i) {
+        connections_.push_back(std::make_unique<ClientConnection>(options));
+    }
+}
+
+ClientConnection& ClientPool::connection() {
+    size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < connections_.size(); ++i) {
+        ClientConnection& candidate = *connections_[(start + i) % connections_.size()];
+        if (candidate.connected()) {
+            return candidate;
+        }
+    }
+    throw ClientError("连接池中的连接都已断开");
+}
+
+std::future<std::string> ClientPool::query(std::string_view sql) {
+    return connection().query(sql);
+}
+
+void ClientPool::query(std::string_view sql, ClientCallback callback) {
+    connection().send(FrameType::QUERY, sql, std::move(callback));
+}
+
+bool ClientPool::drain() {
+    bool ok = true;
+    for (auto& connection : connections_) {
+        ok = connection->drain() && ok;
+    }
+    return ok;
+}
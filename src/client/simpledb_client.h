@@ -0,0 +1,196 @@
+#ifndef SIMPLEDB_CLIENT_H
+#define SIMPLEDB_CLIENT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "protocol/protocol.h"
+#include "client/sql_scanner.h"
+
+// 嵌入应用程序的客户端库（libsimpledb_client）：语句切分、单个连接上的流水线请求与连接池
+
+#define CLIENT_DEFAULT_PORT 8123
+#define CLIENT_DEFAULT_WINDOW 64                // 每个连接默认的已发送、尚未应答的请求上限
+#define CLIENT_FLUSH_BYTES (64 * 1024)          // 攒下的请求达到这么多字节时立即写出
+#define CLIENT_READ_CHUNK (64 * 1024)           // 读取线程每次从套接字读取的字节数
+
+// 连接失败、连接断开或服务器返回错误
+class ClientError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+struct ClientOptions {
+    std::string host = "127.0.0.1";
+    uint16_t port = CLIENT_DEFAULT_PORT;
+    std::string name = "client";                // HELLO 帧中的客户端名称
+    size_t window = CLIENT_DEFAULT_WINDOW;
+    size_t connections = 4;                     // 连接池的连接数
+};
+
+// 一条请求的应答；连接断开时 type 为 ERROR，disconnected 为 true
+struct ClientResponse {
+    FrameType type = FrameType::ERROR;
+    std::string payload;
+    bool disconnected = false;
+
+    bool ok() const { return type != FrameType::ERROR; }
+};
+
+// 应答回调，在连接的读取线程上按发送顺序调用，不应长时间阻塞；
+// 回调中不能等待同一连接上的应答（窗口满时在同一连接上提交也会等待），否则读取线程自己等自己
+using ClientCallback = std::function<void(ClientResponse&)>;
+
+// 按 SQL 语法把输入切分成以分号结束的语句，引号与 -- 注释中的分号不算（flex 扫描器，见 sql_scanner.l）。
+// 输入可以分多次给出，未结束的语句保留到下一次；每个对象有独立的扫描器，不同线程可以各用一个
+class SqlSplitter {
+public:
+    using Callback = std::function<void(std::string_view)>;
+
+    explicit SqlSplitter(Callback callback);
+    ~SqlSplitter();
+
+    SqlSplitter(const SqlSplitter&) = delete;
+    SqlSplitter& operator=(const SqlSplitter&) = delete;
+
+    // 扫描一段输入，每得到一条完整的语句（含分号）调用一次回调。
+    // 分段处应在行尾，否则跨段的 -- 不会被识别为注释
+    void feed(std::string_view text);
+
+    // 扫描整个文件，按 SQL_SCANNER_BUFFER 大小的块读入
+    void feedFile(FILE* file);
+
+    // 当前是否在字符串或注释之中（交互模式据此显示续行提示符）
+    ScannerState state() const { return scanner_.state; }
+
+    // 还没有以分号结束的部分
+    std::string_view pending() const { return std::string_view(scanner_.sql ? scanner_.sql : "", scanner_.sql_size); }
+
+    // 丢弃未结束的语句
+    void reset() { scanner_.sql_size = 0; }
+
+private:
+    SqlScanner scanner_{};
+    void* lexer_ = nullptr;
+    Callback callback_;
+
+    static void onStatement(void* context, const char* sql, size_t size);
+};
+
+// 到服务器的一个连接，可以被多个线程同时使用。
+// 请求帧先追加到发送缓冲区：没有线程在写套接字时由提交者写出，正在写时由写出者在本次 write() 之后
+// 连同期间追加的其他请求一起写出；已有写出而未应答的请求时新请求先留在缓冲区，由读取线程收到应答后
+// 一起写出（前一条执行完之前服务器不会开始执行它，提前写出也不会更早执行）。
+// 所以多个线程同时提交的小请求自动合并为一次写入。
+// 读取线程按发送顺序接收应答并核对 request_id，再交给各请求的回调或 future。
+// 已发送未应答的请求达到 window 时提交者等待。
+// 服务器按到达顺序逐条执行同一连接上的语句，后一条看得到前一条的结果；
+// 唯一的例外是连续的 COPY 数据块，它们之间可能并行导入，但不会越过前后的其他语句
+class ClientConnection {
+public:
+    // 连接并完成 HELLO 握手，失败时抛出 ClientError
+    explicit ClientConnection(const ClientOptions& options);
+    // 写出并等待全部应答后断开
+    ~ClientConnection();
+
+    ClientConnection(const ClientConnection&) = delete;
+    ClientConnection& operator=(const ClientConnection&) = delete;
+
+    // 发送一帧，应答交给 callback；连接已断开时立即以断开的应答调用 callback。
+    // flush 为 false 时请求留在发送缓冲区，直到缓冲区达到 CLIENT_FLUSH_BYTES、窗口满、收到应答或调用 flush()，
+    // 供单个线程成批提交
+    void send(FrameType type, std::string_view payload, ClientCallback callback, bool flush = true);
+    std::future<ClientResponse> send(FrameType type, std::string_view payload, bool flush = true);
+
+    // 执行一条语句，返回结果文本；服务器报错或连接断开时 future 抛出 ClientError
+    std::future<std::string> query(std::string_view sql, bool flush = true);
+
+    // 写出发送缓冲区中的请求（不等待应答）
+    void flush();
+
+    // 写出并等待全部应答，连接已断开时返回 false
+    bool drain();
+
+    bool connected() const;
+    size_t inFlight() const;
+
+    // 服务器对 HELLO 的应答
+    const std::string& welcome() const { return welcome_; }
+
+    // 累计发送的请求数与写套接字的次数，二者之比反映合并写入的效果
+    uint64_t requestCount() const { return requests_.load(std::memory_order_relaxed); }
+    uint64_t writeCount() const { return writes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Pending {
+        uint32_t request_id;
+        ClientCallback callback;
+    };
+
+    int fd_ = -1;
+    size_t window_;
+    std::string welcome_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable space_cv_;      // 窗口有空位、全部应答或连接断开
+    std::condition_variable reader_cv_;     // 有等待应答的请求或停止
+    std::string out_;                       // 发送缓冲区
+    std::deque<Pending> pending_;           // 已追加、尚未应答的请求，按发送顺序
+    size_t buffered_ = 0;                   // 其中还在发送缓冲区、未交给写出者的请求数
+    uint32_t next_request_id_ = 1;
+    bool writing_ = false;                  // 有线程正在写套接字
+    bool connected_ = true;
+    bool stop_ = false;
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> writes_{0};
+
+    std::thread reader_;
+    std::string in_;                        // 以下只有读取线程访问：已读入未解析的数据
+    size_t in_pos_ = 0;
+
+    void flushLocked(std::unique_lock<std::mutex>& lock);
+    bool receive(FrameHeader& header, std::string& payload);
+    void fail(std::unique_lock<std::mutex>& lock);
+    void readerLoop();
+};
+
+// 连接池：options.connections 个 ClientConnection，语句轮流分给仍连接着的连接，可以被任意多个线程同时使用。
+// 不同连接上的语句之间没有先后顺序，有依赖的语句应通过 connection() 取一个连接，都在它上面提交
+// （同一连接上按提交顺序执行，见 ClientConnection）
+class ClientPool {
+public:
+    // 建立全部连接，任何一个失败时抛出 ClientError
+    explicit ClientPool(const ClientOptions& options);
+
+    ClientPool(const ClientPool&) = delete;
+    ClientPool& operator=(const ClientPool&) = delete;
+
+    std::future<std::string> query(std::string_view sql);
+    void query(std::string_view sql, ClientCallback callback);
+
+    // 下一个仍连接着的连接，全部断开时抛出 ClientError
+    ClientConnection& connection();
+    ClientConnection& connection(size_t index) { return *connections_[index]; }
+    size_t size() const { return connections_.size(); }
+
+    // 等待所有连接上的请求全部应答，有连接已断开时返回 false
+    bool drain();
+
+private:
+    std::vector<std::unique_ptr<ClientConnection>> connections_;
+    std::atomic<size_t> next_{0};
+};
+
+#endif // SIMPLEDB_CLIENT_H
@@ -0,0 +1,46 @@
+#ifndef SQL_SCANNER_H
+#define SQL_SCANNER_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum ScannerState {
+    STATE_INITIAL,
+    STATE_SINGLE,
+    STATE_DOUBLE,
+    STATE_COMMENT
+};
+
+// 语句切分器的状态，作为 flex 可重入扫描器（sql_scanner.l）的 extra 数据，各扫描器互不影响。
+// 扫描到引号与注释之外的分号时，以完整的语句（含分号）调用 on_statement，之后清空 sql
+struct SqlScanner {
+    enum ScannerState state;
+    char* sql;              // 当前语句，malloc 分配，按需扩大，以 '\0' 结尾
+    size_t sql_size;
+    size_t sql_capacity;
+    void (*on_statement)(void* context, const char* sql, size_t size);
+    void* context;
+};
+
+#define SQL_SCANNER_BUFFER (1 << 20)    // 从文件扫描时的缓冲区大小，按块读入而不是逐行复制
+
+// flex 生成的入口（%option prefix="sqlscan"），生成的文件中有各自的声明
+#ifndef FLEX_SCANNER
+int sqlscanlex_init_extra(struct SqlScanner* extra, void** scanner);
+int sqlscanlex_destroy(void* scanner);
+int sqlscanlex(void* scanner);
+void* sqlscan_scan_bytes(const char* bytes, int size, void* scanner);
+void* sqlscan_create_buffer(FILE* file, int size, void* scanner);
+void sqlscan_switch_to_buffer(void* buffer, void* scanner);
+void sqlscan_delete_buffer(void* buffer, void* scanner);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SQL_SCANNER_H
@@ -0,0 +1,17 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+// 进程内 operator new 调用次数计数（替换了全局 operator new/delete）
+// 用于验证请求热路径上没有堆分配。每次分配多一次原子加，只在以 ENABLE_ALLOC_COUNTER 构建时编入，
+// 否则不替换 operator new，计数恒为 0
+#ifdef ENABLE_ALLOC_COUNTER
+inline constexpr bool allocation_counting = true;
+uint64_t allocation_count();
+#else
+inline constexpr bool allocation_counting = false;
+inline uint64_t allocation_count() { return 0; }
+#endif
+
+#endif // ALLOC_COUNTER_H
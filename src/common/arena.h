@@ -0,0 +1,103 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <utility>
+#include "common/buffer_pool.h"
+
+// 请求作用域的线性分配器
+// 内存块取自全局 BufferPool，reset() 时一次性归还；超过一个块大小的分配单独从堆上申请。
+// 只允许单线程分配，已分配的内存在 reset() 前地址不变，可以被其他线程读取。
+class Arena {
+public:
+    Arena() = default;
+    ~Arena() { reset(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        if (current_) {
+            if (void* p = bump(current_, size, align)) {
+                return p;
+            }
+        }
+        if (size + align > IO_BUFFER_SIZE) {
+            return allocateLarge(size, align);
+        }
+
+        IoBuffer* block = BufferPool::instance().acquire();
+        block->next = current_;
+        current_ = block;
+        void* p = bump(block, size, align);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    // 在 arena 中构造对象；对象不会被自动析构
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // 拷贝一段字符串到 arena
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        char* p = static_cast<char*>(allocate(text.size(), 1));
+        memcpy(p, text.data(), text.size());
+        return std::string_view(p, text.size());
+    }
+
+    // 释放全部内存
+    void reset() {
+        while (current_) {
+            IoBuffer* next = current_->next;
+            BufferPool::instance().release(current_);
+            current_ = next;
+        }
+        while (large_) {
+            LargeBlock* next = large_->next;
+            ::operator delete(large_, std::align_val_t{alignof(std::max_align_t)});
+            large_ = next;
+        }
+    }
+
+private:
+    struct LargeBlock {
+        LargeBlock* next;
+    };
+
+    IoBuffer* current_ = nullptr;   // 当前块，next 串起之前的块
+    LargeBlock* large_ = nullptr;
+
+    // 在块内按绝对地址对齐后分配，空间不足返回 nullptr
+    static void* bump(IoBuffer* block, size_t size, size_t align) {
+        auto base = reinterpret_cast<uintptr_t>(block->data);
+        uintptr_t p = (base + block->end + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+        size_t offset = static_cast<size_t>(p - base);
+        if (offset + size > IO_BUFFER_SIZE) {
+            return nullptr;
+        }
+        block->end = static_cast<uint32_t>(offset + size);
+        return block->data + offset;
+    }
+
+    void* allocateLarge(size_t size, size_t align) {
+        size_t header = (sizeof(LargeBlock) + align - 1) & ~(align - 1);
+        auto* block = static_cast<LargeBlock*>(
+            ::operator new(header + size, std::align_val_t{alignof(std::max_align_t)}));
+        block->next = large_;
+        large_ = block;
+        return reinterpret_cast<char*>(block) + header;
+    }
+};
+
+#endif // ARENA_H
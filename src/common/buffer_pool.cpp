@@ -0,0 +1,185 @@
+#include <cstring>
+#include <new>
+#include "common/buffer_pool.h"
+
+// 线程本地缓存，线程退出时归还到全局链表
+struct BufferCache {
+    IoBuffer* head = nullptr;
+    size_t count = 0;
+
+    ~BufferCache() {
+        if (head) {
+            IoBuffer* tail = head;
+            while (tail->next) {
+                tail = tail->next;
+            }
+            BufferPool::instance().giveBatch(head, tail, count);
+        }
+    }
+};
+
+static thread_local BufferCache local_cache;
+
+BufferPool& BufferPool::instance() {
+    static BufferPool pool;
+    return pool;
+}
+
+IoBuffer* BufferPool::takeBatch(size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    IoBuffer* head = nullptr;
+    for (size_t i = 0; i < n; ++i) {
+        IoBuffer* buffer = free_list_;
+        if (buffer) {
+            free_list_ = buffer->next;
+            --free_count_;
+        } else {
+            buffer = static_cast<IoBuffer*>(::operator new(sizeof(IoBuffer), std::align_val_t{64}));
+            ++allocated_;
+        }
+        buffer->next = head;
+        head = buffer;
+    }
+    return head;
+}
+
+void BufferPool::giveBatch(IoBuffer* head, IoBuffer* tail, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tail->next = free_list_;
+    free_list_ = head;
+    free_count_ += n;
+}
+
+IoBuffer* BufferPool::acquire() {
+    BufferCache& cache = local_cache;
+    if (!cache.head) {
+        cache.head = takeBatch(BUFFER_POOL_BATCH);
+        cache.count = BUFFER_POOL_BATCH;
+    }
+    IoBuffer* buffer = cache.head;
+    cache.head = buffer->next;
+    --cache.count;
+
+    buffer->next = nullptr;
+    buffer->begin = 0;
+    buffer->end = 0;
+    return buffer;
+}
+
+void BufferPool::release(IoBuffer* buffer) {
+    BufferCache& cache = local_cache;
+    buffer->next = cache.head;
+    cache.head = buffer;
+    ++cache.count;
+
+    // 本地缓存过多时把一批还给全局链表，供其他线程使用
+    if (cache.count >= 2 * BUFFER_POOL_BATCH) {
+        IoBuffer* head = cache.head;
+        IoBuffer* tail = head;
+        for (size_t i = 1; i < BUFFER_POOL_BATCH; ++i) {
+            tail = tail->next;
+        }
+        cache.head = tail->next;
+        cache.count -= BUFFER_POOL_BATCH;
+        giveBatch(head, tail, BUFFER_POOL_BATCH);
+    }
+}
+
+size_t BufferPool::allocated() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocated_;
+}
+
+void OutputChain::pushBuffer() {
+    IoBuffer* buffer = BufferPool::instance().acquire();
+    if (tail_) {
+        tail_->next = buffer;
+    } else {
+        head_ = buffer;
+    }
+    tail_ = buffer;
+}
+
+void OutputChain::append(const char* data, size_t len) {
+    while (len > 0) {
+        if (!tail_ || tail_->space() == 0) {
+            pushBuffer();
+        }
+        size_t n = std::min(len, tail_->space());
+        memcpy(tail_->data + tail_->end, data, n);
+        tail_->end += static_cast<uint32_t>(n);
+        bytes_ += n;
+        data += n;
+        len -= n;
+    }
+}
+
+char* OutputChain::reserve(size_t n) {
+    if (!tail_ || tail_->space() < n) {
+        pushBuffer();
+    }
+    char* p = tail_->data + tail_->end;
+    tail_->end += static_cast<uint32_t>(n);
+    bytes_ += n;
+    return p;
+}
+
+void OutputChain::splice(OutputChain& other) {
+    if (!other.head_) {
+        return;
+    }
+    if (tail_) {
+        tail_->next = other.head_;
+    } else {
+        head_ = other.head_;
+    }
+    tail_ = other.tail_;
+    bytes_ += other.bytes_;
+    other.head_ = other.tail_ = nullptr;
+    other.bytes_ = 0;
+}
+
+int OutputChain::fillIov(iovec* iov, int max_iov) const {
+    int count = 0;
+    for (IoBuffer* buffer = head_; buffer && count < max_iov; buffer = buffer->next) {
+        if (buffer->size() == 0) {
+            continue;
+        }
+        iov[count].iov_base = buffer->data + buffer->begin;
+        iov[count].iov_len = buffer->size();
+        ++count;
+    }
+    return count;
+}
+
+void OutputChain::consume(size_t n) {
+    bytes_ -= n;
+    while (head_ && n >= head_->size()) {
+        n -= head_->size();
+        IoBuffer* next = head_->next;
+        // 尾缓冲区可能还要继续追加，只有被完全消费且不是尾部时才归还
+        if (head_ == tail_) {
+            head_->begin = head_->end = 0;
+            break;
+        }
+        BufferPool::instance().release(head_);
+        head_ = next;
+    }
+    if (head_ && n > 0) {
+        head_->begin += static_cast<uint32_t>(n);
+    }
+    if (bytes_ == 0) {
+        clear();
+    }
+}
+
+void OutputChain::clear() {
+    IoBuffer* buffer = head_;
+    while (buffer) {
+        IoBuffer* next = buffer->next;
+        BufferPool::instance().release(buffer);
+        buffer = next;
+    }
+    head_ = tail_ = nullptr;
+    bytes_ = 0;
+}
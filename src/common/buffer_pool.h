@@ -0,0 +1,93 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <sys/uio.h>
+
+#define IO_BUFFER_SIZE 16384
+#define BUFFER_POOL_BATCH 32          // 线程本地缓存与全局空闲链表之间一次转移的个数
+
+// 固定大小的 I/O 缓冲区，[begin, end) 为有效数据
+struct IoBuffer {
+    IoBuffer* next;
+    uint32_t begin;
+    uint32_t end;
+    char data[IO_BUFFER_SIZE];
+
+    size_t size() const { return end - begin; }
+    size_t space() const { return IO_BUFFER_SIZE - end; }
+};
+
+// 全局 I/O 缓冲区池
+// 缓冲区按批从堆上分配后永不释放，在连接之间循环使用；每个线程有一个本地缓存，
+// 只有本地缓存空或溢出时才访问加锁的全局空闲链表，稳态下获取/归还都不调用 malloc
+class BufferPool {
+public:
+    static BufferPool& instance();
+
+    IoBuffer* acquire();
+    void release(IoBuffer* buffer);
+
+    // 已从堆上分配的缓冲区总数
+    size_t allocated() const;
+
+private:
+    friend struct BufferCache;
+
+    mutable std::mutex mutex_;
+    IoBuffer* free_list_ = nullptr;
+    size_t free_count_ = 0;
+    size_t allocated_ = 0;
+
+    BufferPool() = default;
+
+    // 从全局链表取最多 n 个缓冲区（不足时新分配），返回链表头
+    IoBuffer* takeBatch(size_t n);
+    // 把一串缓冲区归还到全局链表
+    void giveBatch(IoBuffer* head, IoBuffer* tail, size_t n);
+};
+
+// 由池中缓冲区串成的输出链，用于连接的发送缓冲与执行结果
+// 缓冲区地址固定，已提交给内核发送的数据不会因为继续追加而移动
+class OutputChain {
+public:
+    OutputChain() = default;
+    ~OutputChain() { clear(); }
+
+    OutputChain(const OutputChain&) = delete;
+    OutputChain& operator=(const OutputChain&) = delete;
+
+    bool empty() const { return bytes_ == 0; }
+    size_t size() const { return bytes_; }
+
+    // 追加数据
+    void append(const char* data, size_t len);
+    void append(std::string_view data) { append(data.data(), data.size()); }
+
+    // 预留 n 字节连续空间（n <= IO_BUFFER_SIZE），返回写入位置，之后可回填
+    char* reserve(size_t n);
+
+    // 把 other 的全部数据移到本链尾部（不拷贝）
+    void splice(OutputChain& other);
+
+    // 用待发送数据填充 iovec，返回使用的个数
+    int fillIov(iovec* iov, int max_iov) const;
+
+    // 丢弃头部 n 字节已发送的数据，归还用完的缓冲区
+    void consume(size_t n);
+
+    // 归还所有缓冲区
+    void clear();
+
+private:
+    IoBuffer* head_ = nullptr;
+    IoBuffer* tail_ = nullptr;
+    size_t bytes_ = 0;
+
+    void pushBuffer();
+};
+
+#endif // BUFFER_POOL_H
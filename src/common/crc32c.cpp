@@ -0,0 +1,66 @@
+#include <cstring>
+#include "common/crc32c.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32C_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+struct Crc32cTable {
+    uint32_t entries[256];
+
+    constexpr Crc32cTable() : entries() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+constexpr Crc32cTable CRC32C_TABLE;
+
+uint32_t crc32c_scalar(uint32_t crc, const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = CRC32C_TABLE.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef CRC32C_X86
+
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t crc, const unsigned char* data, size_t size) {
+    uint64_t value = crc;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        value = _mm_crc32_u64(value, word);
+    }
+    auto result = static_cast<uint32_t>(value);
+    for (; i < size; ++i) {
+        result = _mm_crc32_u8(result, data[i]);
+    }
+    return result;
+}
+
+#endif // CRC32C_X86
+
+} // namespace
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef CRC32C_X86
+    static const bool hardware = __builtin_cpu_supports("sse4.2");
+    if (hardware) {
+        return ~crc32c_sse42(crc, bytes, size);
+    }
+#endif
+    return ~crc32c_scalar(crc, bytes, size);
+}
@@ -0,0 +1,11 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32C（Castagnoli），用于日志记录与快照校验
+// 支持 SSE4.2 时使用 CRC32 指令，否则查表计算；crc 为上一段的结果，首段传 0
+uint32_t crc32c(uint32_t crc, const void* data, size_t size);
+
+#endif // CRC32C_H
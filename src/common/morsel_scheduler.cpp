@@ -0,0 +1,240 @@
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include "common/morsel_scheduler.h"
+
+namespace {
+
+cpu_set_t allowed_cpus() {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) != 0) {
+        unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < count && i < CPU_SETSIZE; ++i) {
+            CPU_SET(i, &cpus);
+        }
+    }
+    return cpus;
+}
+
+// 解析 "0-3,8,10-11" 形式的 CPU 列表，只保留 allowed 中的 CPU
+std::vector<int> parse_cpu_list(const std::string& text, const cpu_set_t& allowed) {
+    std::vector<int> cpus;
+    const char* p = text.c_str();
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+            if (cpu >= 0 && CPU_ISSET(static_cast<size_t>(cpu), &allowed)) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+        if (*p == ',') {
+            ++p;
+        } else if (*p != '\0') {
+            break;
+        }
+    }
+    return cpus;
+}
+
+// 读取各 NUMA 节点可用的 CPU，按节点号排列；没有节点信息（非 NUMA 内核或容器）时视为一个节点
+std::vector<std::vector<int>> read_numa_nodes(const cpu_set_t& allowed) {
+    std::vector<std::pair<long, std::vector<int>>> found;
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            if (strncmp(entry->d_name, "node", 4) != 0 || entry->d_name[4] < '0' || entry->d_name[4] > '9') {
+                continue;
+            }
+            std::ifstream file(std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist");
+            std::string text;
+            if (std::getline(file, text)) {
+                std::vector<int> cpus = parse_cpu_list(text, allowed);
+                if (!cpus.empty()) {
+                    found.emplace_back(atol(entry->d_name + 4), std::move(cpus));
+                }
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::vector<int>> nodes;
+    for (auto& [id, cpus] : found) {
+        nodes.push_back(std::move(cpus));
+    }
+    if (nodes.empty()) {
+        nodes.emplace_back();
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(static_cast<size_t>(cpu), &allowed)) {
+                nodes.back().push_back(cpu);
+            }
+        }
+    }
+    return nodes;
+}
+
+} // namespace
+
+MorselScheduler::MorselScheduler(size_t workers, bool pin) {
+    cpu_set_t allowed = allowed_cpus();
+    nodes_ = read_numa_nodes(allowed);
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+        for (int cpu : nodes_[node]) {
+            if (cpu_node_.size() <= static_cast<size_t>(cpu)) {
+                cpu_node_.resize(static_cast<size_t>(cpu) + 1, 0);
+            }
+            cpu_node_[static_cast<size_t>(cpu)] = node;
+        }
+    }
+
+    // 工作线程在各节点之间交替分配，线程数少于 CPU 数时各节点也都有线程
+    std::vector<std::pair<size_t, int>> placement;
+    for (size_t k = 0; placement.size() < CPU_SETSIZE; ++k) {
+        size_t added = 0;
+        for (size_t node = 0; node < nodes_.size(); ++node) {
+            if (k < nodes_[node].size()) {
+                placement.emplace_back(node, nodes_[node][k]);
+                ++added;
+            }
+        }
+        if (added == 0) {
+            break;
+        }
+    }
+    workers_.resize(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_[i].node = placement[i % placement.size()].first;
+        workers_[i].cpu = placement[i % placement.size()].second;
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        workers_[i].thread = std::thread(&MorselScheduler::workerMain, this, i, pin);
+    }
+}
+
+MorselScheduler::~MorselScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.thread.join();
+    }
+}
+
+size_t MorselScheduler::availableCpus() {
+    cpu_set_t cpus = allowed_cpus();
+    return static_cast<size_t>(std::max(1, CPU_COUNT(&cpus)));
+}
+
+size_t MorselScheduler::currentNode() const {
+    int cpu = sched_getcpu();
+    return cpu >= 0 && static_cast<size_t>(cpu) < cpu_node_.size() ? cpu_node_[static_cast<size_t>(cpu)] : 0;
+}
+
+void MorselScheduler::runJob(size_t morsels, MorselFn fn, void* arg) {
+    if (morsels == 0) {
+        return;
+    }
+    Job job;
+    job.fn = fn;
+    job.arg = arg;
+    size_t nodes = nodes_.size();
+    job.cursors = std::make_unique<Cursor[]>(nodes);
+    for (size_t node = 0; node < nodes; ++node) {
+        job.cursors[node].next.store(morsels * node / nodes, std::memory_order_relaxed);
+        job.cursors[node].end = morsels * (node + 1) / nodes;
+    }
+
+    if (!workers_.empty() && morsels > 1) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(&job);
+        }
+        work_cv_.notify_all();
+    }
+
+    work(job, workers_.size(), currentNode());
+
+    // 片段都已领完：不再让新的工作线程加入，等正在执行最后几个片段的线程离开
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::erase(jobs_, &job);
+        done_cv_.wait(lock, [&job]() { return job.active == 0; });
+    }
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+// 先领取 node 节点的片段，领完后依次窃取其他节点的片段
+void MorselScheduler::work(Job& job, size_t slot, size_t node) {
+    size_t nodes = nodes_.size();
+    for (size_t i = 0; i < nodes; ++i) {
+        Cursor& cursor = job.cursors[(node + i) % nodes];
+        while (!job.failed.load(std::memory_order_relaxed)) {
+            size_t morsel = cursor.next.fetch_add(1, std::memory_order_relaxed);
+            if (morsel >= cursor.end) {
+                break;
+            }
+            try {
+                job.fn(job.arg, slot, morsel);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job.error_mutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+                job.failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void MorselScheduler::workerMain(size_t index, bool pin) {
+    Worker& self = workers_[index];
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (pin) {
+        CPU_SET(static_cast<size_t>(self.cpu), &cpus);
+    } else {
+        for (int cpu : nodes_[self.node]) {
+            CPU_SET(static_cast<size_t>(cpu), &cpus);
+        }
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+        if (stop_) {
+            return;
+        }
+        Job* job = jobs_[next_job_++ % jobs_.size()];
+        ++job->active;
+        lock.unlock();
+
+        work(*job, index, self.node);
+
+        lock.lock();
+        // 本线程领不到片段说明作业的片段已全部领完
+        std::erase(jobs_, job);
+        if (--job->active == 0) {
+            done_cv_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef MORSEL_SCHEDULER_H
+#define MORSEL_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 单条查询内部的并行调度：把一次作业切成若干片段（morsel），由各工作线程动态领取
+//
+// 工作线程按 NUMA 节点分组（读取 /sys/devices/system/node），每个线程绑定到所在节点的 CPU。
+// 作业的片段按编号连续地分给各节点，线程先领取本节点的片段，领完后再去其他节点窃取，
+// 因此扫描大体上访问本节点的数据，又不会因为某个节点落后而拖慢整个查询。
+// 提交作业的线程也参与执行，run() 在所有片段完成后返回。多个作业可以同时进行。
+//
+// 与语句执行线程池（WorkerPool）分开：语句线程在 run() 中等待时不会占住执行片段所需的线程。
+class MorselScheduler {
+public:
+    // workers 个工作线程（可以为 0，此时作业全部由调用线程执行）；
+    // pin 为 true 时每个工作线程绑定到单个 CPU，否则绑定到所在节点的全部 CPU
+    explicit MorselScheduler(size_t workers, bool pin = false);
+    ~MorselScheduler();
+
+    MorselScheduler(const MorselScheduler&) = delete;
+    MorselScheduler& operator=(const MorselScheduler&) = delete;
+
+    // 执行片段的线程槽位数：工作线程各占一个，调用线程占最后一个
+    // 同一作业中同一槽位的片段不会并发执行，可以按槽位保存局部结果
+    size_t slots() const { return workers_.size() + 1; }
+
+    size_t nodeCount() const { return nodes_.size(); }
+
+    // 执行 fn(slot, morsel)，morsel 取遍 [0, morsels)；片段抛出的第一个异常在全部线程结束后重新抛出
+    template<typename F>
+    void run(size_t morsels, F& fn) {
+        runJob(morsels, [](void* arg, size_t slot, size_t morsel) { (*static_cast<F*>(arg))(slot, morsel); },
+               &fn);
+    }
+
+    // 当前进程可以使用的 CPU 数
+    static size_t availableCpus();
+
+private:
+    using MorselFn = void (*)(void* arg, size_t slot, size_t morsel);
+
+    // 一个节点负责的片段区间，next 为下一个待领取的片段
+    struct alignas(64) Cursor {
+        std::atomic<size_t> next{0};
+        size_t end = 0;
+    };
+
+    struct Job {
+        MorselFn fn;
+        void* arg;
+        std::unique_ptr<Cursor[]> cursors;  // 每个节点一个
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;           // 受 error_mutex 保护
+        std::mutex error_mutex;
+        size_t active = 0;                  // 正在执行本作业的工作线程数，受调度器 mutex_ 保护
+    };
+
+    struct Worker {
+        std::thread thread;
+        size_t node = 0;
+        int cpu = -1;
+    };
+
+    std::vector<std::vector<int>> nodes_;   // 每个节点的 CPU
+    std::vector<size_t> cpu_node_;          // CPU 号到节点的映射
+    std::vector<Worker> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;       // 有新作业或停止
+    std::condition_variable done_cv_;       // 某个作业的工作线程全部离开
+    std::vector<Job*> jobs_;                // 尚有片段未领完的作业
+    size_t next_job_ = 0;                   // 工作线程轮流加入各作业
+    bool stop_ = false;
+
+    void runJob(size_t morsels, MorselFn fn, void* arg);
+    void work(Job& job, size_t slot, size_t node);
+    size_t currentNode() const;
+    void workerMain(size_t index, bool pin);
+};
+
+#endif // MORSEL_SCHEDULER_H
@@ -0,0 +1,125 @@
+#include <pthread.h>
+#include <sched.h>
+#include "common/worker_pool.h"
+
+static thread_local int current_worker_index = -1;
+
+void WorkerPool::TaskRing::pushBack(Task task) {
+    if (tail_ - head_ == slots_.size()) {
+        // 已满：按两倍容量重新排列
+        std::vector<Task> grown(std::max<size_t>(64, slots_.size() * 2));
+        for (size_t i = head_; i != tail_; ++i) {
+            grown[i - head_] = slots_[i & (slots_.size() - 1)];
+        }
+        tail_ -= head_;
+        head_ = 0;
+        slots_.swap(grown);
+    }
+    slots_[tail_++ & (slots_.size() - 1)] = task;
+}
+
+WorkerPool::WorkerPool(size_t workers, bool pin) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        workers_[i]->thread = std::thread(&WorkerPool::workerMain, this, i, pin);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+int WorkerPool::currentWorker() {
+    return current_worker_index;
+}
+
+void WorkerPool::submit(TaskFn fn, void* arg) {
+    size_t index;
+    if (current_worker_index >= 0 && static_cast<size_t>(current_worker_index) < workers_.size()) {
+        index = static_cast<size_t>(current_worker_index);
+    } else {
+        index = next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.pushBack(Task{fn, arg});
+    }
+    pending_.fetch_add(1);
+
+    // 只有存在休眠线程时才需要加锁唤醒
+    if (sleepers_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        sleep_cv_.notify_one();
+    }
+}
+
+// 从自己的队列头部取任务（先进先出，保证同一来源的任务大致按序执行）
+bool WorkerPool::popLocal(size_t self, Task& task) {
+    Worker& worker = *workers_[self];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = worker.tasks.popFront();
+    return true;
+}
+
+// 从其他工作线程队列尾部窃取任务
+bool WorkerPool::steal(size_t self, Task& task) {
+    size_t count = workers_.size();
+    for (size_t i = 1; i < count; ++i) {
+        Worker& victim = *workers_[(self + i) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) {
+            continue;
+        }
+        task = victim.tasks.popBack();
+        return true;
+    }
+    return false;
+}
+
+void WorkerPool::workerMain(size_t index, bool pin) {
+    current_worker_index = static_cast<int>(index);
+
+    if (pin) {
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index % cores, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            pending_.fetch_sub(1);
+            task.fn(task.arg);
+            continue;
+        }
+
+        // 没有任务：休眠直到有新任务或停止；停止前先执行完剩余任务
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleepers_.fetch_add(1);
+        sleep_cv_.wait(lock, [this]() { return stop_ || pending_.load() > 0; });
+        sleepers_.fetch_sub(1);
+        if (stop_ && pending_.load() == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的工作线程池，每个工作线程一个任务双端队列，空闲时从其他线程的队列尾部窃取
+//
+// 任务是一个函数指针加参数，提交时不分配内存。外部线程（如 I/O 线程）提交的任务
+// 轮流放入各工作线程的队列；工作线程自身提交的任务放入自己的队列。
+class WorkerPool {
+public:
+    using TaskFn = void (*)(void*);
+
+    // workers 为 0 时按核心数创建；pin 为 true 时把第 i 个工作线程绑定到第 i 个核心
+    explicit WorkerPool(size_t workers = 0, bool pin = false);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 提交任务
+    void submit(TaskFn fn, void* arg);
+
+    size_t size() const { return workers_.size(); }
+
+    // 当前线程所属工作线程的下标，不在池中时返回 -1
+    static int currentWorker();
+
+private:
+    struct Task {
+        TaskFn fn;
+        void* arg;
+    };
+
+    // 可扩容的环形双端队列；容量只增不减，稳态下入队出队不分配内存
+    class TaskRing {
+    public:
+        bool empty() const { return head_ == tail_; }
+        void pushBack(Task task);
+        Task popFront() { return slots_[head_++ & (slots_.size() - 1)]; }
+        Task popBack() { return slots_[--tail_ & (slots_.size() - 1)]; }
+
+    private:
+        std::vector<Task> slots_;
+        size_t head_ = 0;
+        size_t tail_ = 0;
+    };
+
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        TaskRing tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_worker_{0};    // 外部提交的轮转位置
+    std::atomic<size_t> pending_{0};        // 已提交未取走的任务数
+    std::atomic<size_t> sleepers_{0};       // 正在休眠的工作线程数
+    std::atomic<bool> stop_{false};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+
+    bool popLocal(size_t self, Task& task);
+    bool steal(size_t self, Task& task);
+    void workerMain(size_t index, bool pin);
+};
+
+#endif // WORKER_POOL_H
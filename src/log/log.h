@@ -1,175 +1,262 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <string_view>
 #include <format>
 #include <chrono>
 #include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
 #include <atomic>
 #include <memory>
 #include <cstdarg>
 #include <source_location>
 #include <cstdio>
 #include <utility>
+#include <fcntl.h>
+#include <unistd.h>
 #include <boost/stacktrace.hpp>
+#include "log/log_format.h"
+#include "log/log_ring.h"
 
-// 日志级别枚举
-enum class LogLevel {
-    DEBUG5,
-    DEBUG4,
-    DEBUG3,
-    DEBUG2,
-    DEBUG,
-    INFO,
-    NOTICE,
-    WARNING,
-    ERROR,
-    CRITICAL
-};
+#define LOG_WRITE_BATCH 512             // 写入线程每批最多处理的消息数，一批只调用一次 write()
+#define LOG_WRITER_IDLE_MS 100          // 写入线程空闲时的等待上限（兜底，正常由生产者唤醒）
+#define LOG_FORMAT_BUFFER 1024          // 调用方格式化消息的栈上缓冲区，更长的消息才分配内存
+#define LOG_STACK_DEPTH 64              // ERROR 及以上记录的调用栈最多帧数
+#define LOG_STACK_BUFFER 2048           // 调用方拼装调用栈记录的栈上缓冲区（帧地址加消息），更长的消息才分配内存
+#define LOG_SYMBOL_CACHE 4096           // 写入线程缓存的地址到符号的条数，超过后清空重建
 
-// 日志级别转换为字符串
-constexpr std::string_view levelToString(LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG5:   return "DEBUG5";
-        case LogLevel::DEBUG4:   return "DEBUG4";
-        case LogLevel::DEBUG3:   return "DEBUG3";
-        case LogLevel::DEBUG2:   return "DEBUG2";
-        case LogLevel::DEBUG:    return "DEBUG";
-        case LogLevel::INFO:     return "INFO";
-        case LogLevel::NOTICE:   return "NOTICE";
-        case LogLevel::WARNING:  return "WARNING";
-        case LogLevel::ERROR:    return "ERROR";
-        case LogLevel::CRITICAL: return "CRITICAL";
-        default:                 return "UNKNOWN";
-    }
-}
+// 编译时保留的最低级别（CMake 选项 LOG_MIN_LEVEL），低于它的日志宏整个不生成代码，参数也不求值。
+// LOG(ERROR, ...) 会抛出异常，所以 ERROR 及以上不能被删除
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL DEBUG5
+#endif
+constexpr LogLevel LOG_COMPILED_LEVEL = LogLevel::LOG_MIN_LEVEL;
+static_assert(LOG_COMPILED_LEVEL <= LogLevel::ERROR, "LOG_MIN_LEVEL 不能高于 ERROR");
 
-// 日志模块枚举
-enum class LogModule {
-    SYNTAX,     // 语法模块
-    PARSER,     // 解析模块
-    PLANNER,    // 计划模块
-    EXECUTOR,   // 执行模块
-    NETWORK,    // 网络模块
-    SYSTEM,     // 系统模块
-    GENERAL     // 通用模块
+// 日志文件的格式
+enum class LogFileFormat {
+    TEXT,       // 每条一行文本（默认）
+    BINARY      // 延迟格式化的日志只写参数的原始字节，用 log_decode 转成文本（格式见 log_format.h）
 };
 
-// 日志消息结构
-struct LogMessage {
-    std::chrono::system_clock::time_point timestamp;
-    LogLevel level;
-    LogModule module;
-    std::string content;
-    
-    LogMessage(LogLevel lvl, LogModule mod, std::string msg)
-        : timestamp(std::chrono::system_clock::now())
-        , level(lvl)
-        , module(mod)
-        , content(std::move(msg)) {}
+// 缓冲区中一条记录的正文
+enum class LogRecordKind : uint8_t {
+    TEXT,       // 调用方已格式化的内容
+    DEFERRED,   // const LogSite* 加参数的原始字节，由写入线程格式化
+    STACK       // 帧数（uint64_t）、帧地址与已格式化的消息，由写入线程解析符号
 };
 
 // 日志记录器类
+// 调用方在自己的线程中格式化消息并写入无锁环形缓冲区（见 log_ring.h），不加锁也不分配内存；
+// 写入线程按批取出消息，拼成一块后一次 write() 到以 O_APPEND 打开的日志文件。
+// 写入线程只在缓冲区为空时睡眠，此时才需要生产者唤醒，繁忙时生产者不会碰到互斥锁。
+// LOG_DEFERRED 连格式化也推迟到写入线程：调用方只复制参数的原始字节与调用处的静态 LogSite 的地址。
+// ERROR 及以上的调用栈同样只在调用方记录帧地址，符号解析（很慢）在写入线程进行并按地址缓存。
 class Logger {
 private:
-    // 单例实例
-    static Logger* instance_;
+    // 单例实例（inline 定义，允许多个翻译单元包含本头文件）
+    static inline Logger* instance_ = nullptr;
     
-    // 线程安全的日志队列
-    std::queue<std::shared_ptr<LogMessage>> queue_;
-    mutable std::mutex queue_mutex_;
-    std::condition_variable queue_cv_;
+    // 预分配槽的环形缓冲区与缓冲区满时的处理方式
+    LogRing ring_;
+    std::atomic<LogOverflow> overflow_{LogOverflow::BLOCK};
     
-    // 日志写入线程
+    // 日志写入线程；sleeping_ 为 true 时写入线程在 wake_cv_ 上等待，生产者发布消息后要唤醒它
     std::thread writer_thread_;
     std::atomic<bool> writer_running_{false};
     std::atomic<bool> writer_stop_{false};
+    std::atomic<bool> sleeping_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    
+    // 日志文件，只在写入线程停止时更换
+    int log_fd_ = -1;
+    LogFileFormat file_format_ = LogFileFormat::TEXT;
     
-    // 日志文件
-    std::ofstream log_file_;
+    // 以下只有写入线程访问：行格式化（缓存到秒的时间戳），延迟格式化用的缓冲，
+    // 二进制日志中已写出定义的位置，调用栈地址解析出的符号，已在日志中报告的丢弃条数
+    LogLineFormatter line_formatter_;
+    std::string message_;
+    LogValue values_[LOG_MAX_ARGS];
+    std::unordered_map<const LogSite*, uint32_t> binary_sites_;
+    std::unordered_map<const void*, std::string> symbols_;
+    uint64_t reported_drops_ = 0;
     
-    // 日志控制
-    std::atomic<bool> enabled_{true};
-    std::atomic<bool> modules_enabled_[static_cast<size_t>(LogModule::GENERAL) + 1];
+    // 日志控制：全局开关、各模块的开关与级别，修改时在 config_mutex_ 下合成为 thresholds_。
+    // thresholds_ 是静态的常量初始化数组，日志宏不经过 getInstance() 就能判断，关闭的调用点只有一次 relaxed 读与比较
+    static inline std::atomic<uint8_t> thresholds_[LOG_MODULE_COUNT] = {};
+    mutable std::mutex config_mutex_;
+    bool enabled_ = true;
+    bool modules_enabled_[LOG_MODULE_COUNT];
+    LogLevel module_levels_[LOG_MODULE_COUNT];
     
     // 私有构造函数
     Logger() {
-        // 默认所有模块都启用
-        for (size_t i = 0; i <= static_cast<size_t>(LogModule::GENERAL); ++i) {
+        // 默认所有模块都启用，记录全部级别
+        for (size_t i = 0; i < LOG_MODULE_COUNT; ++i) {
             modules_enabled_[i] = true;
+            module_levels_[i] = LogLevel::DEBUG5;
         }
         
         // 打开日志文件
-        log_file_.open("simple.log", std::ios::out | std::ios::app);
-        if (!log_file_.is_open()) {
-            throw std::runtime_error("无法打开日志文件: simple.log");
-        }
+        openLogFile("simple.log", LogFileFormat::TEXT);
+        instance_ = this;
         
         // 启动写入线程
         startWriterThread();
     }
     
-    // 格式化时间戳
-    std::string formatTimestamp(const std::chrono::system_clock::time_point& tp) {
-        auto time = std::chrono::system_clock::to_time_t(tp);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            tp.time_since_epoch()
-        ) % 1000;
-        
-        std::tm tm_info;
-        localtime_r(&time, &tm_info);
-        
-        char buffer[32];
-        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm_info);
-        
-        return std::format("{}.{:03d}", buffer, static_cast<int>(ms.count()));
+    void openLogFile(const std::string& filename, LogFileFormat format) {
+        log_fd_ = open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (log_fd_ < 0) {
+            throw std::runtime_error("无法打开日志文件: " + filename);
+        }
+        file_format_ = format;
+        binary_sites_.clear();
+        if (format == LogFileFormat::BINARY) {
+            std::string header;
+            log_binary_put(header, static_cast<uint64_t>(LOG_BINARY_MAGIC));
+            log_binary_put(header, static_cast<uint32_t>(LOG_BINARY_VERSION));
+            writeBatch(header);
+        }
+    }
+    
+    // 一条已格式化的内容追加到本批
+    void appendText(std::string& batch, int64_t timestamp_ns, LogLevel level, LogModule module,
+                    std::string_view content) {
+        if (file_format_ == LogFileFormat::TEXT) {
+            line_formatter_.append(batch, timestamp_ns, level, content);
+            return;
+        }
+        log_binary_put(batch, LogBinaryTag::TEXT);
+        log_binary_put(batch, timestamp_ns);
+        log_binary_put(batch, static_cast<uint8_t>(level));
+        log_binary_put(batch, static_cast<uint8_t>(module));
+        log_binary_put_string(batch, content);
+    }
+    
+    // 一条延迟格式化的记录追加到本批：文本日志在这里格式化，二进制日志原样写出参数
+    void appendDeferred(std::string& batch, int64_t timestamp_ns, std::string_view payload) {
+        const LogSite* site = nullptr;
+        memcpy(&site, payload.data(), sizeof(site));
+        std::string_view args = payload.substr(sizeof(site));
+        if (file_format_ == LogFileFormat::TEXT) {
+            message_.clear();
+            if (log_decode_args(site->types, site->arg_count, args, values_)) {
+                log_format_deferred(message_, site->format, values_, site->arg_count);
+            } else {
+                message_ = "[log record corrupted]";
+            }
+            line_formatter_.append(batch, timestamp_ns, site->level, message_);
+            return;
+        }
+        auto [it, inserted] = binary_sites_.try_emplace(site, static_cast<uint32_t>(binary_sites_.size()));
+        if (inserted) {
+            log_binary_put(batch, LogBinaryTag::SITE);
+            log_binary_put(batch, it->second);
+            log_binary_put(batch, static_cast<uint8_t>(site->level));
+            log_binary_put(batch, static_cast<uint8_t>(site->module));
+            log_binary_put(batch, site->line);
+            log_binary_put(batch, site->arg_count);
+            batch.append(reinterpret_cast<const char*>(site->types), site->arg_count);
+            log_binary_put_string(batch, site->file);
+            log_binary_put_string(batch, site->format);
+        }
+        log_binary_put(batch, LogBinaryTag::EVENT);
+        log_binary_put(batch, it->second);
+        log_binary_put(batch, timestamp_ns);
+        log_binary_put_string(batch, args);
+    }
+    
+    // 一条带调用栈的记录追加到本批：解析各帧的符号后按 boost::stacktrace::to_string 的格式拼在消息之后，
+    // 二进制日志也写成文本记录
+    void appendStack(std::string& batch, int64_t timestamp_ns, LogLevel level, LogModule module,
+                     std::string_view payload) {
+        uint64_t count = 0;
+        memcpy(&count, payload.data(), sizeof(count));
+        payload.remove_prefix(sizeof(count));
+        message_.assign(payload.substr(count * sizeof(void*)));
+        message_ += "\nStack trace:\n";
+        for (uint64_t i = 0; i < count; ++i) {
+            const void* address = nullptr;
+            memcpy(&address, payload.data() + i * sizeof(void*), sizeof(address));
+            auto it = symbols_.find(address);
+            if (it == symbols_.end()) {
+                if (symbols_.size() >= LOG_SYMBOL_CACHE) {
+                    symbols_.clear();
+                }
+                it = symbols_.emplace(address, boost::stacktrace::to_string(boost::stacktrace::frame(address))).first;
+            }
+            std::format_to(std::back_inserter(message_), "{:2}# {}\n", i, it->second);
+        }
+        appendText(batch, timestamp_ns, level, module, message_);
+    }
+    
+    void writeBatch(const std::string& batch) {
+        size_t written = 0;
+        while (written < batch.size() && log_fd_ >= 0) {
+            ssize_t n = ::write(log_fd_, batch.data() + written, batch.size() - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;  // 写日志失败无处可报，丢弃这一批
+            }
+            written += static_cast<size_t>(n);
+        }
     }
     
     // 写入线程函数
     void writerThreadFunc() {
-        while (!writer_stop_ || !queue_.empty()) {
-            std::shared_ptr<LogMessage> msg;
-            
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                queue_cv_.wait(lock, [this]() {
-                    return !queue_.empty() || writer_stop_;
-                });
-                
-                if (queue_.empty() && writer_stop_) {
-                    break;
-                }
-                
-                if (!queue_.empty()) {
-                    msg = queue_.front();
-                    queue_.pop();
+        std::string batch;
+        for (;;) {
+            size_t count = ring_.consume(LOG_WRITE_BATCH, [&](const LogRecordHeader& header, std::string_view text) {
+                if (header.kind == static_cast<uint8_t>(LogRecordKind::DEFERRED)) {
+                    appendDeferred(batch, header.timestamp_ns, text);
+                } else if (header.kind == static_cast<uint8_t>(LogRecordKind::STACK)) {
+                    appendStack(batch, header.timestamp_ns, static_cast<LogLevel>(header.level),
+                                static_cast<LogModule>(header.module), text);
+                } else {
+                    appendText(batch, header.timestamp_ns, static_cast<LogLevel>(header.level),
+                               static_cast<LogModule>(header.module), text);
                 }
+            });
+            uint64_t dropped = ring_.dropped();
+            if (dropped != reported_drops_) {
+                auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                appendText(batch, now, LogLevel::WARNING, LogModule::SYSTEM,
+                           std::format("日志缓冲区已满，丢弃了 {} 条日志", dropped - reported_drops_));
+                reported_drops_ = dropped;
             }
-            
-            if (msg) {
-                // 格式化日志行
-                std::string timestamp = formatTimestamp(msg->timestamp);
-                std::string level_str(levelToString(msg->level));
-                // std::string module_str(moduleToString(msg->module));
-                
-                std::string log_line = std::format("[{}] [{}] {}\n",
-                    timestamp, level_str, msg->content);
-                
-                // 写入文件
-                if (log_file_.is_open()) {
-                    log_file_ << log_line;
-                    log_file_.flush();  // 立即刷新，确保日志及时写入
-                }
-                
-                // 同时输出到控制台（可选）
-                // std::cout << log_line;
+            if (!batch.empty()) {
+                writeBatch(batch);
+                batch.clear();
+                // 写出之后才归还槽，pendingLogs() 为 0 时日志都已交给内核
+                ring_.release();
+            }
+            if (count > 0) {
+                continue;
+            }
+            if (writer_stop_ && !ring_.hasUnread()) {
+                break;
             }
+            
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            sleeping_.store(true);
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(LOG_WRITER_IDLE_MS), [this]() {
+                return ring_.readable() || writer_stop_;
+            });
+            sleeping_.store(false, std::memory_order_relaxed);
         }
     }
     
@@ -181,8 +268,11 @@ private:
     
     // 停止写入线程
     void stopWriterThread() {
-        writer_stop_ = true;
-        queue_cv_.notify_all();
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            writer_stop_ = true;
+        }
+        wake_cv_.notify_all();
         
         if (writer_thread_.joinable()) {
             writer_thread_.join();
@@ -190,30 +280,100 @@ private:
         
         writer_running_ = false;
         
-        if (log_file_.is_open()) {
-            log_file_.close();
+        if (log_fd_ >= 0) {
+            close(log_fd_);
+            log_fd_ = -1;
+        }
+    }
+    
+    // 写入环形缓冲区；写入线程在睡眠时唤醒它
+    void enqueue(LogLevel level, LogModule module, std::string_view message,
+                 LogRecordKind kind = LogRecordKind::TEXT) {
+        LogRecordHeader header{};
+        header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header.level = static_cast<uint8_t>(level);
+        header.module = static_cast<uint8_t>(module);
+        header.kind = static_cast<uint8_t>(kind);
+        if (!ring_.push(header, message, overflow_.load(std::memory_order_relaxed))) {
+            return;
+        }
+        // 与写入线程的 sleeping_.store(true) 之后检查缓冲区配对，二者之一必然看到对方
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_cv_.notify_one();
         }
     }
     
-    // 格式化可变参数
-    std::string formatMessage(const char* format, va_list args) {
+    // 格式化可变参数：先写到 buffer，放不下时才分配，返回的视图指向 buffer 或 heap
+    std::string_view formatMessage(char* buffer, size_t capacity, std::string& heap,
+                                   const char* format, va_list args) {
         va_list args_copy;
         va_copy(args_copy, args);
         
-        // 获取需要的缓冲区大小
-        int size = vsnprintf(nullptr, 0, format, args);
+        int size = vsnprintf(buffer, capacity, format, args);
         if (size < 0) {
             va_end(args_copy);
-            return "";
+            return {};
         }
         
-        // 分配缓冲区并格式化
         std::size_t u_size = static_cast<std::size_t>(size);
-        std::string result(u_size, '\0');
-        vsnprintf(result.data(), u_size + 1, format, args_copy);
+        if (u_size < capacity) {
+            va_end(args_copy);
+            return std::string_view(buffer, u_size);
+        }
+        heap.assign(u_size, '\0');
+        vsnprintf(heap.data(), u_size + 1, format, args_copy);
         va_end(args_copy);
+        return heap;
+    }
+    
+    // 由开关与级别合成各模块的阈值，调用方持有 config_mutex_。
+    // 阈值最高为 ERROR：LOG(ERROR, ...) 抛出异常中止当前操作，被过滤掉就会继续往下执行，
+    // 所以关闭日志、模块设为 OFF 或 CRITICAL 时 ERROR 及以上仍然记录（与 LOG_MIN_LEVEL 的限制相同）
+    void updateThresholds() {
+        for (size_t i = 0; i < LOG_MODULE_COUNT; ++i) {
+            LogLevel threshold = enabled_ && modules_enabled_[i] ? std::min(module_levels_[i], LogLevel::ERROR)
+                                                                 : LogLevel::ERROR;
+            thresholds_[i].store(static_cast<uint8_t>(threshold), std::memory_order_relaxed);
+        }
+    }
+    
+    // ERROR 及以上附带调用栈；ERROR 在写入日志后抛出 std::runtime_error。
+    // 调用方只把帧地址收集到栈上的缓冲区（不分配内存、不解析符号），记录为帧数、帧地址、消息
+    void enqueueWithStack(LogLevel level, LogModule module, std::string_view message) {
+        if (level < LogLevel::ERROR) {
+            enqueue(level, module, message);
+            return;
+        }
+        alignas(void*) char buffer[LOG_STACK_BUFFER];
+        static_assert(sizeof(uint64_t) + (LOG_STACK_DEPTH + 1) * sizeof(void*) <= LOG_STACK_BUFFER,
+                      "LOG_STACK_BUFFER 放不下 LOG_STACK_DEPTH 帧");
+        // safe_dump_to 在最后一帧之后写一个空指针，返回值包括它
+        void** frames = reinterpret_cast<void**>(buffer + sizeof(uint64_t));
+        uint64_t count = boost::stacktrace::safe_dump_to(0, frames, (LOG_STACK_DEPTH + 1) * sizeof(void*));
+        count = count > 0 ? count - 1 : 0;
+        memcpy(buffer, &count, sizeof(count));
         
-        return result;
+        size_t prefix = sizeof(count) + count * sizeof(void*);
+        std::string_view text = message.substr(0, std::min(message.size(), LogRing::MAX_TEXT - prefix));
+        std::string heap;
+        std::string_view payload;
+        if (prefix + text.size() > sizeof(buffer)) {
+            heap.reserve(prefix + text.size());
+            heap.assign(buffer, prefix);
+            heap.append(text);
+            payload = heap;
+        } else {
+            memcpy(buffer + prefix, text.data(), text.size());
+            payload = std::string_view(buffer, prefix + text.size());
+        }
+        enqueue(level, module, payload, LogRecordKind::STACK);
+        
+        if (level == LogLevel::ERROR) {
+            throw std::runtime_error(std::string(message));
+        }
     }
     
 public:
@@ -228,76 +388,53 @@ public:
     // 获取单例实例
     static Logger& getInstance() {
         static Logger instance;
-        instance_ = &instance;
         return instance;
     }
     
     // 记录日志的主函数
     void log(LogLevel level, LogModule module, const char* format, ...) {
-        if (!enabled_ || !modules_enabled_[static_cast<size_t>(module)]) {
+        if (!shouldLog(level, module)) {
             return;
         }
         
         // 格式化消息
+        char buffer[LOG_FORMAT_BUFFER];
+        std::string heap;
         va_list args;
         va_start(args, format);
-        std::string message = formatMessage(format, args);
+        std::string_view message = formatMessage(buffer, sizeof(buffer), heap, format, args);
         va_end(args);
-
-        std::string errmsg{};
-
-        if (level >= LogLevel::ERROR) {
-            errmsg = message;
-            message += "\nStack trace:\n";
-            message += boost::stacktrace::to_string(boost::stacktrace::stacktrace());
-        }
-        
-        // 创建日志消息并加入队列
-        auto log_msg = std::make_shared<LogMessage>(level, module, std::move(message));
         
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            queue_.push(std::move(log_msg));
-        }
-        queue_cv_.notify_one();
-
-        if (level == LogLevel::ERROR) {
-            throw std::runtime_error(errmsg);
-        }
+        enqueueWithStack(level, module, message);
     }
     
     // 记录日志，带源码位置（可选功能）
     void logWithSource(LogLevel level, LogModule module, 
                       const std::source_location& location,
                       const char* format, ...) {
-        if (!enabled_ || !modules_enabled_[static_cast<size_t>(module)]) {
+        if (!shouldLog(level, module)) {
             return;
         }
         
         // 格式化消息
+        char buffer[LOG_FORMAT_BUFFER];
+        std::string heap;
         va_list args;
         va_start(args, format);
-        std::string content = formatMessage(format, args);
+        std::string_view content = formatMessage(buffer, sizeof(buffer), heap, format, args);
         va_end(args);
         
         // 添加源码位置信息
-        std::string message = std::format("{}:{}:{} {}",
+        char message[LOG_FORMAT_BUFFER];
+        auto result = std::format_to_n(message, sizeof(message), "{}:{}:{} {}",
             location.file_name(), location.line(), location.function_name(), content);
-        
-        // 创建日志消息并加入队列
-        auto log_msg = std::make_shared<LogMessage>(level, module, std::move(message));
-        
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            queue_.push(std::move(log_msg));
-        }
-        queue_cv_.notify_one();
+        enqueue(level, module, std::string_view(message, std::min(sizeof(message), static_cast<size_t>(result.size))));
     }
 
     // 使用 std::format 的模板化记录方法，支持传入任意 C++ 类型参数
     template<typename... Args>
     void logCpp(LogLevel level, LogModule module, std::string_view fmt, Args&&... args) {
-        if (!enabled_ || !modules_enabled_[static_cast<size_t>(module)]) {
+        if (!shouldLog(level, module)) {
             return;
         }
 
@@ -309,51 +446,161 @@ public:
             message = std::string("[format error] ") + e.what();
         }
 
-        std::string errmsg{};
-        if (level >= LogLevel::ERROR) {
-            errmsg = message;
-            message += "\nStack trace:\n";
-            message += boost::stacktrace::to_string(boost::stacktrace::stacktrace());
+        enqueueWithStack(level, module, message);
+    }
+    
+    // 延迟格式化的记录方法，由 LOG_DEFERRED 调用：format 在编译时按参数类型检查，
+    // 调用方只编码参数的原始字节（字符串复制内容），格式化在写入线程或 log_decode 中进行。
+    // ERROR 及以上与过长的记录在调用方格式化，行为与 logCpp 相同
+    template<typename... Args>
+    void logDeferred(const LogSite& site, std::format_string<const Args&...> format, const Args&... args) {
+        if (!shouldLog(site.level, site.module)) {
+            return;
         }
-
-        auto log_msg = std::make_shared<LogMessage>(level, module, std::move(message));
-
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            queue_.push(std::move(log_msg));
+        
+        size_t size = sizeof(const LogSite*) + (log_arg_size(args) + ... + 0);
+        if (site.level >= LogLevel::ERROR || size > LogRing::MAX_TEXT) {
+            enqueueWithStack(site.level, site.module, std::format(format, args...));
+            return;
         }
-        queue_cv_.notify_one();
-
-        if (level == LogLevel::ERROR) {
-            throw std::runtime_error(errmsg);
+        
+        char buffer[LOG_FORMAT_BUFFER];
+        std::string heap;
+        char* payload = buffer;
+        if (size > sizeof(buffer)) {
+            heap.resize(size);
+            payload = heap.data();
         }
+        const LogSite* address = &site;
+        memcpy(payload, &address, sizeof(address));
+        char* out = payload + sizeof(address);
+        ((out = log_arg_encode(out, args)), ...);
+        enqueue(site.level, site.module, std::string_view(payload, size), LogRecordKind::DEFERRED);
+    }
+    
+    // 该级别与模块的日志是否需要记录，日志宏在求值参数之前调用
+    static bool shouldLog(LogLevel level, LogModule module) {
+        return static_cast<uint8_t>(level) >= thresholds_[static_cast<size_t>(module)].load(std::memory_order_relaxed);
     }
     
     // 启用/禁用日志
     void setEnabled(bool enabled) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
         enabled_ = enabled;
+        updateThresholds();
     }
     
     // 启用/禁用特定模块的日志
     void setModuleEnabled(LogModule module, bool enabled) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
         modules_enabled_[static_cast<size_t>(module)] = enabled;
+        updateThresholds();
     }
     
     // 检查特定模块是否启用
     bool isModuleEnabled(LogModule module) const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
         return modules_enabled_[static_cast<size_t>(module)];
     }
     
-    // 获取队列中待处理的日志数量
+    // 设置特定模块记录的最低级别，运行中随时生效
+    void setModuleLevel(LogModule module, LogLevel level) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        module_levels_[static_cast<size_t>(module)] = level;
+        updateThresholds();
+    }
+    
+    // 设置所有模块记录的最低级别
+    void setLevel(LogLevel level) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        for (LogLevel& module_level : module_levels_) {
+            module_level = level;
+        }
+        updateThresholds();
+    }
+    
+    LogLevel moduleLevel(LogModule module) const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        return module_levels_[static_cast<size_t>(module)];
+    }
+    
+    // 按文本修改级别，逗号分隔的多项依次生效：LEVEL 设置所有模块，MODULE=LEVEL 设置一个模块，
+    // LEVEL 为 OFF 时关闭（模块），设置了级别的模块同时被启用；名字不区分大小写。出错时抛出 std::runtime_error，
+    // 出错之前的项已经生效。OFF 与 CRITICAL 只关闭 ERROR 以下的级别，见 updateThresholds()
+    void configureLevels(std::string_view spec) {
+        while (!spec.empty()) {
+            size_t comma = spec.find(',');
+            std::string_view item = spec.substr(0, comma);
+            spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+            auto trim = [](std::string_view text) {
+                text.remove_prefix(std::min(text.find_first_not_of(' '), text.size()));
+                return text.substr(0, text.find_last_not_of(' ') + 1);
+            };
+            item = trim(item);
+            if (item.empty()) {
+                continue;
+            }
+            size_t equals = item.find('=');
+            std::string_view level_name = equals == std::string_view::npos ? item : trim(item.substr(equals + 1));
+            std::string_view module_name = trim(item.substr(0, equals));
+            LogModule module = LogModule::GENERAL;
+            if (equals != std::string_view::npos && !parseLogModule(module_name, module)) {
+                throw std::runtime_error("未知的日志模块: " + std::string(module_name));
+            }
+            bool off = log_name_equals(level_name, "OFF");
+            LogLevel level = LogLevel::DEBUG5;
+            if (!off && !parseLogLevel(level_name, level)) {
+                throw std::runtime_error("未知的日志级别: " + std::string(level_name));
+            }
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            for (size_t i = 0; i < LOG_MODULE_COUNT; ++i) {
+                if (equals != std::string_view::npos && i != static_cast<size_t>(module)) {
+                    continue;
+                }
+                modules_enabled_[i] = !off;
+                if (!off) {
+                    module_levels_[i] = level;
+                }
+            }
+            updateThresholds();
+        }
+    }
+    
+    // 各模块当前的级别，例如 "SYNTAX=INFO NETWORK=OFF ..."；全局关闭时为 "OFF"（ERROR 及以上照常记录）
+    std::string describeLevels() const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (!enabled_) {
+            return "OFF";
+        }
+        std::string text;
+        for (size_t i = 0; i < LOG_MODULE_COUNT; ++i) {
+            text += text.empty() ? "" : " ";
+            text += moduleToString(static_cast<LogModule>(i));
+            text += '=';
+            text += modules_enabled_[i] ? levelToString(module_levels_[i]) : "OFF";
+        }
+        return text;
+    }
+    
+    // 缓冲区满时的处理方式：BLOCK 等待写入线程，DROP 丢弃并计数
+    void setOverflowPolicy(LogOverflow policy) {
+        overflow_ = policy;
+    }
+    
+    // 因缓冲区满被丢弃的日志条数（累计）
+    uint64_t droppedLogs() const {
+        return ring_.dropped();
+    }
+    
+    // 获取缓冲区中还没写出的槽数（长消息占多个槽），为 0 时之前的日志都已写出
     size_t pendingLogs() const {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        return queue_.size();
+        return static_cast<size_t>(ring_.pending());
     }
     
     // 等待所有日志写入完成
     void flush() {
         while (pendingLogs() > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
     
@@ -365,16 +612,13 @@ public:
         }
     }
     
-    // 设置日志文件名
-    void setLogFile(const std::string& filename) {
-        // 停止当前写入线程
+    // 设置日志文件名与格式
+    void setLogFile(const std::string& filename, LogFileFormat format = LogFileFormat::TEXT) {
+        // 停止当前写入线程（缓冲区中已有的日志写到原文件）
         stopWriterThread();
         
         // 重新打开文件
-        log_file_.open(filename, std::ios::out | std::ios::app);
-        if (!log_file_.is_open()) {
-            throw std::runtime_error("无法打开日志文件: " + filename);
-        }
+        openLogFile(filename, format);
         
         // 重置停止标志并重新启动线程
         writer_stop_ = false;
@@ -388,12 +632,17 @@ public:
     }
 };
 
-// 初始化静态成员
-Logger* Logger::instance_ = nullptr;
-
 // 方便使用的宏
+// 级别低于 LOG_COMPILED_LEVEL 的调用在编译时删除；其余先按模块阈值判断，关闭时参数不求值，也不访问单例。
+// level 须为常量（LogLevel 枚举值）
 #define LOG(level, module, format, ...) \
-    Logger::getInstance().log(level, module, format, ##__VA_ARGS__)
+    do { \
+        if constexpr ((level) >= LOG_COMPILED_LEVEL) { \
+            if (Logger::shouldLog(level, module)) { \
+                Logger::getInstance().log(level, module, format, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
 
 #define LOG_DEBUG(module, format, ...) \
     LOG(LogLevel::DEBUG, module, format, ##__VA_ARGS__)
@@ -415,11 +664,37 @@ Logger* Logger::instance_ = nullptr;
 
 // 带源码位置的日志宏
 #define LOG_SOURCE(level, module, format, ...) \
-    Logger::getInstance().logWithSource(level, module, \
-        std::source_location::current(), format, ##__VA_ARGS__)
+    do { \
+        if constexpr ((level) >= LOG_COMPILED_LEVEL) { \
+            if (Logger::shouldLog(level, module)) { \
+                Logger::getInstance().logWithSource(level, module, \
+                    std::source_location::current(), format, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+// 延迟格式化的日志宏：level 与 module 须为常量，format 为 std::format 语法的字符串字面量，
+// 参数限于整数、浮点数、bool、字符、字符串与指针（见 log_format.h）
+#define LOG_DEFERRED(level, module, format, ...) \
+    do { \
+        if constexpr ((level) >= LOG_COMPILED_LEVEL) { \
+            if (Logger::shouldLog(level, module)) { \
+                static constexpr LogSite log_site_ = make_log_site( \
+                    static_cast<decltype(std::make_tuple(__VA_ARGS__))*>(nullptr), format, __FILE__, __LINE__, \
+                    level, module); \
+                Logger::getInstance().logDeferred(log_site_, format, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
 
 // 使用 std::format 的 C++ 风格日志宏
 #define LOGCPP(level, module, format, ...) \
-    Logger::getInstance().logCpp(level, module, format, ##__VA_ARGS__)
+    do { \
+        if constexpr ((level) >= LOG_COMPILED_LEVEL) { \
+            if (Logger::shouldLog(level, module)) { \
+                Logger::getInstance().logCpp(level, module, format, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
@@ -0,0 +1,185 @@
+// 二进制日志解码工具：把 Logger 以 LogFileFormat::BINARY 写出的日志转成与文本日志相同的行
+// 用法: log_decode [文件...]，不给文件时读标准输入
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "log/log_format.h"
+
+namespace {
+
+// 从二进制日志中顺序读取，数据不足时抛出 std::runtime_error
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view data) : data_(data) {}
+
+    template<typename T>
+    T get() {
+        T value;
+        memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string_view getString() {
+        auto size = get<uint32_t>();
+        return std::string_view(take(size), size);
+    }
+
+    std::string_view getBytes(size_t size) { return std::string_view(take(size), size); }
+
+    bool done() const { return pos_ == data_.size(); }
+    size_t position() const { return pos_; }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+
+    const char* take(size_t size) {
+        if (data_.size() - pos_ < size) {
+            throw std::runtime_error("二进制日志在偏移 " + std::to_string(pos_) + " 处截断");
+        }
+        const char* p = data_.data() + pos_;
+        pos_ += size;
+        return p;
+    }
+};
+
+struct DecodedSite {
+    LogLevel level;
+    std::string format;
+    std::vector<LogArgType> types;
+};
+
+// 解码一个文件的全部内容，返回输出的行数
+size_t decode(std::string_view data, std::string& out) {
+    BinaryReader reader(data);
+    std::vector<DecodedSite> sites;
+    std::vector<LogValue> values(LOG_MAX_ARGS);
+    LogLineFormatter formatter;
+    std::string message;
+    size_t lines = 0;
+    uint64_t magic = 0;
+    if (data.size() >= sizeof(magic)) {
+        memcpy(&magic, data.data(), sizeof(magic));
+    }
+    if (magic != LOG_BINARY_MAGIC) {
+        throw std::runtime_error("不是二进制日志文件");
+    }
+    while (!reader.done()) {
+        // 每次打开日志文件追加一个文件头，位置 id 从头编号
+        if (data.size() - reader.position() >= sizeof(uint64_t)) {
+            memcpy(&magic, data.data() + reader.position(), sizeof(magic));
+            if (magic == LOG_BINARY_MAGIC) {
+                reader.get<uint64_t>();
+                auto version = reader.get<uint32_t>();
+                if (version != LOG_BINARY_VERSION) {
+                    throw std::runtime_error("不支持的二进制日志版本 " + std::to_string(version));
+                }
+                sites.clear();
+                continue;
+            }
+        }
+        auto tag = reader.get<LogBinaryTag>();
+        switch (tag) {
+            case LogBinaryTag::SITE: {
+                auto id = reader.get<uint32_t>();
+                DecodedSite site;
+                site.level = static_cast<LogLevel>(reader.get<uint8_t>());
+                reader.get<uint8_t>();      // module
+                reader.get<uint32_t>();     // line
+                auto count = reader.get<uint8_t>();
+                if (count > LOG_MAX_ARGS) {
+                    throw std::runtime_error("日志位置的参数个数非法");
+                }
+                std::string_view types = reader.getBytes(count);
+                for (char type : types) {
+                    site.types.push_back(static_cast<LogArgType>(type));
+                }
+                reader.getString();         // file
+                site.format = reader.getString();
+                if (id != sites.size()) {
+                    throw std::runtime_error("日志位置编号不连续");
+                }
+                sites.push_back(std::move(site));
+                break;
+            }
+            case LogBinaryTag::EVENT: {
+                auto id = reader.get<uint32_t>();
+                auto timestamp = reader.get<int64_t>();
+                std::string_view args = reader.getString();
+                if (id >= sites.size()) {
+                    throw std::runtime_error("日志记录引用了未定义的位置 " + std::to_string(id));
+                }
+                const DecodedSite& site = sites[id];
+                message.clear();
+                if (log_decode_args(site.types.data(), site.types.size(), args, values.data())) {
+                    log_format_deferred(message, site.format, values.data(), site.types.size());
+                } else {
+                    message = "[log record corrupted]";
+                }
+                formatter.append(out, timestamp, site.level, message);
+                ++lines;
+                break;
+            }
+            case LogBinaryTag::TEXT: {
+                auto timestamp = reader.get<int64_t>();
+                auto level = static_cast<LogLevel>(reader.get<uint8_t>());
+                reader.get<uint8_t>();      // module
+                formatter.append(out, timestamp, level, reader.getString());
+                ++lines;
+                break;
+            }
+            default:
+                throw std::runtime_error("未知的日志记录类型 " + std::to_string(static_cast<int>(tag)));
+        }
+    }
+    return lines;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs(argv + 1, argv + argc);
+    if (inputs.empty()) {
+        inputs.push_back("-");
+    }
+    for (const std::string& input : inputs) {
+        if (input == "--help") {
+            std::cout << "用法: " << argv[0] << " [二进制日志文件...]（不给文件时读标准输入）" << std::endl;
+            return 0;
+        }
+        std::string data;
+        int fd = input == "-" ? STDIN_FILENO : open(input.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            std::cerr << "无法打开 " << input << ": " << strerror(errno) << std::endl;
+            return 1;
+        }
+        char chunk[1 << 16];
+        for (ssize_t n; (n = read(fd, chunk, sizeof(chunk))) != 0;) {
+            if (n < 0 && errno != EINTR) {
+                std::cerr << "读取 " << input << " 失败: " << strerror(errno) << std::endl;
+                return 1;
+            }
+            data.append(chunk, static_cast<size_t>(std::max<ssize_t>(n, 0)));
+        }
+        if (fd != STDIN_FILENO) {
+            close(fd);
+        }
+        std::string out;
+        try {
+            decode(data, out);
+        } catch (const std::exception& e) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            std::cerr << input << ": " << e.what() << std::endl;
+            return 1;
+        }
+        fwrite(out.data(), 1, out.size(), stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,464 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// 日志级别枚举
+enum class LogLevel {
+    DEBUG5,
+    DEBUG4,
+    DEBUG3,
+    DEBUG2,
+    DEBUG,
+    INFO,
+    NOTICE,
+    WARNING,
+    ERROR,
+    CRITICAL
+};
+
+// 日志级别转换为字符串
+constexpr std::string_view levelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG5:   return "DEBUG5";
+        case LogLevel::DEBUG4:   return "DEBUG4";
+        case LogLevel::DEBUG3:   return "DEBUG3";
+        case LogLevel::DEBUG2:   return "DEBUG2";
+        case LogLevel::DEBUG:    return "DEBUG";
+        case LogLevel::INFO:     return "INFO";
+        case LogLevel::NOTICE:   return "NOTICE";
+        case LogLevel::WARNING:  return "WARNING";
+        case LogLevel::ERROR:    return "ERROR";
+        case LogLevel::CRITICAL: return "CRITICAL";
+        default:                 return "UNKNOWN";
+    }
+}
+
+// 日志模块枚举
+enum class LogModule {
+    SYNTAX,     // 语法模块
+    PARSER,     // 解析模块
+    PLANNER,    // 计划模块
+    EXECUTOR,   // 执行模块
+    NETWORK,    // 网络模块
+    SYSTEM,     // 系统模块
+    GENERAL     // 通用模块
+};
+
+#define LOG_MODULE_COUNT (static_cast<size_t>(LogModule::GENERAL) + 1)
+
+// 日志模块转换为字符串
+constexpr std::string_view moduleToString(LogModule module) {
+    switch (module) {
+        case LogModule::SYNTAX:   return "SYNTAX";
+        case LogModule::PARSER:   return "PARSER";
+        case LogModule::PLANNER:  return "PLANNER";
+        case LogModule::EXECUTOR: return "EXECUTOR";
+        case LogModule::NETWORK:  return "NETWORK";
+        case LogModule::SYSTEM:   return "SYSTEM";
+        case LogModule::GENERAL:  return "GENERAL";
+        default:                  return "UNKNOWN";
+    }
+}
+
+// 不区分大小写地比较名字
+constexpr bool log_name_equals(std::string_view text, std::string_view name) {
+    if (text.size() != name.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i] >= 'a' && text[i] <= 'z' ? static_cast<char>(text[i] - 'a' + 'A') : text[i];
+        if (c != name[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按名字（不区分大小写）解析日志级别与模块，不认识时返回 false
+inline bool parseLogLevel(std::string_view text, LogLevel& level) {
+    for (int i = static_cast<int>(LogLevel::DEBUG5); i <= static_cast<int>(LogLevel::CRITICAL); ++i) {
+        if (log_name_equals(text, levelToString(static_cast<LogLevel>(i)))) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool parseLogModule(std::string_view text, LogModule& module) {
+    for (size_t i = 0; i < LOG_MODULE_COUNT; ++i) {
+        if (log_name_equals(text, moduleToString(static_cast<LogModule>(i)))) {
+            module = static_cast<LogModule>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+#define LOG_MAX_ARGS 16                             // 延迟格式化的日志最多的参数个数
+#define LOG_BINARY_MAGIC 0x3130474f4c424453ULL      // "SDBLOG01"，二进制日志每次打开时写在开头
+#define LOG_BINARY_VERSION 1
+
+// ---------------------------------------------------------------------------
+// 延迟格式化：调用方只把参数的原始字节与格式化位置（LogSite）写入缓冲区，由写入线程或 log_decode 格式化
+
+// 参数在缓冲区中的类型：整数按有无符号与宽度归为四类，字符串为 uint32 长度加内容，其余为定长原始字节
+enum class LogArgType : uint8_t {
+    INT32,
+    UINT32,
+    INT64,
+    UINT64,
+    FLOAT,
+    DOUBLE,
+    BOOL,
+    CHAR,
+    STRING,
+    POINTER
+};
+
+template<LogArgType> struct LogArgStorage;
+template<> struct LogArgStorage<LogArgType::INT32> { using type = int32_t; };
+template<> struct LogArgStorage<LogArgType::UINT32> { using type = uint32_t; };
+template<> struct LogArgStorage<LogArgType::INT64> { using type = int64_t; };
+template<> struct LogArgStorage<LogArgType::UINT64> { using type = uint64_t; };
+template<> struct LogArgStorage<LogArgType::FLOAT> { using type = float; };
+template<> struct LogArgStorage<LogArgType::DOUBLE> { using type = double; };
+template<> struct LogArgStorage<LogArgType::BOOL> { using type = bool; };
+template<> struct LogArgStorage<LogArgType::CHAR> { using type = char; };
+template<> struct LogArgStorage<LogArgType::POINTER> { using type = const void*; };
+
+// 参数类型到 LogArgType 的映射；不支持的类型（枚举、自定义类型等）在编译时报错，改用 LOG 或先转换
+template<typename T>
+constexpr LogArgType log_arg_type() {
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, bool>) {
+        return LogArgType::BOOL;
+    } else if constexpr (std::is_same_v<D, char>) {
+        return LogArgType::CHAR;
+    } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+        return sizeof(D) <= 4 ? LogArgType::INT32 : LogArgType::INT64;
+    } else if constexpr (std::is_integral_v<D>) {
+        return sizeof(D) <= 4 ? LogArgType::UINT32 : LogArgType::UINT64;
+    } else if constexpr (std::is_same_v<D, float>) {
+        return LogArgType::FLOAT;
+    } else if constexpr (std::is_same_v<D, double>) {
+        return LogArgType::DOUBLE;
+    } else if constexpr (std::is_null_pointer_v<D>) {
+        return LogArgType::POINTER;
+    } else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*> ||
+                         std::is_convertible_v<const D&, std::string_view>) {
+        return LogArgType::STRING;
+    } else if constexpr (std::is_pointer_v<D>) {
+        return LogArgType::POINTER;
+    } else {
+        static_assert(sizeof(D) == 0, "该参数类型不能延迟格式化");
+    }
+}
+
+template<typename T>
+std::string_view log_arg_string(const T& value) {
+    if constexpr (std::is_pointer_v<std::decay_t<T>>) {
+        return value ? std::string_view(value) : std::string_view("(null)");
+    } else {
+        return std::string_view(value);
+    }
+}
+
+// 参数编码后的字节数
+template<typename T>
+size_t log_arg_size(const T& value) {
+    constexpr LogArgType type = log_arg_type<T>();
+    if constexpr (type == LogArgType::STRING) {
+        return sizeof(uint32_t) + log_arg_string(value).size();
+    } else {
+        return sizeof(typename LogArgStorage<type>::type);
+    }
+}
+
+// 把参数编码到 out，返回写入之后的位置
+template<typename T>
+char* log_arg_encode(char* out, const T& value) {
+    constexpr LogArgType type = log_arg_type<T>();
+    if constexpr (type == LogArgType::STRING) {
+        std::string_view text = log_arg_string(value);
+        auto size = static_cast<uint32_t>(text.size());
+        memcpy(out, &size, sizeof(size));
+        memcpy(out + sizeof(size), text.data(), text.size());
+        return out + sizeof(size) + text.size();
+    } else {
+        auto stored = static_cast<typename LogArgStorage<type>::type>(value);
+        memcpy(out, &stored, sizeof(stored));
+        return out + sizeof(stored);
+    }
+}
+
+// 一个延迟格式化的日志位置，由 LOG_DEFERRED 宏在调用处定义为静态常量，记录中只存放它的地址
+struct LogSite {
+    const char* format;         // std::format 语法，编译时已按参数类型检查
+    const char* file;
+    uint32_t line;
+    LogLevel level;
+    LogModule module;
+    uint8_t arg_count;
+    LogArgType types[LOG_MAX_ARGS];
+};
+
+// 由参数类型（std::tuple<Args...>，宏中用 decltype(std::make_tuple(...)) 得到，不会求值参数）生成 LogSite
+template<typename... Args>
+constexpr LogSite make_log_site(std::tuple<Args...>*, const char* format, const char* file, uint32_t line,
+                                LogLevel level, LogModule module) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "延迟格式化的日志参数过多");
+    return LogSite{format, file, line, level, module, static_cast<uint8_t>(sizeof...(Args)),
+                   {log_arg_type<Args>()...}};
+}
+
+// 解码后的一个参数
+struct LogValue {
+    LogArgType type = LogArgType::INT32;
+    int64_t integer = 0;        // INT32 / INT64 / BOOL / CHAR
+    uint64_t unsigned_integer = 0;  // UINT32 / UINT64 / POINTER
+    double real = 0;            // FLOAT / DOUBLE
+    std::string_view text{};    // STRING
+};
+
+// 按类型表解码 data 中的 count 个参数；数据不足或多余时返回 false
+inline bool log_decode_args(const LogArgType* types, size_t count, std::string_view data, LogValue* values) {
+    size_t pos = 0;
+    auto take = [&](void* out, size_t size) {
+        if (data.size() - pos < size) {
+            return false;
+        }
+        memcpy(out, data.data() + pos, size);
+        pos += size;
+        return true;
+    };
+    for (size_t i = 0; i < count; ++i) {
+        LogValue& value = values[i];
+        value = LogValue{types[i]};
+        bool ok = true;
+        switch (types[i]) {
+            case LogArgType::INT32: { int32_t v = 0; ok = take(&v, sizeof(v)); value.integer = v; break; }
+            case LogArgType::INT64: { ok = take(&value.integer, sizeof(int64_t)); break; }
+            case LogArgType::UINT32: { uint32_t v = 0; ok = take(&v, sizeof(v)); value.unsigned_integer = v; break; }
+            case LogArgType::UINT64: { ok = take(&value.unsigned_integer, sizeof(uint64_t)); break; }
+            case LogArgType::FLOAT: { float v = 0; ok = take(&v, sizeof(v)); value.real = v; break; }
+            case LogArgType::DOUBLE: { ok = take(&value.real, sizeof(double)); break; }
+            case LogArgType::BOOL: { bool v = false; ok = take(&v, sizeof(v)); value.integer = v; break; }
+            case LogArgType::CHAR: { char v = 0; ok = take(&v, sizeof(v)); value.integer = v; break; }
+            case LogArgType::POINTER: {
+                const void* v = nullptr;
+                ok = take(&v, sizeof(v));
+                value.unsigned_integer = reinterpret_cast<uintptr_t>(v);
+                break;
+            }
+            case LogArgType::STRING: {
+                uint32_t size = 0;
+                ok = take(&size, sizeof(size)) && data.size() - pos >= size;
+                if (ok) {
+                    value.text = data.substr(pos, size);
+                    pos += size;
+                }
+                break;
+            }
+            default:
+                ok = false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return pos == data.size();
+}
+
+// 按 pattern（只含一个替换域的格式串）格式化一个参数，类型与编码时一致，所以与在调用方直接格式化的结果相同
+inline void log_format_value(std::string& out, std::string_view pattern, const LogValue& value) {
+    auto sink = std::back_inserter(out);
+    switch (value.type) {
+        case LogArgType::INT32: { auto v = static_cast<int32_t>(value.integer); std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::INT64: { int64_t v = value.integer; std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::UINT32: { auto v = static_cast<uint32_t>(value.unsigned_integer); std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::UINT64: { uint64_t v = value.unsigned_integer; std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::FLOAT: { auto v = static_cast<float>(value.real); std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::DOUBLE: { double v = value.real; std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::BOOL: { bool v = value.integer != 0; std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::CHAR: { auto v = static_cast<char>(value.integer); std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::STRING: { std::string_view v = value.text; std::vformat_to(sink, pattern, std::make_format_args(v)); break; }
+        case LogArgType::POINTER: {
+            auto v = reinterpret_cast<const void*>(static_cast<uintptr_t>(value.unsigned_integer));
+            std::vformat_to(sink, pattern, std::make_format_args(v));
+            break;
+        }
+    }
+}
+
+// 不带格式说明的 {}：整数、浮点数（最短往返表示）直接 to_chars，结果与 std::format 相同
+inline void log_format_plain(std::string& out, const LogValue& value) {
+    char buffer[32];
+    std::to_chars_result result{buffer, std::errc()};
+    switch (value.type) {
+        case LogArgType::INT32:
+        case LogArgType::INT64: result = std::to_chars(buffer, buffer + sizeof(buffer), value.integer); break;
+        case LogArgType::UINT32:
+        case LogArgType::UINT64: result = std::to_chars(buffer, buffer + sizeof(buffer), value.unsigned_integer); break;
+        case LogArgType::STRING: out += value.text; return;
+        case LogArgType::CHAR: out += static_cast<char>(value.integer); return;
+        case LogArgType::BOOL: out += value.integer ? "true" : "false"; return;
+        default: log_format_value(out, "{}", value); return;
+    }
+    out.append(buffer, result.ptr);
+}
+
+// 按格式串与解码后的参数格式化，替换域逐个交给 std::vformat_to；支持 {{ }}、{n} 与 {:{}} 形式的动态宽度
+inline void log_format_deferred(std::string& out, std::string_view format, const LogValue* values, size_t count) {
+    std::string pattern;
+    size_t next = 0;
+    auto argument = [&](std::string_view id, size_t& index) {
+        if (id.empty()) {
+            index = next++;
+        } else if (std::from_chars(id.data(), id.data() + id.size(), index).ec != std::errc()) {
+            return false;
+        }
+        return index < count;
+    };
+    size_t i = 0;
+    while (i < format.size()) {
+        size_t special = format.find_first_of("{}", i);
+        if (special == std::string_view::npos) {
+            out.append(format.substr(i));
+            break;
+        }
+        out.append(format.substr(i, special - i));
+        i = special;
+        if (i + 1 < format.size() && format[i + 1] == format[i]) {
+            out += format[i];
+            i += 2;
+            continue;
+        }
+        if (format[i] == '}') {
+            out += '}';
+            ++i;
+            continue;
+        }
+        // 找到与之配对的 '}'，格式说明中可以嵌套一层 {} 表示动态宽度或精度
+        size_t end = i + 1;
+        for (int depth = 1; end < format.size(); ++end) {
+            depth += format[end] == '{' ? 1 : format[end] == '}' ? -1 : 0;
+            if (depth == 0) {
+                break;
+            }
+        }
+        std::string_view field = format.substr(i + 1, end - i - 1);
+        i = end + 1;
+        size_t colon = field.find(':');
+        size_t index = 0;
+        if (end >= format.size() || !argument(field.substr(0, colon), index)) {
+            out += "[format error]";
+            continue;
+        }
+        if (colon == std::string_view::npos) {
+            log_format_plain(out, values[index]);
+            continue;
+        }
+        pattern = "{:";
+        std::string_view spec = field.substr(colon + 1);
+        bool ok = true;
+        for (size_t k = 0; k < spec.size(); ++k) {
+            if (spec[k] != '{') {
+                pattern += spec[k];
+                continue;
+            }
+            size_t close = spec.find('}', k);
+            size_t nested = 0;
+            if (close == std::string_view::npos || !argument(spec.substr(k + 1, close - k - 1), nested)) {
+                ok = false;
+                break;
+            }
+            log_format_plain(pattern, values[nested]);
+            k = close;
+        }
+        pattern += '}';
+        try {
+            if (!ok) {
+                throw std::format_error("invalid replacement field");
+            }
+            log_format_value(out, pattern, values[index]);
+        } catch (const std::format_error&) {
+            out += "[format error]";
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 日志行: [YYYY-mm-dd HH:MM:SS.mmm] [级别] 内容
+// 秒以上的部分每秒只用 localtime_r/strftime 格式化一次，同一秒内的行只追加毫秒
+class LogLineFormatter {
+public:
+    void append(std::string& out, int64_t timestamp_ns, LogLevel level, std::string_view content) {
+        out += '[';
+        appendTimestamp(out, timestamp_ns);
+        out += "] [";
+        out += levelToString(level);
+        out += "] ";
+        out += content;
+        out += '\n';
+    }
+
+private:
+    int64_t cached_second_ = INT64_MIN;
+    char cached_time_[32] = {};
+    size_t cached_time_len_ = 0;
+
+    void appendTimestamp(std::string& out, int64_t timestamp_ns) {
+        int64_t ms = timestamp_ns / 1000000;
+        int64_t second = ms / 1000;
+        if (second != cached_second_) {
+            auto time = static_cast<time_t>(second);
+            std::tm tm_info;
+            localtime_r(&time, &tm_info);
+            cached_time_len_ = strftime(cached_time_, sizeof(cached_time_), "%Y-%m-%d %H:%M:%S", &tm_info);
+            cached_second_ = second;
+        }
+        auto millis = static_cast<int>(ms % 1000);
+        char tail[4] = {'.', static_cast<char>('0' + millis / 100), static_cast<char>('0' + millis / 10 % 10),
+                        static_cast<char>('0' + millis % 10)};
+        out.append(cached_time_, cached_time_len_);
+        out.append(tail, sizeof(tail));
+    }
+};
+
+// ---------------------------------------------------------------------------
+// 二进制日志（Logger::setLogFile(path, LogFileFormat::BINARY)，用 log_decode 转成文本）：
+//   uint64 LOG_BINARY_MAGIC, uint32 LOG_BINARY_VERSION，之后是一串记录，每条以一字节标记开头
+//   SITE:  uint32 id, uint8 level, uint8 module, uint32 line, uint8 参数个数, 各参数的 LogArgType,
+//          uint32 长度 + 文件名, uint32 长度 + 格式串；每个位置在文件中第一次出现之前写一次
+//   EVENT: uint32 位置 id, int64 时间戳（纳秒）, uint32 长度 + 参数的原始字节
+//   TEXT:  int64 时间戳（纳秒）, uint8 level, uint8 module, uint32 长度 + 已格式化的内容
+// 同一文件可以包含多段（每次打开追加一个文件头），位置 id 只在本段内有效
+enum class LogBinaryTag : uint8_t {
+    SITE = 1,
+    EVENT = 2,
+    TEXT = 3
+};
+
+template<typename T>
+void log_binary_put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void log_binary_put_string(std::string& out, std::string_view text) {
+    log_binary_put(out, static_cast<uint32_t>(text.size()));
+    out.append(text);
+}
+
+#endif // LOG_FORMAT_H
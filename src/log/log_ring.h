@@ -0,0 +1,169 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#define LOG_RING_SLOTS 8192                         // 环形缓冲区的槽数（2 的幂），共 2 MB
+#define LOG_SLOT_BYTES 256                          // 每个槽的大小，长消息占用连续的多个槽
+#define LOG_MAX_MESSAGE_SLOTS (LOG_RING_SLOTS / 16) // 单条消息最多占用的槽数，更长的正文被截断
+#define LOG_BLOCK_SPINS 64                          // 缓冲区满时先让出 CPU 的次数，之后每次睡眠
+#define LOG_BLOCK_SLEEP_US 50                       // 缓冲区满时每次睡眠的微秒数
+
+// 缓冲区满时生产者的处理方式
+enum class LogOverflow {
+    BLOCK,      // 等待写入线程腾出空间，不丢日志（默认）
+    DROP        // 丢弃本条并计数，调用方不会被日志阻塞
+};
+
+// 一条消息的头部，放在它占用的第一个槽中
+struct LogRecordHeader {
+    int64_t timestamp_ns;   // system_clock 纪元以来的纳秒
+    uint32_t size;          // 正文字节数
+    uint16_t slots;         // 占用的槽数
+    uint8_t level;
+    uint8_t module;
+    uint8_t kind;           // 正文的解释方式，由记录器定义
+};
+
+// 多生产者单消费者的有界环形缓冲区，槽在构造时一次分配，写入日志不再分配内存。
+// 位置单调递增，对槽数取模得到槽；tail_ 是下一个可占用的位置，head_ 之前的槽已被消费者处理完。
+// 生产者用一次 CAS 占用消息需要的连续若干个槽（tail_ + k - head_ 不超过容量），
+// 先写正文，最后以 release 写入第一个槽的 sequence = 位置 + 1 发布；消费者按位置顺序读取已发布的消息，
+// 写出之后才推进 head_，所以被占用的槽在写出之前不会被覆盖。
+// 某个生产者占用了槽但还没发布时，消费者停在它前面，之后发布的消息等它发布后再一起写出。
+class LogRing {
+public:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};
+        char data[LOG_SLOT_BYTES - sizeof(std::atomic<uint64_t>)];
+    };
+
+    static constexpr size_t SLOT_DATA = sizeof(Slot::data);
+    static constexpr size_t FIRST_DATA = SLOT_DATA - sizeof(LogRecordHeader);
+    static constexpr size_t MAX_TEXT = FIRST_DATA + (LOG_MAX_MESSAGE_SLOTS - 1) * SLOT_DATA;
+
+    static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0, "LOG_RING_SLOTS 必须是 2 的幂");
+    static_assert(sizeof(Slot) == LOG_SLOT_BYTES, "槽大小必须是 LOG_SLOT_BYTES");
+
+    LogRing() : slots_(std::make_unique<Slot[]>(LOG_RING_SLOTS)) {}
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // 写入一条消息（超过 MAX_TEXT 的部分截断），缓冲区满时按 policy 等待或丢弃；丢弃时返回 false
+    bool push(LogRecordHeader header, std::string_view text, LogOverflow policy) {
+        text = text.substr(0, std::min(text.size(), MAX_TEXT));
+        size_t count = slotsFor(text.size());
+        uint64_t position = tail_.load(std::memory_order_relaxed);
+        for (int waits = 0;;) {
+            uint64_t head = head_.load(std::memory_order_acquire);
+            if (position + count - head > LOG_RING_SLOTS) {
+                if (policy == LogOverflow::DROP) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (++waits < LOG_BLOCK_SPINS) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(LOG_BLOCK_SLEEP_US));
+                }
+                position = tail_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (tail_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        header.size = static_cast<uint32_t>(text.size());
+        header.slots = static_cast<uint16_t>(count);
+        Slot& first = slot(position);
+        memcpy(first.data, &header, sizeof(header));
+        size_t taken = std::min(text.size(), FIRST_DATA);
+        memcpy(first.data + sizeof(header), text.data(), taken);
+        for (uint64_t i = 1; i < count; ++i) {
+            size_t piece = std::min(text.size() - taken, SLOT_DATA);
+            memcpy(slot(position + i).data, text.data() + taken, piece);
+            taken += piece;
+        }
+        first.sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：按顺序读取至多 limit 条已发布的消息，对每条调用 fn(header, text)；
+    // text 只在回调期间有效。读过的槽要等 release() 之后才能被生产者重用，返回读取的条数
+    template<typename Fn>
+    size_t consume(size_t limit, Fn&& fn) {
+        size_t consumed = 0;
+        while (consumed < limit) {
+            Slot& first = slot(read_);
+            if (first.sequence.load(std::memory_order_acquire) != read_ + 1) {
+                break;
+            }
+            LogRecordHeader header;
+            memcpy(&header, first.data, sizeof(header));
+            // 跨槽的正文之间隔着下一个槽的 sequence，拼接到 scratch_
+            std::string_view text = header.slots == 1 ? std::string_view(first.data + sizeof(header), header.size)
+                                                      : gather(header);
+            fn(header, text);
+            read_ += header.slots;
+            ++consumed;
+        }
+        return consumed;
+    }
+
+    // 消费者：已读取的消息都处理完毕，归还它们占用的槽
+    void release() { head_.store(read_, std::memory_order_release); }
+
+    // 已占用但还没有被消费者归还的槽数
+    uint64_t pending() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 消费者：是否有已占用但还没读取的槽（包括已占用还没发布的）
+    bool hasUnread() const { return tail_.load(std::memory_order_acquire) != read_; }
+
+    // 消费者：下一条消息是否已发布
+    bool readable() const {
+        return slots_[read_ & (LOG_RING_SLOTS - 1)].sequence.load(std::memory_order_acquire) == read_ + 1;
+    }
+
+private:
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> tail_{0};     // 生产者竞争
+    alignas(64) std::atomic<uint64_t> head_{0};     // 消费者写、生产者读
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    uint64_t read_ = 0;                             // 以下只有消费者访问
+    std::string scratch_;
+
+    static size_t slotsFor(size_t size) {
+        return size <= FIRST_DATA ? 1 : 1 + (size - FIRST_DATA + SLOT_DATA - 1) / SLOT_DATA;
+    }
+
+    Slot& slot(uint64_t position) { return slots_[position & (LOG_RING_SLOTS - 1)]; }
+
+    std::string_view gather(const LogRecordHeader& header) {
+        scratch_.clear();
+        size_t taken = std::min<size_t>(header.size, FIRST_DATA);
+        scratch_.append(slot(read_).data + sizeof(header), taken);
+        for (uint64_t i = 1; i < header.slots; ++i) {
+            size_t piece = std::min<size_t>(header.size - taken, SLOT_DATA);
+            scratch_.append(slot(read_ + i).data, piece);
+            taken += piece;
+        }
+        return scratch_;
+    }
+};
+
+#endif // LOG_RING_H
@@ -0,0 +1,186 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// 客户端与服务器之间的二进制帧协议
+//
+// 每一帧由 12 字节的帧头和变长负载组成，帧头字段均为网络字节序：
+//   +--------+--------+----------------+--------------------------------+
+//   | type   | flags  | reserved (16)  | length (32)  | request_id (32) |
+//   +--------+--------+----------------+--------------------------------+
+// length 为负载长度（不含帧头）。请求与响应通过 request_id 对应，
+// 服务器对同一连接上的请求按到达顺序应答，因此客户端可以连续发送多条请求（流水线）。
+
+#define FRAME_HEADER_SIZE 12
+#define MAX_FRAME_PAYLOAD (16u * 1024 * 1024)
+#define COPY_CHUNK_SIZE (1u << 20)      // 客户端 COPY 每帧携带的 CSV 数据量
+
+enum class FrameType : uint8_t {
+    HELLO    = 1,   // 客户端 -> 服务器：客户端名称
+    QUERY    = 2,   // 客户端 -> 服务器：一条语句
+    RESULT   = 3,   // 服务器 -> 客户端：执行结果
+    ERROR    = 4,   // 服务器 -> 客户端：错误信息
+    PREPARE  = 5,   // 客户端 -> 服务器：一条带 ? 或 $n 参数的语句
+    PREPARED = 6,   // 服务器 -> 客户端：语句句柄 (32) + 参数个数 (16)
+    EXECUTE  = 7,   // 客户端 -> 服务器：语句句柄 (32) + 参数个数 (16) + 各参数
+    COPY     = 8,   // 客户端 -> 服务器：起始行号 (64) + 表名长度 (16) + 表名 + 若干完整的 CSV 记录
+    COPIED   = 9    // 服务器 -> 客户端：导入的行数 (64)
+};
+
+// EXECUTE 帧中的参数：1 字节类型后跟值，整数与浮点数为 8 字节（浮点数按 IEEE 754 位模式），
+// 字符串为 32 位长度加内容，均为网络字节序。句柄只在准备它的连接上有效，连接关闭时释放
+enum class ParamType : uint8_t {
+    INTEGER = 1,
+    REAL    = 2,
+    STRING  = 3
+};
+
+struct FrameHeader {
+    FrameType type;
+    uint8_t flags;
+    uint32_t length;
+    uint32_t request_id;
+};
+
+namespace protocol {
+
+inline void putU32(char* p, uint32_t v) {
+    p[0] = static_cast<char>((v >> 24) & 0xff);
+    p[1] = static_cast<char>((v >> 16) & 0xff);
+    p[2] = static_cast<char>((v >> 8) & 0xff);
+    p[3] = static_cast<char>(v & 0xff);
+}
+
+inline uint32_t getU32(const char* p) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 24) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(p[2])) << 8) |
+           static_cast<uint32_t>(static_cast<uint8_t>(p[3]));
+}
+
+inline void putU16(char* p, uint16_t v) {
+    p[0] = static_cast<char>((v >> 8) & 0xff);
+    p[1] = static_cast<char>(v & 0xff);
+}
+
+inline uint16_t getU16(const char* p) {
+    return static_cast<uint16_t>((static_cast<uint8_t>(p[0]) << 8) | static_cast<uint8_t>(p[1]));
+}
+
+inline void putU64(char* p, uint64_t v) {
+    putU32(p, static_cast<uint32_t>(v >> 32));
+    putU32(p + 4, static_cast<uint32_t>(v));
+}
+
+inline uint64_t getU64(const char* p) {
+    return (static_cast<uint64_t>(getU32(p)) << 32) | getU32(p + 4);
+}
+
+// 将帧头编码到 out（至少 FRAME_HEADER_SIZE 字节）
+inline void encodeHeader(char* out, FrameType type, uint32_t length, uint32_t request_id,
+                         uint8_t flags = 0) {
+    out[0] = static_cast<char>(type);
+    out[1] = static_cast<char>(flags);
+    out[2] = 0;
+    out[3] = 0;
+    putU32(out + 4, length);
+    putU32(out + 8, request_id);
+}
+
+// 从 data 解码帧头，data 至少 FRAME_HEADER_SIZE 字节
+inline FrameHeader decodeHeader(const char* data) {
+    FrameHeader header;
+    header.type = static_cast<FrameType>(static_cast<uint8_t>(data[0]));
+    header.flags = static_cast<uint8_t>(data[1]);
+    header.length = getU32(data + 4);
+    header.request_id = getU32(data + 8);
+    return header;
+}
+
+// 追加一个完整帧到 out
+inline void appendFrame(std::string& out, FrameType type, uint32_t request_id,
+                        std::string_view payload) {
+    char header[FRAME_HEADER_SIZE];
+    encodeHeader(header, type, static_cast<uint32_t>(payload.size()), request_id);
+    out.append(header, FRAME_HEADER_SIZE);
+    out.append(payload);
+}
+
+// EXECUTE 帧负载的开头：句柄与参数个数，之后用 appendParam 逐个追加参数
+inline void beginExecute(std::string& payload, uint32_t handle, uint16_t count) {
+    char head[6];
+    putU32(head, handle);
+    putU16(head + 4, count);
+    payload.append(head, sizeof(head));
+}
+
+inline void appendParam(std::string& payload, int64_t value) {
+    char data[9];
+    data[0] = static_cast<char>(ParamType::INTEGER);
+    putU64(data + 1, static_cast<uint64_t>(value));
+    payload.append(data, sizeof(data));
+}
+
+inline void appendParam(std::string& payload, double value) {
+    char data[9];
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    data[0] = static_cast<char>(ParamType::REAL);
+    putU64(data + 1, bits);
+    payload.append(data, sizeof(data));
+}
+
+inline void appendParam(std::string& payload, std::string_view value) {
+    char data[5];
+    data[0] = static_cast<char>(ParamType::STRING);
+    putU32(data + 1, static_cast<uint32_t>(value.size()));
+    payload.append(data, sizeof(data));
+    payload.append(value);
+}
+
+// COPY 帧负载的开头：数据在文件中的起始行号（用于错误信息）与表名，之后直接追加 CSV 记录
+// 一个文件按记录边界切成多帧流水线发送，每帧独立解析并作为一次提交导入，各自应答 COPIED 或 ERROR
+inline void beginCopy(std::string& payload, uint64_t first_line, std::string_view table) {
+    char head[10];
+    putU64(head, first_line);
+    putU16(head + 8, static_cast<uint16_t>(table.size()));
+    payload.append(head, sizeof(head));
+    payload.append(table);
+}
+
+// 增量解析结果
+enum class ParseStatus {
+    COMPLETE,     // 解析出一个完整帧
+    NEED_MORE,    // 数据不足
+    INVALID       // 帧头非法（长度超限或类型未知）
+};
+
+// 尝试从 [data, data + size) 解析一个完整帧
+// 成功时 header/payload 被填充，consumed 为该帧占用的字节数
+inline ParseStatus parseFrame(const char* data, size_t size, FrameHeader& header,
+                              std::string_view& payload, size_t& consumed) {
+    if (size < FRAME_HEADER_SIZE) {
+        return ParseStatus::NEED_MORE;
+    }
+    header = decodeHeader(data);
+    if (header.length > MAX_FRAME_PAYLOAD ||
+        header.type < FrameType::HELLO || header.type > FrameType::COPIED) {
+        return ParseStatus::INVALID;
+    }
+    size_t total = FRAME_HEADER_SIZE + static_cast<size_t>(header.length);
+    if (size < total) {
+        return ParseStatus::NEED_MORE;
+    }
+    payload = std::string_view(data + FRAME_HEADER_SIZE, header.length);
+    consumed = total;
+    return ParseStatus::COMPLETE;
+}
+
+} // namespace protocol
+
+#endif // PROTOCOL_H
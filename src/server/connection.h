@@ -0,0 +1,81 @@
+#ifndef CONNECTION_H
+#define CONNECTION_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "common/arena.h"
+#include "common/buffer_pool.h"
+#include "protocol/protocol.h"
+#include "server/request.h"
+
+#define MAX_PREPARED_STATEMENTS 4096     // 每个连接可以准备的语句数上限
+#define CONN_MAX_PENDING 1024            // 每个连接未应答的请求上限，达到后暂停解析输入
+#define CONN_MAX_OUTPUT (4 << 20)        // 每个连接待发送的字节上限，达到后暂停解析输入
+#define CONN_RESUME_PENDING 512          // 暂停后未应答的请求与待发送的字节都降到这里以下才恢复
+#define CONN_RESUME_OUTPUT (1 << 20)
+
+// 单个客户端连接的状态对象
+// 由所属的 I/O 循环独占访问，不需要加锁；空闲连接不持有任何缓冲区
+struct Connection {
+    int fd;
+    int client_id;
+    std::string ip_address;
+    std::string client_name;
+    bool named = false;              // 是否已收到客户端名称
+    bool stop_reading = false;       // 已收到退出指令，不再解析后续请求
+    bool input_paused = false;       // 背压：应答堆积过多，暂停读取与解析，见 resume_input()
+    bool close_after_flush = false;  // 输出缓冲写完后关闭连接
+    bool closed = false;             // 套接字已关闭，等待执行中的请求返回后释放
+
+    // 尚未凑成完整帧的输入数据：小于一个 I/O 缓冲区时放在池化缓冲区中
+    IoBuffer* in_partial = nullptr;
+    std::string in_large;
+
+    // 待发送数据
+    OutputChain out;
+
+    // 请求作用域的内存，所有请求都应答后整体回收
+    Arena arena;
+
+    // 按到达顺序排列的未应答请求，应答严格按此顺序写出
+    StatementRequest* pending_head = nullptr;
+    StatementRequest* pending_tail = nullptr;
+    size_t pending_count = 0;
+    int executing = 0;               // 正在执行线程池中的请求数
+    int copying = 0;                 // 其中 COPY 数据块的个数
+    // 链表中第一个还没有交给线程池的请求：同一连接的语句按到达顺序逐条执行，
+    // 只有连续的 COPY 数据块可以同时执行。之后的请求都尚未提交
+    StatementRequest* waiting = nullptr;
+
+    // 本连接准备的语句，句柄为下标加一；执行中的请求各自持有一份引用
+    std::vector<std::shared_ptr<PreparedSlot>> prepared;
+
+    Connection(int sock, int id, std::string ip)
+        : fd(sock), client_id(id), ip_address(std::move(ip)) {}
+
+    ~Connection() {
+        if (in_partial) {
+            BufferPool::instance().release(in_partial);
+        }
+    }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    // 追加一个应答帧，由 I/O 循环负责真正写出
+    void reply(FrameType type, uint32_t request_id, std::string_view payload) {
+        FrameWriter writer(out, type, request_id);
+        writer << payload;
+        writer.finish();
+    }
+
+    bool hasPendingOutput() const {
+        return !out.empty();
+    }
+};
+
+#endif // CONNECTION_H
@@ -0,0 +1,95 @@
+#ifndef CONNECTION_REGISTRY_H
+#define CONNECTION_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#define REGISTRY_SHARDS 64
+
+// 客户端连接信息（用于 list 等跨连接查询）
+struct ClientInfo {
+    int socket;
+    int client_id;
+    std::string ip_address;
+
+    ClientInfo(int sock, int id, const std::string& ip)
+        : socket(sock), client_id(id), ip_address(ip) {}
+};
+
+// 按 client_id 分片的在线连接表
+// 插入/删除为 O(1)，只锁住一个分片；枚举逐个分片加读锁，不阻塞其他分片的写入；
+// 在线连接数用原子计数维护，准入检查不需要任何锁
+class ConnectionRegistry {
+private:
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<int, ClientInfo> clients;
+    };
+
+    std::array<Shard, REGISTRY_SHARDS> shards_;
+    std::atomic<size_t> count_{0};
+    size_t capacity_;
+
+    Shard& shardFor(int client_id) {
+        return shards_[static_cast<size_t>(client_id) % REGISTRY_SHARDS];
+    }
+
+public:
+    explicit ConnectionRegistry(size_t capacity) : capacity_(capacity) {}
+
+    // 准入并登记；已达到上限时返回 false
+    bool tryAdd(int client_id, int socket, const std::string& ip_address) {
+        size_t current = count_.load(std::memory_order_relaxed);
+        do {
+            if (current >= capacity_) {
+                return false;
+            }
+        } while (!count_.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+
+        Shard& shard = shardFor(client_id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.clients.try_emplace(client_id, socket, client_id, ip_address);
+        return true;
+    }
+
+    // 注销；返回是否存在
+    bool remove(int client_id) {
+        Shard& shard = shardFor(client_id);
+        size_t erased;
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            erased = shard.clients.erase(client_id);
+        }
+        if (erased) {
+            count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return erased > 0;
+    }
+
+    // 当前在线连接数
+    size_t size() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // 枚举所有在线连接；每次只持有一个分片的读锁，结果不是全局一致的快照
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto& [id, info] : shard.clients) {
+                fn(info);
+            }
+        }
+    }
+};
+
+#endif // CONNECTION_REGISTRY_H
@@ -0,0 +1,314 @@
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "server/event_loop.h"
+#include "server/session.h"
+#include "log/log.h"
+
+using enum LogModule;
+using enum LogLevel;
+
+EventLoop::EventLoop(int loop_id, int listen_fd)
+    : loop_id_(loop_id), listen_fd_(listen_fd) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        throw std::runtime_error("epoll_create1 失败: " + std::string(strerror(errno)));
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        close(epoll_fd_);
+        throw std::runtime_error("eventfd 创建失败: " + std::string(strerror(errno)));
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeup_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev);
+
+    // 监听套接字可能由所有循环共享，EPOLLEXCLUSIVE 避免惊群
+    ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+    ev.data.fd = listen_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev) < 0) {
+        close(wakeup_fd_);
+        close(epoll_fd_);
+        throw std::runtime_error("注册监听套接字失败: " + std::string(strerror(errno)));
+    }
+}
+
+EventLoop::~EventLoop() {
+    shutdownAll();
+    // 执行线程池已停止，回收投递回来但未处理的请求，随后释放所有僵尸连接
+    takeCompletions(completed_);
+    for (StatementRequest* req : completed_) {
+        complete_request(req);
+    }
+    zombies_.clear();
+    if (wakeup_fd_ >= 0) {
+        close(wakeup_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+}
+
+void EventLoop::wakeup() {
+    uint64_t one = 1;
+    auto ret = write(wakeup_fd_, &one, sizeof(one));
+    (void)ret;
+}
+
+void EventLoop::run() {
+    epoll_event events[MAX_EPOLL_EVENTS];
+
+    while (server_running) {
+        int n = epoll_wait(epoll_fd_, events, MAX_EPOLL_EVENTS, -1);
+        countSyscall();
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(WARNING, NETWORK, "事件循环 %d epoll_wait 失败: %s", loop_id_, strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t mask = events[i].events;
+
+            if (fd == wakeup_fd_) {
+                uint64_t value;
+                while (read(wakeup_fd_, &value, sizeof(value)) > 0) {}
+                deliverCompletions();
+                continue;
+            }
+
+            if (fd == listen_fd_) {
+                acceptConnections();
+                continue;
+            }
+
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) {
+                continue;
+            }
+            Connection& conn = *it->second;
+
+            if (mask & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                handleRead(conn);
+                // handleRead 可能已关闭连接
+                if (connections_.find(fd) == connections_.end()) {
+                    continue;
+                }
+            }
+
+            if ((mask & EPOLLOUT) && flushOutput(conn) && conn.input_paused) {
+                handleRead(conn);
+            }
+        }
+    }
+}
+
+void EventLoop::acceptConnections() {
+    while (true) {
+        sockaddr_in address{};
+        socklen_t addrlen = sizeof(address);
+        countSyscall();
+        int new_socket = accept4(listen_fd_, reinterpret_cast<sockaddr*>(&address), &addrlen,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (new_socket < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN) {
+                LOG(WARNING, NETWORK, "接受连接失败: %s", strerror(errno));
+            }
+            return;
+        }
+        countAccept();
+
+        // 应答已按读取轮次合并写出，关闭 Nagle 算法，流水线客户端的应答不必等待延迟确认
+        int one = 1;
+        setsockopt(new_socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        countSyscall();
+
+        // 获取客户端IP地址
+        char client_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &(address.sin_addr), client_ip, INET_ADDRSTRLEN);
+        int client_port = ntohs(address.sin_port);
+
+        int client_id = ++client_counter;
+        auto conn = std::make_unique<Connection>(
+            new_socket, client_id, std::string(client_ip) + ":" + std::to_string(client_port)
+        );
+
+        // 检查是否达到最大客户端数
+        if (!register_client(*conn)) {
+            reject_connection(new_socket);
+            continue;
+        }
+
+        // 边缘触发：一次注册读写事件，之后不再修改
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = new_socket;
+        countSyscall();
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, new_socket, &ev) < 0) {
+            LOG(WARNING, NETWORK, "注册客户端套接字失败: %s", strerror(errno));
+            unregister_client(*conn);
+            close(new_socket);
+            continue;
+        }
+
+        safe_cout("新客户端连接，ID:" + std::to_string(client_id) +
+                  " [" + conn->ip_address + "] 事件循环:" + std::to_string(loop_id_));
+        connections_.emplace(new_socket, std::move(conn));
+    }
+}
+
+void EventLoop::handleRead(Connection& conn) {
+    for (;;) {
+        // 背压暂停期间不读套接字，数据留在内核缓冲区中（边缘触发，恢复时主动接着读到 EAGAIN）
+        if (conn.input_paused) {
+            if (!input_resumable(conn)) {
+                return;
+            }
+            int frames = resume_input(*this, conn);
+            if (frames < 0) {
+                closeConnection(conn);
+                return;
+            }
+            countRequests(static_cast<uint64_t>(frames));
+        }
+        if (!conn.input_paused && !conn.stop_reading && !readInput(conn)) {
+            return;
+        }
+        // 写出后待发送的数据可能已降到低水位以下，这时不会再有 EPOLLOUT，直接在这里恢复
+        if (!flushOutput(conn) || !conn.input_paused || !input_resumable(conn)) {
+            return;
+        }
+    }
+}
+
+bool EventLoop::readInput(Connection& conn) {
+    int fd = conn.fd;
+
+    // 边缘触发模式下必须读到 EAGAIN 为止；本轮解析出的所有帧的应答合并为一次写出
+    while (true) {
+        auto valread = read(fd, read_buffer_, READ_BUFFER_SIZE);
+        countSyscall();
+        if (valread > 0) {
+            int frames = consume_input(*this, conn, read_buffer_, static_cast<size_t>(valread));
+            if (frames < 0) {
+                closeConnection(conn);
+                return false;
+            }
+            countRequests(static_cast<uint64_t>(frames));
+            if (conn.stop_reading || conn.input_paused) {
+                break;
+            }
+            continue;
+        }
+
+        if (valread == 0) {
+            std::string disconnect_msg = "客户端 [" + conn.client_name +
+                                         "] ID:" + std::to_string(conn.client_id) + " 断开连接";
+            LOG(INFO, NETWORK, "%s", disconnect_msg.c_str());
+            closeConnection(conn);
+            return false;
+        }
+
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN) {
+            std::string error_msg = "从客户端 [" + conn.client_name +
+                                   "] ID:" + std::to_string(conn.client_id) + " 读取数据失败";
+            LOG(WARNING, NETWORK, "%s", error_msg.c_str());
+            closeConnection(conn);
+            return false;
+        }
+        break;
+    }
+    return true;
+}
+
+// 把执行线程完成的请求交回各自连接，并合并写出
+void EventLoop::deliverCompletions() {
+    takeCompletions(completed_);
+    touched_.clear();
+    for (StatementRequest* req : completed_) {
+        Connection* conn = req->conn;
+        complete_request(req);   // req 已失效
+        if (!conn->closed) {
+            touched_.push_back(conn->fd);
+        } else if (conn->executing == 0) {
+            zombies_.erase(conn);
+        }
+    }
+
+    for (int fd : touched_) {
+        auto it = connections_.find(fd);
+        if (it != connections_.end() && flushOutput(*it->second) && it->second->input_paused) {
+            // 应答发出后可能降到低水位以下，恢复读取
+            handleRead(*it->second);
+        }
+    }
+}
+
+bool EventLoop::flushOutput(Connection& conn) {
+    iovec iov[MAX_WRITE_IOV];
+    while (conn.hasPendingOutput()) {
+        int count = conn.out.fillIov(iov, MAX_WRITE_IOV);
+        countSyscall();
+        auto sent = writev(conn.fd, iov, count);
+        if (sent > 0) {
+            conn.out.consume(static_cast<size_t>(sent));
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && errno == EAGAIN) {
+            // 等待 EPOLLOUT 再继续写
+            return true;
+        }
+        closeConnection(conn);
+        return false;
+    }
+
+    if (conn.close_after_flush) {
+        closeConnection(conn);
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::closeConnection(Connection& conn) {
+    int fd = conn.fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    int executing = release_pending(conn);
+    unregister_client(conn);
+    close(fd);
+
+    auto it = connections_.find(fd);
+    if (executing > 0) {
+        zombies_.emplace(&conn, std::move(it->second));
+    }
+    connections_.erase(it);
+}
+
+void EventLoop::shutdownAll() {
+    while (!connections_.empty()) {
+        closeConnection(*connections_.begin()->second);
+    }
+}
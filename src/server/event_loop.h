@@ -0,0 +1,60 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <atomic>
+#include "server/connection.h"
+#include "server/io_loop.h"
+
+#define READ_BUFFER_SIZE 65536
+#define MAX_EPOLL_EVENTS 256
+#define MAX_WRITE_IOV 64
+
+// 基于 epoll 的边缘触发事件循环，每个核心一个
+// 负责监听套接字上的 accept 以及所属连接的读写，连接只是一个状态对象而不再是线程
+class EventLoop : public IoLoop {
+private:
+    int loop_id_;
+    int listen_fd_;
+    int epoll_fd_ = -1;
+    int wakeup_fd_ = -1;   // eventfd，用于跨线程唤醒（如停止）
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    // 已关闭但仍有请求在执行的连接，请求全部返回后释放
+    std::unordered_map<Connection*, std::unique_ptr<Connection>> zombies_;
+    char read_buffer_[READ_BUFFER_SIZE];
+    std::vector<StatementRequest*> completed_;   // 复用的完成请求缓冲
+    std::vector<int> touched_;                   // 本轮有新应答的连接
+
+    void acceptConnections();
+    void deliverCompletions();
+    // 读取并处理输入；背压暂停的连接在降到低水位以下时先恢复（见 resume_input）
+    void handleRead(Connection& conn);
+    // 读到 EAGAIN、退出指令或背压暂停为止，连接被关闭时返回 false
+    bool readInput(Connection& conn);
+    // 写出待发送的数据，连接被关闭时返回 false
+    bool flushOutput(Connection& conn);
+    void closeConnection(Connection& conn);
+
+public:
+    EventLoop(int loop_id, int listen_fd);
+    ~EventLoop() override;
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // 运行事件循环直到 server_running 为 false
+    void run() override;
+
+    // 唤醒阻塞中的 epoll_wait
+    void wakeup() override;
+
+    // 关闭本循环持有的所有连接
+    void shutdownAll();
+
+    size_t connectionCount() const { return connections_.size(); }
+};
+
+#endif // EVENT_LOOP_H
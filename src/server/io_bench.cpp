@@ -0,0 +1,425 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "server/io_bench.h"
+#include "common/alloc_counter.h"
+#include "common/buffer_pool.h"
+#include "server/io_loop.h"
+#include "server/listener.h"
+#include "server/session.h"
+#include "server/uring_loop.h"
+#include "protocol/protocol.h"
+#include "log/log.h"
+
+namespace {
+
+// 压测请求：非 SQL 消息走回显路径，一定成功，测的是 I/O 路径而不是执行器的错误处理
+constexpr std::string_view BENCH_MESSAGE = "ping";
+
+struct BenchResult {
+    uint64_t requests = 0;
+    uint64_t syscalls = 0;
+    uint64_t allocations = 0;       // 压测阶段进程内的堆分配次数
+    double seconds = 0;
+    std::vector<uint64_t> latencies_ns;
+};
+
+bool write_full(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        auto sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        len -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool read_full(int fd, char* data, size_t len) {
+    while (len > 0) {
+        auto got = read(fd, data, len);
+        if (got <= 0) {
+            return false;
+        }
+        data += got;
+        len -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+// 发送一帧并读回应答，应答不是 RESULT（如 ERROR）也视为失败
+bool round_trip(int fd, const std::string& frame, std::string& payload) {
+    if (!write_full(fd, frame.data(), frame.size())) {
+        return false;
+    }
+    char raw[FRAME_HEADER_SIZE];
+    if (!read_full(fd, raw, FRAME_HEADER_SIZE)) {
+        return false;
+    }
+    FrameHeader header = protocol::decodeHeader(raw);
+    payload.resize(header.length);
+    return read_full(fd, payload.data(), payload.size()) && header.type == FrameType::RESULT;
+}
+
+// 所有客户端完成握手后同时开始压测，握手阶段的分配不计入统计
+struct StartGate {
+    std::atomic<int> arrived{0};
+    std::atomic<bool> open{false};
+
+    void arrive() { arrived.fetch_add(1); }
+    void wait() const {
+        while (!open.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// 单个客户端：逐条发送小请求并等待应答，记录每条请求的往返延迟
+// 压测循环内不做堆分配，分配计数只反映服务端
+void bench_client(uint16_t port, int requests, StartGate& gate, std::vector<uint64_t>& latencies) {
+    latencies.reserve(static_cast<size_t>(requests));
+    std::string payload;
+    std::string frame;
+    payload.reserve(256);
+    frame.reserve(256);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        gate.arrive();
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        gate.arrive();
+        close(fd);
+        return;
+    }
+
+    protocol::appendFrame(frame, FrameType::HELLO, 0, "bench");
+    bool ok = round_trip(fd, frame, payload);
+    gate.arrive();
+    if (!ok) {
+        close(fd);
+        return;
+    }
+    gate.wait();
+
+    for (int i = 0; i < requests; ++i) {
+        frame.clear();
+        protocol::appendFrame(frame, FrameType::QUERY, static_cast<uint32_t>(i + 1), BENCH_MESSAGE);
+        auto start = std::chrono::steady_clock::now();
+        if (!round_trip(fd, frame, payload)) {
+            break;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        latencies.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    close(fd);
+}
+
+// 在进程内运行的被测服务：若干事件循环及其监听套接字
+struct TestServer {
+    std::vector<int> listen_fds;
+    std::vector<std::unique_ptr<IoLoop>> loops;
+    std::vector<std::thread> threads;
+    uint16_t port = 0;
+
+    bool start(IoBackend backend, unsigned loop_count, ListenMode mode, int backlog) {
+        std::string error;
+        listen_fds = create_listen_sockets(0, backlog, mode, loop_count, error);
+        if (listen_fds.empty()) {
+            std::cerr << error << std::endl;
+            return false;
+        }
+        port = local_port(listen_fds[0]);
+
+        try {
+            for (unsigned i = 0; i < loop_count; ++i) {
+                loops.push_back(create_io_loop(backend, static_cast<int>(i), listen_fds[i]));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            loops.clear();
+            close_listen_sockets(listen_fds);
+            return false;
+        }
+
+        server_running = true;
+        for (auto& loop : loops) {
+            threads.emplace_back(&IoLoop::run, loop.get());
+        }
+        return true;
+    }
+
+    // 停止所有循环；统计数据在 release() 之前仍可读取
+    void stop() {
+        server_running = false;
+        for (auto& loop : loops) {
+            loop->wakeup();
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        threads.clear();
+    }
+
+    void release() {
+        loops.clear();
+        close_listen_sockets(listen_fds);
+        server_running = true;
+    }
+
+    uint64_t requests() const {
+        uint64_t total = 0;
+        for (auto& loop : loops) {
+            total += loop->requestCount();
+        }
+        return total;
+    }
+};
+
+bool run_backend(IoBackend backend, const IoBenchOptions& options, BenchResult& result) {
+    TestServer server;
+    if (!server.start(backend, options.loops, ListenMode::SHARED, options.backlog)) {
+        return false;
+    }
+
+    std::vector<std::vector<uint64_t>> per_client(static_cast<size_t>(options.connections));
+    StartGate gate;
+    std::vector<std::thread> clients_threads;
+    for (auto& latencies : per_client) {
+        clients_threads.emplace_back(bench_client, server.port, options.requests_per_connection,
+                                     std::ref(gate), std::ref(latencies));
+    }
+    while (gate.arrived.load() < options.connections) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    uint64_t requests_before = server.requests();
+    uint64_t allocations_before = allocation_count();
+    auto start = std::chrono::steady_clock::now();
+    gate.open.store(true, std::memory_order_release);
+    for (auto& t : clients_threads) {
+        t.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = allocation_count() - allocations_before;
+
+    server.stop();
+    result.requests = server.requests() - requests_before;
+    for (auto& loop : server.loops) {
+        result.syscalls += loop->syscallCount();
+    }
+    for (auto& latencies : per_client) {
+        result.latencies_ns.insert(result.latencies_ns.end(), latencies.begin(), latencies.end());
+    }
+    server.release();
+    return true;
+}
+
+// 连接建立测试的单个客户端统计
+struct AcceptClientStats {
+    int failed = 0;
+    std::vector<uint64_t> latencies_ns;   // connect 到收到欢迎消息的耗时
+};
+
+// 单个客户端：反复建立连接、完成 HELLO 握手后立即以 RST 关闭，避免客户端端口堆积在 TIME_WAIT
+void accept_client(uint16_t port, int attempts, StartGate& gate, AcceptClientStats& stats) {
+    stats.latencies_ns.reserve(static_cast<size_t>(attempts));
+    std::string frame;
+    std::string payload;
+    protocol::appendFrame(frame, FrameType::HELLO, 0, "bench");
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+    gate.arrive();
+    gate.wait();
+
+    for (int i = 0; i < attempts; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            ++stats.failed;
+            continue;
+        }
+        timeval timeout{2, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        linger abort_close{1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &abort_close, sizeof(abort_close));
+
+        bool ok = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+                  round_trip(fd, frame, payload);
+        close(fd);
+        if (!ok) {
+            ++stats.failed;
+            continue;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        stats.latencies_ns.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+}
+
+double percentile_us(std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[idx]) / 1000.0;
+}
+
+void print_result(const char* name, BenchResult& result) {
+    std::sort(result.latencies_ns.begin(), result.latencies_ns.end());
+    double requests = static_cast<double>(std::max<uint64_t>(result.requests, 1));
+    // 没有以 ENABLE_ALLOC_COUNTER 构建时不统计分配
+    char allocations[32] = "-";
+    if (allocation_counting) {
+        snprintf(allocations, sizeof(allocations), "%.3f", static_cast<double>(result.allocations) / requests);
+    }
+    printf("%-8s %12.0f %12.2f %12.2f %16.3f %12s\n", name,
+           static_cast<double>(result.latencies_ns.size()) / result.seconds,
+           percentile_us(result.latencies_ns, 0.50),
+           percentile_us(result.latencies_ns, 0.99),
+           static_cast<double>(result.syscalls) / requests,
+           allocations);
+}
+
+// 以给定的监听方式运行一轮连接建立测试并输出一行结果
+void run_accept_round(const char* name, IoBackend backend, unsigned loop_count, ListenMode mode,
+                      const IoBenchOptions& options) {
+    TestServer server;
+    if (!server.start(backend, loop_count, mode, options.backlog)) {
+        return;
+    }
+
+    std::vector<AcceptClientStats> per_client(static_cast<size_t>(options.connections));
+    StartGate gate;
+    std::vector<std::thread> clients_threads;
+    for (auto& stats : per_client) {
+        clients_threads.emplace_back(accept_client, server.port, options.accepts_per_client,
+                                     std::ref(gate), std::ref(stats));
+    }
+    while (gate.arrived.load() < options.connections) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    gate.open.store(true, std::memory_order_release);
+    for (auto& t : clients_threads) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server.stop();
+
+    // 各循环接受连接数的最小/最大值，反映内核分摊是否均匀
+    uint64_t min_accepts = UINT64_MAX;
+    uint64_t max_accepts = 0;
+    for (auto& loop : server.loops) {
+        min_accepts = std::min(min_accepts, loop->acceptCount());
+        max_accepts = std::max(max_accepts, loop->acceptCount());
+    }
+    server.release();
+
+    std::vector<uint64_t> latencies;
+    int failed = 0;
+    for (auto& stats : per_client) {
+        latencies.insert(latencies.end(), stats.latencies_ns.begin(), stats.latencies_ns.end());
+        failed += stats.failed;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    size_t listeners = mode == ListenMode::REUSEPORT ? loop_count : 1;
+    printf("%-10s %6u %10zu %12.0f %10.2f %10.2f %8d %8llu/%llu\n", name, loop_count, listeners,
+           static_cast<double>(latencies.size()) / seconds,
+           percentile_us(latencies, 0.50), percentile_us(latencies, 0.99), failed,
+           static_cast<unsigned long long>(min_accepts), static_cast<unsigned long long>(max_accepts));
+}
+
+} // namespace
+
+int run_io_benchmark(const IoBenchOptions& input) {
+    IoBenchOptions options = input;
+    if (options.loops == 0) {
+        options.loops = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // 关闭日志，只测量网络 I/O 路径
+    Logger::getInstance().setEnabled(false);
+
+    std::cout << "I/O 后端基准测试: " << options.connections << " 个连接 × "
+              << options.requests_per_connection << " 条请求, "
+              << options.loops << " 个事件循环" << std::endl;
+
+    BenchResult epoll_result;
+    BenchResult uring_result;
+    bool have_epoll = run_backend(IoBackend::EPOLL, options, epoll_result);
+
+    std::string reason;
+    bool have_uring = UringLoop::isSupported(reason) &&
+                      run_backend(IoBackend::URING, options, uring_result);
+    if (!have_uring && !reason.empty()) {
+        std::cout << "io_uring 不可用: " << reason << std::endl;
+    }
+
+    printf("%-8s %12s %12s %12s %16s %12s\n", "backend", "req/s", "p50(us)", "p99(us)",
+           "syscalls/req", "allocs/req");
+    if (have_epoll) {
+        print_result("epoll", epoll_result);
+    }
+    if (have_uring) {
+        print_result("io_uring", uring_result);
+    }
+
+    std::cout << "I/O 缓冲区池共分配 " << BufferPool::instance().allocated() << " 个缓冲区" << std::endl;
+
+    Logger::getInstance().setEnabled(true);
+    return have_epoll ? 0 : -1;
+}
+
+int run_accept_benchmark(const IoBenchOptions& input, IoBackend backend) {
+    IoBenchOptions options = input;
+    if (options.loops == 0) {
+        options.loops = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    Logger::getInstance().setEnabled(false);
+
+    std::cout << "连接建立基准测试 (" << (backend == IoBackend::URING ? "io_uring" : "epoll")
+              << "): " << options.connections << " 个客户端线程 × "
+              << options.accepts_per_client << " 次连接, backlog " << options.backlog << std::endl;
+    printf("%-10s %6s %10s %12s %10s %10s %8s %12s\n", "mode", "loops", "listeners", "conn/s",
+           "p50(us)", "p99(us)", "failed", "accepts/loop");
+
+    // 单个事件循环与单个监听套接字：原先一个 accept 循环的基线
+    run_accept_round("single", backend, 1, ListenMode::SHARED, options);
+    // 多个事件循环争用同一个监听套接字的接受队列
+    run_accept_round("shared", backend, options.loops, ListenMode::SHARED, options);
+    // 每个事件循环一个 SO_REUSEPORT 监听套接字
+    run_accept_round("reuseport", backend, options.loops, ListenMode::REUSEPORT, options);
+
+    Logger::getInstance().setEnabled(true);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef IO_BENCH_H
+#define IO_BENCH_H
+
+#include "server/io_loop.h"
+#include "server/listener.h"
+
+// I/O 后端基准测试参数
+struct IoBenchOptions {
+    int connections = 64;           // 并发连接数（每个连接一个客户端线程）
+    int requests_per_connection = 2000;
+    unsigned loops = 0;             // 事件循环数，0 表示按核心数
+    int backlog = DEFAULT_LISTEN_BACKLOG;
+    int accepts_per_client = 500;   // 连接建立测试中每个客户端线程建立的连接数
+};
+
+// 在进程内分别以 epoll 与 io_uring 后端启动服务，用本地客户端压测
+// 输出吞吐、p50/p99 延迟与每请求系统调用次数
+int run_io_benchmark(const IoBenchOptions& options);
+
+// 连接建立速率测试：客户端反复建连并完成 HELLO 握手，
+// 分别以单循环单套接字、多循环共享套接字、多循环 SO_REUSEPORT 套接字运行并对比
+int run_accept_benchmark(const IoBenchOptions& options, IoBackend backend);
+
+#endif // IO_BENCH_H
@@ -0,0 +1,10 @@
+#include "server/io_loop.h"
+#include "server/event_loop.h"
+#include "server/uring_loop.h"
+
+std::unique_ptr<IoLoop> create_io_loop(IoBackend backend, int loop_id, int listen_fd) {
+    if (backend == IoBackend::URING) {
+        return std::make_unique<UringLoop>(loop_id, listen_fd);
+    }
+    return std::make_unique<EventLoop>(loop_id, listen_fd);
+}
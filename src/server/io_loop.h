@@ -0,0 +1,77 @@
+#ifndef IO_LOOP_H
+#define IO_LOOP_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "server/request.h"
+
+// I/O 后端类型
+enum class IoBackend {
+    EPOLL,
+    URING
+};
+
+// 网络 I/O 循环的公共接口：epoll 与 io_uring 两种实现，每个核心一个
+class IoLoop {
+protected:
+    // 统计计数，只由本循环线程写入，其他线程只读
+    std::atomic<uint64_t> syscalls_{0};   // 网络相关系统调用次数
+    std::atomic<uint64_t> requests_{0};   // 处理的请求帧数
+    std::atomic<uint64_t> accepts_{0};    // 接受的连接数
+
+    void countSyscall(uint64_t n = 1) {
+        syscalls_.store(syscalls_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    void countRequests(uint64_t n) {
+        requests_.store(requests_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    void countAccept() {
+        accepts_.store(accepts_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // 执行线程投递回来的已完成请求
+    std::mutex completions_mutex_;
+    std::vector<StatementRequest*> completions_;
+
+    // 取出所有已完成请求（I/O 线程调用）
+    void takeCompletions(std::vector<StatementRequest*>& out) {
+        out.clear();
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        out.swap(completions_);
+    }
+
+public:
+    // 请求对象属于连接的 arena，由具体循环在析构时处理残留的完成请求
+    virtual ~IoLoop() = default;
+
+    // 执行线程完成请求后调用：加入完成队列，队列由空变非空时唤醒 I/O 线程
+    void postCompletion(StatementRequest* req) {
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(completions_mutex_);
+            was_empty = completions_.empty();
+            completions_.push_back(req);
+        }
+        if (was_empty) {
+            wakeup();
+        }
+    }
+
+    // 运行循环直到 server_running 为 false
+    virtual void run() = 0;
+
+    // 跨线程唤醒阻塞中的循环
+    virtual void wakeup() = 0;
+
+    uint64_t syscallCount() const { return syscalls_.load(std::memory_order_relaxed); }
+    uint64_t requestCount() const { return requests_.load(std::memory_order_relaxed); }
+    uint64_t acceptCount() const { return accepts_.load(std::memory_order_relaxed); }
+};
+
+// 创建指定后端的 I/O 循环，listen_fd 为非阻塞监听套接字（可能与其他循环共享）
+std::unique_ptr<IoLoop> create_io_loop(IoBackend backend, int loop_id, int listen_fd);
+
+#endif // IO_LOOP_H
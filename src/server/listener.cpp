@@ -0,0 +1,97 @@
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "server/listener.h"
+
+int create_listen_socket(uint16_t port, int backlog, bool nonblocking, std::string& error) {
+    int type = SOCK_STREAM | SOCK_CLOEXEC;
+    if (nonblocking) {
+        type |= SOCK_NONBLOCK;
+    }
+
+    // 创建socket文件描述符
+    int fd = socket(AF_INET, type, 0);
+    if (fd < 0) {
+        error = "Socket创建失败: " + std::string(strerror(errno));
+        return -1;
+    }
+
+    // 设置socket选项
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt))) {
+        error = "设置socket选项失败: " + std::string(strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+
+    // 绑定socket到地址和端口
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        error = "绑定端口失败: " + std::string(strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    // 开始监听连接
+    if (listen(fd, backlog) < 0) {
+        error = "监听失败: " + std::string(strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+std::vector<int> create_listen_sockets(uint16_t port, int backlog, ListenMode mode, size_t count,
+                                       std::string& error) {
+    std::vector<int> fds;
+    int first = create_listen_socket(port, backlog, true, error);
+    if (first < 0) {
+        return fds;
+    }
+    fds.push_back(first);
+
+    if (mode == ListenMode::SHARED) {
+        fds.resize(count, first);
+        return fds;
+    }
+
+    // 其余套接字绑定到第一个套接字实际使用的端口，加入同一个 SO_REUSEPORT 组
+    uint16_t bound_port = local_port(first);
+    for (size_t i = 1; i < count; ++i) {
+        int fd = create_listen_socket(bound_port, backlog, true, error);
+        if (fd < 0) {
+            close_listen_sockets(fds);
+            return fds;
+        }
+        fds.push_back(fd);
+    }
+    return fds;
+}
+
+void close_listen_sockets(std::vector<int>& fds) {
+    int last = -1;
+    for (int fd : fds) {
+        if (fd != last) {
+            close(fd);
+        }
+        last = fd;
+    }
+    fds.clear();
+}
+
+uint16_t local_port(int fd) {
+    sockaddr_in address{};
+    socklen_t len = sizeof(address);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &len) < 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
@@ -0,0 +1,32 @@
+#ifndef LISTENER_H
+#define LISTENER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define DEFAULT_LISTEN_BACKLOG 4096
+
+// 监听方式
+enum class ListenMode {
+    SHARED,      // 所有事件循环共享一个监听套接字
+    REUSEPORT    // 每个事件循环一个 SO_REUSEPORT 监听套接字，由内核分摊新连接
+};
+
+// 创建绑定到 port 的监听套接字（SO_REUSEADDR | SO_REUSEPORT）
+// port 为 0 时由内核分配端口；失败返回 -1，并在 error 中给出原因
+int create_listen_socket(uint16_t port, int backlog, bool nonblocking, std::string& error);
+
+// 按监听方式为 count 个事件循环创建非阻塞监听套接字，返回的第 i 个供第 i 个循环使用
+// SHARED 模式下所有元素为同一个描述符；port 为 0 时所有套接字绑定到内核分配的同一端口
+// 失败返回空数组并关闭已创建的套接字
+std::vector<int> create_listen_sockets(uint16_t port, int backlog, ListenMode mode, size_t count,
+                                       std::string& error);
+
+// 关闭 create_listen_sockets 返回的套接字（共享的描述符只关闭一次）
+void close_listen_sockets(std::vector<int>& fds);
+
+// 查询套接字实际绑定的端口
+uint16_t local_port(int fd);
+
+#endif // LISTENER_H
@@ -0,0 +1,85 @@
+#ifndef REQUEST_H
+#define REQUEST_H
+
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "common/buffer_pool.h"
+#include "protocol/protocol.h"
+
+class IoLoop;
+struct Connection;
+struct PreparedStatement;
+
+// 连接上准备的一条语句：PREPARE 在 I/O 线程上按到达顺序占好句柄，执行线程解析后填入。
+// 同一连接的请求按到达顺序逐条执行，之后的 EXECUTE 开始执行时解析一定已经结束
+struct PreparedSlot {
+    std::shared_ptr<const PreparedStatement> statement;   // 解析失败时为空
+};
+
+// 一条交给执行线程池处理的语句请求
+// 由 I/O 线程在连接的 arena 中创建，执行线程只读 sql 等上下文并把完整的应答帧写入 response，
+// 完成后投递回所属 IoLoop；请求对象始终由所属 I/O 线程析构。
+// 连接在仍有请求执行时关闭，会被保留到这些请求全部返回，因此 conn/sql/client_name 始终有效。
+struct StatementRequest {
+    // 执行所需的上下文（创建后只读）
+    IoLoop* loop;
+    Connection* conn;
+    int client_id;
+    uint32_t request_id;
+    std::string_view client_name;
+    std::string_view sql;            // 指向连接 arena 中的拷贝；EXECUTE 请求为参数部分
+    std::shared_ptr<PreparedSlot> prepared;  // EXECUTE 请求要执行的语句；PREPARE 请求解析后填入
+    uint32_t prepare_handle = 0;     // 非 0 时为 PREPARE 请求，sql 为要准备的语句
+    bool copy = false;               // COPY 请求，负载在 copy_data 中
+    std::string copy_data;           // 数据块较大且连续到达，不放入 arena，随请求释放
+    StatementRequest* batch_next = nullptr;  // 同一任务中接着执行的请求（提交前设置）
+
+    // 执行结果：一个或多个完整应答帧，缓冲区取自全局池（执行线程写入）
+    OutputChain response;
+
+    // 以下字段只由 I/O 线程访问
+    StatementRequest* next = nullptr;   // 连接的待应答链表
+    bool done = false;                  // 结果已回到 I/O 线程
+    bool closes_connection = false;     // 应答发出后关闭连接（quit/exit）
+};
+
+// 把一个应答帧直接写入输出链：先预留帧头，写完负载后回填长度
+class FrameWriter {
+public:
+    FrameWriter(OutputChain& out, FrameType type, uint32_t request_id)
+        : out_(out), type_(type), request_id_(request_id),
+          header_(out.reserve(FRAME_HEADER_SIZE)), start_(out.size()) {}
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    FrameWriter& operator<<(std::string_view text) {
+        out_.append(text);
+        return *this;
+    }
+
+    FrameWriter& operator<<(long value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out_.append(digits, static_cast<size_t>(result.ptr - digits));
+        return *this;
+    }
+
+    // 回填帧头
+    void finish() {
+        protocol::encodeHeader(header_, type_, static_cast<uint32_t>(out_.size() - start_),
+                               request_id_);
+    }
+
+private:
+    OutputChain& out_;
+    FrameType type_;
+    uint32_t request_id_;
+    char* header_;
+    size_t start_;
+};
+
+#endif // REQUEST_H
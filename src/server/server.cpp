@@ -1,306 +1,301 @@
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <cstring>
+#include <cstdlib>
 #include <vector>
 #include <memory>
 #include <thread>
-#include <mutex>
-#include <atomic>
+#include <csignal>
 #include <sys/socket.h>
-#include <netinet/in.h>
+#include <sys/resource.h>
 #include <unistd.h>
-#include <arpa/inet.h>
 #include "log/log.h"
+#include "server/session.h"
+#include "server/io_loop.h"
+#include "server/uring_loop.h"
+#include "server/listener.h"
+#include "server/io_bench.h"
+#include "storage/wal.h"
 
 #define PORT 8123
-#define MAX_CLIENTS 100
-#define BUFFER_SIZE 1024
+#define DEFAULT_CHECKPOINT_SECONDS 300   // 自动写检查点的默认间隔
 
-using enum LogModule;
-using enum LogLevel;
-
-// 客户端连接信息
-struct ClientInfo {
-    int socket;
-    int client_id;
-    std::string ip_address;
-    std::thread thread;
-    
-    ClientInfo(int sock, int id, const std::string& ip) 
-        : socket(sock), client_id(id), ip_address(ip) {}
-    
-    ~ClientInfo() {
-        if (thread.joinable()) {
-            thread.detach();
-        }
+// 将文件描述符软限制提升到硬限制，以支持大量空闲连接
+static void raise_fd_limit() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
     }
-};
-
-// 全局变量
-std::vector<std::shared_ptr<ClientInfo>> clients;
-std::mutex clients_mutex;
-std::atomic<int> client_counter{0};
-std::atomic<bool> server_running{true};
-std::mutex cout_mutex;  // 保护标准输出
+}
 
-// 线程安全的输出
-void safe_cout(const std::string& message) {
-    std::lock_guard<std::mutex> lock(cout_mutex);
-    std::cout << message << std::endl;
+static void print_usage(const char* program) {
+    std::cout << "用法: " << program << " [选项]\n"
+              << "  --io=epoll|uring         选择网络 I/O 后端（默认 epoll）\n"
+              << "  --workers=N              语句执行线程数（默认按核心数）\n"
+              << "  --pin-workers            把执行线程绑定到 CPU 核心\n"
+              << "  --query-threads=N        单条大查询的并行线程数（默认按核心数，1 表示不并行）\n"
+              << "  --reuseport              每个事件循环一个 SO_REUSEPORT 监听套接字\n"
+              << "  --backlog=N              监听队列长度（默认 " << DEFAULT_LISTEN_BACKLOG << "）\n"
+              << "  --wal-dir=PATH           在 PATH 下写预写日志，启动时回放（默认不写日志）\n"
+              << "  --wal-sync=group|each    组提交（默认）或每次提交各自 fdatasync\n"
+              << "  --wal-delay-us=N         组提交时等待更多提交加入本组的最长时间（默认 0）\n"
+              << "  --wal-group-kb=N         组累积到 N KB 时立即刷盘（默认 1024）\n"
+              << "  --wal-segment-mb=N       日志段文件大小（默认 64）\n"
+              << "  --checkpoint-interval=N  每 N 秒写一次检查点并截断日志，0 表示只在关闭时与 checkpoint 命令时写\n"
+              << "                           （默认 " << DEFAULT_CHECKPOINT_SECONDS << "，需要 --wal-dir）\n"
+              << "  --log-level=SPEC         日志级别，LEVEL 或 MODULE=LEVEL,...（如 INFO,NETWORK=WARNING），\n"
+              << "                           运行中可用 loglevel 命令修改（默认记录全部级别）\n"
+              << "  --log-binary=PATH        日志以二进制写入 PATH，格式化推迟到用 log_decode 查看时（默认文本 simple.log）\n"
+              << "  --bench                  运行 I/O 后端基准测试后退出\n"
+              << "  --bench-accept           运行连接建立速率基准测试后退出\n"
+              << "  --bench-connections=N    基准测试并发连接数（客户端线程数）\n"
+              << "  --bench-requests=N       基准测试每个连接的请求数\n"
+              << "  --bench-accepts=N        连接建立测试中每个客户端线程的连接数\n"
+              << "  --bench-loops=N          基准测试事件循环数（默认按核心数）\n";
 }
 
-// 处理单个客户端的函数
-void handle_client(int client_socket, int client_id, const std::string& client_ip) {
-    char buffer[BUFFER_SIZE] = {0};
-    char client_name[BUFFER_SIZE];
-    
-    // 首次读取客户端名称
-    auto name_read = read(client_socket, client_name, BUFFER_SIZE - 1);
-    if (name_read <= 0) {
-        close(client_socket);
-        return;
+// 服务器主函数
+int main(int argc, char* argv[]) {
+    IoBackend backend = IoBackend::EPOLL;
+    bool bench = false;
+    bool bench_accept = false;
+    ListenMode listen_mode = ListenMode::SHARED;
+    int backlog = DEFAULT_LISTEN_BACKLOG;
+    size_t workers = 0;
+    bool pin_workers = false;
+    size_t query_threads = 0;
+    IoBenchOptions bench_options;
+    WalOptions wal_options;
+    long checkpoint_seconds = DEFAULT_CHECKPOINT_SECONDS;
+    std::string binary_log;
+    std::string log_levels;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--io=epoll") {
+            backend = IoBackend::EPOLL;
+        } else if (arg == "--io=uring") {
+            backend = IoBackend::URING;
+        } else if (arg.starts_with("--workers=")) {
+            workers = static_cast<size_t>(atoi(arg.c_str() + strlen("--workers=")));
+        } else if (arg == "--pin-workers") {
+            pin_workers = true;
+        } else if (arg.starts_with("--query-threads=")) {
+            query_threads = static_cast<size_t>(atoi(arg.c_str() + strlen("--query-threads=")));
+        } else if (arg == "--reuseport") {
+            listen_mode = ListenMode::REUSEPORT;
+        } else if (arg.starts_with("--backlog=")) {
+            backlog = atoi(arg.c_str() + strlen("--backlog="));
+        } else if (arg.starts_with("--wal-dir=")) {
+            wal_options.directory = arg.substr(strlen("--wal-dir="));
+        } else if (arg == "--wal-sync=group") {
+            wal_options.sync = WalSyncMode::GROUP;
+        } else if (arg == "--wal-sync=each") {
+            wal_options.sync = WalSyncMode::EACH;
+        } else if (arg.starts_with("--wal-delay-us=")) {
+            wal_options.group_delay_us = static_cast<uint32_t>(atoi(arg.c_str() + strlen("--wal-delay-us=")));
+        } else if (arg.starts_with("--wal-group-kb=")) {
+            wal_options.group_bytes = static_cast<size_t>(atoi(arg.c_str() + strlen("--wal-group-kb="))) << 10;
+        } else if (arg.starts_with("--wal-segment-mb=")) {
+            wal_options.segment_bytes = static_cast<size_t>(atoi(arg.c_str() + strlen("--wal-segment-mb="))) << 20;
+        } else if (arg.starts_with("--checkpoint-interval=")) {
+            checkpoint_seconds = atol(arg.c_str() + strlen("--checkpoint-interval="));
+        } else if (arg.starts_with("--log-level=")) {
+            log_levels = arg.substr(strlen("--log-level="));
+        } else if (arg.starts_with("--log-binary=")) {
+            binary_log = arg.substr(strlen("--log-binary="));
+        } else if (arg == "--bench") {
+            bench = true;
+        } else if (arg == "--bench-accept") {
+            bench_accept = true;
+        } else if (arg.starts_with("--bench-loops=")) {
+            bench_options.loops = static_cast<unsigned>(atoi(arg.c_str() + strlen("--bench-loops=")));
+        } else if (arg.starts_with("--bench-accepts=")) {
+            bench_options.accepts_per_client = atoi(arg.c_str() + strlen("--bench-accepts="));
+        } else if (arg.starts_with("--bench-connections=")) {
+            bench_options.connections = atoi(arg.c_str() + strlen("--bench-connections="));
+        } else if (arg.starts_with("--bench-requests=")) {
+            bench_options.requests_per_connection = atoi(arg.c_str() + strlen("--bench-requests="));
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : -1;
+        }
     }
-    client_name[name_read] = '\0';
-    
-    std::string welcome_msg = "客户端 [" + std::string(client_name) + 
-                              "] ID:" + std::to_string(client_id) + 
-                              " 已连接 (" + client_ip + ")";
-    LOG(INFO, NETWORK, "%s", welcome_msg.c_str());
-    
-    // 发送欢迎消息
-    std::string welcome_client = "欢迎 " + std::string(client_name) + 
-                                 "! 你是第 " + std::to_string(client_id) + 
-                                 " 个连接。发送 'quit' 或 'exit' 退出。";
-    send(client_socket, welcome_client.c_str(), welcome_client.length(), 0);
-    
-    // 处理客户端消息循环
-    while (server_running) {
+
+    if (!binary_log.empty() || !log_levels.empty()) {
         try {
-        memset(buffer, 0, BUFFER_SIZE);
-        
-        // 接收客户端消息
-        auto valread = read(client_socket, buffer, BUFFER_SIZE - 1);
-        if (valread <= 0) {
-            if (valread == 0) {
-                std::string disconnect_msg = "客户端 [" + std::string(client_name) + 
-                                             "] ID:" + std::to_string(client_id) + " 断开连接";
-                LOG(INFO, NETWORK, "%s", disconnect_msg.c_str());
-            } else {
-                std::string error_msg = "从客户端 [" + std::string(client_name) + 
-                                       "] ID:" + std::to_string(client_id) + " 读取数据失败";
-                LOG(WARNING, NETWORK, "%s", error_msg.c_str());
-            }
-            break;
-        }
-        
-        std::string msg_str(buffer);
-        std::string log_msg = "来自 [" + std::string(client_name) + 
-                             "] ID:" + std::to_string(client_id) + " 的消息: " + msg_str;
-        LOG(INFO, NETWORK, "%s", log_msg.c_str());
-        
-        // 检查是否收到退出指令
-        if (msg_str == "quit" || msg_str == "exit") {
-            std::string goodbye_msg = "再见，" + std::string(client_name) + "!";
-            send(client_socket, goodbye_msg.c_str(), goodbye_msg.length(), 0);
-            
-            std::string leave_msg = "客户端 [" + std::string(client_name) + 
-                                   "] ID:" + std::to_string(client_id) + " 主动退出";
-            LOG(INFO, NETWORK, "%s", leave_msg.c_str());
-            break;
-        }
-        
-        // 处理特殊指令
-        if (msg_str == "list") {
-            std::lock_guard<std::mutex> lock(clients_mutex);
-            std::string list_msg = "当前在线客户端 (" + std::to_string(clients.size()) + " 个):\n";
-            for (const auto& client : clients) {
-                if (client->socket != client_socket) {
-                    list_msg += "  ID:" + std::to_string(client->client_id) + 
-                               " [" + client->ip_address + "]\n";
-                }
-            }
-            if (clients.size() <= 1) {
-                list_msg += "  没有其他客户端在线\n";
+            Logger::getInstance().configureLevels(log_levels);
+            if (!binary_log.empty()) {
+                Logger::getInstance().setLogFile(binary_log, LogFileFormat::BINARY);
             }
-            send(client_socket, list_msg.c_str(), list_msg.length(), 0);
-            continue;
-        }
-
-        // 模拟错误
-        if (msg_str == "error;") {
-            LOG(ERROR, NETWORK, "模拟错误触发于客户端 [%s] ID:%d", client_name, client_id);
-        }
-        
-        if (msg_str == "help") {
-            std::string help_msg = "可用命令:\n"
-                                  "  help     - 显示帮助信息\n"
-                                  "  list     - 显示在线客户端列表\n"
-                                  "  quit/exit - 退出连接\n"
-                                  "  其他消息 - 服务器会回显您的消息";
-            send(client_socket, help_msg.c_str(), help_msg.length(), 0);
-            continue;
-        }
-        
-        // 普通消息：回显给客户端
-        std::string echo_msg = "服务器回显: " + msg_str;
-        send(client_socket, echo_msg.c_str(), echo_msg.length(), 0);
         } catch (const std::exception& e) {
-            std::string error_log = "处理客户端 [" + std::string(client_name) + 
-                                    "] ID:" + std::to_string(client_id) + 
-                                    " 时发生异常: " + e.what();
-            safe_cout(error_log);
-            send(client_socket, e.what(), strlen(e.what()), 0);
+            std::cerr << e.what() << std::endl;
+            return -1;
         }
     }
-    
-    // 清理客户端连接
-    {
-        std::lock_guard<std::mutex> lock(clients_mutex);
-        for (auto it = clients.begin(); it != clients.end(); ++it) {
-            if ((*it)->socket == client_socket) {
-                clients.erase(it);
-                break;
-            }
+
+    raise_fd_limit();
+    signal(SIGPIPE, SIG_IGN);
+
+    // I/O 线程只负责收发，语句交给执行线程池
+    init_statement_executor(workers, query_threads, pin_workers);
+
+    if (bench) {
+        bench_options.backlog = backlog;
+        int ret = run_io_benchmark(bench_options);
+        shutdown_statement_executor();
+        return ret;
+    }
+
+    // 内核不支持 io_uring 时回退到 epoll
+    if (backend == IoBackend::URING) {
+        std::string reason;
+        if (!UringLoop::isSupported(reason)) {
+            std::cout << "io_uring 不可用 (" << reason << ")，回退到 epoll" << std::endl;
+            backend = IoBackend::EPOLL;
         }
     }
-    
-    // 输出当前客户端数量
-    {
-        std::lock_guard<std::mutex> lock(clients_mutex);
-        std::string count_msg = "当前在线客户端数量: " + std::to_string(clients.size());
-        safe_cout(count_msg);
+
+    if (bench_accept) {
+        bench_options.backlog = backlog;
+        int ret = run_accept_benchmark(bench_options, backend);
+        shutdown_statement_executor();
+        return ret;
     }
-    
-    close(client_socket);
-}
 
-// 清理已完成的线程
-void cleanup_threads() {
-    std::lock_guard<std::mutex> lock(clients_mutex);
-    auto it = clients.begin();
-    while (it != clients.end()) {
-        if (!(*it)->thread.joinable()) {
-            it = clients.erase(it);
-        } else {
-            ++it;
+    // 屏蔽退出信号，由主线程通过 sigwait 统一处理；之后创建的线程继承该屏蔽字
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+    // 先从检查点映射各表，再打开预写日志回放检查点之后的记录；刷盘线程在屏蔽信号之后创建
+    std::unique_ptr<WriteAheadLog> wal;
+    if (!wal_options.directory.empty()) {
+        checkpoint_path = wal_options.directory + "/" + CHECKPOINT_FILE_NAME;
+        auto replay_start = std::chrono::steady_clock::now();
+        CheckpointStats checkpoint;
+        try {
+            if (database_catalog.loadCheckpoint(checkpoint_path, checkpoint)) {
+                std::cout << "检查点: 映射 " << checkpoint.tables << " 张表 " << checkpoint.rows << " 行 ("
+                          << (checkpoint.bytes >> 20) << " MB"
+                          << (checkpoint.relocated ? "，映射地址已变，字符串指针已修正" : "")
+                          << ")，日志从 LSN " << checkpoint.lsn << " 开始回放" << std::endl;
+            }
+            wal_options.start_lsn = checkpoint.lsn;
+            wal = std::make_unique<WriteAheadLog>(wal_options, [](uint8_t type, std::string_view payload) {
+                database_catalog.replay(type, payload);
+            });
+        } catch (const std::exception& e) {
+            std::cerr << "恢复失败: " << e.what() << std::endl;
+            shutdown_statement_executor();
+            return -1;
         }
+        auto replay_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - replay_start).count();
+        WalStats wal_stats = wal->stats();
+        std::cout << "预写日志: " << wal_options.directory << "，回放 " << wal_stats.replayed
+                  << " 条记录（跳过检查点中已有的 " << wal_stats.skipped << " 条），恢复 "
+                  << database_catalog.tableCount() << " 张表，耗时 " << replay_ms << " ms" << std::endl;
+        database_catalog.attachLog(wal.get());
     }
-}
 
-// 服务器主函数
-int main() {
-    int server_fd, new_socket;
-    struct sockaddr_in address;
-    int opt = 1;
-    int addrlen = sizeof(address);
-    
-    // 创建socket文件描述符
-    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
-        std::cerr << "Socket创建失败" << std::endl;
-        return -1;
+    // 定期写检查点：写入期间读写照常进行，完成后删除已被覆盖的日志段
+    std::mutex checkpoint_mutex;
+    std::condition_variable checkpoint_cond;
+    bool checkpoint_stop = false;
+    std::thread checkpoint_thread;
+    if (wal && checkpoint_seconds > 0) {
+        checkpoint_thread = std::thread([&]() {
+            std::unique_lock<std::mutex> lock(checkpoint_mutex);
+            while (!checkpoint_cond.wait_for(lock, std::chrono::seconds(checkpoint_seconds),
+                                             [&]() { return checkpoint_stop; })) {
+                lock.unlock();
+                run_checkpoint();
+                lock.lock();
+            }
+        });
     }
-    
-    // 设置socket选项
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt))) {
-        std::cerr << "设置socket选项失败" << std::endl;
-        return -1;
+
+    // 每个核心一个事件循环
+    unsigned loop_count = std::thread::hardware_concurrency();
+    if (loop_count == 0) {
+        loop_count = 1;
     }
-    
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(PORT);
-    
-    // 绑定socket到地址和端口
-    if (bind(server_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
-        std::cerr << "绑定端口失败" << std::endl;
-        close(server_fd);
+
+    std::string error;
+    std::vector<int> listen_fds = create_listen_sockets(PORT, backlog, listen_mode, loop_count, error);
+    if (listen_fds.empty()) {
+        std::cerr << error << std::endl;
+        shutdown_statement_executor();
         return -1;
     }
-    
-    // 开始监听连接
-    if (listen(server_fd, 10) < 0) {  // 增加等待队列长度
-        std::cerr << "监听失败" << std::endl;
-        close(server_fd);
+
+    std::vector<std::unique_ptr<IoLoop>> loops;
+    try {
+        for (unsigned i = 0; i < loop_count; ++i) {
+            loops.push_back(create_io_loop(backend, static_cast<int>(i), listen_fds[i]));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        loops.clear();
+        close_listen_sockets(listen_fds);
+        shutdown_statement_executor();
         return -1;
     }
-    
+
+    std::vector<std::thread> loop_threads;
+    for (auto& loop : loops) {
+        loop_threads.emplace_back(&IoLoop::run, loop.get());
+    }
+
     std::cout << "服务器已启动，监听端口 " << PORT << "..." << std::endl;
-    std::cout << "支持最多 " << MAX_CLIENTS << " 个客户端同时连接" << std::endl;
+    std::cout << "I/O 后端: " << (backend == IoBackend::URING ? "io_uring" : "epoll")
+              << "，事件循环数: " << loop_count
+              << "，监听套接字数: " << (listen_mode == ListenMode::REUSEPORT ? loop_count : 1)
+              << " (backlog " << backlog << ")"
+              << "，支持最多 " << MAX_CLIENTS << " 个客户端同时连接" << std::endl;
     std::cout << "等待客户端连接..." << std::endl;
-    
-    // 主循环：接受客户端连接
-    while (server_running) {
-        // 接受客户端连接
-        new_socket = accept(server_fd, reinterpret_cast<sockaddr*>(&address), reinterpret_cast<socklen_t*>(&addrlen));
-        if (new_socket < 0) {
-            if (!server_running) {
-                break;  // 服务器正在关闭
-            }
-            std::cerr << "接受连接失败" << std::endl;
-            continue;
-        }
-        
-        // 检查是否达到最大客户端数
-        {
-            std::lock_guard<std::mutex> lock(clients_mutex);
-            if (clients.size() >= MAX_CLIENTS) {
-                std::string reject_msg = "服务器已达到最大客户端数限制 (" + 
-                                        std::to_string(MAX_CLIENTS) + ")";
-                send(new_socket, reject_msg.c_str(), reject_msg.length(), 0);
-                close(new_socket);
-                std::cout << "拒绝新连接：已达到最大客户端数限制" << std::endl;
-                continue;
-            }
-        }
-        
-        // 获取客户端IP地址
-        char client_ip[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &(address.sin_addr), client_ip, INET_ADDRSTRLEN);
-        int client_port = ntohs(address.sin_port);
-        
-        // 创建客户端ID
-        int client_id = ++client_counter;
-        
-        // 创建客户端信息
-        auto client_info = std::make_shared<ClientInfo>(
-            new_socket, client_id, std::string(client_ip) + ":" + std::to_string(client_port)
-        );
-        
-        // 创建线程处理客户端
-        client_info->thread = std::thread(
-            handle_client, 
-            new_socket, 
-            client_id, 
-            client_info->ip_address
-        );
-        client_info->thread.detach();  // 分离线程
-        
-        // 添加到客户端列表
+
+    // 等待退出信号
+    int sig = 0;
+    sigwait(&stop_signals, &sig);
+    server_running = false;
+
+    std::cout << "等待所有客户端断开连接..." << std::endl;
+    for (auto& loop : loops) {
+        loop->wakeup();
+    }
+    for (auto& t : loop_threads) {
+        t.join();
+    }
+
+    // 先停止执行线程（仍在执行的请求会投递到已停止的循环），再关闭所有连接并清理资源
+    shutdown_statement_executor();
+    loops.clear();
+    close_listen_sockets(listen_fds);
+
+    if (checkpoint_thread.joinable()) {
         {
-            std::lock_guard<std::mutex> lock(clients_mutex);
-            clients.push_back(client_info);
+            std::lock_guard<std::mutex> lock(checkpoint_mutex);
+            checkpoint_stop = true;
         }
-        
-        std::cout << "新客户端连接，ID:" << client_id 
-                 << " [" << client_info->ip_address << "]" 
-                 << " 当前客户端数: " << clients.size() << std::endl;
+        checkpoint_cond.notify_one();
+        checkpoint_thread.join();
     }
-    
-    // 等待所有客户端线程结束
-    std::cout << "等待所有客户端断开连接..." << std::endl;
-    {
-        std::lock_guard<std::mutex> lock(clients_mutex);
-        for (auto& client : clients) {
-            shutdown(client->socket, SHUT_RDWR);
-        }
+    // 执行线程已停止，不会再有新的日志记录；写最后一个检查点，下次启动不必回放日志
+    if (wal) {
+        run_checkpoint();
     }
-    
-    // 等待一段时间让客户端断开
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-    
-    // 清理资源
-    close(server_fd);
-    
+    // 关闭日志会刷完已追加的记录
+    database_catalog.attachLog(nullptr);
+    wal.reset();
+
     std::cout << "服务器已安全关闭" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
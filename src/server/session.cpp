@@ -0,0 +1,724 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "server/session.h"
+#include "sql/executor.h"
+#include "sql/tokenizer.h"
+#include "server/io_loop.h"
+#include "common/worker_pool.h"
+#include "log/log.h"
+
+using enum LogModule;
+using enum LogLevel;
+
+ConnectionRegistry client_registry(MAX_CLIENTS);
+Catalog database_catalog;
+static PlanCache plan_cache;   // 所有连接共享的语句缓存
+std::atomic<int> client_counter{0};
+std::atomic<bool> server_running{true};
+std::string checkpoint_path;
+static std::mutex cout_mutex;  // 保护标准输出
+
+// 语句执行线程池
+static std::unique_ptr<WorkerPool> statement_pool;
+
+void safe_cout(const std::string& message) {
+    std::lock_guard<std::mutex> lock(cout_mutex);
+    std::cout << message << std::endl;
+}
+
+bool register_client(const Connection& conn) {
+    return client_registry.tryAdd(conn.client_id, conn.fd, conn.ip_address);
+}
+
+void unregister_client(const Connection& conn) {
+    if (!client_registry.remove(conn.client_id)) {
+        return;
+    }
+    std::string count_msg = "当前在线客户端数量: " + std::to_string(client_registry.size());
+    safe_cout(count_msg);
+}
+
+void reject_connection(int fd) {
+    std::string reject_msg;
+    protocol::appendFrame(reject_msg, FrameType::ERROR, 0,
+                          "服务器已达到最大客户端数限制 (" + std::to_string(MAX_CLIENTS) + ")");
+    send(fd, reject_msg.data(), reject_msg.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    close(fd);
+    safe_cout("拒绝新连接：已达到最大客户端数限制");
+}
+
+std::string run_checkpoint() {
+    if (checkpoint_path.empty()) {
+        return "未启用检查点（需要 --wal-dir）";
+    }
+    try {
+        auto begin = std::chrono::steady_clock::now();
+        CheckpointStats stats = database_catalog.checkpoint(checkpoint_path);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+        char message[256];
+        snprintf(message, sizeof(message),
+                 "检查点: %zu 张表 %zu 行, %zu MB, 日志从 LSN %llu 起保留, 删除 %zu 个日志段, 耗时 %lld ms",
+                 stats.tables, stats.rows, stats.bytes >> 20, static_cast<unsigned long long>(stats.lsn),
+                 stats.removed_segments, static_cast<long long>(ms.count()));
+        LOG(INFO, SYSTEM, "%s", message);
+        return message;
+    } catch (const std::exception& e) {
+        LOG(ERROR, SYSTEM, "写检查点失败: %s", e.what());
+        return std::string("写检查点失败: ") + e.what();
+    }
+}
+
+void init_statement_executor(size_t workers, size_t query_threads, bool pin) {
+    statement_pool = std::make_unique<WorkerPool>(workers, pin);
+    init_query_parallelism(query_threads, pin);
+}
+
+void shutdown_statement_executor() {
+    statement_pool.reset();
+    shutdown_query_parallelism();
+}
+
+// 把 SQL 执行结果直接写入应答帧的输出链；接近帧大小上限时让执行器停止输出
+class FrameSink : public ResultSink {
+public:
+    explicit FrameSink(OutputChain& out) : out_(out) {}
+
+    void write(std::string_view text) override { out_.append(text); }
+    bool accepting() const override { return out_.size() + RESULT_FRAME_SLACK < MAX_FRAME_PAYLOAD; }
+
+private:
+    OutputChain& out_;
+};
+
+// 解码 EXECUTE 帧的参数部分（参数个数加各参数），格式错误或个数与语句不符时抛出 SqlError
+static std::vector<Literal> decode_parameters(std::string_view data, size_t expected) {
+    auto malformed = []() { return SqlError("EXECUTE 帧中的参数格式错误"); };
+    if (data.size() < 2) {
+        throw malformed();
+    }
+    size_t count = protocol::getU16(data.data());
+    if (count != expected) {
+        throw SqlError("语句需要 " + std::to_string(expected) + " 个参数，收到 " + std::to_string(count) + " 个");
+    }
+    std::vector<Literal> parameters(count);
+    size_t offset = 2;
+    for (auto& parameter : parameters) {
+        if (offset >= data.size()) {
+            throw malformed();
+        }
+        auto type = static_cast<ParamType>(static_cast<uint8_t>(data[offset++]));
+        if (type == ParamType::INTEGER || type == ParamType::REAL) {
+            if (data.size() - offset < 8) {
+                throw malformed();
+            }
+            uint64_t bits = protocol::getU64(data.data() + offset);
+            offset += 8;
+            if (type == ParamType::INTEGER) {
+                parameter.kind = Literal::Kind::INTEGER;
+                parameter.integer = static_cast<int64_t>(bits);
+            } else {
+                parameter.kind = Literal::Kind::REAL;
+                memcpy(&parameter.real, &bits, sizeof(bits));
+            }
+        } else if (type == ParamType::STRING) {
+            if (data.size() - offset < 4) {
+                throw malformed();
+            }
+            size_t length = protocol::getU32(data.data() + offset);
+            offset += 4;
+            if (data.size() - offset < length) {
+                throw malformed();
+            }
+            parameter.kind = Literal::Kind::STRING;
+            parameter.text.assign(data.data() + offset, length);
+            offset += length;
+        } else {
+            throw malformed();
+        }
+    }
+    if (offset != data.size()) {
+        throw malformed();
+    }
+    return parameters;
+}
+
+// 在执行线程上运行一条语句，应答帧直接写入 req.response；不访问 Connection
+static void execute_statement(StatementRequest& req) {
+    std::string_view client_name = req.client_name;
+    int client_id = req.client_id;
+    std::string_view msg_str = req.sql;
+
+    try {
+        // 批量导入的一个数据块：起始行号、表名与 CSV 记录
+        if (req.copy) {
+            std::string_view payload = req.copy_data;
+            size_t name_length = payload.size() >= 10 ? protocol::getU16(payload.data() + 8) : 0;
+            if (payload.size() < 10 + name_length || name_length == 0) {
+                throw SqlError("COPY 帧格式错误");
+            }
+            uint64_t rows = copy_csv(database_catalog, std::string(payload.substr(10, name_length)),
+                                     payload.substr(10 + name_length), protocol::getU64(payload.data()));
+            char count[8];
+            protocol::putU64(count, rows);
+            FrameWriter writer(req.response, FrameType::COPIED, req.request_id);
+            writer << std::string_view(count, sizeof(count));
+            writer.finish();
+            return;
+        }
+
+        // 准备语句：解析一次后填入连接占好的句柄，应答句柄与参数个数
+        if (req.prepare_handle != 0) {
+            auto prepared = std::make_shared<PreparedStatement>();
+            prepared->statement = parse_statement(msg_str, &prepared->parameters);
+            char payload[6];
+            protocol::putU32(payload, req.prepare_handle);
+            protocol::putU16(payload + 4, static_cast<uint16_t>(prepared->parameters));
+            req.prepared->statement = std::move(prepared);
+            FrameWriter writer(req.response, FrameType::PREPARED, req.request_id);
+            writer << std::string_view(payload, sizeof(payload));
+            writer.finish();
+            return;
+        }
+
+        // 按句柄执行预备语句：帧中只有参数
+        if (req.prepared) {
+            // 句柄对应的 PREPARE 解析失败
+            if (!req.prepared->statement) {
+                throw SqlError("无效的语句句柄");
+            }
+            const PreparedStatement& prepared = *req.prepared->statement;
+            std::vector<Literal> parameters = decode_parameters(msg_str, prepared.parameters);
+            FrameWriter writer(req.response, FrameType::RESULT, req.request_id);
+            FrameSink sink(req.response);
+            execute_parsed(database_catalog, prepared.statement, sink, parameters);
+            writer.finish();
+            return;
+        }
+
+        // 每条请求都记录，格式化推迟到日志写入线程
+        LOG_DEFERRED(INFO, NETWORK, "来自 [{}] ID:{} 的消息: {}", client_name, client_id, msg_str);
+
+        // SQL 语句交给存储引擎执行；同一形状的语句只解析一次
+        if (is_sql_statement(msg_str)) {
+            FrameWriter writer(req.response, FrameType::RESULT, req.request_id);
+            FrameSink sink(req.response);
+            execute_cached(database_catalog, plan_cache, msg_str, sink);
+            writer.finish();
+            return;
+        }
+
+        // 未闭合的引号视为语法错误；词法分析直接在请求的 SQL 视图上进行，不拷贝
+        SqlTokenizer tokenizer(msg_str);
+        for (Token token = tokenizer.next(); token.type != TokenType::END; token = tokenizer.next()) {
+            if (token.type == TokenType::ERROR && (token.text[0] == '\'' || token.text[0] == '"')) {
+                LOG_DEFERRED(WARNING, SYNTAX, "客户端 ID:{} 的语句在偏移 {} 处有未闭合的引号", client_id,
+                             token.text.data() - msg_str.data());
+                FrameWriter error_writer(req.response, FrameType::ERROR, req.request_id);
+                error_writer << "语法错误: 未闭合的引号";
+                error_writer.finish();
+                return;
+            }
+        }
+
+        FrameWriter writer(req.response, FrameType::RESULT, req.request_id);
+
+        // 处理特殊指令
+        if (msg_str == "list") {
+            size_t total = client_registry.size();
+            writer << "当前在线客户端 (" << static_cast<long>(total) << " 个):\n";
+            client_registry.forEach([&](const ClientInfo& client) {
+                if (client.client_id != client_id) {
+                    writer << "  ID:" << static_cast<long>(client.client_id)
+                           << " [" << client.ip_address << "]\n";
+                }
+            });
+            if (total <= 1) {
+                writer << "  没有其他客户端在线\n";
+            }
+            writer.finish();
+            return;
+        }
+
+        if (msg_str == "cache") {
+            PlanCacheStats stats = plan_cache.stats();
+            char ratio[16];
+            snprintf(ratio, sizeof(ratio), "%.1f%%", stats.hitRatio() * 100);
+            writer << "语句缓存: " << static_cast<long>(stats.entries) << " 个语句形状, 命中 "
+                   << static_cast<long>(stats.hits) << " 次, 未命中 " << static_cast<long>(stats.misses)
+                   << " 次, 命中率 " << ratio << ", 淘汰 " << static_cast<long>(stats.evictions) << " 次";
+            writer.finish();
+            return;
+        }
+
+        if (msg_str == "storage") {
+            writer << "列存储占用（压缩后 / 未压缩，按编码统计的列块数）:\n";
+            database_catalog.forEach([&](Table& table) {
+                std::vector<ColumnStorage> columns;
+                {
+                    std::lock_guard<std::mutex> lock(table.latch());
+                    columns = table.storage();
+                }
+                writer << table.name() << ":\n";
+                for (size_t i = 0; i < columns.size(); ++i) {
+                    const ColumnStorage& column = columns[i];
+                    char line[160];
+                    snprintf(line, sizeof(line), "  %-16s %10zu / %10zu 字节 (%.2fx)", table.columnDef(i).name.c_str(),
+                             column.bytes, column.plain_bytes,
+                             column.bytes == 0 ? 1.0
+                                               : static_cast<double>(column.plain_bytes) /
+                                                     static_cast<double>(column.bytes));
+                    writer << line;
+                    for (size_t e = 0; e < ENCODING_COUNT; ++e) {
+                        if (column.chunks[e] > 0) {
+                            writer << " " << encoding_name(static_cast<Encoding>(e)) << ":"
+                                   << static_cast<long>(column.chunks[e]);
+                        }
+                    }
+                    writer << "\n";
+                }
+            });
+            writer.finish();
+            return;
+        }
+
+        if (msg_str == "checkpoint") {
+            writer << run_checkpoint();
+            writer.finish();
+            return;
+        }
+
+        // 查看或在运行中修改日志级别，格式见 Logger::configureLevels()
+        if (msg_str == "loglevel" || msg_str.starts_with("loglevel ")) {
+            std::string_view spec = msg_str.substr(strlen("loglevel"));
+            spec.remove_prefix(std::min(spec.find_first_not_of(' '), spec.size()));
+            if (!spec.empty()) {
+                Logger::getInstance().configureLevels(spec);
+            }
+            writer << "日志级别: " << Logger::getInstance().describeLevels();
+            writer.finish();
+            return;
+        }
+
+        // 模拟错误
+        if (msg_str == "error;") {
+            LOG(ERROR, NETWORK, "模拟错误触发于客户端 [%.*s] ID:%d",
+                static_cast<int>(client_name.size()), client_name.data(), client_id);
+        }
+
+        if (msg_str == "help") {
+            writer << "可用命令:\n"
+                      "  help     - 显示帮助信息\n"
+                      "  list     - 显示在线客户端列表\n"
+                      "  cache    - 显示语句缓存的命中率\n"
+                      "  storage  - 显示各表的列压缩情况\n"
+                      "  checkpoint - 立即写检查点并截断预写日志\n"
+                      "  loglevel [级别 | 模块=级别,...] - 查看或修改日志级别（级别为 OFF 时关闭）\n"
+                      "  quit/exit - 退出连接\n"
+                      "  CREATE TABLE / INSERT / SELECT - 执行 SQL\n"
+                      "  COPY 表名 FROM '文件.csv' [HEADER] - 由客户端流式导入 CSV 文件\n"
+                      "  其他消息 - 服务器会回显您的消息";
+            writer.finish();
+            return;
+        }
+
+        // 普通消息：回显给客户端
+        writer << "服务器回显: " << msg_str;
+        writer.finish();
+    } catch (const SqlError& e) {
+        LOG_DEFERRED(WARNING, EXECUTOR, "客户端 ID:{} 的语句执行失败: {}", client_id, e.what());
+        req.response.clear();
+        FrameWriter writer(req.response, FrameType::ERROR, req.request_id);
+        writer << e.what();
+        writer.finish();
+    } catch (const std::exception& e) {
+        std::string error_log = "处理客户端 [" + std::string(client_name) +
+                                "] ID:" + std::to_string(client_id) +
+                                " 时发生异常: " + e.what();
+        safe_cout(error_log);
+        req.response.clear();
+        FrameWriter writer(req.response, FrameType::ERROR, req.request_id);
+        writer << e.what();
+        writer.finish();
+    }
+}
+
+// 执行线程入口：依次执行一个任务中的请求，每条完成即交回 I/O 线程
+static void run_statement(void* arg) {
+    auto* req = static_cast<StatementRequest*>(arg);
+    while (req) {
+        // 投递之后请求可能随时被 I/O 线程析构
+        StatementRequest* next = req->batch_next;
+        execute_statement(*req);
+        req->loop->postCompletion(req);
+        req = next;
+    }
+}
+
+// 析构请求；内存留在连接 arena 中，随 arena 整体回收
+static void destroy_request(StatementRequest* req) {
+    req->~StatementRequest();
+}
+
+// 把队首已完成的请求依次移入输出链；全部应答后回收 arena
+static void flush_completed(Connection& conn) {
+    while (conn.pending_head && conn.pending_head->done) {
+        StatementRequest* req = conn.pending_head;
+        conn.pending_head = req->next;
+        --conn.pending_count;
+        conn.out.splice(req->response);
+        if (req->closes_connection) {
+            conn.close_after_flush = true;
+        }
+        destroy_request(req);
+    }
+    if (!conn.pending_head) {
+        conn.pending_tail = nullptr;
+        conn.arena.reset();
+    }
+}
+
+static StatementRequest* new_request(IoLoop& loop, Connection& conn, uint32_t request_id) {
+    auto* req = conn.arena.create<StatementRequest>();
+    req->loop = &loop;
+    req->conn = &conn;
+    req->client_id = conn.client_id;
+    req->request_id = request_id;
+
+    if (conn.pending_tail) {
+        conn.pending_tail->next = req;
+    } else {
+        conn.pending_head = req;
+    }
+    conn.pending_tail = req;
+    ++conn.pending_count;
+    return req;
+}
+
+// 在 I/O 线程上直接得出结果的请求，同样排队以保持应答顺序
+static void reply_inline(IoLoop& loop, Connection& conn, uint32_t request_id,
+                         FrameType type, std::string_view result) {
+    StatementRequest* req = new_request(loop, conn, request_id);
+    FrameWriter writer(req->response, type, request_id);
+    writer << result;
+    writer.finish();
+    req->done = true;
+    flush_completed(conn);
+}
+
+// 首条消息为客户端名称
+static void handle_hello(IoLoop& loop, Connection& conn, uint32_t request_id, std::string_view name) {
+    conn.client_name.assign(name);
+    conn.named = true;
+
+    std::string welcome_msg = "客户端 [" + conn.client_name +
+                              "] ID:" + std::to_string(conn.client_id) +
+                              " 已连接 (" + conn.ip_address + ")";
+    LOG(INFO, NETWORK, "%s", welcome_msg.c_str());
+
+    // 发送欢迎消息
+    std::string welcome_client = "欢迎 " + conn.client_name +
+                                 "! 你是第 " + std::to_string(conn.client_id) +
+                                 " 个连接。发送 'quit' 或 'exit' 退出。";
+    reply_inline(loop, conn, request_id, FrameType::RESULT, welcome_client);
+}
+
+// 请求现在能否交给线程池：前面的请求都已执行完，或者正在执行的都是 COPY 数据块且本请求也是
+static bool can_start(const Connection& conn, const StatementRequest* req) {
+    return conn.executing == 0 || (req->copy && conn.copying == conn.executing);
+}
+
+static void submit_request(Connection& conn, StatementRequest* req) {
+    ++conn.executing;
+    if (req->copy) {
+        ++conn.copying;
+    }
+    statement_pool->submit(run_statement, req);
+}
+
+// 按到达顺序提交排队的请求，直到遇到必须等前面的请求执行完的一条。
+// 排在一起的语句（最多 STATEMENT_BATCH 条）串成一个任务在同一个执行线程上依次执行，
+// 仍然只有一条在执行，省去逐条经过线程池与完成队列的往返
+static void start_waiting(Connection& conn) {
+    while (conn.waiting) {
+        StatementRequest* req = conn.waiting;
+        // 在 I/O 线程上直接应答的请求已经完成，跳过
+        conn.waiting = req->next;
+        if (req->done) {
+            continue;
+        }
+        if (!can_start(conn, req)) {
+            conn.waiting = req;
+            return;
+        }
+        if (!req->copy) {
+            StatementRequest* last = req;
+            for (int batched = 1; batched < STATEMENT_BATCH && conn.waiting && !conn.waiting->copy; ) {
+                StatementRequest* next = conn.waiting;
+                conn.waiting = next->next;
+                if (!next->done) {
+                    last->batch_next = next;
+                    last = next;
+                    ++conn.executing;
+                    ++batched;
+                }
+            }
+        }
+        submit_request(conn, req);
+    }
+}
+
+// 把请求交给执行线程池，没有线程池时直接执行。
+// 同一连接的语句按到达顺序逐条执行，后面的语句可能依赖前面语句的结果（建表后插入、插入后查询）；
+// 前面的请求未执行完时排队，由 complete_request 依次提交
+static void dispatch_request(Connection& conn, StatementRequest* req) {
+    if (statement_pool) {
+        if (conn.waiting || !can_start(conn, req)) {
+            if (!conn.waiting) {
+                conn.waiting = req;
+            }
+            return;
+        }
+        submit_request(conn, req);
+    } else {
+        execute_statement(*req);
+        req->done = true;
+        flush_completed(conn);
+    }
+}
+
+static void handle_query(IoLoop& loop, Connection& conn, uint32_t request_id, std::string_view msg) {
+    // 检查是否收到退出指令：在 I/O 线程处理，之前的请求应答完后关闭连接
+    if (msg == "quit" || msg == "exit") {
+        std::string leave_msg = "客户端 [" + conn.client_name +
+                               "] ID:" + std::to_string(conn.client_id) + " 主动退出";
+        LOG(INFO, NETWORK, "%s", leave_msg.c_str());
+
+        StatementRequest* req = new_request(loop, conn, request_id);
+        FrameWriter writer(req->response, FrameType::RESULT, request_id);
+        writer << "再见，" << conn.client_name << "!";
+        writer.finish();
+        req->closes_connection = true;
+        req->done = true;
+        conn.stop_reading = true;
+        flush_completed(conn);
+        return;
+    }
+
+    StatementRequest* req = new_request(loop, conn, request_id);
+    req->client_name = conn.client_name;
+    req->sql = conn.arena.copy(msg);
+    dispatch_request(conn, req);
+}
+
+// 准备语句：在 I/O 线程上按到达顺序占好句柄，与其他语句一样交给执行线程解析，
+// 之后流水线发来的 EXECUTE 不必等 PREPARED 应答
+static void handle_prepare(IoLoop& loop, Connection& conn, uint32_t request_id, std::string_view sql) {
+    if (conn.prepared.size() >= MAX_PREPARED_STATEMENTS) {
+        reply_inline(loop, conn, request_id, FrameType::ERROR, "准备的语句过多");
+        return;
+    }
+    conn.prepared.push_back(std::make_shared<PreparedSlot>());
+
+    StatementRequest* req = new_request(loop, conn, request_id);
+    req->client_name = conn.client_name;
+    req->prepared = conn.prepared.back();
+    req->prepare_handle = static_cast<uint32_t>(conn.prepared.size());
+    req->sql = conn.arena.copy(sql);
+    dispatch_request(conn, req);
+}
+
+// 按句柄执行：请求只带参数，跳过词法与语法分析
+static void handle_execute(IoLoop& loop, Connection& conn, uint32_t request_id, std::string_view payload) {
+    uint32_t handle = payload.size() >= 4 ? protocol::getU32(payload.data()) : 0;
+    if (handle == 0 || handle > conn.prepared.size()) {
+        reply_inline(loop, conn, request_id, FrameType::ERROR, "无效的语句句柄");
+        return;
+    }
+    StatementRequest* req = new_request(loop, conn, request_id);
+    req->client_name = conn.client_name;
+    req->prepared = conn.prepared[handle - 1];
+    req->sql = conn.arena.copy(payload.substr(4));
+    dispatch_request(conn, req);
+}
+
+// 批量导入的数据块交给执行线程解析与写入；同一连接上连续到达的多个数据块可以同时在不同的线程上导入，
+// 其余语句仍等它们全部完成后才执行
+static void handle_copy(IoLoop& loop, Connection& conn, uint32_t request_id, std::string_view payload) {
+    StatementRequest* req = new_request(loop, conn, request_id);
+    req->client_name = conn.client_name;
+    req->copy = true;
+    req->copy_data.assign(payload);
+    dispatch_request(conn, req);
+}
+
+static void handle_frame(IoLoop& loop, Connection& conn, const FrameHeader& header,
+                         std::string_view payload) {
+    uint32_t request_id = header.request_id;
+    try {
+        switch (header.type) {
+            case FrameType::HELLO:
+                handle_hello(loop, conn, request_id, payload);
+                break;
+            case FrameType::QUERY:
+            case FrameType::PREPARE:
+            case FrameType::EXECUTE:
+            case FrameType::COPY:
+                if (!conn.named) {
+                    reply_inline(loop, conn, request_id, FrameType::ERROR, "请先发送 HELLO 帧");
+                } else if (header.type == FrameType::QUERY) {
+                    handle_query(loop, conn, request_id, payload);
+                } else if (header.type == FrameType::PREPARE) {
+                    handle_prepare(loop, conn, request_id, payload);
+                } else if (header.type == FrameType::EXECUTE) {
+                    handle_execute(loop, conn, request_id, payload);
+                } else {
+                    handle_copy(loop, conn, request_id, payload);
+                }
+                break;
+            default:
+                reply_inline(loop, conn, request_id, FrameType::ERROR, "不支持的帧类型");
+                break;
+        }
+    } catch (const std::exception& e) {
+        std::string error_log = "处理客户端 [" + conn.client_name +
+                                "] ID:" + std::to_string(conn.client_id) +
+                                " 时发生异常: " + e.what();
+        safe_cout(error_log);
+        reply_inline(loop, conn, request_id, FrameType::ERROR, e.what());
+    }
+}
+
+void complete_request(StatementRequest* req) {
+    Connection& conn = *req->conn;
+    --conn.executing;
+    if (req->copy) {
+        --conn.copying;
+    }
+    if (conn.closed) {
+        destroy_request(req);
+        return;
+    }
+    req->done = true;
+    flush_completed(conn);
+    start_waiting(conn);
+}
+
+int release_pending(Connection& conn) {
+    conn.closed = true;
+    // 执行中的请求仍由执行线程持有，返回后在 complete_request 中析构；排队未提交的请求直接析构
+    bool submitted = true;
+    for (StatementRequest* req = conn.pending_head; req; ) {
+        StatementRequest* next = req->next;
+        if (req == conn.waiting) {
+            submitted = false;
+        }
+        if (req->done || !submitted) {
+            destroy_request(req);
+        }
+        req = next;
+    }
+    conn.pending_head = conn.pending_tail = nullptr;
+    conn.pending_count = 0;
+    conn.waiting = nullptr;
+    return conn.executing;
+}
+
+// 解析 [data, data + size) 中的完整帧，返回消费的字节数；协议错误时 frames 置为 -1
+static size_t parse_frames(IoLoop& loop, Connection& conn, const char* data, size_t size,
+                           int& frames) {
+    size_t offset = 0;
+    while (!conn.stop_reading) {
+        if (conn.pending_count >= CONN_MAX_PENDING || conn.out.size() >= CONN_MAX_OUTPUT) {
+            conn.input_paused = true;
+            break;
+        }
+        FrameHeader header;
+        std::string_view payload;
+        size_t consumed = 0;
+        auto status = protocol::parseFrame(data + offset, size - offset, header, payload, consumed);
+        if (status == protocol::ParseStatus::NEED_MORE) {
+            break;
+        }
+        if (status == protocol::ParseStatus::INVALID) {
+            LOG(WARNING, NETWORK, "客户端 ID:%d 发送了非法帧，断开连接", conn.client_id);
+            frames = -1;
+            return offset;
+        }
+        handle_frame(loop, conn, header, payload);
+        offset += consumed;
+        ++frames;
+    }
+    return offset;
+}
+
+int consume_input(IoLoop& loop, Connection& conn, const char* data, size_t size) {
+    int frames = 0;
+
+    // 有大于一个缓冲区的残留帧
+    if (!conn.in_large.empty()) {
+        conn.in_large.append(data, size);
+        size_t offset = parse_frames(loop, conn, conn.in_large.data(), conn.in_large.size(), frames);
+        if (offset == conn.in_large.size() || conn.stop_reading) {
+            std::string().swap(conn.in_large);
+        } else {
+            conn.in_large.erase(0, offset);
+        }
+        return frames;
+    }
+
+    // 有放在池化缓冲区中的残留帧
+    if (IoBuffer* partial = conn.in_partial) {
+        if (partial->size() + size > IO_BUFFER_SIZE) {
+            conn.in_large.assign(partial->data + partial->begin, partial->size());
+            BufferPool::instance().release(partial);
+            conn.in_partial = nullptr;
+            return consume_input(loop, conn, data, size);
+        }
+        memmove(partial->data, partial->data + partial->begin, partial->size());
+        partial->end = static_cast<uint32_t>(partial->size());
+        partial->begin = 0;
+        memcpy(partial->data + partial->end, data, size);
+        partial->end += static_cast<uint32_t>(size);
+
+        size_t offset = parse_frames(loop, conn, partial->data, partial->end, frames);
+        partial->begin = static_cast<uint32_t>(offset);
+        if (partial->size() == 0 || conn.stop_reading) {
+            BufferPool::instance().release(partial);
+            conn.in_partial = nullptr;
+        }
+        return frames;
+    }
+
+    // 没有残留数据时直接在读缓冲上解析，避免一次拷贝
+    size_t offset = parse_frames(loop, conn, data, size, frames);
+    size_t rest = size - offset;
+    if (rest > 0 && frames >= 0 && !conn.stop_reading) {
+        if (rest <= IO_BUFFER_SIZE) {
+            IoBuffer* partial = BufferPool::instance().acquire();
+            memcpy(partial->data, data + offset, rest);
+            partial->end = static_cast<uint32_t>(rest);
+            conn.in_partial = partial;
+        } else {
+            conn.in_large.assign(data + offset, rest);
+        }
+    }
+    return frames;
+}
+
+bool input_resumable(const Connection& conn) {
+    return conn.input_paused && !conn.closed && conn.pending_count <= CONN_RESUME_PENDING &&
+           conn.out.size() <= CONN_RESUME_OUTPUT;
+}
+
+int resume_input(IoLoop& loop, Connection& conn) {
+    conn.input_paused = false;
+    // 只解析暂停时留在连接中的输入
+    static const char none = 0;
+    return consume_input(loop, conn, &none, 0);
+}
@@ -0,0 +1,65 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <string>
+#include <string_view>
+#include <atomic>
+#include "server/connection.h"
+#include "server/connection_registry.h"
+#include "server/request.h"
+#include "storage/catalog.h"
+
+#define MAX_CLIENTS 65536
+#define RESULT_FRAME_SLACK 65536   // 查询结果距帧大小上限的保留空间
+#define STATEMENT_BATCH 64         // 同一连接排队的语句最多这么多条合成一个任务依次执行
+
+class IoLoop;
+
+// 全局变量
+extern ConnectionRegistry client_registry;
+extern Catalog database_catalog;     // 所有客户端共享的内存表
+extern std::atomic<int> client_counter;
+extern std::atomic<bool> server_running;
+extern std::string checkpoint_path;     // 检查点文件，为空表示没有启用预写日志，不写检查点
+
+// 线程安全的输出
+void safe_cout(const std::string& message);
+
+// 把所有表写成检查点并截断日志，返回结果说明；失败时记录日志并返回错误说明
+std::string run_checkpoint();
+
+// 连接建立时准入并登记，已达到 MAX_CLIENTS 时返回 false；断开时注销
+bool register_client(const Connection& conn);
+void unregister_client(const Connection& conn);
+
+// 拒绝超出上限的新连接：发送错误帧后关闭
+void reject_connection(int fd);
+
+// 启动/停止语句执行线程池；未启动时语句直接在 I/O 线程上执行
+// workers 为 0 时按核心数创建，pin 为 true 时把执行线程绑定到核心
+// query_threads 为单条大查询的并行度（见 init_query_parallelism），0 表示按核心数
+void init_statement_executor(size_t workers, size_t query_threads, bool pin);
+void shutdown_statement_executor();
+
+// 从新到达的数据中增量解析帧并逐个处理（未凑齐的部分暂存在连接中）
+// 语句交给执行线程池，完成后通过 loop 的完成队列回到 I/O 线程；
+// 同一连接的语句按到达顺序逐条执行（连续的 COPY 数据块除外）
+// 返回处理的帧数，-1 表示协议错误需要断开连接
+int consume_input(IoLoop& loop, Connection& conn, const char* data, size_t size);
+
+// 背压：客户端只发送不读取应答时，未应答的请求或待发送的数据达到 CONN_MAX_PENDING / CONN_MAX_OUTPUT 后
+// consume_input 停止解析并置 conn.input_paused，剩余输入暂存在连接中，I/O 循环随之停止读取套接字。
+// input_resumable() 为真（两者都降到 CONN_RESUME_* 以下）时调用 resume_input()：清除暂停并解析暂存的输入，
+// 返回值同 consume_input；之后若仍未暂停，I/O 循环继续读取套接字
+bool input_resumable(const Connection& conn);
+int resume_input(IoLoop& loop, Connection& conn);
+
+// I/O 线程收到已完成的请求：连接仍在时按请求到达顺序把可以发出的应答移入输出链，并提交排队的下一条语句；
+// 连接已关闭时直接析构请求。调用后 req 失效
+void complete_request(StatementRequest* req);
+
+// 连接关闭时调用：丢弃已完成的应答并标记连接已关闭
+// 返回仍在执行的请求数，不为 0 时连接对象必须保留到这些请求全部返回
+int release_pending(Connection& conn);
+
+#endif // SESSION_H
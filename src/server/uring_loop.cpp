@@ -0,0 +1,634 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "server/uring_loop.h"
+#include "server/session.h"
+#include "log/log.h"
+
+using enum LogModule;
+using enum LogLevel;
+
+// user_data 编码：高 8 位为操作类型，低 32 位为 client_id
+enum UringOp : uint64_t {
+    OP_ACCEPT = 1,
+    OP_WAKEUP,
+    OP_RECV,
+    OP_SEND,
+    OP_SHUTDOWN,
+    OP_CLOSE,
+    OP_CANCEL
+};
+
+static uint64_t encode_user_data(UringOp op, int client_id) {
+    return (static_cast<uint64_t>(op) << 56) | static_cast<uint32_t>(client_id);
+}
+
+static UringOp decode_op(uint64_t user_data) {
+    return static_cast<UringOp>(user_data >> 56);
+}
+
+static int decode_client_id(uint64_t user_data) {
+    return static_cast<int>(user_data & 0xffffffffu);
+}
+
+static int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                                    nullptr, 0));
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+static std::string errno_string(const char* what) {
+    return std::string(what) + ": " + strerror(errno);
+}
+
+bool UringLoop::isSupported(std::string& reason) {
+    // 多次触发的 recv 需要 6.0 及以上内核
+    utsname info{};
+    int major = 0;
+    int minor = 0;
+    if (uname(&info) != 0 || sscanf(info.release, "%d.%d", &major, &minor) != 2) {
+        reason = "无法获取内核版本";
+        return false;
+    }
+    if (major < 6) {
+        reason = std::string("内核版本过低 (") + info.release + ")，需要 6.0 以上";
+        return false;
+    }
+
+    io_uring_params params{};
+    int fd = sys_io_uring_setup(8, &params);
+    if (fd < 0) {
+        reason = errno_string("io_uring_setup 失败");
+        return false;
+    }
+
+    // 探测所需操作码
+    constexpr unsigned probe_ops = 256;
+    std::vector<char> storage(sizeof(io_uring_probe) + probe_ops * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    bool ok = sys_io_uring_register(fd, IORING_REGISTER_PROBE, probe, probe_ops) == 0;
+    if (ok) {
+        for (unsigned op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SENDMSG,
+                            IORING_OP_SHUTDOWN, IORING_OP_READ, IORING_OP_CLOSE,
+                            IORING_OP_ASYNC_CANCEL}) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                reason = "内核不支持 io_uring 操作码 " + std::to_string(op);
+                ok = false;
+                break;
+            }
+        }
+    } else {
+        reason = errno_string("IORING_REGISTER_PROBE 失败");
+    }
+    close(fd);
+    return ok;
+}
+
+UringLoop::UringLoop(int loop_id, int listen_fd)
+    : loop_id_(loop_id), listen_fd_(listen_fd) {
+    wakeup_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        throw std::runtime_error(errno_string("eventfd 创建失败"));
+    }
+    try {
+        setupRing();
+        setupBuffers();
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+UringLoop::~UringLoop() {
+    release();
+}
+
+void UringLoop::release() {
+    // 先关闭 ring，内核会取消所有未完成的请求，之后才能安全释放缓冲区
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    for (auto& [id, uc] : connections_) {
+        if (!uc->closing) {
+            release_pending(uc->conn);
+            unregister_client(uc->conn);
+        }
+        close(uc->conn.fd);
+    }
+    // 执行线程池已停止，回收投递回来但未处理的请求，之后连接才能释放
+    takeCompletions(completed_);
+    for (StatementRequest* req : completed_) {
+        complete_request(req);
+    }
+    connections_.clear();
+
+    if (buffers_) {
+        munmap(buffers_, static_cast<size_t>(URING_BUFFER_COUNT) * URING_BUFFER_SIZE);
+        buffers_ = nullptr;
+    }
+    if (buf_ring_) {
+        munmap(buf_ring_, URING_BUFFER_COUNT * sizeof(io_uring_buf));
+        buf_ring_ = nullptr;
+    }
+    if (sqes_) {
+        munmap(sqes_, sqes_map_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ptr_ && cq_ptr_ != sq_ptr_) {
+        munmap(cq_ptr_, cq_map_size_);
+    }
+    cq_ptr_ = nullptr;
+    if (sq_ptr_) {
+        munmap(sq_ptr_, sq_map_size_);
+        sq_ptr_ = nullptr;
+    }
+    if (wakeup_fd_ >= 0) {
+        close(wakeup_fd_);
+        wakeup_fd_ = -1;
+    }
+}
+
+void UringLoop::setupRing() {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_COOP_TASKRUN;
+    ring_fd_ = sys_io_uring_setup(URING_QUEUE_DEPTH, &params);
+    if (ring_fd_ < 0 && errno == EINVAL) {
+        params = io_uring_params{};
+        ring_fd_ = sys_io_uring_setup(URING_QUEUE_DEPTH, &params);
+    }
+    if (ring_fd_ < 0) {
+        throw std::runtime_error(errno_string("io_uring_setup 失败"));
+    }
+
+    sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_map_size_ = cq_map_size_ = std::max(sq_map_size_, cq_map_size_);
+    }
+
+    sq_ptr_ = mmap(nullptr, sq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+        sq_ptr_ = nullptr;
+        throw std::runtime_error(errno_string("映射提交队列失败"));
+    }
+    if (single_mmap) {
+        cq_ptr_ = sq_ptr_;
+    } else {
+        cq_ptr_ = mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) {
+            cq_ptr_ = nullptr;
+            throw std::runtime_error(errno_string("映射完成队列失败"));
+        }
+    }
+
+    sqes_map_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        throw std::runtime_error(errno_string("映射 SQE 数组失败"));
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sq_ptr_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    auto* sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; ++i) {
+        sq_array[i] = i;   // SQE 下标与数组下标一一对应
+    }
+    sq_local_tail_ = *sq_tail_;
+
+    char* cq = static_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+void UringLoop::setupBuffers() {
+    size_t ring_size = URING_BUFFER_COUNT * sizeof(io_uring_buf);
+    void* ring = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1, 0);
+    if (ring == MAP_FAILED) {
+        throw std::runtime_error(errno_string("分配缓冲区环失败"));
+    }
+    buf_ring_ = static_cast<io_uring_buf_ring*>(ring);
+
+    size_t pool_size = static_cast<size_t>(URING_BUFFER_COUNT) * URING_BUFFER_SIZE;
+    void* pool = mmap(nullptr, pool_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1, 0);
+    if (pool == MAP_FAILED) {
+        throw std::runtime_error(errno_string("分配接收缓冲区失败"));
+    }
+    buffers_ = static_cast<char*>(pool);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+    reg.ring_entries = URING_BUFFER_COUNT;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (sys_io_uring_register(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        throw std::runtime_error(errno_string("注册接收缓冲区环失败"));
+    }
+
+    for (unsigned short bid = 0; bid < URING_BUFFER_COUNT; ++bid) {
+        recycleBuffer(bid);
+    }
+}
+
+// 把缓冲区归还给内核
+void UringLoop::recycleBuffer(unsigned short bid) {
+    // 不使用 bufs 成员：内核头文件中的柔性数组在 C++ 下会因空结构体占位而整体偏移
+    io_uring_buf& buf = reinterpret_cast<io_uring_buf*>(buf_ring_)[buf_tail_ & (URING_BUFFER_COUNT - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<size_t>(bid) * URING_BUFFER_SIZE);
+    buf.len = URING_BUFFER_SIZE;
+    buf.bid = bid;
+    ++buf_tail_;
+    std::atomic_ref<__u16>(buf_ring_->tail).store(buf_tail_, std::memory_order_release);
+}
+
+io_uring_sqe* UringLoop::getSqe() {
+    unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+    if (sq_local_tail_ - head > sq_mask_) {
+        // 提交队列已满，先提交已有请求
+        enter(to_submit_, 0);
+    }
+    io_uring_sqe* sqe = &sqes_[sq_local_tail_ & sq_mask_];
+    memset(sqe, 0, sizeof(*sqe));
+    ++sq_local_tail_;
+    ++to_submit_;
+    return sqe;
+}
+
+int UringLoop::enter(unsigned to_submit, unsigned min_complete) {
+    std::atomic_ref<unsigned>(*sq_tail_).store(sq_local_tail_, std::memory_order_release);
+    unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret = sys_io_uring_enter(ring_fd_, to_submit, min_complete, flags);
+    countSyscall();
+    if (ret < 0) {
+        if (errno != EINTR && errno != EBUSY && errno != EAGAIN) {
+            LOG(WARNING, NETWORK, "事件循环 %d io_uring_enter 失败: %s", loop_id_, strerror(errno));
+        }
+        return 0;
+    }
+    to_submit_ -= std::min(to_submit_, static_cast<unsigned>(ret));
+    return ret;
+}
+
+void UringLoop::wakeup() {
+    uint64_t one = 1;
+    auto ret = write(wakeup_fd_, &one, sizeof(one));
+    (void)ret;
+}
+
+void UringLoop::armAccept() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd_;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = encode_user_data(OP_ACCEPT, 0);
+    accept_armed_ = true;
+}
+
+void UringLoop::armWakeup() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wakeup_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeup_value_);
+    sqe->len = sizeof(wakeup_value_);
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->user_data = encode_user_data(OP_WAKEUP, 0);
+}
+
+void UringLoop::armRecv(UringConnection& uc) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = uc.conn.fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = encode_user_data(OP_RECV, uc.conn.client_id);
+    uc.recv_armed = true;
+    ++uc.inflight;
+}
+
+void UringLoop::submitSend(UringConnection& uc) {
+    // 缓冲区地址固定，发送期间新追加的应答不影响已提交的 iovec
+    int count = uc.conn.out.fillIov(uc.send_iov, URING_SEND_IOV);
+    uc.send_msg.msg_iov = uc.send_iov;
+    uc.send_msg.msg_iovlen = static_cast<size_t>(count);
+
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = uc.conn.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&uc.send_msg);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = encode_user_data(OP_SEND, uc.conn.client_id);
+    uc.send_pending = true;
+    ++uc.inflight;
+}
+
+void UringLoop::updateRecv(UringConnection& uc) {
+    if (uc.closing) {
+        return;
+    }
+    if (!uc.conn.input_paused) {
+        if (!uc.recv_armed) {
+            armRecv(uc);
+        }
+        return;
+    }
+    if (!uc.recv_armed || uc.recv_cancelling) {
+        return;
+    }
+
+    // 取消后已到达的数据仍会交付并暂存在连接中，恢复时一并解析
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = encode_user_data(OP_RECV, uc.conn.client_id);
+    sqe->user_data = encode_user_data(OP_CANCEL, uc.conn.client_id);
+    uc.recv_cancelling = true;
+    ++uc.inflight;
+}
+
+void UringLoop::resumeInput(UringConnection& uc) {
+    if (uc.closing || !input_resumable(uc.conn)) {
+        return;
+    }
+    int frames = resume_input(*this, uc.conn);
+    if (frames < 0) {
+        beginClose(uc);
+        return;
+    }
+    countRequests(static_cast<uint64_t>(frames));
+    if (uc.conn.hasPendingOutput() && !uc.send_pending) {
+        submitSend(uc);
+    }
+    updateRecv(uc);
+}
+
+void UringLoop::beginClose(UringConnection& uc) {
+    if (uc.closing) {
+        return;
+    }
+    uc.closing = true;
+    release_pending(uc.conn);
+    unregister_client(uc.conn);
+
+    // shutdown 会让多次触发的 recv 以 0 结束，之后才能关闭描述符
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_SHUTDOWN;
+    sqe->fd = uc.conn.fd;
+    sqe->len = SHUT_RDWR;
+    sqe->user_data = encode_user_data(OP_SHUTDOWN, uc.conn.client_id);
+    ++uc.inflight;
+}
+
+// 连接已关闭且没有未完成请求时释放；调用后 uc 可能失效
+void UringLoop::maybeRelease(UringConnection& uc) {
+    if (!uc.closing || uc.inflight > 0 || uc.conn.executing > 0) {
+        return;
+    }
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = uc.conn.fd;
+    sqe->user_data = encode_user_data(OP_CLOSE, 0);
+    connections_.erase(uc.conn.client_id);
+}
+
+void UringLoop::run() {
+    armWakeup();
+    armAccept();
+
+    while (server_running) {
+        // 一次系统调用同时提交本轮产生的所有请求并等待完成事件
+        enter(to_submit_, 1);
+
+        unsigned head = *cq_head_;
+        unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+        while (head != tail) {
+            io_uring_cqe cqe = cqes_[head & cq_mask_];
+            ++head;
+            std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+            handleCompletion(cqe);
+        }
+    }
+}
+
+void UringLoop::handleCompletion(const io_uring_cqe& cqe) {
+    bool more = cqe.flags & IORING_CQE_F_MORE;
+    UringOp op = decode_op(cqe.user_data);
+
+    switch (op) {
+        case OP_ACCEPT:
+            onAccept(cqe.res, more);
+            return;
+        case OP_WAKEUP:
+            deliverCompletions();
+            if (server_running) {
+                armWakeup();
+            }
+            return;
+        case OP_CLOSE:
+            return;
+        default:
+            break;
+    }
+
+    auto it = connections_.find(decode_client_id(cqe.user_data));
+    if (it == connections_.end()) {
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            recycleBuffer(static_cast<unsigned short>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+        }
+        return;
+    }
+    UringConnection& uc = *it->second;
+
+    switch (op) {
+        case OP_RECV:
+            onRecv(uc, cqe);
+            break;
+        case OP_SEND:
+            onSend(uc, cqe.res);
+            break;
+        case OP_SHUTDOWN:
+        case OP_CANCEL:
+            --uc.inflight;
+            break;
+        default:
+            break;
+    }
+    maybeRelease(uc);
+}
+
+// 把执行线程完成的请求交回各自连接；新产生的应答在下一次 io_uring_enter 时一并提交
+void UringLoop::deliverCompletions() {
+    takeCompletions(completed_);
+    for (StatementRequest* req : completed_) {
+        int client_id = req->conn->client_id;
+        complete_request(req);   // req 已失效
+        // 仍有语句在执行的连接不会被释放，这里一定能找到
+        auto it = connections_.find(client_id);
+        if (it == connections_.end()) {
+            continue;
+        }
+        UringConnection& uc = *it->second;
+        if (uc.closing) {
+            maybeRelease(uc);
+            continue;
+        }
+        if (uc.conn.hasPendingOutput() && !uc.send_pending) {
+            submitSend(uc);
+        }
+        resumeInput(uc);
+    }
+}
+
+void UringLoop::onAccept(int res, bool more) {
+    if (!more) {
+        accept_armed_ = false;
+    }
+
+    if (res >= 0) {
+        int new_socket = res;
+        countAccept();
+
+        // 应答已按读取轮次合并写出，关闭 Nagle 算法，流水线客户端的应答不必等待延迟确认
+        int one = 1;
+        setsockopt(new_socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        countSyscall();
+
+        // 获取客户端IP地址
+        sockaddr_in address{};
+        socklen_t addrlen = sizeof(address);
+        getpeername(new_socket, reinterpret_cast<sockaddr*>(&address), &addrlen);
+        countSyscall();
+        char client_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &(address.sin_addr), client_ip, INET_ADDRSTRLEN);
+        int client_port = ntohs(address.sin_port);
+
+        int client_id = ++client_counter;
+        auto uc = std::make_unique<UringConnection>(
+            new_socket, client_id, std::string(client_ip) + ":" + std::to_string(client_port)
+        );
+
+        // 检查是否达到最大客户端数
+        if (!register_client(uc->conn)) {
+            reject_connection(new_socket);
+        } else {
+            safe_cout("新客户端连接，ID:" + std::to_string(client_id) +
+                      " [" + uc->conn.ip_address + "] 事件循环:" + std::to_string(loop_id_));
+            armRecv(*uc);
+            connections_.emplace(client_id, std::move(uc));
+        }
+    } else if (res != -ECANCELED) {
+        LOG(WARNING, NETWORK, "接受连接失败: %s", strerror(-res));
+    }
+
+    if (!accept_armed_ && server_running) {
+        armAccept();
+    }
+}
+
+void UringLoop::onRecv(UringConnection& uc, const io_uring_cqe& cqe) {
+    bool more = cqe.flags & IORING_CQE_F_MORE;
+    if (!more) {
+        uc.recv_armed = false;
+        uc.recv_cancelling = false;
+        --uc.inflight;
+    }
+
+    int res = cqe.res;
+    if (res > 0) {
+        auto bid = static_cast<unsigned short>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        if (!uc.closing) {
+            const char* data = buffers_ + static_cast<size_t>(bid) * URING_BUFFER_SIZE;
+            int frames = consume_input(*this, uc.conn, data, static_cast<size_t>(res));
+            recycleBuffer(bid);
+            if (frames < 0) {
+                beginClose(uc);
+                return;
+            }
+            countRequests(static_cast<uint64_t>(frames));
+            if (uc.conn.hasPendingOutput() && !uc.send_pending) {
+                submitSend(uc);
+            }
+        } else {
+            recycleBuffer(bid);
+        }
+    } else if (res == 0) {
+        if (!uc.closing) {
+            std::string disconnect_msg = "客户端 [" + uc.conn.client_name +
+                                         "] ID:" + std::to_string(uc.conn.client_id) + " 断开连接";
+            LOG(INFO, NETWORK, "%s", disconnect_msg.c_str());
+            beginClose(uc);
+        }
+        return;
+    } else if (res != -ENOBUFS && res != -ECANCELED) {
+        if (!uc.closing) {
+            std::string error_msg = "从客户端 [" + uc.conn.client_name +
+                                   "] ID:" + std::to_string(uc.conn.client_id) + " 读取数据失败";
+            LOG(WARNING, NETWORK, "%s", error_msg.c_str());
+            beginClose(uc);
+        }
+        return;
+    }
+
+    // 多次触发的 recv 被内核终止（如缓冲区暂时耗尽）时重新提交；背压暂停时则取消
+    updateRecv(uc);
+}
+
+void UringLoop::onSend(UringConnection& uc, int res) {
+    uc.send_pending = false;
+    --uc.inflight;
+    if (uc.closing) {
+        return;
+    }
+    if (res < 0) {
+        beginClose(uc);
+        return;
+    }
+
+    uc.conn.out.consume(static_cast<size_t>(res));
+    resumeInput(uc);
+    if (uc.closing) {
+        return;
+    }
+    if (uc.conn.hasPendingOutput()) {
+        if (!uc.send_pending) {
+            submitSend(uc);
+        }
+        return;
+    }
+
+    if (uc.conn.close_after_flush) {
+        beginClose(uc);
+    }
+}
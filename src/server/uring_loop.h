@@ -0,0 +1,112 @@
+#ifndef URING_LOOP_H
+#define URING_LOOP_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+#include <linux/io_uring.h>
+#include "server/connection.h"
+#include "server/io_loop.h"
+
+#define URING_QUEUE_DEPTH 4096
+#define URING_BUFFER_COUNT 256      // 提供给内核的接收缓冲区个数（2 的幂）
+#define URING_BUFFER_SIZE 16384
+#define URING_BUFFER_GROUP 0
+#define URING_SEND_IOV 64           // 一次 sendmsg 最多携带的输出缓冲区个数
+
+// 基于 io_uring 的 I/O 循环
+// 使用多次触发的 accept、基于提供缓冲区（provided buffer ring）的多次触发 recv，
+// 并在每轮循环中把所有待发送的 send 合并为一次 io_uring_enter 提交
+class UringLoop : public IoLoop {
+private:
+    // io_uring 侧的连接状态
+    struct UringConnection {
+        Connection conn;
+        // 进行中的 sendmsg 直接引用 conn.out 中的缓冲区，完成后才从输出链中消费
+        msghdr send_msg{};
+        iovec send_iov[URING_SEND_IOV];
+        bool send_pending = false;
+        bool recv_armed = false;
+        bool recv_cancelling = false;   // 背压暂停时已请求取消多次触发的 recv
+        bool closing = false;
+        int inflight = 0;           // 尚未结束的 io_uring 请求数，与执行中的语句都为 0 时才能释放
+
+        UringConnection(int sock, int id, std::string ip)
+            : conn(sock, id, std::move(ip)) {}
+    };
+
+    int loop_id_;
+    int listen_fd_;
+    int ring_fd_ = -1;
+    int wakeup_fd_ = -1;
+    uint64_t wakeup_value_ = 0;
+
+    // 提交队列
+    void* sq_ptr_ = nullptr;
+    size_t sq_map_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_map_size_ = 0;
+    unsigned sq_local_tail_ = 0;
+    unsigned to_submit_ = 0;
+
+    // 完成队列
+    void* cq_ptr_ = nullptr;
+    size_t cq_map_size_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    // 提供给内核的接收缓冲区
+    io_uring_buf_ring* buf_ring_ = nullptr;
+    char* buffers_ = nullptr;
+    unsigned short buf_tail_ = 0;
+
+    bool accept_armed_ = false;
+    std::vector<StatementRequest*> completed_;   // 复用的完成请求缓冲
+    std::unordered_map<int, std::unique_ptr<UringConnection>> connections_;  // 以 client_id 为键
+
+    void setupRing();
+    void release();
+    void setupBuffers();
+    io_uring_sqe* getSqe();
+    int enter(unsigned to_submit, unsigned min_complete);
+    void recycleBuffer(unsigned short bid);
+
+    void armAccept();
+    void armWakeup();
+    void armRecv(UringConnection& uc);
+    void submitSend(UringConnection& uc);
+    // 按背压状态暂停（取消 recv）或恢复（重新提交 recv）读取
+    void updateRecv(UringConnection& uc);
+    // 应答降到低水位以下时解析暂停期间留下的输入并恢复读取
+    void resumeInput(UringConnection& uc);
+    void beginClose(UringConnection& uc);
+    void maybeRelease(UringConnection& uc);
+
+    void handleCompletion(const io_uring_cqe& cqe);
+    void deliverCompletions();
+    void onAccept(int res, bool more);
+    void onRecv(UringConnection& uc, const io_uring_cqe& cqe);
+    void onSend(UringConnection& uc, int res);
+
+public:
+    UringLoop(int loop_id, int listen_fd);
+    ~UringLoop() override;
+
+    UringLoop(const UringLoop&) = delete;
+    UringLoop& operator=(const UringLoop&) = delete;
+
+    void run() override;
+    void wakeup() override;
+
+    // 检测当前内核是否支持本后端所需的 io_uring 特性
+    static bool isSupported(std::string& reason);
+};
+
+#endif // URING_LOOP_H
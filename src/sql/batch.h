@@ -0,0 +1,76 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "storage/column.h"
+
+#define BATCH_SIZE 2048             // 每批行数，CHUNK_ROWS 的约数，批不会跨列块
+#define MAX_BATCH_COLUMNS 64
+#define SEL_PADDING 16              // 选择向量尾部余量，SIMD 压缩写入可以越过有效长度
+
+// 在算子之间传递的一批行
+// 列数据不拷贝：columns[slot] 直接指向列块中本批第一行，按扫描时的列类型解释。
+// 列块已压缩时 columns[slot] 为空、encoded[slot] 为压缩形式，过滤直接在压缩数据上进行，
+// 之后由 DecodeOperator 只解码选中的行。
+// 过滤只修改选择向量：dense 为 true 时选中 0..count-1，否则选中 sel[0..count)。
+struct Batch {
+    size_t row_base = 0;            // 本批第一行在表中的行号
+    uint32_t size = 0;              // 批内行数
+    uint32_t count = 0;             // 选中行数
+    bool dense = true;
+    size_t column_count = 0;
+    const char* columns[MAX_BATCH_COLUMNS] = {};
+    const EncodedChunk* encoded[MAX_BATCH_COLUMNS] = {};
+    alignas(64) uint16_t sel[BATCH_SIZE + SEL_PADDING];
+
+    template<typename T>
+    const T* column(size_t slot) const {
+        return reinterpret_cast<const T*>(columns[slot]);
+    }
+
+    // 第 k 个选中行在批内的下标
+    uint32_t selected(uint32_t k) const { return dense ? k : sel[k]; }
+
+    // 供核函数使用的选择向量，稠密时为 nullptr
+    const uint16_t* selection() const { return dense ? nullptr : sel; }
+
+    // 本批第一行在列块内的位置
+    size_t chunkOffset() const { return row_base % CHUNK_ROWS; }
+};
+
+// 各列类型在批中的存取方式，算子按此特化，内层循环中没有类型分支
+struct Int64Traits {
+    using value_type = int64_t;
+    static constexpr ColumnType TYPE = ColumnType::INT64;
+    static int64_t get(const char* data, uint32_t i, uint32_t) {
+        return reinterpret_cast<const int64_t*>(data)[i];
+    }
+};
+
+struct DoubleTraits {
+    using value_type = double;
+    static constexpr ColumnType TYPE = ColumnType::DOUBLE;
+    static double get(const char* data, uint32_t i, uint32_t) {
+        return reinterpret_cast<const double*>(data)[i];
+    }
+};
+
+struct CharTraits {
+    using value_type = std::string_view;
+    static constexpr ColumnType TYPE = ColumnType::CHAR;
+    static std::string_view get(const char* data, uint32_t i, uint32_t width) {
+        return trim_char_value(data + static_cast<size_t>(i) * width, width);
+    }
+};
+
+struct VarcharTraits {
+    using value_type = std::string_view;
+    static constexpr ColumnType TYPE = ColumnType::VARCHAR;
+    static std::string_view get(const char* data, uint32_t i, uint32_t) {
+        return reinterpret_cast<const StringRef*>(data)[i].view();
+    }
+};
+
+#endif // BATCH_H
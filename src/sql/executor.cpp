@@ -0,0 +1,916 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "common/morsel_scheduler.h"
+#include "sql/executor.h"
+#include "sql/operators.h"
+
+namespace {
+
+// 单条查询的并行调度器，只在启动和退出时设置，为空时查询在发起线程中串行执行
+std::unique_ptr<MorselScheduler> query_scheduler;
+
+// 把字面量转换为列类型的值，类型不兼容时抛出 SqlError
+// 参数占位符取 parameters 中绑定的值；字符串值指向字面量本身
+Value convert_literal(const ColumnDef& def, const Literal& given, const std::vector<Literal>& parameters) {
+    if (given.kind == Literal::Kind::PARAMETER && given.parameter >= parameters.size()) {
+        throw SqlError("参数 $" + std::to_string(given.parameter + 1) + " 未绑定");
+    }
+    const Literal& literal = given.kind == Literal::Kind::PARAMETER ? parameters[given.parameter] : given;
+    Value value;
+    switch (def.type) {
+        case ColumnType::INT64:
+            if (literal.kind != Literal::Kind::INTEGER) {
+                throw SqlError("列 " + def.name + " 需要整数值");
+            }
+            value.integer = literal.integer;
+            break;
+        case ColumnType::DOUBLE:
+            if (literal.kind != Literal::Kind::INTEGER && literal.kind != Literal::Kind::REAL) {
+                throw SqlError("列 " + def.name + " 需要数值");
+            }
+            value.real = literal.kind == Literal::Kind::REAL ? literal.real
+                                                             : static_cast<double>(literal.integer);
+            break;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            if (literal.kind != Literal::Kind::STRING) {
+                throw SqlError("列 " + def.name + " 需要字符串值");
+            }
+            value.text = literal.text;
+            break;
+    }
+    return value;
+}
+
+// 插入时额外检查字符串长度
+void check_length(const ColumnDef& def, const Value& value) {
+    if ((def.type == ColumnType::CHAR || def.type == ColumnType::VARCHAR) &&
+        def.width > 0 && value.text.size() > def.width) {
+        throw SqlError("值超过列 " + def.name + " 的长度上限 " + std::to_string(def.width));
+    }
+}
+
+Table& require_table(Catalog& catalog, const std::string& name) {
+    Table* table = catalog.findTable(name);
+    if (!table) {
+        throw SqlError("表不存在: " + name);
+    }
+    return *table;
+}
+
+size_t require_column(const Table& table, const std::string& name) {
+    int index = table.findColumn(name);
+    if (index < 0) {
+        throw SqlError("表 " + table.name() + " 中不存在列 " + name);
+    }
+    return static_cast<size_t>(index);
+}
+
+void write_integer(ResultSink& sink, int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    sink.write(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+void write_real(ResultSink& sink, double value) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    sink.write(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+// 批内第 index 行的值，data 为该列在批中的数据
+void write_batch_value(ResultSink& sink, const ColumnDef& def, const char* data, uint32_t index) {
+    switch (def.type) {
+        case ColumnType::INT64:
+            write_integer(sink, Int64Traits::get(data, index, def.width));
+            break;
+        case ColumnType::DOUBLE:
+            write_real(sink, DoubleTraits::get(data, index, def.width));
+            break;
+        case ColumnType::CHAR:
+            sink.write(CharTraits::get(data, index, def.width));
+            break;
+        case ColumnType::VARCHAR:
+            sink.write(VarcharTraits::get(data, index, def.width));
+            break;
+    }
+}
+
+// 聚合结果：没有输入行时除 COUNT 外都为 NULL
+void write_aggregate(ResultSink& sink, const AggregateSpec& spec, const AggregateState& state) {
+    if (spec.kind == AggregateKind::COUNT) {
+        write_integer(sink, state.count);
+        return;
+    }
+    if (state.count == 0) {
+        sink.write("NULL");
+        return;
+    }
+    if (spec.kind == AggregateKind::AVG) {
+        double sum = spec.type == ColumnType::INT64 ? static_cast<double>(state.integer) : state.real;
+        write_real(sink, sum / static_cast<double>(state.count));
+        return;
+    }
+    switch (spec.type) {
+        case ColumnType::INT64:
+            write_integer(sink, state.integer);
+            break;
+        case ColumnType::DOUBLE:
+            write_real(sink, state.real);
+            break;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            sink.write(state.text);
+            break;
+    }
+}
+
+// 输出表头中的列名，聚合函数写作 sum(b) / count(*)
+void write_item_name(ResultSink& sink, const SelectItem& item) {
+    static const char* const NAMES[] = {"", "count", "sum", "min", "max", "avg"};
+    if (item.aggregate == AggregateKind::NONE) {
+        sink.write(item.column);
+        return;
+    }
+    sink.write(NAMES[static_cast<size_t>(item.aggregate)]);
+    sink.write("(");
+    sink.write(item.column.empty() ? "*" : item.column);
+    sink.write(")");
+}
+
+// 绑定到批中列号的谓词
+struct BoundPredicate {
+    size_t slot;
+    const ColumnDef* def;
+    CompareOp op;
+    Value value;
+};
+
+std::unique_ptr<Operator> add_filters(std::unique_ptr<Operator> plan, const std::vector<BoundPredicate>& predicates) {
+    for (const auto& predicate : predicates) {
+        plan = make_filter(std::move(plan), predicate.slot, *predicate.def, predicate.op, predicate.value);
+    }
+    return plan;
+}
+
+// 写语句的 WHERE：第 i 个谓词读取批中的第 i 列，columns 为各列在表中的列号
+std::vector<BoundPredicate> bind_where(const Table& table, const std::vector<Predicate>& where,
+                                       const std::vector<Literal>& parameters, std::vector<size_t>& columns) {
+    std::vector<BoundPredicate> predicates;
+    for (const auto& predicate : where) {
+        size_t index = require_column(table, predicate.column);
+        const ColumnDef& def = table.columnDef(index);
+        predicates.push_back({columns.size(), &def, predicate.op, convert_literal(def, predicate.value, parameters)});
+        columns.push_back(index);
+    }
+    return predicates;
+}
+
+// 写语句的目标：当前数据版本中满足条件且未删除的行的位置（调用方持有写锁，ts 为本次提交的时间戳）
+// 只用到行号，压缩的列块在过滤后不必解码
+std::vector<size_t> find_target_rows(const TableData& data, std::vector<size_t> columns,
+                                     const std::vector<BoundPredicate>& predicates, int64_t ts) {
+    std::unique_ptr<Operator> plan = add_filters(
+        std::make_unique<ScanOperator>(data, std::move(columns), 0, data.rowCount(), ts), predicates);
+    std::vector<size_t> rows;
+    Batch batch;
+    while (plan->next(batch)) {
+        for (uint32_t k = 0; k < batch.count; ++k) {
+            rows.push_back(batch.row_base + batch.selected(k));
+        }
+    }
+    return rows;
+}
+
+void execute_create(Catalog& catalog, const CreateTableStatement& statement, ResultSink& sink) {
+    uint64_t lsn = 0;
+    if (!catalog.createTable(statement.table, statement.columns, &lsn)) {
+        throw SqlError("表已存在: " + statement.table);
+    }
+    catalog.waitDurable(lsn);
+    sink.write("表 ");
+    sink.write(statement.table);
+    sink.write(" 已创建");
+}
+
+// 等待本提交的日志持久化后发布。刷盘失败时修改已经写入表中，却可能在崩溃后丢失，不能让读者看到：
+// 放弃本提交并停止之后的所有发布（数据库不再接受写入，重启后按日志恢复），不在析构时发布
+static void publish_durable(Catalog& catalog, MvccManager::Commit& commit, uint64_t lsn) {
+    try {
+        catalog.waitDurable(lsn);
+    } catch (...) {
+        commit.abandon();
+        throw;
+    }
+    if (!commit.publish()) {
+        throw std::runtime_error("数据库已停止写入: 更早的提交未能持久化");
+    }
+}
+
+// 把已检查过的 rows 行（每行按表的列顺序）作为一次提交插入表中
+// 先在写锁内写日志再写表，日志失败时表不变；释放锁后再等待刷盘，并发的插入可以合并到同一组，
+// 持久化之后才发布，读者看不到可能在崩溃后丢失的行
+void insert_rows(Catalog& catalog, Table& table, const Value* values, size_t rows) {
+    std::unique_lock<std::mutex> lock(table.latch());
+    MvccManager::Commit commit(catalog.mvcc());
+    uint64_t lsn = catalog.logInsert(table, values, rows);
+    table.appendRows(values, rows, commit.ts());
+    bool sealed = table.needsEncoding();
+    lock.unlock();
+    publish_durable(catalog, commit, lsn);
+    if (sealed) {
+        catalog.collectGarbage(table);
+    }
+}
+
+void execute_insert(Catalog& catalog, const InsertStatement& statement, const std::vector<Literal>& parameters,
+                    ResultSink& sink) {
+    Table& table = require_table(catalog, statement.table);
+    size_t column_count = table.columnCount();
+
+    // 列表中第 i 个值写入表的第 mapping[i] 列；目前不支持 NULL 与默认值，必须给出所有列
+    std::vector<size_t> mapping;
+    if (statement.columns.empty()) {
+        for (size_t i = 0; i < column_count; ++i) {
+            mapping.push_back(i);
+        }
+    } else {
+        std::vector<bool> seen(column_count, false);
+        for (const auto& name : statement.columns) {
+            size_t index = require_column(table, name);
+            if (seen[index]) {
+                throw SqlError("列重复: " + name);
+            }
+            seen[index] = true;
+            mapping.push_back(index);
+        }
+        for (size_t i = 0; i < column_count; ++i) {
+            if (!seen[i]) {
+                throw SqlError("列 " + table.columnDef(i).name + " 缺少值（暂不支持 NULL 与默认值）");
+            }
+        }
+    }
+
+    // 先转换并检查全部行，保证语句要么全部插入要么全部不插入
+    std::vector<Value> values(statement.rows.size() * column_count);
+    for (size_t r = 0; r < statement.rows.size(); ++r) {
+        const auto& row = statement.rows[r];
+        if (row.size() != mapping.size()) {
+            throw SqlError("第 " + std::to_string(r + 1) + " 行的值个数与列数不一致");
+        }
+        for (size_t i = 0; i < row.size(); ++i) {
+            const ColumnDef& def = table.columnDef(mapping[i]);
+            Value value = convert_literal(def, row[i], parameters);
+            check_length(def, value);
+            values[r * column_count + mapping[i]] = value;
+        }
+    }
+
+    insert_rows(catalog, table, values.data(), statement.rows.size());
+
+    sink.write("插入 ");
+    write_integer(sink, static_cast<int64_t>(statement.rows.size()));
+    sink.write(" 行");
+}
+
+void execute_delete(Catalog& catalog, const DeleteStatement& statement, const std::vector<Literal>& parameters,
+                    ResultSink& sink) {
+    Table& table = require_table(catalog, statement.table);
+    std::vector<size_t> columns;
+    std::vector<BoundPredicate> predicates = bind_where(table, statement.where, parameters, columns);
+
+    std::unique_lock<std::mutex> lock(table.latch());
+    MvccManager::Commit commit(catalog.mvcc());
+    const TableData& data = table.data();
+    std::vector<size_t> rows = find_target_rows(data, std::move(columns), predicates, commit.ts());
+    uint64_t lsn = 0;
+    if (!rows.empty()) {
+        std::vector<int64_t> row_ids;
+        for (size_t row : rows) {
+            row_ids.push_back(data.row_ids.integerAt(row));
+        }
+        lsn = catalog.logDelete(table, row_ids);
+        for (size_t row : rows) {
+            table.deleteRow(row, commit.ts());
+        }
+    }
+    lock.unlock();
+    publish_durable(catalog, commit, lsn);
+    if (!rows.empty()) {
+        catalog.collectGarbage(table);
+    }
+
+    sink.write("删除 ");
+    write_integer(sink, static_cast<int64_t>(rows.size()));
+    sink.write(" 行");
+}
+
+// 更新即删除旧版本并在表尾追加新版本，正在读旧快照的查询仍看到旧值
+void execute_update(Catalog& catalog, const UpdateStatement& statement, const std::vector<Literal>& parameters,
+                    ResultSink& sink) {
+    Table& table = require_table(catalog, statement.table);
+    size_t column_count = table.columnCount();
+
+    std::vector<std::pair<size_t, Value>> assignments;
+    std::vector<bool> seen(column_count, false);
+    for (const auto& assignment : statement.assignments) {
+        size_t index = require_column(table, assignment.column);
+        if (seen[index]) {
+            throw SqlError("列重复: " + assignment.column);
+        }
+        seen[index] = true;
+        const ColumnDef& def = table.columnDef(index);
+        Value value = convert_literal(def, assignment.value, parameters);
+        check_length(def, value);
+        assignments.emplace_back(index, value);
+    }
+    std::vector<size_t> columns;
+    std::vector<BoundPredicate> predicates = bind_where(table, statement.where, parameters, columns);
+
+    std::unique_lock<std::mutex> lock(table.latch());
+    MvccManager::Commit commit(catalog.mvcc());
+    const TableData& data = table.data();
+    std::vector<size_t> rows = find_target_rows(data, std::move(columns), predicates, commit.ts());
+    uint64_t lsn = 0;
+    if (!rows.empty()) {
+        // 新版本的字符串指向旧版本的数据，同一数据版本中追加不会移动已有数据
+        std::vector<Value> values(rows.size() * column_count);
+        std::vector<int64_t> row_ids;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            for (size_t i = 0; i < column_count; ++i) {
+                values[r * column_count + i] = data.column(i).valueAt(rows[r]);
+            }
+            for (const auto& [index, value] : assignments) {
+                values[r * column_count + index] = value;
+            }
+            row_ids.push_back(data.row_ids.integerAt(rows[r]));
+        }
+        lsn = catalog.logUpdate(table, row_ids, values.data());
+        for (size_t row : rows) {
+            table.deleteRow(row, commit.ts());
+        }
+        for (size_t r = 0; r < rows.size(); ++r) {
+            table.appendRow(&values[r * column_count], commit.ts());
+        }
+    }
+    lock.unlock();
+    publish_durable(catalog, commit, lsn);
+    if (!rows.empty()) {
+        catalog.collectGarbage(table);
+    }
+
+    sink.write("更新 ");
+    write_integer(sink, static_cast<int64_t>(rows.size()));
+    sink.write(" 行");
+}
+
+// 查询的扫描与过滤部分，按行范围实例化
+struct ScanPlan {
+    const TableData& data;
+    const std::vector<size_t>& columns;
+    const std::vector<BoundPredicate>& predicates;
+    int64_t snapshot;
+
+    std::unique_ptr<Operator> build(size_t begin, size_t end) const {
+        return std::make_unique<DecodeOperator>(
+            add_filters(std::make_unique<ScanOperator>(data, columns, begin, end, snapshot), predicates));
+    }
+};
+
+// 对 [0, end) 行执行 consume(partial, plan)：启用了并行且不止一个片段时按片段并行，
+// 每个线程槽位累加到自己的局部结果 partials[slot]；否则在当前线程整体执行，只有一个局部结果
+template<typename Partial, typename Consume>
+void run_morsels(const ScanPlan& plan, size_t end, const Partial& empty, std::vector<Partial>& partials,
+                 Consume consume) {
+    MorselScheduler* scheduler = query_scheduler.get();
+    size_t morsels = (end + MORSEL_ROWS - 1) / MORSEL_ROWS;
+    if (!scheduler || morsels < 2) {
+        partials.assign(1, empty);
+        consume(partials[0], plan.build(0, end));
+        return;
+    }
+    partials.assign(scheduler->slots(), empty);
+    auto task = [&](size_t slot, size_t morsel) {
+        size_t begin = morsel * MORSEL_ROWS;
+        consume(partials[slot], plan.build(begin, std::min(end, begin + MORSEL_ROWS)));
+    };
+    scheduler->run(morsels, task);
+}
+
+// 无分组聚合的结果；CHAR 的 MIN/MAX 复制到自己的字符串堆（各线程分别创建，不共享）
+struct AggregateResult {
+    std::vector<AggregateState> states;
+    std::shared_ptr<StringHeap> strings;
+};
+
+// 无分组的聚合：各线程的局部状态合并为一组
+AggregateResult run_aggregate(const ScanPlan& plan, size_t end, const std::vector<AggregateSpec>& specs) {
+    std::vector<AggregateResult> partials;
+    run_morsels(plan, end, AggregateResult{std::vector<AggregateState>(specs.size()), nullptr}, partials,
+                [&specs](AggregateResult& partial, std::unique_ptr<Operator> input) {
+                    AggregateOperator aggregation(std::move(input), specs);
+                    aggregation.run();
+                    if (!partial.strings) {
+                        partial.strings = std::make_shared<StringHeap>();
+                    }
+                    for (size_t i = 0; i < specs.size(); ++i) {
+                        partial.states[i].merge(specs[i], aggregation.states()[i], partial.strings.get());
+                    }
+                });
+    AggregateResult& result = partials[0];
+    if (!result.strings) {
+        result.strings = std::make_shared<StringHeap>();
+    }
+    for (size_t slot = 1; slot < partials.size(); ++slot) {
+        for (size_t i = 0; i < specs.size(); ++i) {
+            result.states[i].merge(specs[i], partials[slot].states[i], result.strings.get());
+        }
+    }
+    return std::move(result);
+}
+
+// 分组聚合：各线程累加到局部哈希表；局部表不止一张时按哈希值分区，由各线程并行合并，每个分区一张表
+std::vector<GroupTable> run_grouped(const ScanPlan& plan, size_t end, const std::vector<GroupKeySpec>& keys,
+                                    const std::vector<AggregateSpec>& specs) {
+    std::vector<GroupTable> partials;
+    run_morsels(plan, end, GroupTable(keys, specs), partials,
+                [](GroupTable& groups, std::unique_ptr<Operator> input) {
+                    Batch batch;
+                    while (input->next(batch)) {
+                        groups.consume(batch);
+                    }
+                });
+    if (partials.size() == 1) {
+        return partials;
+    }
+
+    size_t partitions = query_scheduler->slots();
+    std::vector<GroupTable> merged(partitions, GroupTable(keys, specs));
+    auto task = [&](size_t, size_t partition) {
+        for (const auto& partial : partials) {
+            merged[partition].merge(partial, partition, partitions);
+        }
+    };
+    query_scheduler->run(partitions, task);
+    return merged;
+}
+
+int compare_values(ColumnType type, const Value& left, const Value& right) {
+    switch (type) {
+        case ColumnType::INT64:
+            return left.integer < right.integer ? -1 : left.integer > right.integer ? 1 : 0;
+        case ColumnType::DOUBLE:
+            return left.real < right.real ? -1 : left.real > right.real ? 1 : 0;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            return left.text.compare(right.text);
+    }
+    return 0;
+}
+
+void write_value(ResultSink& sink, ColumnType type, const Value& value) {
+    switch (type) {
+        case ColumnType::INT64:
+            write_integer(sink, value.integer);
+            break;
+        case ColumnType::DOUBLE:
+            write_real(sink, value.real);
+            break;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            sink.write(value.text);
+            break;
+    }
+}
+
+// 查询计划：扫描 -> 逐个谓词过滤 -> 解码压缩的列 -> 聚合或分组聚合（大表上按片段并行），或 -> 限制行数 -> 投影
+void execute_select(Catalog& catalog, const SelectStatement& statement, const std::vector<Literal>& parameters,
+                    ResultSink& sink) {
+    Table& table = require_table(catalog, statement.table);
+
+    std::vector<SelectItem> items = statement.items;
+    if (items.empty()) {
+        for (size_t i = 0; i < table.columnCount(); ++i) {
+            items.push_back({AggregateKind::NONE, table.columnDef(i).name});
+        }
+    }
+    bool grouped = !statement.group_by.empty();
+    bool aggregate = grouped;
+    for (const auto& item : items) {
+        aggregate = aggregate || item.aggregate != AggregateKind::NONE;
+    }
+
+    // 查询涉及的列只扫描一次，批中的列号为其在 scan_columns 中的位置
+    std::vector<size_t> scan_columns;
+    auto slot_of = [&scan_columns](size_t column) {
+        auto it = std::find(scan_columns.begin(), scan_columns.end(), column);
+        if (it == scan_columns.end()) {
+            scan_columns.push_back(column);
+            return scan_columns.size() - 1;
+        }
+        return static_cast<size_t>(it - scan_columns.begin());
+    };
+
+    std::vector<GroupKeySpec> keys;
+    for (const auto& name : statement.group_by) {
+        size_t index = require_column(table, name);
+        const ColumnDef& def = table.columnDef(index);
+        keys.push_back({slot_of(index), def.type, def.width});
+    }
+
+    // 聚合查询中每个输出项对应的分组列或聚合函数的下标
+    std::vector<size_t> item_index;
+    std::vector<size_t> output_slots;
+    std::vector<const ColumnDef*> output_defs;
+    std::vector<AggregateSpec> specs;
+    for (const auto& item : items) {
+        if (aggregate && item.aggregate == AggregateKind::NONE) {
+            auto key = std::find(statement.group_by.begin(), statement.group_by.end(), item.column);
+            item_index.push_back(static_cast<size_t>(key - statement.group_by.begin()));
+            continue;
+        }
+        item_index.push_back(specs.size());
+        if (item.column.empty()) {
+            specs.push_back({AggregateKind::COUNT, 0, ColumnType::INT64, 0, true});
+            continue;
+        }
+        size_t index = require_column(table, item.column);
+        const ColumnDef& def = table.columnDef(index);
+        if (!aggregate) {
+            output_slots.push_back(slot_of(index));
+            output_defs.push_back(&def);
+            continue;
+        }
+        bool numeric = def.type == ColumnType::INT64 || def.type == ColumnType::DOUBLE;
+        if (!numeric && (item.aggregate == AggregateKind::SUM || item.aggregate == AggregateKind::AVG)) {
+            throw SqlError("列 " + def.name + " 不是数值类型，不能求和或平均");
+        }
+        specs.push_back({item.aggregate, slot_of(index), def.type, def.width, false});
+    }
+
+    std::vector<BoundPredicate> predicates;
+    for (const auto& predicate : statement.where) {
+        size_t index = require_column(table, predicate.column);
+        const ColumnDef& def = table.columnDef(index);
+        predicates.push_back({slot_of(index), &def, predicate.op,
+                              convert_literal(def, predicate.value, parameters)});
+    }
+    if (scan_columns.size() > MAX_BATCH_COLUMNS) {
+        throw SqlError("查询涉及的列过多");
+    }
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        sink.write(i == 0 ? "" : " | ");
+        write_item_name(sink, items[i]);
+    }
+    sink.write("\n");
+
+    // 先取快照再读表数据；快照期间表数据版本不会被释放
+    MvccManager::Snapshot snapshot = catalog.mvcc().snapshot();
+    const TableData& data = table.data();
+    size_t end = data.visibleEnd(snapshot.ts());
+    ScanPlan scan{data, scan_columns, predicates, snapshot.ts()};
+
+    size_t emitted = 0;
+    bool truncated = false;
+    if (grouped) {
+        std::vector<GroupTable> tables = run_grouped(scan, end, keys, specs);
+
+        // 按分组键排序输出，结果与并行度无关
+        std::vector<std::pair<const GroupTable*, size_t>> order;
+        for (const auto& groups : tables) {
+            for (size_t group = 0; group < groups.groupCount(); ++group) {
+                order.emplace_back(&groups, group);
+            }
+        }
+        std::sort(order.begin(), order.end(), [&keys](const auto& left, const auto& right) {
+            const Value* left_key = left.first->key(left.second);
+            const Value* right_key = right.first->key(right.second);
+            for (size_t j = 0; j < keys.size(); ++j) {
+                int c = compare_values(keys[j].type, left_key[j], right_key[j]);
+                if (c != 0) {
+                    return c < 0;
+                }
+            }
+            return false;
+        });
+        size_t limit = statement.limit >= 0 ? static_cast<size_t>(statement.limit) : order.size();
+        for (const auto& [groups, group] : order) {
+            if (emitted == limit) {
+                break;
+            }
+            if (!sink.accepting()) {
+                truncated = true;
+                break;
+            }
+            for (size_t i = 0; i < items.size(); ++i) {
+                sink.write(i == 0 ? "" : " | ");
+                size_t index = item_index[i];
+                if (items[i].aggregate == AggregateKind::NONE) {
+                    write_value(sink, keys[index].type, groups->key(group)[index]);
+                } else {
+                    write_aggregate(sink, specs[index], groups->states(group)[index]);
+                }
+            }
+            sink.write("\n");
+            ++emitted;
+        }
+    } else if (aggregate) {
+        AggregateResult result = run_aggregate(scan, end, specs);
+        const std::vector<AggregateState>& states = result.states;
+        if (statement.limit != 0) {
+            for (size_t i = 0; i < specs.size(); ++i) {
+                sink.write(i == 0 ? "" : " | ");
+                write_aggregate(sink, specs[i], states[i]);
+            }
+            sink.write("\n");
+            emitted = 1;
+        }
+    } else {
+        std::unique_ptr<Operator> plan = scan.build(0, end);
+        if (statement.limit >= 0) {
+            plan = std::make_unique<LimitOperator>(std::move(plan), static_cast<size_t>(statement.limit));
+        }
+        plan = std::make_unique<ProjectOperator>(std::move(plan), std::move(output_slots));
+
+        Batch batch;
+        while (!truncated && plan->next(batch)) {
+            for (uint32_t k = 0; k < batch.count; ++k) {
+                if (!sink.accepting()) {
+                    truncated = true;
+                    break;
+                }
+                uint32_t index = batch.selected(k);
+                for (size_t i = 0; i < output_defs.size(); ++i) {
+                    sink.write(i == 0 ? "" : " | ");
+                    write_batch_value(sink, *output_defs[i], batch.columns[i], index);
+                }
+                sink.write("\n");
+                ++emitted;
+            }
+        }
+    }
+
+    sink.write("(");
+    write_integer(sink, static_cast<int64_t>(emitted));
+    sink.write(truncated ? " 行，结果过大已截断)" : " 行)");
+}
+
+
+// CSV 解析错误：position 为出错处在数据块中的字节偏移，由调用方换算成行号
+struct CsvError {
+    size_t position;
+    std::string message;
+};
+
+// 数据块中的一段完整记录：解析结果从 values 的第 first_row 行起存放，最多 capacity 行（段内换行数加一）
+// 字符串值指向数据块本身；带转义引号的字段去掉转义后存入 strings
+struct CsvPiece {
+    size_t first_row = 0;
+    size_t capacity = 0;
+    size_t rows = 0;
+    std::unique_ptr<StringHeap> strings = std::make_unique<StringHeap>();
+};
+
+// 把一个字段转换为列类型的值并检查长度
+Value convert_field(const ColumnDef& def, std::string_view field, size_t position) {
+    Value value;
+    const char* first = field.data();
+    const char* last = field.data() + field.size();
+    switch (def.type) {
+        case ColumnType::INT64: {
+            auto result = std::from_chars(first + (field.starts_with('+') ? 1 : 0), last, value.integer);
+            if (field.empty() || result.ec != std::errc() || result.ptr != last) {
+                throw CsvError{position, "列 " + def.name + " 需要整数值: '" + std::string(field) + "'"};
+            }
+            break;
+        }
+        case ColumnType::DOUBLE: {
+            auto result = std::from_chars(first + (field.starts_with('+') ? 1 : 0), last, value.real);
+            if (field.empty() || result.ec != std::errc() || result.ptr != last) {
+                throw CsvError{position, "列 " + def.name + " 需要数值: '" + std::string(field) + "'"};
+            }
+            break;
+        }
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            if (def.width > 0 && field.size() > def.width) {
+                throw CsvError{position, "值超过列 " + def.name + " 的长度上限 " + std::to_string(def.width)};
+            }
+            value.text = field;
+            break;
+    }
+    return value;
+}
+
+// 解析 data 中 [begin, end) 范围内的记录，每条记录按列顺序写入 out 中的一行，返回记录数
+// 字段以逗号分隔，记录以 \n 或 \r\n 结束，空行跳过；字段可以用双引号包围（其中可以有逗号与换行，
+// "" 表示引号本身），去掉转义后的字符串存入 strings
+size_t parse_csv(const Table& table, std::string_view data, size_t begin, size_t end, Value* out,
+                 StringHeap& strings) {
+    size_t column_count = table.columnCount();
+    const char* base = data.data();
+    const char* p = base + begin;
+    const char* limit = base + end;
+    std::string unescaped;
+    size_t rows = 0;
+    while (p < limit) {
+        if (*p == '\n' || (*p == '\r' && p + 1 < limit && p[1] == '\n')) {
+            p += *p == '\n' ? 1 : 2;
+            continue;
+        }
+        for (size_t i = 0; i < column_count; ++i) {
+            auto position = static_cast<size_t>(p - base);
+            std::string_view field;
+            if (p < limit && *p == '"') {
+                const char* quote = p + 1;
+                bool escaped = false;
+                while (true) {
+                    quote = static_cast<const char*>(memchr(quote, '"', static_cast<size_t>(limit - quote)));
+                    if (!quote) {
+                        throw CsvError{position, "未闭合的引号"};
+                    }
+                    if (quote + 1 < limit && quote[1] == '"') {
+                        escaped = true;
+                        quote += 2;
+                        continue;
+                    }
+                    break;
+                }
+                field = std::string_view(p + 1, static_cast<size_t>(quote - p - 1));
+                p = quote + 1;
+                if (escaped) {
+                    unescaped.clear();
+                    for (size_t k = 0; k < field.size(); ++k) {
+                        unescaped += field[k];
+                        k += field[k] == '"' ? 1u : 0u;
+                    }
+                    field = strings.store(unescaped).view();
+                }
+            } else {
+                const char* start = p;
+                while (p < limit && *p != ',' && *p != '\n') {
+                    ++p;
+                }
+                field = std::string_view(start, static_cast<size_t>(p - start));
+                if (field.ends_with('\r') && i + 1 == column_count) {
+                    field.remove_suffix(1);
+                }
+            }
+            out[rows * column_count + i] = convert_field(table.columnDef(i), field, position);
+
+            if (i + 1 < column_count) {
+                if (p >= limit || *p != ',') {
+                    throw CsvError{position, "字段数少于列数 " + std::to_string(column_count)};
+                }
+                ++p;
+            } else {
+                p += p < limit && *p == '\r' ? 1 : 0;
+                if (p < limit && *p != '\n') {
+                    throw CsvError{position, "字段数多于列数 " + std::to_string(column_count)};
+                }
+                ++p;
+            }
+        }
+        ++rows;
+    }
+    return rows;
+}
+
+// 把数据块按记录边界切成约 COPY_PIECE_BYTES 的段：换行之前的引号个数为偶数时换行在引号之外，是记录边界
+std::vector<size_t> split_records(std::string_view data) {
+    std::vector<size_t> bounds{0};
+    size_t quotes = 0;
+    size_t counted = 0;
+    size_t target = COPY_PIECE_BYTES;
+    while (target < data.size()) {
+        size_t newline = data.find('\n', target);
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        quotes += static_cast<size_t>(std::count(data.begin() + static_cast<std::ptrdiff_t>(counted),
+                                                 data.begin() + static_cast<std::ptrdiff_t>(newline), '"'));
+        counted = newline;
+        if (quotes % 2 == 0) {
+            bounds.push_back(newline + 1);
+            target = newline + 1 + COPY_PIECE_BYTES;
+        } else {
+            target = newline + 1;
+        }
+    }
+    bounds.push_back(data.size());
+    return bounds;
+}
+
+} // namespace
+
+void execute_parsed(Catalog& catalog, const Statement& statement, ResultSink& sink,
+                    const std::vector<Literal>& parameters) {
+    if (const auto* create = std::get_if<CreateTableStatement>(&statement)) {
+        execute_create(catalog, *create, sink);
+    } else if (const auto* insert = std::get_if<InsertStatement>(&statement)) {
+        execute_insert(catalog, *insert, parameters, sink);
+    } else if (const auto* update = std::get_if<UpdateStatement>(&statement)) {
+        execute_update(catalog, *update, parameters, sink);
+    } else if (const auto* remove = std::get_if<DeleteStatement>(&statement)) {
+        execute_delete(catalog, *remove, parameters, sink);
+    } else {
+        execute_select(catalog, std::get<SelectStatement>(statement), parameters, sink);
+    }
+}
+
+void execute_sql(Catalog& catalog, std::string_view sql, ResultSink& sink) {
+    execute_parsed(catalog, parse_statement(sql), sink);
+}
+
+void execute_cached(Catalog& catalog, PlanCache& cache, std::string_view sql, ResultSink& sink) {
+    // 键与字面量的缓冲区按线程复用，稳态下规范化不分配内存
+    thread_local std::string key;
+    thread_local std::vector<Literal> literals;
+    if (!normalize_statement(sql, key, literals)) {
+        execute_sql(catalog, sql, sink);
+        return;
+    }
+
+    std::shared_ptr<const PreparedStatement> prepared = cache.find(key);
+    if (!prepared) {
+        auto fresh = std::make_shared<PreparedStatement>();
+        try {
+            fresh->statement = parse_statement(key, &fresh->parameters);
+        } catch (const SqlError&) {
+            // 按原文重新解析，错误信息指向原语句中的位置
+            execute_sql(catalog, sql, sink);
+            return;
+        }
+        prepared = cache.insert(key, std::move(fresh));
+    }
+    execute_parsed(catalog, prepared->statement, sink, literals);
+}
+
+size_t copy_csv(Catalog& catalog, const std::string& table_name, std::string_view records, uint64_t first_line) {
+    Table& table = require_table(catalog, table_name);
+    std::vector<size_t> bounds = split_records(records);
+    std::vector<CsvPiece> pieces(bounds.size() - 1);
+    size_t capacity = 0;
+    for (size_t piece = 0; piece < pieces.size(); ++piece) {
+        auto first = records.begin() + static_cast<std::ptrdiff_t>(bounds[piece]);
+        auto last = records.begin() + static_cast<std::ptrdiff_t>(bounds[piece + 1]);
+        pieces[piece].first_row = capacity;
+        pieces[piece].capacity = static_cast<size_t>(std::count(first, last, '\n')) + 1;
+        capacity += pieces[piece].capacity;
+    }
+
+    // 各段直接解析到同一个数组中各自的区间，之后只需挪动段间的空隙
+    size_t column_count = table.columnCount();
+    std::vector<Value> values(capacity * column_count);
+    auto task = [&](size_t, size_t index) {
+        CsvPiece& piece = pieces[index];
+        piece.rows = parse_csv(table, records, bounds[index], bounds[index + 1],
+                               &values[piece.first_row * column_count], *piece.strings);
+    };
+    try {
+        if (query_scheduler && pieces.size() > 1) {
+            query_scheduler->run(pieces.size(), task);
+        } else {
+            for (size_t piece = 0; piece < pieces.size(); ++piece) {
+                task(0, piece);
+            }
+        }
+    } catch (const CsvError& e) {
+        auto end = records.begin() + static_cast<std::ptrdiff_t>(e.position);
+        uint64_t line = first_line + static_cast<uint64_t>(std::count(records.begin(), end, '\n'));
+        throw SqlError("第 " + std::to_string(line) + " 行: " + e.message);
+    }
+
+    size_t rows = 0;
+    for (const CsvPiece& piece : pieces) {
+        if (piece.first_row != rows) {
+            std::copy_n(&values[piece.first_row * column_count], piece.rows * column_count,
+                        &values[rows * column_count]);
+        }
+        rows += piece.rows;
+    }
+    if (rows > 0) {
+        insert_rows(catalog, table, values.data(), rows);
+    }
+    return rows;
+}
+
+void init_query_parallelism(size_t threads, bool pin) {
+    if (threads == 0) {
+        threads = MorselScheduler::availableCpus();
+    }
+    query_scheduler.reset();
+    if (threads > 1) {
+        query_scheduler = std::make_unique<MorselScheduler>(threads - 1, pin);
+    }
+}
+
+void shutdown_query_parallelism() {
+    query_scheduler.reset();
+}
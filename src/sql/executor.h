@@ -0,0 +1,47 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "sql/parser.h"
+#include "sql/plan_cache.h"
+#include "storage/catalog.h"
+
+#define COPY_PIECE_BYTES (256u * 1024)  // 批量导入时一个数据块切成的段的大小，各段并行解析
+
+// 执行结果的输出目标，由调用方决定结果写到哪里（如直接写入应答帧）
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+
+    virtual void write(std::string_view text) = 0;
+
+    // 返回 false 时执行器停止输出更多结果行（例如应答即将超过帧大小上限）
+    virtual bool accepting() const { return true; }
+};
+
+// 解析并执行一条 SQL 语句，结果以文本表格形式写入 sink；出错时抛出 SqlError
+void execute_sql(Catalog& catalog, std::string_view sql, ResultSink& sink);
+
+// 执行已解析的语句，语句中的参数按序号取 parameters 中的值
+void execute_parsed(Catalog& catalog, const Statement& statement, ResultSink& sink,
+                    const std::vector<Literal>& parameters = {});
+
+// 与 execute_sql 相同，但先把语句规范化（字面量提取为参数）后在 cache 中查找，
+// 命中时跳过语法分析，直接以提取出的字面量为参数执行
+void execute_cached(Catalog& catalog, PlanCache& cache, std::string_view sql, ResultSink& sink);
+
+// 批量导入：records 为若干完整的 CSV 记录，每条按表的列顺序给出全部列（不经过 SQL 解析）。
+// 数据块按记录边界切段，由单条查询的并行线程解析，全部检查通过后作为一次提交写入表中，返回导入的行数；
+// 格式或类型错误时抛出 SqlError（行号从 first_line 起算），表不变
+size_t copy_csv(Catalog& catalog, const std::string& table, std::string_view records, uint64_t first_line = 1);
+
+// 单条查询的并行度：大表上的聚合查询切成 MORSEL_ROWS 行的片段，由 threads 个线程（含发起查询的线程）执行
+// threads 为 0 时按可用 CPU 数，为 1 时不并行；未调用时不并行
+void init_query_parallelism(size_t threads, bool pin);
+void shutdown_query_parallelism();
+
+#endif // EXECUTOR_H
@@ -0,0 +1,429 @@
+#include <limits>
+#include "sql/kernels.h"
+#include "storage/encoding.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SQL_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// 聚合运算：单位元与两两合并，标量与向量版本共用
+struct SumOp {
+    template<typename T>
+    static T identity() { return T(0); }
+
+    // 整数求和按补码回绕，与向量加法一致
+    static int64_t combine(int64_t a, int64_t b) {
+        return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+    }
+    static double combine(double a, double b) { return a + b; }
+
+#ifdef SQL_KERNEL_X86
+    __attribute__((target("avx2")))
+    static __m256i combine(__m256i a, __m256i b) { return _mm256_add_epi64(a, b); }
+    __attribute__((target("avx2")))
+    static __m256d combine(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+#endif
+};
+
+struct MinOp {
+    template<typename T>
+    static T identity() {
+        if constexpr (std::numeric_limits<T>::has_infinity) {
+            return std::numeric_limits<T>::infinity();
+        } else {
+            return std::numeric_limits<T>::max();
+        }
+    }
+
+    template<typename T>
+    static T combine(T a, T b) { return b < a ? b : a; }
+
+#ifdef SQL_KERNEL_X86
+    __attribute__((target("avx2")))
+    static __m256i combine(__m256i a, __m256i b) {
+        return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    }
+    __attribute__((target("avx2")))
+    static __m256d combine(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+#endif
+};
+
+struct MaxOp {
+    template<typename T>
+    static T identity() {
+        if constexpr (std::numeric_limits<T>::has_infinity) {
+            return -std::numeric_limits<T>::infinity();
+        } else {
+            return std::numeric_limits<T>::min();
+        }
+    }
+
+    template<typename T>
+    static T combine(T a, T b) { return a < b ? b : a; }
+
+#ifdef SQL_KERNEL_X86
+    __attribute__((target("avx2")))
+    static __m256i combine(__m256i a, __m256i b) {
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    }
+    __attribute__((target("avx2")))
+    static __m256d combine(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+#endif
+};
+
+template<typename Op, typename T>
+T reduce_scalar(const T* values, const uint16_t* sel, uint32_t n) {
+    T result = Op::template identity<T>();
+    if (sel == nullptr) {
+        for (uint32_t i = 0; i < n; ++i) {
+            result = Op::combine(result, values[i]);
+        }
+    } else {
+        for (uint32_t k = 0; k < n; ++k) {
+            result = Op::combine(result, values[sel[k]]);
+        }
+    }
+    return result;
+}
+
+template<typename T>
+uint32_t filter_scalar_values(const T* values, const uint16_t* sel, uint32_t n,
+                              CompareOp op, T value, uint16_t* out) {
+    return with_compare_op(op, [&](auto tag) {
+        return filter_scalar<decltype(tag)::value>([values](uint32_t i) { return values[i]; },
+                                                   sel, n, value, out);
+    });
+}
+
+#ifdef SQL_KERNEL_X86
+
+// 8 位比较掩码到 8 个 uint16 下标的压缩重排表：PSHUFB 把选中的下标移到低位
+struct CompressTable {
+    alignas(16) uint8_t shuffle[256][16];
+
+    constexpr CompressTable() : shuffle() {
+        for (unsigned mask = 0; mask < 256; ++mask) {
+            unsigned k = 0;
+            for (unsigned lane = 0; lane < 8; ++lane) {
+                if (mask & (1u << lane)) {
+                    shuffle[mask][2 * k] = static_cast<uint8_t>(2 * lane);
+                    shuffle[mask][2 * k + 1] = static_cast<uint8_t>(2 * lane + 1);
+                    ++k;
+                }
+            }
+            for (; k < 8; ++k) {
+                shuffle[mask][2 * k] = 0x80;
+                shuffle[mask][2 * k + 1] = 0x80;
+            }
+        }
+    }
+};
+
+constexpr CompressTable COMPRESS_TABLE;
+
+__attribute__((target("avx2")))
+inline __m256i broadcast(int64_t value) { return _mm256_set1_epi64x(value); }
+
+__attribute__((target("avx2")))
+inline __m256d broadcast(double value) { return _mm256_set1_pd(value); }
+
+__attribute__((target("avx2")))
+inline void store4(int64_t* lanes, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+}
+
+__attribute__((target("avx2")))
+inline void store4(double* lanes, __m256d v) { _mm256_storeu_pd(lanes, v); }
+
+// 读取第 i..i+3 个元素：稠密时连续加载，否则按 sel 中的下标 gather
+// 使用带掩码的 gather 并显式给出初值，非掩码版本在 GCC 12 下会误报未初始化
+template<bool SPARSE>
+__attribute__((target("avx2")))
+inline __m256i load4(const int64_t* values, const uint16_t* sel, uint32_t i) {
+    if constexpr (SPARSE) {
+        __m128i index = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sel + i)));
+        return _mm256_mask_i32gather_epi64(_mm256_setzero_si256(), reinterpret_cast<const long long*>(values),
+                                           index, _mm256_set1_epi64x(-1), 8);
+    } else {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    }
+}
+
+template<bool SPARSE>
+__attribute__((target("avx2")))
+inline __m256d load4(const double* values, const uint16_t* sel, uint32_t i) {
+    if constexpr (SPARSE) {
+        __m128i index = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sel + i)));
+        return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), values, index,
+                                        _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+    } else {
+        return _mm256_loadu_pd(values + i);
+    }
+}
+
+// 4 路比较的结果掩码（低 4 位）。AVX2 只有 64 位整数的 EQ 与 GT，其余比较由交换操作数或取反得到
+template<CompareOp OP>
+__attribute__((target("avx2")))
+inline unsigned compare_mask(__m256i v, __m256i c) {
+    __m256i hit;
+    if constexpr (OP == CompareOp::EQ || OP == CompareOp::NE) {
+        hit = _mm256_cmpeq_epi64(v, c);
+    } else if constexpr (OP == CompareOp::GT || OP == CompareOp::LE) {
+        hit = _mm256_cmpgt_epi64(v, c);
+    } else {
+        hit = _mm256_cmpgt_epi64(c, v);
+    }
+    auto mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hit)));
+    if constexpr (OP == CompareOp::NE || OP == CompareOp::LE || OP == CompareOp::GE) {
+        mask ^= 0xFu;
+    }
+    return mask;
+}
+
+template<CompareOp OP>
+__attribute__((target("avx2")))
+inline unsigned compare_mask(__m256d v, __m256d c) {
+    // 与标量比较的 NaN 语义一致：只有 NE 在无序时成立
+    constexpr int PREDICATE = OP == CompareOp::EQ ? _CMP_EQ_OQ
+                            : OP == CompareOp::NE ? _CMP_NEQ_UQ
+                            : OP == CompareOp::LT ? _CMP_LT_OQ
+                            : OP == CompareOp::LE ? _CMP_LE_OQ
+                            : OP == CompareOp::GT ? _CMP_GT_OQ
+                                                  : _CMP_GE_OQ;
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(v, c, PREDICATE)));
+}
+
+// 每次比较 8 个值，用压缩表把选中的下标一次写出 8 个 uint16，再按选中个数前移
+// 写出位置不超过读取位置，因此 out 可以与 sel 相同
+template<CompareOp OP, bool SPARSE, typename T>
+__attribute__((target("avx2")))
+uint32_t filter_avx2(const T* values, const uint16_t* sel, uint32_t n, T value, uint16_t* out) {
+    auto c = broadcast(value);
+    const __m128i lanes = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned mask = compare_mask<OP>(load4<SPARSE>(values, sel, i), c) |
+                        compare_mask<OP>(load4<SPARSE>(values, sel, i + 4), c) << 4;
+        __m128i indices;
+        if constexpr (SPARSE) {
+            indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sel + i));
+        } else {
+            indices = _mm_add_epi16(lanes, _mm_set1_epi16(static_cast<short>(i)));
+        }
+        __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(COMPRESS_TABLE.shuffle[mask]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_shuffle_epi8(indices, shuffle));
+        count += static_cast<uint32_t>(__builtin_popcount(mask));
+    }
+    for (; i < n; ++i) {
+        auto index = static_cast<uint16_t>(SPARSE ? sel[i] : i);
+        out[count] = index;
+        count += compare_values<OP>(values[index], value) ? 1u : 0u;
+    }
+    return count;
+}
+
+template<typename T>
+uint32_t filter_avx2_values(const T* values, const uint16_t* sel, uint32_t n,
+                            CompareOp op, T value, uint16_t* out) {
+    return with_compare_op(op, [&](auto tag) {
+        constexpr CompareOp OP = decltype(tag)::value;
+        return sel == nullptr ? filter_avx2<OP, false>(values, sel, n, value, out)
+                              : filter_avx2<OP, true>(values, sel, n, value, out);
+    });
+}
+
+// 两个向量累加器交替使用以隐藏延迟，最后横向合并并处理尾部
+template<typename Op, bool SPARSE, typename T>
+__attribute__((target("avx2")))
+T reduce_avx2(const T* values, const uint16_t* sel, uint32_t n) {
+    auto acc0 = broadcast(Op::template identity<T>());
+    auto acc1 = acc0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = Op::combine(acc0, load4<SPARSE>(values, sel, i));
+        acc1 = Op::combine(acc1, load4<SPARSE>(values, sel, i + 4));
+    }
+    T lanes[4];
+    store4(lanes, Op::combine(acc0, acc1));
+    T result = Op::template identity<T>();
+    for (T lane : lanes) {
+        result = Op::combine(result, lane);
+    }
+    for (; i < n; ++i) {
+        result = Op::combine(result, values[SPARSE ? sel[i] : i]);
+    }
+    return result;
+}
+
+// 4 个位打包的值，index 为各值的序号：按字节偏移 gather 8 字节，右移字节内的位偏移后取低 bits 位
+__attribute__((target("avx2")))
+inline __m256i unpack4(const uint8_t* packed, __m256i index, __m256i bits, __m256i mask) {
+    __m256i bit = _mm256_mul_epu32(index, bits);
+    __m256i word = _mm256_mask_i64gather_epi64(_mm256_setzero_si256(), reinterpret_cast<const long long*>(packed),
+                                               _mm256_srli_epi64(bit, 3), _mm256_set1_epi64x(-1), 1);
+    return _mm256_and_si256(_mm256_srlv_epi64(word, _mm256_and_si256(bit, _mm256_set1_epi64x(7))), mask);
+}
+
+// 第 i..i+3 个值的序号：稠密时连续，否则取 sel 中的下标
+template<bool SPARSE>
+__attribute__((target("avx2")))
+inline __m256i packed_index4(size_t first, const uint16_t* sel, uint32_t i) {
+    if constexpr (SPARSE) {
+        __m256i lanes = _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sel + i)));
+        return _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(first)), lanes);
+    } else {
+        return _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(first + i)),
+                                _mm256_setr_epi64x(0, 1, 2, 3));
+    }
+}
+
+// 与 filter_avx2 相同的压缩写出，比较前先解包
+template<CompareOp OP, bool SPARSE>
+__attribute__((target("avx2")))
+uint32_t filter_packed_avx2(const uint8_t* packed, unsigned bits, size_t first, const uint16_t* sel, uint32_t n,
+                            int64_t value, uint16_t* out) {
+    __m256i c = _mm256_set1_epi64x(value);
+    __m256i width = _mm256_set1_epi64x(bits);
+    __m256i mask = _mm256_set1_epi64x(static_cast<long long>((uint64_t{1} << bits) - 1));
+    const __m128i lanes = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned hit = compare_mask<OP>(unpack4(packed, packed_index4<SPARSE>(first, sel, i), width, mask), c) |
+                       compare_mask<OP>(unpack4(packed, packed_index4<SPARSE>(first, sel, i + 4), width, mask), c)
+                           << 4;
+        __m128i indices;
+        if constexpr (SPARSE) {
+            indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sel + i));
+        } else {
+            indices = _mm_add_epi16(lanes, _mm_set1_epi16(static_cast<short>(i)));
+        }
+        __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(COMPRESS_TABLE.shuffle[hit]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_shuffle_epi8(indices, shuffle));
+        count += static_cast<uint32_t>(__builtin_popcount(hit));
+    }
+    for (; i < n; ++i) {
+        auto index = static_cast<uint16_t>(SPARSE ? sel[i] : i);
+        out[count] = index;
+        count += compare_values<OP>(static_cast<int64_t>(unpack_bits(packed, bits, first + index)), value) ? 1u : 0u;
+    }
+    return count;
+}
+
+__attribute__((target("avx2")))
+void unpack_avx2(const uint8_t* packed, unsigned bits, size_t first, int64_t base, uint32_t n, int64_t* out) {
+    __m256i offset = _mm256_set1_epi64x(base);
+    __m256i width = _mm256_set1_epi64x(bits);
+    __m256i mask = _mm256_set1_epi64x(static_cast<long long>((uint64_t{1} << bits) - 1));
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i values = unpack4(packed, packed_index4<false>(first, nullptr, i), width, mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_add_epi64(values, offset));
+    }
+    for (; i < n; ++i) {
+        out[i] = static_cast<int64_t>(static_cast<uint64_t>(base) + unpack_bits(packed, bits, first + i));
+    }
+}
+
+#endif // SQL_KERNEL_X86
+
+template<typename T>
+uint32_t filter_values(ScanIsa isa, const T* values, const uint16_t* sel, uint32_t n,
+                       CompareOp op, T value, uint16_t* out) {
+#ifdef SQL_KERNEL_X86
+    if (isa == ScanIsa::AVX2) {
+        return filter_avx2_values(values, sel, n, op, value, out);
+    }
+#endif
+    (void)isa;
+    return filter_scalar_values(values, sel, n, op, value, out);
+}
+
+template<typename Op, typename T>
+T reduce(ScanIsa isa, const T* values, const uint16_t* sel, uint32_t n) {
+#ifdef SQL_KERNEL_X86
+    if (isa == ScanIsa::AVX2) {
+        return sel == nullptr ? reduce_avx2<Op, false>(values, sel, n)
+                              : reduce_avx2<Op, true>(values, sel, n);
+    }
+#endif
+    (void)isa;
+    return reduce_scalar<Op>(values, sel, n);
+}
+
+} // namespace
+
+uint32_t filter_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n,
+                      CompareOp op, int64_t value, uint16_t* out) {
+    return filter_values(isa, values, sel, n, op, value, out);
+}
+
+uint32_t filter_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n,
+                       CompareOp op, double value, uint16_t* out) {
+    return filter_values(isa, values, sel, n, op, value, out);
+}
+
+uint32_t filter_packed(ScanIsa isa, const uint8_t* packed, unsigned bits, size_t first, const uint16_t* sel,
+                       uint32_t n, CompareOp op, int64_t value, uint16_t* out) {
+    return with_compare_op(op, [&](auto tag) {
+        constexpr CompareOp OP = decltype(tag)::value;
+#ifdef SQL_KERNEL_X86
+        if (isa == ScanIsa::AVX2) {
+            return sel == nullptr ? filter_packed_avx2<OP, false>(packed, bits, first, sel, n, value, out)
+                                  : filter_packed_avx2<OP, true>(packed, bits, first, sel, n, value, out);
+        }
+#endif
+        (void)isa;
+        return filter_scalar<OP>(
+            [packed, bits, first](uint32_t i) { return static_cast<int64_t>(unpack_bits(packed, bits, first + i)); },
+            sel, n, value, out);
+    });
+}
+
+void unpack_int64(ScanIsa isa, const uint8_t* packed, unsigned bits, size_t first, int64_t base,
+                  const uint16_t* sel, uint32_t n, int64_t* out) {
+    if (sel == nullptr) {
+#ifdef SQL_KERNEL_X86
+        if (isa == ScanIsa::AVX2) {
+            unpack_avx2(packed, bits, first, base, n, out);
+            return;
+        }
+#endif
+        for (uint32_t i = 0; i < n; ++i) {
+            out[i] = static_cast<int64_t>(static_cast<uint64_t>(base) + unpack_bits(packed, bits, first + i));
+        }
+        return;
+    }
+    (void)isa;
+    for (uint32_t k = 0; k < n; ++k) {
+        out[sel[k]] = static_cast<int64_t>(static_cast<uint64_t>(base) + unpack_bits(packed, bits, first + sel[k]));
+    }
+}
+
+int64_t sum_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n) {
+    return reduce<SumOp>(isa, values, sel, n);
+}
+
+int64_t min_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n) {
+    return reduce<MinOp>(isa, values, sel, n);
+}
+
+int64_t max_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n) {
+    return reduce<MaxOp>(isa, values, sel, n);
+}
+
+double sum_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n) {
+    return reduce<SumOp>(isa, values, sel, n);
+}
+
+double min_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n) {
+    return reduce<MinOp>(isa, values, sel, n);
+}
+
+double max_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n) {
+    return reduce<MaxOp>(isa, values, sel, n);
+}
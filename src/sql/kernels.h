@@ -0,0 +1,88 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstdint>
+#include <type_traits>
+#include "sql/parser.h"
+#include "sql/tokenizer.h"
+
+// 批执行用的过滤与聚合核
+// 每个核都有 AVX2 与标量两个版本，按 isa 参数选择；ScanIsa::SSE42 按标量处理。
+// sel 为 nullptr 时处理 values[0..n)，否则只处理 values[sel[0..n))。
+
+// 过滤：把满足 values[i] op value 的下标 i 写入 out，返回个数；out 可以与 sel 相同
+uint32_t filter_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n,
+                      CompareOp op, int64_t value, uint16_t* out);
+uint32_t filter_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n,
+                       CompareOp op, double value, uint16_t* out);
+
+// 位打包数据上的过滤：第 first + i 个值（无符号，bits 不超过 BITPACK_MAX_BITS）op value
+// 每次解包 4 个值后直接比较，不写出解包的结果
+uint32_t filter_packed(ScanIsa isa, const uint8_t* packed, unsigned bits, size_t first, const uint16_t* sel,
+                       uint32_t n, CompareOp op, int64_t value, uint16_t* out);
+
+// 位打包数据的解包：out[i] = base + 第 first + i 个值；sel 不为空时只写 out[sel[0..n)]
+void unpack_int64(ScanIsa isa, const uint8_t* packed, unsigned bits, size_t first, int64_t base,
+                  const uint16_t* sel, uint32_t n, int64_t* out);
+
+// 聚合：n 为 0 时返回单位元（0、类型最大值或最小值）
+int64_t sum_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n);
+int64_t min_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n);
+int64_t max_int64(ScanIsa isa, const int64_t* values, const uint16_t* sel, uint32_t n);
+double sum_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n);
+double min_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n);
+double max_double(ScanIsa isa, const double* values, const uint16_t* sel, uint32_t n);
+
+// 编译期确定比较符的比较，供各类型的内层循环使用
+template<CompareOp OP, typename T>
+inline bool compare_values(const T& left, const T& right) {
+    if constexpr (OP == CompareOp::EQ) {
+        return left == right;
+    } else if constexpr (OP == CompareOp::NE) {
+        return left != right;
+    } else if constexpr (OP == CompareOp::LT) {
+        return left < right;
+    } else if constexpr (OP == CompareOp::LE) {
+        return left <= right;
+    } else if constexpr (OP == CompareOp::GT) {
+        return left > right;
+    } else {
+        return left >= right;
+    }
+}
+
+// 把运行期的比较符转换为编译期常量：fn 以 std::integral_constant<CompareOp, OP> 调用
+// 分支只在进入内层循环前发生一次
+template<typename Fn>
+decltype(auto) with_compare_op(CompareOp op, Fn&& fn) {
+    switch (op) {
+        case CompareOp::EQ: return fn(std::integral_constant<CompareOp, CompareOp::EQ>());
+        case CompareOp::NE: return fn(std::integral_constant<CompareOp, CompareOp::NE>());
+        case CompareOp::LT: return fn(std::integral_constant<CompareOp, CompareOp::LT>());
+        case CompareOp::LE: return fn(std::integral_constant<CompareOp, CompareOp::LE>());
+        case CompareOp::GT: return fn(std::integral_constant<CompareOp, CompareOp::GT>());
+        case CompareOp::GE: break;
+    }
+    return fn(std::integral_constant<CompareOp, CompareOp::GE>());
+}
+
+// 标量过滤的通用形式：get(i) 取第 i 行的值，无分支地追加下标
+template<CompareOp OP, typename Get, typename T>
+uint32_t filter_scalar(Get get, const uint16_t* sel, uint32_t n, const T& value, uint16_t* out) {
+    uint32_t count = 0;
+    if (sel == nullptr) {
+        for (uint32_t i = 0; i < n; ++i) {
+            out[count] = static_cast<uint16_t>(i);
+            count += compare_values<OP>(get(i), value) ? 1u : 0u;
+        }
+    } else {
+        for (uint32_t k = 0; k < n; ++k) {
+            uint16_t i = sel[k];
+            out[count] = i;
+            count += compare_values<OP>(get(i), value) ? 1u : 0u;
+        }
+    }
+    return count;
+}
+
+#endif // KERNELS_H
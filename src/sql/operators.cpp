@@ -0,0 +1,727 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include "sql/kernels.h"
+#include "sql/operators.h"
+#include "storage/encoding.h"
+
+namespace {
+
+// 按列类型特化的过滤算子：INT64/DOUBLE 走 SIMD 核函数，字符串走标量模板
+template<typename Traits>
+class FilterOperator final : public Operator {
+public:
+    using value_type = typename Traits::value_type;
+
+    FilterOperator(std::unique_ptr<Operator> child, size_t slot, uint32_t width, CompareOp op,
+                   const Value& value, ScanIsa isa)
+        : child_(std::move(child)), slot_(slot), width_(width), op_(op), isa_(isa) {
+        if constexpr (std::is_same_v<value_type, int64_t>) {
+            value_ = value.integer;
+        } else if constexpr (std::is_same_v<value_type, double>) {
+            value_ = value.real;
+        } else {
+            text_ = value.text;
+            value_ = text_;
+        }
+    }
+
+    bool next(Batch& batch) override {
+        while (child_->next(batch)) {
+            const uint16_t* sel = batch.selection();
+            uint32_t count;
+            if (const EncodedChunk* encoded = batch.encoded[slot_]) {
+                count = filterEncoded(*encoded, batch.chunkOffset(), sel, batch.count, batch.sel);
+            } else if constexpr (std::is_same_v<value_type, int64_t>) {
+                count = filter_int64(isa_, batch.column<int64_t>(slot_), sel, batch.count,
+                                     op_, value_, batch.sel);
+            } else if constexpr (std::is_same_v<value_type, double>) {
+                count = filter_double(isa_, batch.column<double>(slot_), sel, batch.count,
+                                      op_, value_, batch.sel);
+            } else {
+                const char* data = batch.columns[slot_];
+                uint32_t width = width_;
+                count = with_compare_op(op_, [&](auto tag) {
+                    return filter_scalar<decltype(tag)::value>(
+                        [data, width](uint32_t i) { return Traits::get(data, i, width); },
+                        sel, batch.count, value_, batch.sel);
+                });
+            }
+            batch.dense = false;
+            batch.count = count;
+            if (count > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::unique_ptr<Operator> child_;
+    size_t slot_;
+    uint32_t width_;
+    CompareOp op_;
+    ScanIsa isa_;
+    std::string text_;
+    value_type value_{};
+
+    // 字典与位打包的编码与值的顺序一致：求出第一个不小于 value 的编码 lower 与第一个大于 value 的编码 upper
+    // （编码取值 [0, limit)），比较转换为编码上的 EQ/NE/LT/GE，整块都满足或都不满足时不读编码
+    uint32_t filterEncoded(const EncodedChunk& encoded, size_t first, const uint16_t* sel, uint32_t n,
+                           uint16_t* out) const {
+        if (encoded.encoding() == Encoding::RLE) {
+            return with_compare_op(op_, [&](auto tag) {
+                return filter_runs<decltype(tag)::value>(encoded, first, sel, n, out);
+            });
+        }
+        int64_t lower = 0;
+        int64_t upper = 0;
+        int64_t limit = 0;
+        if (encoded.encoding() == Encoding::BITPACK) {
+            if constexpr (std::is_same_v<value_type, int64_t>) {
+                limit = int64_t{1} << encoded.bits();
+                if (value_ >= encoded.base()) {
+                    uint64_t delta = static_cast<uint64_t>(value_) - static_cast<uint64_t>(encoded.base());
+                    lower = delta >= static_cast<uint64_t>(limit) ? limit : static_cast<int64_t>(delta);
+                    upper = std::min(lower + 1, limit);
+                }
+            }
+        } else {
+            const char* values = encoded.values();
+            uint32_t width = width_;
+            auto count = static_cast<uint32_t>(encoded.valueCount());
+            auto bound = [&](bool inclusive) {
+                uint32_t low = 0;
+                uint32_t high = count;
+                while (low < high) {
+                    uint32_t mid = low + (high - low) / 2;
+                    value_type entry = Traits::get(values, mid, width);
+                    if (inclusive ? !(value_ < entry) : entry < value_) {
+                        low = mid + 1;
+                    } else {
+                        high = mid;
+                    }
+                }
+                return static_cast<int64_t>(low);
+            };
+            limit = count;
+            lower = bound(false);
+            upper = bound(true);
+        }
+
+        CompareOp op = op_;
+        int64_t key = lower;
+        switch (op_) {
+            case CompareOp::EQ:
+                if (lower == upper) {
+                    return 0;
+                }
+                break;
+            case CompareOp::NE:
+                if (lower == upper) {
+                    return select_all(sel, n, out);
+                }
+                break;
+            case CompareOp::LT:
+                break;
+            case CompareOp::LE:
+                op = CompareOp::LT;
+                key = upper;
+                break;
+            case CompareOp::GT:
+                op = CompareOp::GE;
+                key = upper;
+                break;
+            case CompareOp::GE:
+                break;
+        }
+        if ((op == CompareOp::LT && key == 0) || (op == CompareOp::GE && key >= limit)) {
+            return 0;
+        }
+        if ((op == CompareOp::LT && key >= limit) || (op == CompareOp::GE && key == 0)) {
+            return select_all(sel, n, out);
+        }
+        return filter_packed(isa_, encoded.packed(), encoded.bits(), first, sel, n, op, key, out);
+    }
+
+    // 游程：每段的值只比较一次，稠密批按段整段写出下标
+    template<CompareOp OP>
+    uint32_t filter_runs(const EncodedChunk& encoded, size_t first, const uint16_t* sel, uint32_t n,
+                         uint16_t* out) const {
+        const uint32_t* ends = encoded.runEnds();
+        size_t run = encoded.runOf(first);
+        auto hit = [&](size_t r) {
+            return compare_values<OP>(Traits::get(encoded.values(), static_cast<uint32_t>(r), width_), value_);
+        };
+        uint32_t count = 0;
+        if (sel == nullptr) {
+            for (uint32_t i = 0; i < n; ++run) {
+                auto end = static_cast<uint32_t>(std::min<size_t>(ends[run] - first, n));
+                if (hit(run)) {
+                    for (; i < end; ++i) {
+                        out[count++] = static_cast<uint16_t>(i);
+                    }
+                }
+                i = end;
+            }
+            return count;
+        }
+        bool matched = hit(run);
+        for (uint32_t k = 0; k < n; ++k) {
+            uint16_t i = sel[k];
+            if (first + i >= ends[run]) {
+                do {
+                    ++run;
+                } while (first + i >= ends[run]);
+                matched = hit(run);
+            }
+            out[count] = i;
+            count += matched ? 1u : 0u;
+        }
+        return count;
+    }
+
+    static uint32_t select_all(const uint16_t* sel, uint32_t n, uint16_t* out) {
+        for (uint32_t i = 0; i < n; ++i) {
+            out[i] = sel == nullptr ? static_cast<uint16_t>(i) : sel[i];
+        }
+        return n;
+    }
+};
+
+// 按列类型特化的聚合累加：每批一次虚调用，批内由核函数或紧凑的模板循环完成
+template<typename Traits>
+class TypedAccumulator final : public AggregateOperator::Accumulator {
+public:
+    TypedAccumulator(const AggregateSpec& spec, ScanIsa isa) : spec_(spec), isa_(isa) {}
+
+    void update(const Batch& batch, AggregateState& state) override {
+        AggregateState partial;
+        partial.count = batch.count;
+        if (spec_.kind != AggregateKind::COUNT && !spec_.star) {
+            accumulate(batch, partial);
+        }
+        state.merge(spec_, partial, &strings_);
+    }
+
+private:
+    AggregateSpec spec_;
+    ScanIsa isa_;
+    StringHeap strings_;        // 跨批保留的 CHAR 最值
+
+    void accumulate(const Batch& batch, AggregateState& partial) const {
+        const uint16_t* sel = batch.selection();
+        uint32_t n = batch.count;
+        AggregateKind kind = spec_.kind == AggregateKind::AVG ? AggregateKind::SUM : spec_.kind;
+        if constexpr (std::is_same_v<typename Traits::value_type, int64_t>) {
+            const int64_t* values = batch.column<int64_t>(spec_.slot);
+            partial.integer = kind == AggregateKind::SUM ? sum_int64(isa_, values, sel, n)
+                            : kind == AggregateKind::MIN ? min_int64(isa_, values, sel, n)
+                                                         : max_int64(isa_, values, sel, n);
+        } else if constexpr (std::is_same_v<typename Traits::value_type, double>) {
+            const double* values = batch.column<double>(spec_.slot);
+            partial.real = kind == AggregateKind::SUM ? sum_double(isa_, values, sel, n)
+                         : kind == AggregateKind::MIN ? min_double(isa_, values, sel, n)
+                                                      : max_double(isa_, values, sel, n);
+        } else {
+            // 字符串只支持 MIN/MAX（由执行器检查）
+            const char* data = batch.columns[spec_.slot];
+            bool min = kind == AggregateKind::MIN;
+            std::string_view best = Traits::get(data, batch.selected(0), spec_.width);
+            for (uint32_t k = 1; k < n; ++k) {
+                std::string_view value = Traits::get(data, batch.selected(k), spec_.width);
+                if (min ? value < best : best < value) {
+                    best = value;
+                }
+            }
+            partial.text = best;
+        }
+    }
+};
+
+template<template<typename> class T, typename... Args>
+auto make_typed(ColumnType type, Args&&... args) {
+    using Base = std::conditional_t<std::is_base_of_v<Operator, T<Int64Traits>>,
+                                    Operator, AggregateOperator::Accumulator>;
+    std::unique_ptr<Base> result;
+    switch (type) {
+        case ColumnType::INT64:
+            result = std::make_unique<T<Int64Traits>>(std::forward<Args>(args)...);
+            break;
+        case ColumnType::DOUBLE:
+            result = std::make_unique<T<DoubleTraits>>(std::forward<Args>(args)...);
+            break;
+        case ColumnType::CHAR:
+            result = std::make_unique<T<CharTraits>>(std::forward<Args>(args)...);
+            break;
+        case ColumnType::VARCHAR:
+            result = std::make_unique<T<VarcharTraits>>(std::forward<Args>(args)...);
+            break;
+    }
+    return result;
+}
+
+// 按值的字节数复制，常见的 8 与 16 字节（整数、浮点数与 StringRef）在编译期确定长度
+template<typename Fn>
+void with_value_size(size_t size, Fn&& fn) {
+    if (size == 8) {
+        fn([](char* out, const char* in) { memcpy(out, in, 8); });
+    } else if (size == 16) {
+        fn([](char* out, const char* in) { memcpy(out, in, 16); });
+    } else {
+        fn([size](char* out, const char* in) { memcpy(out, in, size); });
+    }
+}
+
+} // namespace
+
+ScanOperator::ScanOperator(const TableData& data, std::vector<size_t> columns, size_t begin, size_t end,
+                           int64_t snapshot)
+    : data_(data), columns_(std::move(columns)), position_(begin), end_(end), snapshot_(snapshot) {}
+
+bool ScanOperator::next(Batch& batch) {
+    for (;;) {
+        if (position_ >= end_) {
+            return false;
+        }
+        size_t chunk = position_ / CHUNK_ROWS;
+        size_t offset = position_ % CHUNK_ROWS;
+        size_t rows = std::min({end_ - position_, CHUNK_ROWS - offset, static_cast<size_t>(BATCH_SIZE)});
+
+        batch.row_base = position_;
+        batch.size = static_cast<uint32_t>(rows);
+        batch.count = batch.size;
+        batch.dense = true;
+        batch.column_count = columns_.size();
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            // 先取压缩形式：为空时未压缩的数据在本次扫描期间不会被释放
+            const Column& column = data_.column(columns_[i]);
+            batch.encoded[i] = column.encodedChunk(chunk);
+            batch.columns[i] = batch.encoded[i] ? nullptr : column.chunk(chunk) + offset * column.valueSize();
+        }
+        position_ += rows;
+        if (!data_.chunkHasDeletes(chunk)) {
+            return true;
+        }
+
+        // 块内有删除：结束时间戳不大于快照的行不可见
+        const int64_t* end_ts = data_.end_ts.values<int64_t>(chunk) + offset;
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < batch.size; ++i) {
+            batch.sel[count] = static_cast<uint16_t>(i);
+            count += __atomic_load_n(&end_ts[i], __ATOMIC_RELAXED) > snapshot_ ? 1u : 0u;
+        }
+        if (count == batch.size) {
+            return true;
+        }
+        if (count > 0) {
+            batch.count = count;
+            batch.dense = false;
+            return true;
+        }
+    }
+}
+
+DecodeOperator::DecodeOperator(std::unique_ptr<Operator> child, ScanIsa isa)
+    : child_(std::move(child)), isa_(isa) {}
+
+bool DecodeOperator::next(Batch& batch) {
+    if (!child_->next(batch)) {
+        return false;
+    }
+    for (size_t i = 0; i < batch.column_count; ++i) {
+        const EncodedChunk* encoded = batch.encoded[i];
+        if (!encoded) {
+            continue;
+        }
+        if (!buffers_[i]) {
+            buffers_[i] = std::make_unique<int64_t[]>((BATCH_SIZE * encoded->valueSize() + 7) / 8);
+        }
+        char* out = reinterpret_cast<char*>(buffers_[i].get());
+        decode(*encoded, batch, out);
+        batch.columns[i] = out;
+        batch.encoded[i] = nullptr;
+    }
+    return true;
+}
+
+void DecodeOperator::decode(const EncodedChunk& encoded, const Batch& batch, char* out) {
+    size_t first = batch.chunkOffset();
+    const uint16_t* sel = batch.selection();
+    uint32_t n = batch.count;
+    size_t size = encoded.valueSize();
+    const char* values = encoded.values();
+    switch (encoded.encoding()) {
+        case Encoding::BITPACK:
+            unpack_int64(isa_, encoded.packed(), encoded.bits(), first, encoded.base(), sel, n,
+                         reinterpret_cast<int64_t*>(out));
+            break;
+        case Encoding::DICTIONARY: {
+            if (!codes_) {
+                codes_ = std::make_unique<int64_t[]>(BATCH_SIZE);
+            }
+            const int64_t* codes = codes_.get();
+            unpack_int64(isa_, encoded.packed(), encoded.bits(), first, 0, sel, n, codes_.get());
+            with_value_size(size, [&](auto copy) {
+                for (uint32_t k = 0; k < n; ++k) {
+                    uint32_t i = batch.selected(k);
+                    copy(out + i * size, values + static_cast<size_t>(codes[i]) * size);
+                }
+            });
+            break;
+        }
+        case Encoding::RLE: {
+            const uint32_t* ends = encoded.runEnds();
+            size_t run = encoded.runOf(first);
+            with_value_size(size, [&](auto copy) {
+                for (uint32_t k = 0; k < n; ++k) {
+                    uint32_t i = batch.selected(k);
+                    while (first + i >= ends[run]) {
+                        ++run;
+                    }
+                    copy(out + i * size, values + run * size);
+                }
+            });
+            break;
+        }
+        case Encoding::PLAIN:
+            break;
+    }
+}
+
+ProjectOperator::ProjectOperator(std::unique_ptr<Operator> child, std::vector<size_t> slots)
+    : child_(std::move(child)), slots_(std::move(slots)) {}
+
+bool ProjectOperator::next(Batch& batch) {
+    if (!child_->next(batch)) {
+        return false;
+    }
+    const char* columns[MAX_BATCH_COLUMNS];
+    std::copy(batch.columns, batch.columns + MAX_BATCH_COLUMNS, columns);
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        batch.columns[i] = columns[slots_[i]];
+    }
+    batch.column_count = slots_.size();
+    return true;
+}
+
+LimitOperator::LimitOperator(std::unique_ptr<Operator> child, size_t limit)
+    : child_(std::move(child)), remaining_(limit) {}
+
+bool LimitOperator::next(Batch& batch) {
+    if (remaining_ == 0 || !child_->next(batch)) {
+        return false;
+    }
+    // 截断只需缩小 count，稠密批的选中行也是前缀
+    if (batch.count > remaining_) {
+        batch.count = static_cast<uint32_t>(remaining_);
+    }
+    remaining_ -= batch.count;
+    return true;
+}
+
+std::unique_ptr<Operator> make_filter(std::unique_ptr<Operator> child, size_t slot,
+                                      const ColumnDef& def, CompareOp op, const Value& value,
+                                      ScanIsa isa) {
+    return make_typed<FilterOperator>(def.type, std::move(child), slot, def.width, op, value, isa);
+}
+
+void AggregateState::merge(const AggregateSpec& spec, const AggregateState& other, StringHeap* strings) {
+    auto retain = [&]() {
+        if (strings && spec.type == ColumnType::CHAR && !text.empty() && text.data() == other.text.data()) {
+            text = strings->store(text).view();
+        }
+    };
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        retain();
+        return;
+    }
+    count += other.count;
+    AggregateKind kind = spec.kind == AggregateKind::AVG ? AggregateKind::SUM : spec.kind;
+    if (kind == AggregateKind::COUNT || spec.star) {
+        return;
+    }
+    switch (spec.type) {
+        case ColumnType::INT64:
+            if (kind == AggregateKind::SUM) {
+                integer = static_cast<int64_t>(static_cast<uint64_t>(integer) +
+                                               static_cast<uint64_t>(other.integer));
+            } else {
+                integer = kind == AggregateKind::MIN ? std::min(integer, other.integer)
+                                                     : std::max(integer, other.integer);
+            }
+            break;
+        case ColumnType::DOUBLE:
+            if (kind == AggregateKind::SUM) {
+                real += other.real;
+            } else {
+                real = kind == AggregateKind::MIN ? std::min(real, other.real)
+                                                  : std::max(real, other.real);
+            }
+            break;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            text = kind == AggregateKind::MIN ? std::min(text, other.text)
+                                              : std::max(text, other.text);
+            retain();
+            break;
+    }
+}
+
+AggregateOperator::AggregateOperator(std::unique_ptr<Operator> child, std::vector<AggregateSpec> specs,
+                                     ScanIsa isa)
+    : child_(std::move(child)), specs_(std::move(specs)), states_(specs_.size()) {
+    for (const auto& spec : specs_) {
+        accumulators_.push_back(make_typed<TypedAccumulator>(spec.type, spec, isa));
+    }
+}
+
+AggregateOperator::~AggregateOperator() = default;
+
+void AggregateOperator::run() {
+    Batch batch;
+    while (child_->next(batch)) {
+        for (size_t i = 0; i < accumulators_.size(); ++i) {
+            accumulators_[i]->update(batch, states_[i]);
+        }
+    }
+}
+
+namespace {
+
+// 批中第 index 行某列的值
+Value batch_value(ColumnType type, const char* data, uint32_t index, uint32_t width) {
+    Value value;
+    switch (type) {
+        case ColumnType::INT64:
+            value.integer = Int64Traits::get(data, index, width);
+            break;
+        case ColumnType::DOUBLE:
+            value.real = DoubleTraits::get(data, index, width);
+            break;
+        case ColumnType::CHAR:
+            value.text = CharTraits::get(data, index, width);
+            break;
+        case ColumnType::VARCHAR:
+            value.text = VarcharTraits::get(data, index, width);
+            break;
+    }
+    return value;
+}
+
+// 把分组键追加编码到 out：数值为 8 字节，字符串为 4 字节长度加内容，编码相同当且仅当各列值相等
+void encode_key(std::string& out, const GroupKeySpec& spec, const Value& value) {
+    switch (spec.type) {
+        case ColumnType::INT64:
+            out.append(reinterpret_cast<const char*>(&value.integer), sizeof(value.integer));
+            break;
+        case ColumnType::DOUBLE: {
+            double real = value.real == 0 ? 0.0 : value.real;     // -0.0 与 0.0 同组
+            out.append(reinterpret_cast<const char*>(&real), sizeof(real));
+            break;
+        }
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR: {
+            auto size = static_cast<uint32_t>(value.text.size());
+            out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            out.append(value.text);
+            break;
+        }
+    }
+}
+
+// 编码后的分组键的哈希值，每次处理 8 字节
+uint64_t hash_key(std::string_view bytes) {
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ bytes.size();
+    for (size_t i = 0; i < bytes.size(); i += 8) {
+        uint64_t word = 0;
+        memcpy(&word, bytes.data() + i, std::min<size_t>(8, bytes.size() - i));
+        hash = (hash ^ word) * 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 31;
+    }
+    hash *= 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 32);
+}
+
+// 把一批选中的行累加到各自组的状态：groups[k] 为第 k 个选中行的组号，
+// 第 g 组的状态为 states[g * stride]
+template<typename Traits>
+void update_groups(const AggregateSpec& spec, const Batch& batch, const uint32_t* groups,
+                   AggregateState* states, size_t stride, StringHeap& strings) {
+    using value_type = typename Traits::value_type;
+    AggregateKind kind = spec.kind == AggregateKind::AVG ? AggregateKind::SUM : spec.kind;
+    if (kind == AggregateKind::COUNT || spec.star) {
+        for (uint32_t k = 0; k < batch.count; ++k) {
+            ++states[groups[k] * stride].count;
+        }
+        return;
+    }
+    const char* data = batch.columns[spec.slot];
+    bool min = kind == AggregateKind::MIN;
+    for (uint32_t k = 0; k < batch.count; ++k) {
+        AggregateState& state = states[groups[k] * stride];
+        value_type value = Traits::get(data, batch.selected(k), spec.width);
+        if constexpr (std::is_same_v<value_type, int64_t>) {
+            if (kind == AggregateKind::SUM) {
+                state.integer = static_cast<int64_t>(static_cast<uint64_t>(state.integer) +
+                                                     static_cast<uint64_t>(value));
+            } else if (state.count == 0 || (min ? value < state.integer : state.integer < value)) {
+                state.integer = value;
+            }
+        } else if constexpr (std::is_same_v<value_type, double>) {
+            if (kind == AggregateKind::SUM) {
+                state.real += value;
+            } else if (state.count == 0 || (min ? value < state.real : state.real < value)) {
+                state.real = value;
+            }
+        } else {
+            if (state.count == 0 || (min ? value < state.text : state.text < value)) {
+                state.text = value;
+            }
+        }
+        ++state.count;
+    }
+    if constexpr (std::is_same_v<Traits, CharTraits>) {
+        // 本批更新过、仍指向批数据的最值复制到字符串堆，复制后不再落在批数据的范围内
+        const char* end = data + size_t{BATCH_SIZE} * spec.width;
+        for (uint32_t k = 0; k < batch.count; ++k) {
+            AggregateState& state = states[groups[k] * stride];
+            const char* text = state.text.data();
+            if (!state.text.empty() && std::less_equal<>()(data, text) && std::less<>()(text, end)) {
+                state.text = strings.store(state.text).view();
+            }
+        }
+    }
+}
+
+} // namespace
+
+GroupTable::GroupTable(std::vector<GroupKeySpec> keys, std::vector<AggregateSpec> specs)
+    : key_specs_(std::move(keys)), specs_(std::move(specs)), slots_(64, 0), key_offsets_(1, 0),
+      strings_(std::make_unique<StringHeap>()) {}
+
+GroupTable::GroupTable(const GroupTable& other)
+    : key_specs_(other.key_specs_), specs_(other.specs_), slots_(other.slots_), hashes_(other.hashes_),
+      key_offsets_(other.key_offsets_), key_bytes_(other.key_bytes_), keys_(other.keys_), states_(other.states_),
+      strings_(std::make_unique<StringHeap>()) {
+    retainStrings();
+}
+
+GroupTable& GroupTable::operator=(const GroupTable& other) {
+    if (this != &other) {
+        *this = GroupTable(other);
+    }
+    return *this;
+}
+
+void GroupTable::retainStrings() {
+    for (size_t group = 0; group < groupCount(); ++group) {
+        for (size_t j = 0; j < key_specs_.size(); ++j) {
+            Value& key = keys_[group * key_specs_.size() + j];
+            if (key_specs_[j].type == ColumnType::CHAR) {
+                key.text = strings_->store(key.text).view();
+            }
+        }
+        for (size_t j = 0; j < specs_.size(); ++j) {
+            AggregateState& state = states_[group * specs_.size() + j];
+            if (specs_[j].type == ColumnType::CHAR && !state.text.empty()) {
+                state.text = strings_->store(state.text).view();
+            }
+        }
+    }
+}
+
+void GroupTable::grow() {
+    std::vector<uint32_t> slots(slots_.size() * 2, 0);
+    size_t mask = slots.size() - 1;
+    for (size_t group = 0; group < hashes_.size(); ++group) {
+        size_t position = hashes_[group] & mask;
+        while (slots[position] != 0) {
+            position = (position + 1) & mask;
+        }
+        slots[position] = static_cast<uint32_t>(group + 1);
+    }
+    slots_.swap(slots);
+}
+
+uint32_t GroupTable::findOrInsert(std::string_view encoded, uint64_t hash, const Value* key) {
+    size_t mask = slots_.size() - 1;
+    size_t position = hash & mask;
+    for (; slots_[position] != 0; position = (position + 1) & mask) {
+        uint32_t group = slots_[position] - 1;
+        if (hashes_[group] == hash && encodedKey(group) == encoded) {
+            return group;
+        }
+    }
+
+    auto group = static_cast<uint32_t>(hashes_.size());
+    slots_[position] = group + 1;
+    hashes_.push_back(hash);
+    key_bytes_.append(encoded);
+    key_offsets_.push_back(key_bytes_.size());
+    keys_.insert(keys_.end(), key, key + key_specs_.size());
+    for (size_t j = 0; j < key_specs_.size(); ++j) {
+        if (key_specs_[j].type == ColumnType::CHAR) {
+            Value& stored = keys_[keys_.size() - key_specs_.size() + j];
+            stored.text = strings_->store(stored.text).view();
+        }
+    }
+    states_.resize(states_.size() + specs_.size());
+    if (hashes_.size() * 2 > slots_.size()) {
+        grow();
+    }
+    return group;
+}
+
+void GroupTable::consume(const Batch& batch) {
+    uint32_t groups[BATCH_SIZE];
+    Value key[MAX_BATCH_COLUMNS];
+    for (uint32_t k = 0; k < batch.count; ++k) {
+        uint32_t index = batch.selected(k);
+        scratch_.clear();
+        for (size_t j = 0; j < key_specs_.size(); ++j) {
+            const GroupKeySpec& spec = key_specs_[j];
+            key[j] = batch_value(spec.type, batch.columns[spec.slot], index, spec.width);
+            encode_key(scratch_, spec, key[j]);
+        }
+        groups[k] = findOrInsert(scratch_, hash_key(scratch_), key);
+    }
+
+    for (size_t j = 0; j < specs_.size(); ++j) {
+        AggregateState* states = states_.data() + j;
+        switch (specs_[j].type) {
+            case ColumnType::INT64:
+                update_groups<Int64Traits>(specs_[j], batch, groups, states, specs_.size(), *strings_);
+                break;
+            case ColumnType::DOUBLE:
+                update_groups<DoubleTraits>(specs_[j], batch, groups, states, specs_.size(), *strings_);
+                break;
+            case ColumnType::CHAR:
+                update_groups<CharTraits>(specs_[j], batch, groups, states, specs_.size(), *strings_);
+                break;
+            case ColumnType::VARCHAR:
+                update_groups<VarcharTraits>(specs_[j], batch, groups, states, specs_.size(), *strings_);
+                break;
+        }
+    }
+}
+
+void GroupTable::merge(const GroupTable& other, size_t partition, size_t partitions) {
+    for (size_t group = 0; group < other.groupCount(); ++group) {
+        if (partitions > 1 && (other.hashes_[group] >> 32) % partitions != partition) {
+            continue;
+        }
+        AggregateState* states =
+            &states_[findOrInsert(other.encodedKey(group), other.hashes_[group], other.key(group)) * specs_.size()];
+        const AggregateState* others = other.states(group);
+        for (size_t j = 0; j < specs_.size(); ++j) {
+            states[j].merge(specs_[j], others[j], strings_.get());
+        }
+    }
+}
@@ -0,0 +1,197 @@
+#ifndef OPERATORS_H
+#define OPERATORS_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "sql/batch.h"
+#include "sql/parser.h"
+#include "sql/tokenizer.h"
+#include "storage/table.h"
+
+// 批执行算子：每次 next() 产生一批（最多 BATCH_SIZE 行）
+// 虚调用只发生在批的粒度上，逐行的内层循环在按列类型特化的模板与核函数中。
+// 调用方在整个执行期间持有读快照（或表的写锁），扫描的表数据版本不会被释放。
+class Operator {
+public:
+    virtual ~Operator() = default;
+
+    // 产生下一批，没有更多数据时返回 false；返回的批至少选中一行
+    virtual bool next(Batch& batch) = 0;
+};
+
+#define MORSEL_ROWS (2 * CHUNK_ROWS)    // 并行扫描时一个片段的行数（约 13 万行），与列块对齐
+
+// 扫描表数据的 [begin, end) 行中对快照 snapshot 可见的行，批的第 i 列对应表的 columns[i] 列
+// end 不应超过 data.visibleEnd(snapshot)，范围内的行开始时间戳都不大于快照，只需检查删除：
+// 没有删除的块输出稠密批，否则按结束时间戳生成选择向量。
+// 批不跨越列块，列指针直接指向列块内的数据
+class ScanOperator final : public Operator {
+public:
+    ScanOperator(const TableData& data, std::vector<size_t> columns, size_t begin, size_t end,
+                 int64_t snapshot);
+
+    bool next(Batch& batch) override;
+
+private:
+    const TableData& data_;
+    std::vector<size_t> columns_;
+    size_t position_;
+    size_t end_;
+    int64_t snapshot_;
+};
+
+// 把批中压缩列块的列解码到本算子的缓冲区，只解码选中的行，之后的算子按未压缩列块的格式读取
+// 放在过滤之后：过滤直接在压缩数据上进行，没有选中任何行的批不解码
+class DecodeOperator final : public Operator {
+public:
+    explicit DecodeOperator(std::unique_ptr<Operator> child, ScanIsa isa = best_scan_isa());
+
+    bool next(Batch& batch) override;
+
+private:
+    std::unique_ptr<Operator> child_;
+    ScanIsa isa_;
+    std::unique_ptr<int64_t[]> buffers_[MAX_BATCH_COLUMNS];    // 每列一个，按批内下标存放，首次用到时分配
+    std::unique_ptr<int64_t[]> codes_;                          // 字典编码
+
+    void decode(const EncodedChunk& encoded, const Batch& batch, char* out);
+};
+
+// 只保留 slots 中的列并按其顺序重排，不触及数据
+class ProjectOperator final : public Operator {
+public:
+    ProjectOperator(std::unique_ptr<Operator> child, std::vector<size_t> slots);
+
+    bool next(Batch& batch) override;
+
+private:
+    std::unique_ptr<Operator> child_;
+    std::vector<size_t> slots_;
+};
+
+// 最多输出 limit 行
+class LimitOperator final : public Operator {
+public:
+    LimitOperator(std::unique_ptr<Operator> child, size_t limit);
+
+    bool next(Batch& batch) override;
+
+private:
+    std::unique_ptr<Operator> child_;
+    size_t remaining_;
+};
+
+// 在批的 slot 列上应用 column op value，按列类型实例化对应的过滤算子
+// value 已按列类型转换；字符串值会被复制，调用方无需保持其生命周期
+// 列块已压缩时直接在压缩数据上比较：字典与位打包转换为编码上的比较，游程每段只比较一次
+std::unique_ptr<Operator> make_filter(std::unique_ptr<Operator> child, size_t slot,
+                                      const ColumnDef& def, CompareOp op, const Value& value,
+                                      ScanIsa isa = best_scan_isa());
+
+// 一个聚合函数的输入：COUNT(*) 不读取任何列
+struct AggregateSpec {
+    AggregateKind kind = AggregateKind::COUNT;
+    size_t slot = 0;
+    ColumnType type = ColumnType::INT64;
+    uint32_t width = 0;
+    bool star = false;
+};
+
+// 聚合的中间状态，可以跨批、跨扫描范围合并
+// VARCHAR 的 MIN/MAX 指向列的字符串堆，只在持有读快照期间有效；CHAR 的批数据可能是解码缓冲区，
+// 跨批保留的 MIN/MAX 由状态的持有者复制到自己的字符串堆
+struct AggregateState {
+    int64_t count = 0;
+    int64_t integer = 0;        // INT64 列的 SUM/MIN/MAX
+    double real = 0;            // DOUBLE 列的 SUM/MIN/MAX
+    std::string_view text;      // 字符串列的 MIN/MAX
+
+    // strings 非空时，合并后取自 other 的 CHAR 字符串复制到 strings 中
+    void merge(const AggregateSpec& spec, const AggregateState& other, StringHeap* strings = nullptr);
+};
+
+// 无分组的聚合：消费子算子的全部输出，每个聚合函数得到一个状态
+class AggregateOperator {
+public:
+    AggregateOperator(std::unique_ptr<Operator> child, std::vector<AggregateSpec> specs,
+                      ScanIsa isa = best_scan_isa());
+    ~AggregateOperator();
+
+    void run();
+    const std::vector<AggregateState>& states() const { return states_; }
+
+    // 每种聚合函数对一批数据的累加，按列类型特化
+    class Accumulator {
+    public:
+        virtual ~Accumulator() = default;
+        virtual void update(const Batch& batch, AggregateState& state) = 0;
+    };
+
+private:
+    std::unique_ptr<Operator> child_;
+    std::vector<AggregateSpec> specs_;
+    std::vector<std::unique_ptr<Accumulator>> accumulators_;
+    std::vector<AggregateState> states_;
+};
+
+// 分组列：批中的列号与列类型
+struct GroupKeySpec {
+    size_t slot = 0;
+    ColumnType type = ColumnType::INT64;
+    uint32_t width = 0;
+};
+
+// 分组聚合的哈希表：分组键编码成字节串，开放寻址表按哈希值找到组号，每组保存键值与各聚合函数的状态
+// 每批先求出各行的组号，再按聚合函数逐列累加，内层循环按列类型特化。
+// 并行执行时每个线程累加到自己的局部表，最后按哈希值分区 merge()，每个分区得到一张表。
+// VARCHAR 键与 MIN/MAX 指向列的字符串堆，只在持有读快照期间有效；CHAR 的键与 MIN/MAX 复制到表自己的字符串堆
+class GroupTable {
+public:
+    GroupTable(std::vector<GroupKeySpec> keys, std::vector<AggregateSpec> specs);
+
+    // 复制得到的表有自己的字符串堆
+    GroupTable(const GroupTable& other);
+    GroupTable& operator=(const GroupTable& other);
+    GroupTable(GroupTable&&) = default;
+    GroupTable& operator=(GroupTable&&) = default;
+
+    // 累加一批中选中的行
+    void consume(const Batch& batch);
+
+    // 并入另一张分组列与聚合函数相同的表中哈希值属于第 partition 个分区（共 partitions 个）的组
+    // 不同分区的组互不相交，可以由多个线程分别合并到各自的表中
+    void merge(const GroupTable& other, size_t partition = 0, size_t partitions = 1);
+
+    size_t groupCount() const { return hashes_.size(); }
+
+    // 第 group 组的键（按分组列顺序）与聚合状态（按聚合函数顺序）
+    const Value* key(size_t group) const { return &keys_[group * key_specs_.size()]; }
+    const AggregateState* states(size_t group) const { return &states_[group * specs_.size()]; }
+
+private:
+    std::vector<GroupKeySpec> key_specs_;
+    std::vector<AggregateSpec> specs_;
+    std::vector<uint32_t> slots_;           // 组号 + 1，0 表示空位；容量为 2 的幂，至少是组数的两倍
+    std::vector<uint64_t> hashes_;          // 每组编码后的键的哈希值
+    std::vector<size_t> key_offsets_;       // 每组编码后的键在 key_bytes_ 中的起点，末尾多一项
+    std::string key_bytes_;
+    std::vector<Value> keys_;
+    std::vector<AggregateState> states_;
+    std::unique_ptr<StringHeap> strings_;
+    std::string scratch_;
+
+    std::string_view encodedKey(size_t group) const {
+        return std::string_view(key_bytes_).substr(key_offsets_[group], key_offsets_[group + 1] - key_offsets_[group]);
+    }
+
+    // 编码后为 encoded 的键所在的组，不存在时以 key 为键新建
+    uint32_t findOrInsert(std::string_view encoded, uint64_t hash, const Value* key);
+    void grow();
+
+    // 把 CHAR 的键与 MIN/MAX 复制到 strings_ 中
+    void retainStrings();
+};
+
+#endif // OPERATORS_H
@@ -0,0 +1,541 @@
+#include <algorithm>
+#include <charconv>
+#include <utility>
+#include "sql/parser.h"
+#include "sql/tokenizer.h"
+
+namespace {
+
+std::string lower(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return result;
+}
+
+// 数值字面量，超出范围时返回 false
+bool parse_number(std::string_view text, bool negative, Literal& literal) {
+    const char* begin = text.data();
+    const char* end = text.data() + text.size();
+    std::from_chars_result result{};
+    if (text.find_first_of(".eE") != std::string_view::npos) {
+        literal.kind = Literal::Kind::REAL;
+        result = std::from_chars(begin, end, literal.real);
+        literal.real = negative ? -literal.real : literal.real;
+    } else {
+        literal.kind = Literal::Kind::INTEGER;
+        result = std::from_chars(begin, end, literal.integer);
+        literal.integer = negative ? -literal.integer : literal.integer;
+    }
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// 递归下降解析器，每次只向前看一个 Token
+class Parser {
+public:
+    explicit Parser(std::string_view sql) : tokenizer_(sql) {
+        advance();
+    }
+
+    // 已解析部分中参数的个数
+    size_t parameters() const { return parameters_; }
+
+    Statement parse() {
+        Statement statement;
+        if (current_.is("create")) {
+            statement = parseCreate();
+        } else if (current_.is("insert")) {
+            statement = parseInsert();
+        } else if (current_.is("select")) {
+            statement = parseSelect();
+        } else if (current_.is("update")) {
+            statement = parseUpdate();
+        } else if (current_.is("delete")) {
+            statement = parseDelete();
+        } else {
+            fail("不支持的语句");
+        }
+
+        if (current_.type == TokenType::SEMICOLON) {
+            advance();
+        }
+        if (current_.type != TokenType::END) {
+            fail("语句结尾有多余内容");
+        }
+        return statement;
+    }
+
+private:
+    SqlTokenizer tokenizer_;
+    Token current_;
+    std::string scratch_;
+    size_t next_parameter_ = 0;     // 下一个 ? 的序号
+    size_t parameters_ = 0;
+
+    void advance() {
+        current_ = tokenizer_.next();
+        if (current_.type == TokenType::ERROR) {
+            fail(current_.text[0] == '\'' || current_.text[0] == '"' ? "未闭合的引号" : "非法字符");
+        }
+    }
+
+    [[noreturn]] void fail(std::string_view reason) const {
+        std::string message = "语法错误: " + std::string(reason);
+        if (current_.type == TokenType::END) {
+            message += "（位于语句末尾）";
+        } else {
+            message += "（位于 '" + std::string(current_.text) + "'）";
+        }
+        throw SqlError(message);
+    }
+
+    void expectKeyword(std::string_view keyword) {
+        if (!current_.is(keyword)) {
+            fail("期望 " + lower(keyword));
+        }
+        advance();
+    }
+
+    void expectSymbol(char symbol) {
+        if (!current_.isSymbol(symbol)) {
+            fail(std::string("期望 '") + symbol + "'");
+        }
+        advance();
+    }
+
+    bool acceptSymbol(char symbol) {
+        if (current_.isSymbol(symbol)) {
+            advance();
+            return true;
+        }
+        return false;
+    }
+
+    std::string parseIdentifier() {
+        std::string name;
+        if (current_.type == TokenType::IDENTIFIER) {
+            name = lower(current_.text);
+        } else if (current_.type == TokenType::QUOTED_IDENTIFIER) {
+            name = std::string(sql_unquote(current_, scratch_));
+        } else {
+            fail("期望标识符");
+        }
+        advance();
+        return name;
+    }
+
+    int64_t parseInteger() {
+        bool negative = acceptSymbol('-');
+        if (current_.type != TokenType::NUMBER) {
+            fail("期望整数");
+        }
+        int64_t value = 0;
+        auto [end, ec] = std::from_chars(current_.text.data(),
+                                         current_.text.data() + current_.text.size(), value);
+        if (ec != std::errc() || end != current_.text.data() + current_.text.size()) {
+            fail("无效的整数");
+        }
+        advance();
+        return negative ? -value : value;
+    }
+
+    Literal parseLiteral() {
+        Literal literal;
+        if (current_.type == TokenType::STRING) {
+            literal.kind = Literal::Kind::STRING;
+            literal.text = std::string(sql_unquote(current_, scratch_));
+            advance();
+            return literal;
+        }
+
+        if (current_.type == TokenType::PARAMETER) {
+            literal.kind = Literal::Kind::PARAMETER;
+            if (current_.text == "?") {
+                literal.parameter = next_parameter_++;
+            } else {
+                size_t number = 0;
+                auto [end, ec] = std::from_chars(current_.text.data() + 1,
+                                                 current_.text.data() + current_.text.size(), number);
+                if (ec != std::errc() || number == 0 || number > MAX_PARAMETERS) {
+                    fail("无效的参数序号");
+                }
+                literal.parameter = number - 1;
+            }
+            if (literal.parameter >= MAX_PARAMETERS) {
+                fail("参数过多");
+            }
+            parameters_ = std::max(parameters_, literal.parameter + 1);
+            advance();
+            return literal;
+        }
+
+        bool negative = acceptSymbol('-');
+        if (current_.type != TokenType::NUMBER) {
+            fail("期望字面量");
+        }
+        if (!parse_number(current_.text, negative, literal)) {
+            fail("数值超出范围");
+        }
+        advance();
+        return literal;
+    }
+
+    ColumnDef parseColumnDef() {
+        ColumnDef def;
+        def.name = parseIdentifier();
+        if (current_.type != TokenType::IDENTIFIER) {
+            fail("期望列类型");
+        }
+
+        if (current_.is("int") || current_.is("integer") || current_.is("bigint") ||
+            current_.is("int64")) {
+            def.type = ColumnType::INT64;
+            advance();
+        } else if (current_.is("double") || current_.is("float") || current_.is("real")) {
+            def.type = ColumnType::DOUBLE;
+            advance();
+            if (current_.is("precision")) {
+                advance();
+            }
+        } else if (current_.is("char")) {
+            def.type = ColumnType::CHAR;
+            advance();
+            expectSymbol('(');
+            int64_t width = parseInteger();
+            if (width <= 0 || width > 255) {
+                fail("CHAR 长度必须在 1 到 255 之间");
+            }
+            def.width = static_cast<uint32_t>(width);
+            expectSymbol(')');
+        } else if (current_.is("varchar") || current_.is("text") || current_.is("string")) {
+            def.type = ColumnType::VARCHAR;
+            advance();
+            if (acceptSymbol('(')) {
+                int64_t width = parseInteger();
+                if (width <= 0 || width > UINT32_MAX) {
+                    fail("无效的 VARCHAR 长度");
+                }
+                def.width = static_cast<uint32_t>(width);
+                expectSymbol(')');
+            }
+        } else {
+            fail("不支持的列类型");
+        }
+
+        // 目前所有列都不允许 NULL，显式的 NOT NULL 可以接受
+        if (current_.is("not")) {
+            advance();
+            expectKeyword("null");
+        }
+        return def;
+    }
+
+    CreateTableStatement parseCreate() {
+        CreateTableStatement statement;
+        expectKeyword("create");
+        expectKeyword("table");
+        statement.table = parseIdentifier();
+        expectSymbol('(');
+        do {
+            statement.columns.push_back(parseColumnDef());
+        } while (acceptSymbol(','));
+        expectSymbol(')');
+
+        for (size_t i = 0; i < statement.columns.size(); ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (statement.columns[i].name == statement.columns[j].name) {
+                    throw SqlError("列名重复: " + statement.columns[i].name);
+                }
+            }
+        }
+        return statement;
+    }
+
+    InsertStatement parseInsert() {
+        InsertStatement statement;
+        expectKeyword("insert");
+        expectKeyword("into");
+        statement.table = parseIdentifier();
+        if (acceptSymbol('(')) {
+            do {
+                statement.columns.push_back(parseIdentifier());
+            } while (acceptSymbol(','));
+            expectSymbol(')');
+        }
+        expectKeyword("values");
+        do {
+            expectSymbol('(');
+            std::vector<Literal> row;
+            do {
+                row.push_back(parseLiteral());
+            } while (acceptSymbol(','));
+            expectSymbol(')');
+            statement.rows.push_back(std::move(row));
+        } while (acceptSymbol(','));
+        return statement;
+    }
+
+    bool parseCompareOp(CompareOp& op) {
+        if (current_.type != TokenType::SYMBOL) {
+            return false;
+        }
+        std::string_view text = current_.text;
+        if (text == "=") {
+            op = CompareOp::EQ;
+        } else if (text == "!=" || text == "<>") {
+            op = CompareOp::NE;
+        } else if (text == "<") {
+            op = CompareOp::LT;
+        } else if (text == "<=") {
+            op = CompareOp::LE;
+        } else if (text == ">") {
+            op = CompareOp::GT;
+        } else if (text == ">=") {
+            op = CompareOp::GE;
+        } else {
+            return false;
+        }
+        advance();
+        return true;
+    }
+
+    // 字面量在左侧时交换比较方向
+    static CompareOp flip(CompareOp op) {
+        switch (op) {
+            case CompareOp::LT: return CompareOp::GT;
+            case CompareOp::LE: return CompareOp::GE;
+            case CompareOp::GT: return CompareOp::LT;
+            case CompareOp::GE: return CompareOp::LE;
+            default:            return op;
+        }
+    }
+
+    Predicate parsePredicate() {
+        Predicate predicate;
+        bool literal_first = current_.type != TokenType::IDENTIFIER &&
+                             current_.type != TokenType::QUOTED_IDENTIFIER;
+        if (literal_first) {
+            predicate.value = parseLiteral();
+        } else {
+            predicate.column = parseIdentifier();
+        }
+        if (!parseCompareOp(predicate.op)) {
+            fail("期望比较运算符");
+        }
+        if (literal_first) {
+            predicate.column = parseIdentifier();
+            predicate.op = flip(predicate.op);
+        } else {
+            predicate.value = parseLiteral();
+        }
+        return predicate;
+    }
+
+    // 可选的 WHERE 子句，谓词以 AND 连接
+    void parseWhere(std::vector<Predicate>& where) {
+        if (!current_.is("where")) {
+            return;
+        }
+        advance();
+        where.push_back(parsePredicate());
+        while (current_.is("and")) {
+            advance();
+            where.push_back(parsePredicate());
+        }
+    }
+
+    // 列名，或 COUNT(*) / COUNT(col) / SUM / MIN / MAX / AVG(col)
+    SelectItem parseSelectItem() {
+        SelectItem item;
+        bool quoted = current_.type == TokenType::QUOTED_IDENTIFIER;
+        item.column = parseIdentifier();
+        if (quoted || !current_.isSymbol('(')) {
+            return item;
+        }
+
+        static const std::pair<const char*, AggregateKind> FUNCTIONS[] = {
+            {"count", AggregateKind::COUNT},
+            {"sum", AggregateKind::SUM},
+            {"min", AggregateKind::MIN},
+            {"max", AggregateKind::MAX},
+            {"avg", AggregateKind::AVG},
+        };
+        for (const auto& [name, kind] : FUNCTIONS) {
+            if (item.column == name) {
+                item.aggregate = kind;
+            }
+        }
+        if (item.aggregate == AggregateKind::NONE) {
+            fail("不支持的函数 " + item.column);
+        }
+        advance();
+
+        if (item.aggregate == AggregateKind::COUNT && acceptSymbol('*')) {
+            item.column.clear();
+        } else {
+            item.column = parseIdentifier();
+        }
+        expectSymbol(')');
+        return item;
+    }
+
+    SelectStatement parseSelect() {
+        SelectStatement statement;
+        expectKeyword("select");
+        if (!acceptSymbol('*')) {
+            do {
+                statement.items.push_back(parseSelectItem());
+            } while (acceptSymbol(','));
+        }
+        expectKeyword("from");
+        statement.table = parseIdentifier();
+
+        parseWhere(statement.where);
+        if (current_.is("group")) {
+            if (statement.items.empty()) {
+                fail("GROUP BY 不能与 * 一起使用");
+            }
+            advance();
+            expectKeyword("by");
+            do {
+                statement.group_by.push_back(parseIdentifier());
+            } while (acceptSymbol(','));
+        }
+
+        // 有聚合函数或 GROUP BY 时，普通列只能是分组列
+        bool aggregate = !statement.group_by.empty();
+        for (const auto& item : statement.items) {
+            aggregate = aggregate || item.aggregate != AggregateKind::NONE;
+        }
+        for (const auto& item : statement.items) {
+            if (aggregate && item.aggregate == AggregateKind::NONE &&
+                std::find(statement.group_by.begin(), statement.group_by.end(), item.column) ==
+                    statement.group_by.end()) {
+                throw SqlError("列 " + item.column + " 必须出现在 GROUP BY 中或用于聚合函数");
+            }
+        }
+        if (current_.is("limit")) {
+            advance();
+            statement.limit = parseInteger();
+            if (statement.limit < 0) {
+                fail("LIMIT 不能为负数");
+            }
+        }
+        return statement;
+    }
+
+    UpdateStatement parseUpdate() {
+        UpdateStatement statement;
+        expectKeyword("update");
+        statement.table = parseIdentifier();
+        expectKeyword("set");
+        do {
+            Assignment assignment;
+            assignment.column = parseIdentifier();
+            expectSymbol('=');
+            assignment.value = parseLiteral();
+            statement.assignments.push_back(std::move(assignment));
+        } while (acceptSymbol(','));
+        parseWhere(statement.where);
+        return statement;
+    }
+
+    DeleteStatement parseDelete() {
+        DeleteStatement statement;
+        expectKeyword("delete");
+        expectKeyword("from");
+        statement.table = parseIdentifier();
+        parseWhere(statement.where);
+        return statement;
+    }
+};
+
+} // namespace
+
+Statement parse_statement(std::string_view sql, size_t* parameters) {
+    Parser parser(sql);
+    Statement statement = parser.parse();
+    if (parameters) {
+        *parameters = parser.parameters();
+    }
+    return statement;
+}
+
+bool normalize_statement(std::string_view sql, std::string& text, std::vector<Literal>& literals) {
+    text.clear();
+    literals.clear();
+    SqlTokenizer tokenizer(sql);
+    Token token = tokenizer.next();
+    if (!token.is("insert") && !token.is("select") && !token.is("update") && !token.is("delete")) {
+        return false;
+    }
+
+    std::string scratch;
+    bool after_limit = false;
+    for (Token next = tokenizer.next(); token.type != TokenType::END; token = next, next = tokenizer.next()) {
+        if (!text.empty() && token.type != TokenType::SEMICOLON) {
+            text += ' ';
+        }
+        switch (token.type) {
+            case TokenType::IDENTIFIER:
+                for (char c : token.text) {
+                    text += c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+                }
+                break;
+            case TokenType::STRING:
+                literals.emplace_back();
+                literals.back().kind = Literal::Kind::STRING;
+                literals.back().text = std::string(sql_unquote(token, scratch));
+                text += '?';
+                break;
+            case TokenType::NUMBER:
+                if (after_limit) {
+                    text += token.text;
+                    break;
+                }
+                literals.emplace_back();
+                if (!parse_number(token.text, false, literals.back())) {
+                    return false;
+                }
+                text += '?';
+                break;
+            case TokenType::SYMBOL:
+                // 负号与其后的数值合为一个字面量（语法中没有减法）
+                if (token.isSymbol('-') && next.type == TokenType::NUMBER && !after_limit) {
+                    literals.emplace_back();
+                    if (!parse_number(next.text, true, literals.back())) {
+                        return false;
+                    }
+                    text += '?';
+                    next = tokenizer.next();
+                    break;
+                }
+                text += token.text;
+                break;
+            case TokenType::SEMICOLON:
+                if (next.type != TokenType::END) {
+                    return false;
+                }
+                break;
+            case TokenType::QUOTED_IDENTIFIER:
+                text += token.text;
+                break;
+            case TokenType::PARAMETER:
+            case TokenType::ERROR:
+            case TokenType::END:
+                return false;
+        }
+        after_limit = token.is("limit") || (after_limit && token.isSymbol('-'));
+    }
+    return true;
+}
+
+bool is_sql_statement(std::string_view sql) {
+    SqlTokenizer tokenizer(sql);
+    Token first = tokenizer.next();
+    return first.is("create") || first.is("insert") || first.is("select") || first.is("update") ||
+           first.is("delete");
+}
@@ -0,0 +1,120 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "storage/column.h"
+
+#define MAX_PARAMETERS 65535        // 一条语句的参数个数上限（EXECUTE 帧中以 16 位计数）
+
+// SQL 语法或语义错误，消息直接返回给客户端
+class SqlError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// 字面量
+struct Literal {
+    enum class Kind : uint8_t {
+        INTEGER,
+        REAL,
+        STRING,
+        PARAMETER                               // ? 或 $n，执行时绑定
+    };
+
+    Kind kind = Kind::INTEGER;
+    int64_t integer = 0;
+    double real = 0;
+    std::string text;
+    size_t parameter = 0;                       // PARAMETER 的序号，从 0 开始
+};
+
+enum class CompareOp : uint8_t {
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE
+};
+
+// 形如 column op literal 的比较谓词
+struct Predicate {
+    std::string column;
+    CompareOp op = CompareOp::EQ;
+    Literal value;
+};
+
+struct CreateTableStatement {
+    std::string table;
+    std::vector<ColumnDef> columns;
+};
+
+struct InsertStatement {
+    std::string table;
+    std::vector<std::string> columns;           // 为空表示按表定义顺序
+    std::vector<std::vector<Literal>> rows;
+};
+
+enum class AggregateKind : uint8_t {
+    NONE,                                       // 普通列
+    COUNT,
+    SUM,
+    MIN,
+    MAX,
+    AVG
+};
+
+// SELECT 列表中的一项：列名或聚合函数
+struct SelectItem {
+    AggregateKind aggregate = AggregateKind::NONE;
+    std::string column;                         // COUNT(*) 时为空
+};
+
+struct SelectStatement {
+    std::string table;
+    std::vector<SelectItem> items;              // 为空表示 *；有聚合时普通列须出现在 GROUP BY 中
+    std::vector<Predicate> where;               // 以 AND 连接
+    std::vector<std::string> group_by;
+    int64_t limit = -1;                         // -1 表示不限
+};
+
+// SET 子句中的一项
+struct Assignment {
+    std::string column;
+    Literal value;
+};
+
+struct UpdateStatement {
+    std::string table;
+    std::vector<Assignment> assignments;
+    std::vector<Predicate> where;
+};
+
+struct DeleteStatement {
+    std::string table;
+    std::vector<Predicate> where;
+};
+
+using Statement = std::variant<CreateTableStatement, InsertStatement, SelectStatement, UpdateStatement,
+                               DeleteStatement>;
+
+// 解析一条语句（末尾分号可选），语法错误抛出 SqlError
+// 未加引号的标识符统一转为小写
+// parameters 不为空时返回语句中参数的个数（最大序号加一）；? 按出现顺序编号，$n 为第 n 个参数
+Statement parse_statement(std::string_view sql, size_t* parameters = nullptr);
+
+// 把 INSERT/SELECT/UPDATE/DELETE 语句规范化为计划缓存的键：关键字与标识符转为小写，Token 之间以一个空格分隔，
+// 字面量（含负号）替换为 ? 并按顺序存入 literals，LIMIT 的行数保留在文本中。
+// text 本身是合法的带参数语句，解析后以 literals 为参数执行与原语句等价。
+// 其他语句、已含参数或有词法错误的语句返回 false
+bool normalize_statement(std::string_view sql, std::string& text, std::vector<Literal>& literals);
+
+// 语句是否以本解析器支持的关键字开头（用于区分 SQL 与其他指令）
+bool is_sql_statement(std::string_view sql);
+
+#endif // PARSER_H
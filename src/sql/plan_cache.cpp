@@ -0,0 +1,52 @@
+#include <algorithm>
+#include "sql/plan_cache.h"
+
+PlanCache::PlanCache(size_t capacity)
+    : shard_capacity_(std::max<size_t>(1, (capacity + PLAN_CACHE_SHARDS - 1) / PLAN_CACHE_SHARDS)),
+      shards_(std::make_unique<Shard[]>(PLAN_CACHE_SHARDS)) {}
+
+std::shared_ptr<const PreparedStatement> PlanCache::find(std::string_view key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        ++shard.misses;
+        return nullptr;
+    }
+    ++shard.hits;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return it->second->statement;
+}
+
+std::shared_ptr<const PreparedStatement> PlanCache::insert(std::string_view key,
+                                                           std::shared_ptr<const PreparedStatement> statement) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->statement;
+    }
+
+    if (shard.lru.size() >= shard_capacity_) {
+        shard.index.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+        ++shard.evictions;
+    }
+    shard.lru.push_front(Entry{std::string(key), std::move(statement)});
+    shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+    return shard.lru.front().statement;
+}
+
+PlanCacheStats PlanCache::stats() const {
+    PlanCacheStats stats;
+    for (size_t i = 0; i < PLAN_CACHE_SHARDS; ++i) {
+        const Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.evictions += shard.evictions;
+        stats.entries += shard.lru.size();
+    }
+    return stats;
+}
@@ -0,0 +1,77 @@
+#ifndef PLAN_CACHE_H
+#define PLAN_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "sql/parser.h"
+
+#define PLAN_CACHE_SHARDS 16
+#define PLAN_CACHE_CAPACITY 4096        // 缓存的语句形状数上限，各分片均分
+
+// 解析好的语句，字面量位置为参数，每次执行时绑定；创建后只读，可以被多个线程同时执行
+struct PreparedStatement {
+    Statement statement;
+    size_t parameters = 0;
+};
+
+struct PlanCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+
+    double hitRatio() const {
+        uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+// 以规范化语句文本（见 normalize_statement）为键的语句缓存
+// 按键的哈希值分成 PLAN_CACHE_SHARDS 个分片，各自加锁并按最近最少使用淘汰，
+// 并发的查找通常落在不同分片上。返回的语句以 shared_ptr 持有，被淘汰后正在执行的语句仍然有效。
+class PlanCache {
+public:
+    explicit PlanCache(size_t capacity = PLAN_CACHE_CAPACITY);
+
+    PlanCache(const PlanCache&) = delete;
+    PlanCache& operator=(const PlanCache&) = delete;
+
+    // 查找并标记为最近使用，找不到返回空
+    std::shared_ptr<const PreparedStatement> find(std::string_view key);
+
+    // 加入缓存并返回缓存中的语句（其他线程已先加入同一键时返回已有的）
+    std::shared_ptr<const PreparedStatement> insert(std::string_view key,
+                                                    std::shared_ptr<const PreparedStatement> statement);
+
+    PlanCacheStats stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const PreparedStatement> statement;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;           // 最近使用的在前
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;   // 键指向 lru 中的 Entry::key
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    size_t shard_capacity_;
+    std::unique_ptr<Shard[]> shards_;
+
+    Shard& shardFor(std::string_view key) {
+        return shards_[(std::hash<std::string_view>()(key) >> 32) % PLAN_CACHE_SHARDS];
+    }
+};
+
+#endif // PLAN_CACHE_H
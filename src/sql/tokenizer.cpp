@@ -0,0 +1,401 @@
+#include <cstring>
+#include "sql/tokenizer.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SQL_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// 语句分隔相关的字符集合
+constexpr std::string_view INITIAL_CHARS = "'\"-;";
+constexpr std::string_view SINGLE_CHARS = "'";
+constexpr std::string_view DOUBLE_CHARS = "\"";
+constexpr std::string_view COMMENT_CHARS = "\n";
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 非 ASCII 字节按标识符字符处理，允许 UTF-8 标识符
+inline bool is_ident_start(char c) {
+    auto u = static_cast<unsigned char>(c);
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '_' || u >= 0x80;
+}
+
+inline bool is_ident_char(char c) {
+    return is_ident_start(c) || is_digit(c);
+}
+
+inline char ascii_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+size_t scan_scalar(const char* data, size_t size, std::string_view chars) {
+    for (size_t i = 0; i < size; ++i) {
+        for (char c : chars) {
+            if (data[i] == c) {
+                return i;
+            }
+        }
+    }
+    return size;
+}
+
+#ifdef SQL_SCAN_X86
+
+// SSE4.2：PCMPESTRI 一次比较 16 字节与最多 16 个目标字符
+__attribute__((target("sse4.2")))
+size_t scan_sse42(const char* data, size_t size, std::string_view chars) {
+    char needle_bytes[16] = {};
+    memcpy(needle_bytes, chars.data(), chars.size());
+    __m128i needle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(needle_bytes));
+    int needle_len = static_cast<int>(chars.size());
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int index = _mm_cmpestri(needle, needle_len, block, 16,
+                                 _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+        if (index < 16) {
+            return i + static_cast<size_t>(index);
+        }
+    }
+    return i + scan_scalar(data + i, size - i, chars);
+}
+
+// AVX2：每个目标字符一次 32 字节比较，合并后取最低位
+__attribute__((target("avx2")))
+size_t scan_avx2(const char* data, size_t size, std::string_view chars) {
+    // 目标字符不足 4 个时重复第一个字符
+    __m256i c0 = _mm256_set1_epi8(chars[0]);
+    __m256i c1 = _mm256_set1_epi8(chars.size() > 1 ? chars[1] : chars[0]);
+    __m256i c2 = _mm256_set1_epi8(chars.size() > 2 ? chars[2] : chars[0]);
+    __m256i c3 = _mm256_set1_epi8(chars.size() > 3 ? chars[3] : chars[0]);
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, c0), _mm256_cmpeq_epi8(block, c1)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, c2), _mm256_cmpeq_epi8(block, c3)));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    return i + scan_scalar(data + i, size - i, chars);
+}
+
+#endif // SQL_SCAN_X86
+
+// 跳过空白，返回第一个非空白字符的位置
+size_t skip_space(std::string_view text, size_t pos) {
+    while (pos < text.size() && is_space(text[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+} // namespace
+
+size_t scan_for_any(ScanIsa isa, const char* data, size_t size, std::string_view chars) {
+#ifdef SQL_SCAN_X86
+    switch (isa) {
+        case ScanIsa::AVX2:
+            if (chars.size() <= 4) {
+                return scan_avx2(data, size, chars);
+            }
+            return scan_sse42(data, size, chars);
+        case ScanIsa::SSE42:
+            return scan_sse42(data, size, chars);
+        default:
+            break;
+    }
+#else
+    (void)isa;
+#endif
+    return scan_scalar(data, size, chars);
+}
+
+bool scan_isa_supported(ScanIsa isa) {
+    switch (isa) {
+        case ScanIsa::SCALAR:
+            return true;
+#ifdef SQL_SCAN_X86
+        case ScanIsa::SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case ScanIsa::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+ScanIsa best_scan_isa() {
+    static const ScanIsa best = scan_isa_supported(ScanIsa::AVX2)  ? ScanIsa::AVX2
+                              : scan_isa_supported(ScanIsa::SSE42) ? ScanIsa::SSE42
+                                                                   : ScanIsa::SCALAR;
+    return best;
+}
+
+const char* scan_isa_name(ScanIsa isa) {
+    switch (isa) {
+        case ScanIsa::SSE42:
+            return "sse4.2";
+        case ScanIsa::AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// StatementSplitter
+
+StatementSplitter::StatementSplitter(std::string_view script, ScanIsa isa)
+    : script_(script), isa_(isa) {}
+
+bool StatementSplitter::next(std::string_view& statement) {
+    if (done_) {
+        return false;
+    }
+
+    const char* data = script_.data();
+    size_t size = script_.size();
+    size_t start = skip_space(script_, pos_);
+    size_t i = start;
+
+    // 只在状态转换点之间跳跃：'' 与 "" 视为先退出再进入字符串，结果与 flex 的最长匹配一致
+    while (i < size) {
+        std::string_view chars;
+        switch (state_) {
+            case ScanState::INITIAL: chars = INITIAL_CHARS; break;
+            case ScanState::SINGLE:  chars = SINGLE_CHARS;  break;
+            case ScanState::DOUBLE:  chars = DOUBLE_CHARS;  break;
+            case ScanState::COMMENT: chars = COMMENT_CHARS; break;
+        }
+        i += scan_for_any(isa_, data + i, size - i, chars);
+        if (i >= size) {
+            break;
+        }
+
+        char c = data[i++];
+        if (state_ != ScanState::INITIAL) {
+            state_ = ScanState::INITIAL;
+            continue;
+        }
+        if (c == ';') {
+            statement = script_.substr(start, i - start);
+            pos_ = i;
+            return true;
+        }
+        if (c == '\'') {
+            state_ = ScanState::SINGLE;
+        } else if (c == '"') {
+            state_ = ScanState::DOUBLE;
+        } else if (i < size && data[i] == '-') {
+            state_ = ScanState::COMMENT;
+            ++i;
+        }
+    }
+
+    // 没有更多完整语句：pos_ 停在未结束部分的起点，state_ 保留末尾的扫描状态
+    pos_ = start;
+    done_ = true;
+    return false;
+}
+
+std::string_view StatementSplitter::remainder() const {
+    return script_.substr(skip_space(script_, pos_));
+}
+
+// ---------------------------------------------------------------------------
+// Token
+
+bool Token::is(std::string_view keyword) const {
+    if (type != TokenType::IDENTIFIER || text.size() != keyword.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (ascii_lower(text[i]) != ascii_lower(keyword[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view sql_unquote(const Token& token, std::string& scratch) {
+    if (token.text.size() < 2) {
+        return {};
+    }
+    std::string_view inner = token.text.substr(1, token.text.size() - 2);
+    if (!token.escaped) {
+        return inner;
+    }
+
+    char quote = token.text[0];
+    scratch.clear();
+    scratch.reserve(inner.size());
+    for (size_t i = 0; i < inner.size(); ++i) {
+        scratch.push_back(inner[i]);
+        if (inner[i] == quote) {
+            ++i;   // 跳过成对引号中的第二个
+        }
+    }
+    return scratch;
+}
+
+// ---------------------------------------------------------------------------
+// SqlTokenizer
+
+SqlTokenizer::SqlTokenizer(std::string_view text, ScanIsa isa)
+    : text_(text), isa_(isa) {}
+
+Token SqlTokenizer::next() {
+    size_t size = text_.size();
+
+    // 跳过空白与 -- 注释
+    while (true) {
+        pos_ = skip_space(text_, pos_);
+        if (pos_ + 1 < size && text_[pos_] == '-' && text_[pos_ + 1] == '-') {
+            pos_ += 2;
+            pos_ += scan_for_any(isa_, text_.data() + pos_, size - pos_, COMMENT_CHARS);
+            continue;
+        }
+        break;
+    }
+
+    Token token;
+    if (pos_ >= size) {
+        return token;
+    }
+
+    size_t start = pos_;
+    char c = text_[pos_];
+
+    if (is_ident_start(c)) {
+        while (pos_ < size && is_ident_char(text_[pos_])) {
+            ++pos_;
+        }
+        token.type = TokenType::IDENTIFIER;
+        token.text = text_.substr(start, pos_ - start);
+        return token;
+    }
+
+    if (is_digit(c) || (c == '.' && pos_ + 1 < size && is_digit(text_[pos_ + 1]))) {
+        return number();
+    }
+
+    switch (c) {
+        case '\'':
+            return quoted('\'', TokenType::STRING);
+        case '"':
+            return quoted('"', TokenType::QUOTED_IDENTIFIER);
+        case ';':
+            token.type = TokenType::SEMICOLON;
+            token.text = text_.substr(pos_++, 1);
+            return token;
+        case '?':
+            token.type = TokenType::PARAMETER;
+            token.text = text_.substr(pos_++, 1);
+            return token;
+        case '$':
+            if (pos_ + 1 < size && is_digit(text_[pos_ + 1])) {
+                ++pos_;
+                while (pos_ < size && is_digit(text_[pos_])) {
+                    ++pos_;
+                }
+                token.type = TokenType::PARAMETER;
+                token.text = text_.substr(start, pos_ - start);
+                return token;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // 双字符运算符
+    if (pos_ + 1 < size) {
+        std::string_view pair = text_.substr(pos_, 2);
+        if (pair == "<=" || pair == ">=" || pair == "<>" || pair == "!=" ||
+            pair == "||" || pair == "::") {
+            pos_ += 2;
+            token.type = TokenType::SYMBOL;
+            token.text = pair;
+            return token;
+        }
+    }
+
+    constexpr std::string_view SYMBOLS = "(),.*=<>+-/%:[]!|&^~{}@#";
+    token.type = SYMBOLS.find(c) != std::string_view::npos ? TokenType::SYMBOL : TokenType::ERROR;
+    token.text = text_.substr(pos_++, 1);
+    return token;
+}
+
+// 字符串或带引号的标识符：用 SIMD 直接跳到下一个引号，成对引号为转义
+Token SqlTokenizer::quoted(char quote, TokenType type) {
+    size_t size = text_.size();
+    size_t start = pos_;
+    size_t i = pos_ + 1;
+    std::string_view chars = quote == '\'' ? SINGLE_CHARS : DOUBLE_CHARS;
+
+    Token token;
+    while (true) {
+        i += scan_for_any(isa_, text_.data() + i, size - i, chars);
+        if (i >= size) {
+            // 未闭合
+            pos_ = size;
+            token.type = TokenType::ERROR;
+            token.text = text_.substr(start);
+            return token;
+        }
+        if (i + 1 < size && text_[i + 1] == quote) {
+            token.escaped = true;
+            i += 2;
+            continue;
+        }
+        pos_ = i + 1;
+        token.type = type;
+        token.text = text_.substr(start, pos_ - start);
+        return token;
+    }
+}
+
+Token SqlTokenizer::number() {
+    size_t size = text_.size();
+    size_t start = pos_;
+    while (pos_ < size && is_digit(text_[pos_])) {
+        ++pos_;
+    }
+    if (pos_ < size && text_[pos_] == '.') {
+        ++pos_;
+        while (pos_ < size && is_digit(text_[pos_])) {
+            ++pos_;
+        }
+    }
+    // 指数部分只在后面确实跟着数字时才计入
+    if (pos_ < size && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+        size_t exp = pos_ + 1;
+        if (exp < size && (text_[exp] == '+' || text_[exp] == '-')) {
+            ++exp;
+        }
+        if (exp < size && is_digit(text_[exp])) {
+            pos_ = exp;
+            while (pos_ < size && is_digit(text_[pos_])) {
+                ++pos_;
+            }
+        }
+    }
+
+    Token token;
+    token.type = TokenType::NUMBER;
+    token.text = text_.substr(start, pos_ - start);
+    return token;
+}
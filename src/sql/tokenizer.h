@@ -0,0 +1,104 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 分隔符扫描使用的指令集
+enum class ScanIsa {
+    SCALAR,
+    SSE42,
+    AVX2
+};
+
+// 当前 CPU 支持的最快实现
+ScanIsa best_scan_isa();
+bool scan_isa_supported(ScanIsa isa);
+const char* scan_isa_name(ScanIsa isa);
+
+// 语句扫描状态，与客户端 flex 扫描器的起始条件一一对应
+enum class ScanState : uint8_t {
+    INITIAL,
+    SINGLE,     // 单引号字符串内
+    DOUBLE,     // 双引号标识符内
+    COMMENT     // -- 注释内，直到换行
+};
+
+// 在多语句脚本中按分号切分语句，不拷贝输入
+// 规则与 client.l 一致：引号内与 -- 注释内的分号不结束语句，'' 与 "" 为转义的引号，
+// 语句开头的空白被跳过，语句包含结尾的分号
+class StatementSplitter {
+public:
+    explicit StatementSplitter(std::string_view script, ScanIsa isa = best_scan_isa());
+
+    // 取下一条完整语句，没有更多以分号结尾的语句时返回 false
+    bool next(std::string_view& statement);
+
+    // 最后一条完整语句之后的部分（去掉开头空白），next() 返回 false 后有效
+    std::string_view remainder() const;
+
+    // 扫描到末尾时所处的状态，不为 INITIAL 表示有未闭合的引号或注释
+    ScanState state() const { return state_; }
+
+private:
+    std::string_view script_;
+    size_t pos_ = 0;
+    ScanState state_ = ScanState::INITIAL;
+    bool done_ = false;
+    ScanIsa isa_;
+};
+
+enum class TokenType : uint8_t {
+    END,                // 输入结束
+    IDENTIFIER,         // 标识符或关键字
+    QUOTED_IDENTIFIER,  // "..."，text 含引号
+    STRING,             // '...'，text 含引号
+    NUMBER,
+    PARAMETER,          // ? 或 $n
+    SYMBOL,             // 运算符与标点
+    SEMICOLON,
+    ERROR               // 未闭合的字符串或非法字符
+};
+
+// 词法单元，text 指向原始输入
+struct Token {
+    TokenType type = TokenType::END;
+    bool escaped = false;   // 字符串中含有 '' 或 ""，取值时需要去转义
+    std::string_view text;
+
+    // 标识符与关键字按 ASCII 大小写不敏感比较
+    bool is(std::string_view keyword) const;
+    bool isSymbol(char c) const {
+        return type == TokenType::SYMBOL && text.size() == 1 && text[0] == c;
+    }
+};
+
+// 零拷贝 SQL 词法分析器：跳过空白与 -- 注释，逐个返回指向输入的 Token
+// 字符串与注释体用 SIMD 查找结束符
+class SqlTokenizer {
+public:
+    explicit SqlTokenizer(std::string_view text, ScanIsa isa = best_scan_isa());
+
+    Token next();
+
+    // 当前位置（字节偏移）
+    size_t offset() const { return pos_; }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+    ScanIsa isa_;
+
+    Token quoted(char quote, TokenType type);
+    Token number();
+};
+
+// 去掉字符串或带引号标识符的引号；含转义时把结果写入 scratch 并返回其视图
+std::string_view sql_unquote(const Token& token, std::string& scratch);
+
+// 在 [data, data + size) 中查找 chars 中任意字符的第一次出现，找不到返回 size
+size_t scan_for_any(ScanIsa isa, const char* data, size_t size, std::string_view chars);
+
+#endif // TOKENIZER_H
@@ -0,0 +1,388 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#define BTREE_NODE_BYTES 1024       // 节点大小，键与值内联存放在节点中
+
+// 自旋等待时让出流水线
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// 乐观锁：版本号最低位为写锁位，每次写入使版本号加 2
+// 读者不写共享内存，只在读前后比较版本号；写者用 CAS 从读到的版本升级为写锁，
+// 版本已变化说明读到的数据过期，需要从根节点重来。
+class OptimisticLock {
+public:
+    // 开始读，节点正被写入时返回 false
+    bool readLock(uint64_t& version) const {
+        version = version_.load(std::memory_order_acquire);
+        return (version & 1) == 0;
+    }
+
+    // 读结束后检查版本，未变化则期间读到的数据一致
+    bool validate(uint64_t version) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version_.load(std::memory_order_relaxed) == version;
+    }
+
+    // 从读升级为写，版本已变化时失败
+    bool upgrade(uint64_t version) {
+        return version_.compare_exchange_strong(version, version + 1);
+    }
+
+    void unlock() { version_.fetch_add(1, std::memory_order_release); }
+
+private:
+    std::atomic<uint64_t> version_{0};
+};
+
+// 二级索引的键：列值可以重复，附加行号后唯一
+struct SecondaryKey {
+    int64_t key = 0;
+    uint64_t row = 0;
+
+    bool operator<(const SecondaryKey& other) const {
+        return key < other.key || (key == other.key && row < other.row);
+    }
+};
+
+// 内存 B+ 树，采用乐观锁耦合（optimistic lock coupling）
+// - 读（查找、范围扫描）不加锁，只校验经过节点的版本号，失败时重试；
+// - 插入下降时提前分裂已满的内部节点，分裂只需锁住父子两层；
+// - 节点在树销毁前不会释放，因此读者持有的过期指针总是可以安全解引用。
+// 键唯一，只要求 Key 支持 operator<；Key 与 Value 需可平凡复制。
+// 乐观读与写者并发读写同一内存，读到的值在版本校验通过前不可使用。
+template<typename Key, typename Value>
+class BTree {
+public:
+    BTree() : root_(new Leaf()) {
+        static_assert(sizeof(Leaf) <= BTREE_NODE_BYTES && sizeof(Inner) <= BTREE_NODE_BYTES);
+    }
+    ~BTree() { destroy(root_.load(std::memory_order_relaxed)); }
+
+    BTree(const BTree&) = delete;
+    BTree& operator=(const BTree&) = delete;
+
+    // 插入键值，键已存在时不修改并返回 false
+    bool insert(const Key& key, const Value& value) {
+        for (;;) {
+            InsertResult result = tryInsert(key, value);
+            if (result != InsertResult::RESTART) {
+                return result == InsertResult::INSERTED;
+            }
+            cpu_relax();
+        }
+    }
+
+    // 点查询
+    bool lookup(const Key& key, Value& value) const {
+        for (;;) {
+            Leaf* leaf;
+            uint64_t version;
+            if (!descend(key, leaf, version)) {
+                cpu_relax();
+                continue;
+            }
+            size_t count = leaf->size();
+            size_t pos = lowerBound(leaf->keys, count, key);
+            bool found = pos < count && !(key < leaf->keys[pos]);
+            Value result = found ? leaf->values[pos] : Value();
+            if (leaf->lock.validate(version)) {
+                if (found) {
+                    value = result;
+                }
+                return found;
+            }
+        }
+    }
+
+    // 从 from 起按键升序回调 fn(key, value)，fn 返回 false 时停止
+    // 每个叶子先复制到本地并校验版本，回调期间不持有任何节点
+    template<typename Fn>
+    void scan(const Key& from, Fn fn) const {
+        Key keys[LEAF_CAPACITY];
+        Value values[LEAF_CAPACITY];
+        Key cursor = from;
+        bool inclusive = true;      // 重新下降时是否包含 cursor 本身
+        Leaf* leaf = nullptr;
+        uint64_t version = 0;
+        for (;;) {
+            if (!leaf && !descend(cursor, leaf, version)) {
+                leaf = nullptr;
+                cpu_relax();
+                continue;
+            }
+            size_t count = leaf->size();
+            size_t pos = lowerBound(leaf->keys, count, cursor);
+            if (!inclusive && pos < count && !(cursor < leaf->keys[pos])) {
+                ++pos;
+            }
+            size_t n = 0;
+            for (; pos < count; ++pos, ++n) {
+                keys[n] = leaf->keys[pos];
+                values[n] = leaf->values[pos];
+            }
+            Leaf* next = leaf->next;
+            if (!leaf->lock.validate(version)) {
+                leaf = nullptr;
+                continue;
+            }
+
+            for (size_t i = 0; i < n; ++i) {
+                if (!fn(keys[i], values[i])) {
+                    return;
+                }
+                cursor = keys[i];
+                inclusive = false;
+            }
+            if (!next) {
+                return;
+            }
+            // 右兄弟在此期间分裂时，新节点链在它之后，沿 next 继续不会漏掉已有的键
+            if (!next->lock.readLock(version)) {
+                leaf = nullptr;
+                continue;
+            }
+            leaf = next;
+        }
+    }
+
+private:
+    struct alignas(64) Node {
+        explicit Node(bool is_leaf) : leaf(is_leaf) {}
+        OptimisticLock lock;
+        uint16_t count = 0;
+        bool leaf;
+    };
+
+    // 节点头独占一个缓存行，其后是叶子的 next 或内部节点多出的一个子指针
+    static constexpr size_t LEAF_CAPACITY =
+        (BTREE_NODE_BYTES - sizeof(Node) - sizeof(void*)) / (sizeof(Key) + sizeof(Value));
+    static constexpr size_t INNER_CAPACITY =
+        (BTREE_NODE_BYTES - sizeof(Node) - sizeof(void*)) / (sizeof(Key) + sizeof(Node*));
+    static_assert(LEAF_CAPACITY >= 4 && INNER_CAPACITY >= 4, "BTREE_NODE_BYTES 对键值类型过小");
+
+    struct Leaf : Node {
+        Leaf() : Node(true) {}
+        Leaf* next = nullptr;
+        Key keys[LEAF_CAPACITY];
+        Value values[LEAF_CAPACITY];
+
+        // 乐观读时 count 可能与键不一致，限制在容量内保证不越界
+        size_t size() const { return std::min<size_t>(this->count, LEAF_CAPACITY); }
+    };
+
+    // keys[i] 为 children[i] 子树中的最大键，大于所有键的落在 children[count]
+    struct Inner : Node {
+        Inner() : Node(false) {}
+        Key keys[INNER_CAPACITY];
+        Node* children[INNER_CAPACITY + 1];
+
+        size_t size() const { return std::min<size_t>(this->count, INNER_CAPACITY); }
+    };
+
+    enum class InsertResult {
+        RESTART,
+        INSERTED,
+        EXISTS
+    };
+
+    std::atomic<Node*> root_;
+
+    // 第一个不小于 key 的位置
+    static size_t lowerBound(const Key* keys, size_t count, const Key& key) {
+        size_t low = 0;
+        size_t high = count;
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            if (keys[mid] < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    // 乐观下降到可能包含 key 的叶子，成功时 version 为该叶子的读版本
+    // 每一层先取得子节点版本，再校验父节点版本，保证子节点指针读取时有效
+    bool descend(const Key& key, Leaf*& leaf, uint64_t& version) const {
+        Node* node = root_.load(std::memory_order_acquire);
+        uint64_t node_version;
+        if (!node->lock.readLock(node_version) || node != root_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        while (!node->leaf) {
+            auto* inner = static_cast<Inner*>(node);
+            Node* child = inner->children[lowerBound(inner->keys, inner->size(), key)];
+            uint64_t child_version;
+            if (!inner->lock.validate(node_version) || !child->lock.readLock(child_version) ||
+                !inner->lock.validate(node_version)) {
+                return false;
+            }
+            node = child;
+            node_version = child_version;
+        }
+        leaf = static_cast<Leaf*>(node);
+        version = node_version;
+        return true;
+    }
+
+    InsertResult tryInsert(const Key& key, const Value& value) {
+        Node* node = root_.load(std::memory_order_acquire);
+        uint64_t node_version;
+        if (!node->lock.readLock(node_version) || node != root_.load(std::memory_order_acquire)) {
+            return InsertResult::RESTART;
+        }
+        Inner* parent = nullptr;
+        uint64_t parent_version = 0;
+
+        while (!node->leaf) {
+            auto* inner = static_cast<Inner*>(node);
+            // 下降途中提前分裂已满的内部节点，保证之后插入分隔键时父节点总有空位
+            if (inner->count == INNER_CAPACITY) {
+                split(parent, parent_version, node, node_version);
+                return InsertResult::RESTART;
+            }
+            if (parent && !parent->lock.validate(parent_version)) {
+                return InsertResult::RESTART;
+            }
+            Node* child = inner->children[lowerBound(inner->keys, inner->size(), key)];
+            uint64_t child_version;
+            if (!inner->lock.validate(node_version) || !child->lock.readLock(child_version)) {
+                return InsertResult::RESTART;
+            }
+            parent = inner;
+            parent_version = node_version;
+            node = child;
+            node_version = child_version;
+        }
+
+        auto* leaf = static_cast<Leaf*>(node);
+        if (leaf->count == LEAF_CAPACITY) {
+            split(parent, parent_version, leaf, node_version);
+            return InsertResult::RESTART;
+        }
+        if (!leaf->lock.upgrade(node_version)) {
+            return InsertResult::RESTART;
+        }
+        if (parent && !parent->lock.validate(parent_version)) {
+            leaf->lock.unlock();
+            return InsertResult::RESTART;
+        }
+
+        size_t count = leaf->count;
+        size_t pos = lowerBound(leaf->keys, count, key);
+        if (pos < count && !(key < leaf->keys[pos])) {
+            leaf->lock.unlock();
+            return InsertResult::EXISTS;
+        }
+        std::copy_backward(leaf->keys + pos, leaf->keys + count, leaf->keys + count + 1);
+        std::copy_backward(leaf->values + pos, leaf->values + count, leaf->values + count + 1);
+        leaf->keys[pos] = key;
+        leaf->values[pos] = value;
+        leaf->count = static_cast<uint16_t>(count + 1);
+        leaf->lock.unlock();
+        return InsertResult::INSERTED;
+    }
+
+    // 分裂 node 并把分隔键插入父节点（没有父节点时生成新根）
+    // 按自上而下的顺序锁住父子两层，任一版本已变化则放弃，由调用方重试
+    void split(Inner* parent, uint64_t parent_version, Node* node, uint64_t node_version) {
+        if (parent && !parent->lock.upgrade(parent_version)) {
+            return;
+        }
+        if (!node->lock.upgrade(node_version)) {
+            if (parent) {
+                parent->lock.unlock();
+            }
+            return;
+        }
+        if (!parent && node != root_.load(std::memory_order_relaxed)) {
+            node->lock.unlock();
+            return;
+        }
+
+        Key separator;
+        Node* right;
+        if (node->leaf) {
+            right = splitLeaf(static_cast<Leaf*>(node), separator);
+        } else {
+            right = splitInner(static_cast<Inner*>(node), separator);
+        }
+        if (parent) {
+            insertChild(parent, separator, right);
+        } else {
+            auto* root = new Inner();
+            root->keys[0] = separator;
+            root->children[0] = node;
+            root->children[1] = right;
+            root->count = 1;
+            root_.store(root, std::memory_order_release);
+        }
+        node->lock.unlock();
+        if (parent) {
+            parent->lock.unlock();
+        }
+    }
+
+    // 右半部分移入新叶子，新叶子链在原叶子之后（写锁保护下尚未对其他线程可见）
+    static Leaf* splitLeaf(Leaf* leaf, Key& separator) {
+        auto* right = new Leaf();
+        size_t half = leaf->count / 2;
+        size_t moved = leaf->count - half;
+        std::copy(leaf->keys + half, leaf->keys + leaf->count, right->keys);
+        std::copy(leaf->values + half, leaf->values + leaf->count, right->values);
+        right->count = static_cast<uint16_t>(moved);
+        right->next = leaf->next;
+        leaf->count = static_cast<uint16_t>(half);
+        leaf->next = right;
+        separator = leaf->keys[half - 1];
+        return right;
+    }
+
+    // 中间的键上移到父节点，其右侧的键与子节点移入新节点
+    static Inner* splitInner(Inner* inner, Key& separator) {
+        auto* right = new Inner();
+        size_t half = inner->count / 2;
+        size_t moved = inner->count - half - 1;
+        std::copy(inner->keys + half + 1, inner->keys + inner->count, right->keys);
+        std::copy(inner->children + half + 1, inner->children + inner->count + 1, right->children);
+        right->count = static_cast<uint16_t>(moved);
+        separator = inner->keys[half];
+        inner->count = static_cast<uint16_t>(half);
+        return right;
+    }
+
+    static void insertChild(Inner* inner, const Key& separator, Node* right) {
+        size_t count = inner->count;
+        size_t pos = lowerBound(inner->keys, count, separator);
+        std::copy_backward(inner->keys + pos, inner->keys + count, inner->keys + count + 1);
+        std::copy_backward(inner->children + pos + 1, inner->children + count + 1,
+                           inner->children + count + 2);
+        inner->keys[pos] = separator;
+        inner->children[pos + 1] = right;
+        inner->count = static_cast<uint16_t>(count + 1);
+    }
+
+    static void destroy(Node* node) {
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        auto* inner = static_cast<Inner*>(node);
+        for (size_t i = 0; i <= inner->count; ++i) {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+};
+
+#endif // BTREE_H
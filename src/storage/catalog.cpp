@@ -0,0 +1,227 @@
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include "storage/catalog.h"
+#include "storage/record.h"
+#include "storage/wal.h"
+
+namespace {
+
+void encode_value(RecordWriter& writer, ColumnType type, const Value& value) {
+    switch (type) {
+        case ColumnType::INT64:
+            writer.put(value.integer);
+            break;
+        case ColumnType::DOUBLE:
+            writer.put(value.real);
+            break;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            writer.putString(value.text);
+            break;
+    }
+}
+
+Value decode_value(RecordReader& reader, ColumnType type) {
+    Value value;
+    switch (type) {
+        case ColumnType::INT64:
+            value.integer = reader.get<int64_t>();
+            break;
+        case ColumnType::DOUBLE:
+            value.real = reader.get<double>();
+            break;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            value.text = reader.getString();
+            break;
+    }
+    return value;
+}
+
+} // namespace
+
+Table* Catalog::createTable(const std::string& name, std::vector<ColumnDef> columns, uint64_t* lsn) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto [it, inserted] = tables_.try_emplace(name);
+    if (!inserted) {
+        return nullptr;
+    }
+
+    // 在目录锁内写日志：之后对该表的插入记录一定排在建表记录之后
+    uint64_t create_lsn = 0;
+    if (wal_) {
+        std::string payload;
+        RecordWriter writer(payload);
+        writer.putString(name);
+        writer.put(static_cast<uint32_t>(columns.size()));
+        for (const auto& def : columns) {
+            writer.putString(def.name);
+            writer.put(static_cast<uint8_t>(def.type));
+            writer.put(def.width);
+        }
+        try {
+            create_lsn = wal_->append(WAL_CREATE_TABLE, payload);
+        } catch (...) {
+            tables_.erase(it);
+            throw;
+        }
+    }
+    if (lsn) {
+        *lsn = create_lsn;
+    }
+    it->second = std::make_unique<Table>(name, std::move(columns));
+    return it->second.get();
+}
+
+Table* Catalog::findTable(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = tables_.find(std::string(name));
+    return it == tables_.end() ? nullptr : it->second.get();
+}
+
+size_t Catalog::tableCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return tables_.size();
+}
+
+void Catalog::forEach(const std::function<void(Table&)>& fn) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const auto& [name, table] : tables_) {
+        fn(*table);
+    }
+}
+
+uint64_t Catalog::logInsert(const Table& table, const Value* values, size_t rows) {
+    if (!wal_) {
+        return 0;
+    }
+    std::string payload;
+    RecordWriter writer(payload);
+    writer.putString(table.name());
+    writer.put(static_cast<uint64_t>(rows));
+    size_t columns = table.columnCount();
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t i = 0; i < columns; ++i) {
+            encode_value(writer, table.columnDef(i).type, values[r * columns + i]);
+        }
+    }
+    return wal_->append(WAL_INSERT, payload);
+}
+
+uint64_t Catalog::logDelete(const Table& table, const std::vector<int64_t>& row_ids) {
+    if (!wal_) {
+        return 0;
+    }
+    std::string payload;
+    RecordWriter writer(payload);
+    writer.putString(table.name());
+    writer.put(static_cast<uint64_t>(row_ids.size()));
+    for (int64_t row_id : row_ids) {
+        writer.put(row_id);
+    }
+    return wal_->append(WAL_DELETE, payload);
+}
+
+uint64_t Catalog::logUpdate(const Table& table, const std::vector<int64_t>& row_ids, const Value* values) {
+    if (!wal_) {
+        return 0;
+    }
+    std::string payload;
+    RecordWriter writer(payload);
+    writer.putString(table.name());
+    writer.put(static_cast<uint64_t>(row_ids.size()));
+    for (int64_t row_id : row_ids) {
+        writer.put(row_id);
+    }
+    size_t columns = table.columnCount();
+    for (size_t r = 0; r < row_ids.size(); ++r) {
+        for (size_t i = 0; i < columns; ++i) {
+            encode_value(writer, table.columnDef(i).type, values[r * columns + i]);
+        }
+    }
+    return wal_->append(WAL_UPDATE, payload);
+}
+
+void Catalog::waitDurable(uint64_t lsn) {
+    if (wal_ && lsn != 0) {
+        wal_->waitDurable(lsn);
+    }
+}
+
+void Catalog::replay(uint8_t type, std::string_view payload) {
+    RecordReader reader(payload);
+    if (type == WAL_CREATE_TABLE) {
+        std::string name(reader.getString());
+        auto count = reader.get<uint32_t>();
+        std::vector<ColumnDef> columns;
+        for (uint32_t i = 0; i < count; ++i) {
+            ColumnDef def;
+            def.name = reader.getString();
+            auto column_type = reader.get<uint8_t>();
+            if (column_type > static_cast<uint8_t>(ColumnType::VARCHAR)) {
+                throw std::runtime_error("日志记录损坏: 未知的列类型");
+            }
+            def.type = static_cast<ColumnType>(column_type);
+            def.width = reader.get<decltype(def.width)>();
+            columns.push_back(std::move(def));
+        }
+        if (!createTable(name, std::move(columns))) {
+            throw std::runtime_error("日志回放失败: 表 " + name + " 重复创建");
+        }
+    } else if (type == WAL_INSERT || type == WAL_DELETE || type == WAL_UPDATE) {
+        std::string_view name = reader.getString();
+        Table* table = findTable(name);
+        if (!table) {
+            throw std::runtime_error("日志回放失败: 表 " + std::string(name) + " 不存在");
+        }
+        auto rows = reader.get<uint64_t>();
+        size_t columns = table->columnCount();
+        std::vector<Value> values(columns);
+        bool sealed = false;
+        {
+            std::lock_guard<std::mutex> lock(table->latch());
+            MvccManager::Commit commit(mvcc_);
+            if (type != WAL_INSERT) {
+                // 删除与更新按行号定位；行号随行序递增，压缩后也保持有序
+                for (uint64_t r = 0; r < rows; ++r) {
+                    long row = table->data().find(reader.get<int64_t>());
+                    if (row < 0) {
+                        throw std::runtime_error("日志回放失败: 表 " + table->name() + " 中找不到要删除的行");
+                    }
+                    table->deleteRow(static_cast<size_t>(row), commit.ts());
+                }
+            }
+            if (type != WAL_DELETE) {
+                for (uint64_t r = 0; r < rows; ++r) {
+                    for (size_t i = 0; i < columns; ++i) {
+                        values[i] = decode_value(reader, table->columnDef(i).type);
+                    }
+                    table->appendRow(values.data(), commit.ts());
+                }
+            }
+            sealed = table->needsEncoding();
+        }
+        if (type != WAL_INSERT || sealed) {
+            collectGarbage(*table);
+        }
+    } else {
+        throw std::runtime_error("日志记录损坏: 未知的记录类型 " + std::to_string(type));
+    }
+    if (!reader.done()) {
+        throw std::runtime_error("日志记录损坏: 结尾有多余数据");
+    }
+}
+
+void Catalog::collectGarbage(Table& table) {
+    std::lock_guard<std::mutex> lock(table.latch());
+    table.releaseRetired(mvcc_.horizon());
+    if (table.needsCompaction()) {
+        table.compact(mvcc_.horizon(), mvcc_);
+    }
+    if (table.needsEncoding()) {
+        table.encodeChunks(mvcc_);
+        // 没有更早的读者时未压缩的数据立即释放
+        table.releaseRetired(mvcc_.horizon());
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "storage/checkpoint.h"
+#include "storage/mvcc.h"
+#include "storage/table.h"
+
+class WriteAheadLog;
+
+// 预写日志中的记录类型
+#define WAL_CREATE_TABLE 1
+#define WAL_INSERT 2
+#define WAL_DELETE 3
+#define WAL_UPDATE 4
+
+// 表目录：表创建后不会被删除，返回的 Table* 在目录生命周期内有效
+class Catalog {
+public:
+    Catalog() = default;
+
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    // 创建表，同名表已存在时返回 nullptr
+    // 挂接了日志时在目录锁内追加建表记录，*lsn 为其 LSN（未挂接时为 0）
+    Table* createTable(const std::string& name, std::vector<ColumnDef> columns, uint64_t* lsn = nullptr);
+
+    // 查找表，不存在时返回 nullptr
+    Table* findTable(std::string_view name) const;
+
+    size_t tableCount() const;
+
+    void forEach(const std::function<void(Table&)>& fn) const;
+
+    // 挂接预写日志，之后的建表与插入都先写日志；应在回放完成、开始服务之前调用
+    void attachLog(WriteAheadLog* wal) { wal_ = wal; }
+
+    // 各表共用的提交时间戳与读快照
+    MvccManager& mvcc() { return mvcc_; }
+
+    // 追加一条插入记录，values 按行、列顺序排列，返回 LSN（未挂接日志时为 0）
+    // 调用方在写入表之前、持有表的写锁时调用，保证日志顺序与表中的行序一致
+    uint64_t logInsert(const Table& table, const Value* values, size_t rows);
+
+    // 追加一条删除记录，按行号标识被删除的行
+    uint64_t logDelete(const Table& table, const std::vector<int64_t>& row_ids);
+
+    // 追加一条更新记录：删除 row_ids 中的行，并按顺序插入 values 中的新版本（每个被删除的行对应一行）
+    uint64_t logUpdate(const Table& table, const std::vector<int64_t>& row_ids, const Value* values);
+
+    // 等待 lsn 及之前的日志持久化，lsn 为 0 时立即返回
+    void waitDurable(uint64_t lsn);
+
+    // 回放一条日志记录（不再写日志），记录损坏时抛出 std::runtime_error
+    void replay(uint8_t type, std::string_view payload);
+
+    // 写语句发布之后调用：释放已没有读者的旧数据版本，旧版本足够多时压缩表，
+    // 并压缩新写满的列块
+    void collectGarbage(Table& table);
+
+    // 把所有表写成检查点文件 path（先写临时文件，同步后改名），写入期间不阻塞读写：
+    // 只在持有目录锁与各表写锁时记下日志位置、各表行数与数据版本，之后凭快照读取。
+    // 挂接了日志时等待检查点之前的记录持久化，完成后截断日志；失败时抛出 std::runtime_error
+    CheckpointStats checkpoint(const std::string& path);
+
+    // 启动时从检查点文件恢复各表（须在建表与回放日志之前调用），文件不存在时返回 false；
+    // stats.lsn 为日志应开始回放的位置（见 WalOptions::start_lsn）。文件损坏时抛出 std::runtime_error
+    bool loadCheckpoint(const std::string& path, CheckpointStats& stats);
+
+private:
+    MvccManager mvcc_;
+    mutable std::shared_mutex mutex_;
+    std::unique_ptr<CheckpointImage> image_;    // 在 tables_ 之前声明：表中的列块可能指向它，须先销毁表
+    std::unordered_map<std::string, std::unique_ptr<Table>> tables_;
+    WriteAheadLog* wal_ = nullptr;
+    std::mutex checkpoint_mutex_;               // 同一时间只写一个检查点
+};
+
+#endif // CATALOG_H
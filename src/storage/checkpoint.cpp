@@ -0,0 +1,509 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "common/crc32c.h"
+#include "storage/catalog.h"
+#include "storage/encoding.h"
+#include "storage/record.h"
+#include "storage/wal.h"
+
+#define CHECKPOINT_PAGE_BYTES 4096          // 未压缩列块的对齐，写时复制以页为单位
+#define CHECKPOINT_BUFFER_BYTES (8u << 20)  // 写入缓冲，满后一次 pwrite
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::runtime_error(what + ": " + strerror(errno));
+}
+
+// 一个列块在文件中的位置，偏移为 0 表示没有该部分
+struct ChunkLayout {
+    uint64_t data = 0;              // 未压缩数据，CHUNK_ROWS 行
+    uint8_t encoding = 0;           // Encoding，PLAIN 表示没有压缩形式
+    uint8_t bits = 0;
+    int64_t base = 0;
+    uint64_t values = 0;
+    uint64_t value_count = 0;
+    uint64_t packed = 0;
+    uint64_t packed_bytes = 0;
+    uint64_t run_ends = 0;
+    uint64_t run_count = 0;
+};
+
+void put_layout(RecordWriter& writer, const ChunkLayout& layout) {
+    writer.put(layout.data);
+    writer.put(layout.encoding);
+    writer.put(layout.bits);
+    writer.put(layout.base);
+    writer.put(layout.values);
+    writer.put(layout.value_count);
+    writer.put(layout.packed);
+    writer.put(layout.packed_bytes);
+    writer.put(layout.run_ends);
+    writer.put(layout.run_count);
+}
+
+ChunkLayout get_layout(RecordReader& reader) {
+    ChunkLayout layout;
+    layout.data = reader.get<uint64_t>();
+    layout.encoding = reader.get<uint8_t>();
+    layout.bits = reader.get<uint8_t>();
+    layout.base = reader.get<int64_t>();
+    layout.values = reader.get<uint64_t>();
+    layout.value_count = reader.get<uint64_t>();
+    layout.packed = reader.get<uint64_t>();
+    layout.packed_bytes = reader.get<uint64_t>();
+    layout.run_ends = reader.get<uint64_t>();
+    layout.run_count = reader.get<uint64_t>();
+    return layout;
+}
+
+// 顺序写入文件头之后的部分，offset() 为下一个字节在文件中的位置
+class FileWriter {
+public:
+    explicit FileWriter(int fd) : fd_(fd) {}
+
+    uint64_t offset() const { return flushed_ + buffer_.size(); }
+
+    void append(const void* data, size_t size) {
+        buffer_.append(static_cast<const char*>(data), size);
+        if (buffer_.size() >= CHECKPOINT_BUFFER_BYTES) {
+            flush();
+        }
+    }
+
+    void zeros(size_t size) { buffer_.append(size, '\0'); }
+
+    // 跳过 size 字节，在文件中留下空洞
+    void skip(size_t size) {
+        flush();
+        flushed_ += size;
+    }
+
+    void align(size_t alignment) { zeros((alignment - offset() % alignment) % alignment); }
+
+    void flush() {
+        size_t done = 0;
+        while (done < buffer_.size()) {
+            ssize_t n = pwrite(fd_, buffer_.data() + done, buffer_.size() - done, static_cast<off_t>(flushed_ + done));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                throw_errno("写入检查点失败");
+            }
+            done += static_cast<size_t>(n);
+        }
+        flushed_ += done;
+        buffer_.clear();
+    }
+
+private:
+    int fd_;
+    uint64_t flushed_ = CHECKPOINT_HEADER_BYTES;
+    std::string buffer_;
+};
+
+// 把 count 个 StringRef 指向的字符串写入文件，返回指向映射在首选地址时文件中副本的 StringRef
+std::vector<StringRef> write_strings(FileWriter& writer, const char* slots, size_t count) {
+    std::vector<StringRef> refs(count);
+    memcpy(refs.data(), slots, count * sizeof(StringRef));
+    for (StringRef& ref : refs) {
+        uint64_t offset = writer.offset();
+        writer.append(ref.data, ref.size);
+        ref.data = reinterpret_cast<const char*>(CHECKPOINT_BASE_ADDRESS + offset);
+    }
+    return refs;
+}
+
+// 写出未压缩列块的前 count 行，占满 CHUNK_ROWS 行的空间（未用的部分是文件空洞），之后追加的行在映射中按页复制
+uint64_t write_plain(FileWriter& writer, const Column& column, const char* data, size_t count) {
+    std::vector<StringRef> refs;
+    if (column.type() == ColumnType::VARCHAR) {
+        refs = write_strings(writer, data, count);
+        data = reinterpret_cast<const char*>(refs.data());
+    }
+    writer.align(CHECKPOINT_PAGE_BYTES);
+    uint64_t offset = writer.offset();
+    writer.append(data, count * column.valueSize());
+    writer.skip((CHUNK_ROWS - count) * column.valueSize());
+    return offset;
+}
+
+ChunkLayout write_encoded(FileWriter& writer, const Column& column, const EncodedChunk& encoded) {
+    ChunkLayout layout;
+    layout.encoding = static_cast<uint8_t>(encoded.encoding());
+    layout.bits = static_cast<uint8_t>(encoded.bits());
+    layout.base = encoded.base();
+    if (encoded.encoding() != Encoding::BITPACK) {
+        const char* values = encoded.values();
+        std::vector<StringRef> refs;
+        if (column.type() == ColumnType::VARCHAR) {
+            refs = write_strings(writer, values, encoded.valueCount());
+            values = reinterpret_cast<const char*>(refs.data());
+        }
+        writer.align(COLUMN_ALIGNMENT);
+        layout.values = writer.offset();
+        layout.value_count = encoded.valueCount();
+        writer.append(values, encoded.valueCount() * column.valueSize());
+    }
+    if (encoded.encoding() != Encoding::RLE) {
+        writer.align(COLUMN_ALIGNMENT);
+        layout.packed = writer.offset();
+        layout.packed_bytes = encoded.packedBytes();
+        writer.append(encoded.packed(), encoded.packedBytes());
+    } else {
+        writer.align(COLUMN_ALIGNMENT);
+        layout.run_ends = writer.offset();
+        layout.run_count = encoded.runCount();
+        writer.append(encoded.runEnds(), encoded.runCount() * sizeof(uint32_t));
+    }
+    return layout;
+}
+
+// 写出一张表的数据版本 data 的前 rows 行：各列块，以及行号与按 cut 归一化的版本时间戳
+// 元数据写入 meta，各块的删除行数依据 end_ts 重新统计
+void write_table(FileWriter& writer, RecordWriter& meta, const Table& table, const TableData& data, size_t rows,
+                 size_t encoded_chunks, int64_t next_row_id, int64_t cut) {
+    size_t chunks = (rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    meta.putString(table.name());
+    meta.put(static_cast<uint32_t>(table.columnCount()));
+    for (size_t i = 0; i < table.columnCount(); ++i) {
+        const ColumnDef& def = table.columnDef(i);
+        meta.putString(def.name);
+        meta.put(static_cast<uint8_t>(def.type));
+        meta.put(def.width);
+    }
+    meta.put(static_cast<uint64_t>(rows));
+    meta.put(next_row_id);
+    meta.put(static_cast<uint64_t>(encoded_chunks));
+
+    std::vector<ChunkLayout> layouts;
+    for (const auto& column : data.columns) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t count = std::min<size_t>(CHUNK_ROWS, rows - chunk * CHUNK_ROWS);
+            // 先取压缩形式：为空时未压缩数据一定还在，之后被释放也要等本检查点的快照结束
+            if (const EncodedChunk* encoded = column->encodedChunk(chunk)) {
+                layouts.push_back(write_encoded(writer, *column, *encoded));
+            } else {
+                ChunkLayout layout;
+                layout.data = write_plain(writer, *column, column->chunk(chunk), count);
+                layouts.push_back(layout);
+            }
+        }
+    }
+
+    std::vector<int64_t> deletes(chunks, 0);
+    std::vector<int64_t> values(CHUNK_ROWS);
+    for (const Column* column : {&data.row_ids, &data.begin_ts, &data.end_ts}) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t first = chunk * CHUNK_ROWS;
+            size_t count = std::min<size_t>(CHUNK_ROWS, rows - first);
+            for (size_t k = 0; k < count; ++k) {
+                if (column == &data.row_ids) {
+                    values[k] = data.row_ids.integerAt(first + k);
+                } else if (column == &data.begin_ts) {
+                    values[k] = 1;
+                } else if (data.end_ts.loadInteger(first + k) <= cut) {
+                    values[k] = 1;
+                    ++deletes[chunk];
+                } else {
+                    values[k] = MVCC_INFINITY;
+                }
+            }
+            ChunkLayout layout;
+            layout.data = write_plain(writer, *column, reinterpret_cast<const char*>(values.data()), count);
+            layouts.push_back(layout);
+        }
+    }
+
+    for (int64_t count : deletes) {
+        meta.put(count);
+    }
+    for (const ChunkLayout& layout : layouts) {
+        put_layout(meta, layout);
+    }
+}
+
+// 映射中 [offset, offset + size) 的位置，越界时抛出异常
+char* locate(const CheckpointImage& image, uint64_t offset, uint64_t size, uint64_t limit) {
+    if (offset < CHECKPOINT_HEADER_BYTES || offset > limit || size > limit - offset) {
+        throw std::runtime_error("检查点文件损坏: 列块位置越界");
+    }
+    return image.data() + offset;
+}
+
+// 映射不在首选地址时修正 count 个 StringRef
+void relocate_strings(char* slots, size_t count, uint64_t delta) {
+    for (size_t k = 0; k < count; ++k) {
+        StringRef ref;
+        memcpy(&ref, slots + k * sizeof(StringRef), sizeof(ref));
+        ref.data = reinterpret_cast<const char*>(reinterpret_cast<uint64_t>(ref.data) + delta);
+        memcpy(slots + k * sizeof(StringRef), &ref, sizeof(ref));
+    }
+}
+
+// 按 layout 把一个列块装入 column，count 为块中的行数
+void attach_chunk(Column& column, const CheckpointImage& image, const ChunkLayout& layout, size_t count,
+                  uint64_t limit, uint64_t delta) {
+    bool text = column.type() == ColumnType::VARCHAR;
+    char* data = nullptr;
+    if (layout.data != 0) {
+        data = locate(image, layout.data, CHUNK_ROWS * column.valueSize(), limit);
+        if (text && delta != 0) {
+            relocate_strings(data, count, delta);
+        }
+    }
+    std::unique_ptr<EncodedChunk> encoded;
+    if (layout.encoding != static_cast<uint8_t>(Encoding::PLAIN)) {
+        if (layout.encoding >= ENCODING_COUNT || layout.bits > BITPACK_MAX_BITS || count != CHUNK_ROWS) {
+            throw std::runtime_error("检查点文件损坏: 无效的列块编码");
+        }
+        char* values = nullptr;
+        if (layout.values != 0) {
+            values = locate(image, layout.values, layout.value_count * column.valueSize(), limit);
+            if (text && delta != 0) {
+                relocate_strings(values, layout.value_count, delta);
+            }
+        }
+        const char* packed = layout.packed ? locate(image, layout.packed, layout.packed_bytes, limit) : nullptr;
+        const char* run_ends =
+            layout.run_ends ? locate(image, layout.run_ends, layout.run_count * sizeof(uint32_t), limit) : nullptr;
+        encoded = EncodedChunk::attach(static_cast<Encoding>(layout.encoding), column.valueSize(), layout.bits,
+                                       layout.base, values, layout.value_count,
+                                       reinterpret_cast<const uint8_t*>(packed), layout.packed_bytes,
+                                       reinterpret_cast<const uint32_t*>(run_ends), layout.run_count);
+    } else if (data == nullptr) {
+        throw std::runtime_error("检查点文件损坏: 列块没有数据");
+    }
+    column.attachChunk(data, std::move(encoded));
+}
+
+std::string directory_of(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+}
+
+} // namespace
+
+CheckpointImage::~CheckpointImage() {
+    munmap(data_, size_);
+}
+
+CheckpointStats Catalog::checkpoint(const std::string& path) {
+    std::lock_guard<std::mutex> serialize(checkpoint_mutex_);
+
+    struct Captured {
+        const Table* table;
+        const TableData* data;
+        size_t rows;
+        size_t encoded_chunks;
+        int64_t next_row_id;
+    };
+    std::vector<Captured> captured;
+    std::optional<MvccManager::Snapshot> snapshot;
+    int64_t cut = 0;
+    CheckpointStats stats;
+    {
+        // 持有目录锁与所有表的写锁时：LSN 小于 stats.lsn 的记录都已写入表中，
+        // 写入的版本时间戳都不大于 cut；之后的提交只追加行或把 end_ts 改为大于 cut 的值
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<std::unique_lock<std::mutex>> latches;
+        for (const auto& [name, table] : tables_) {
+            latches.emplace_back(table->latch());
+        }
+        for (const auto& [name, table] : tables_) {
+            const TableData& data = table->data();
+            captured.push_back({table.get(), &data, data.rowCount(),
+                                std::min(data.encoded_chunks, data.rowCount() / CHUNK_ROWS), table->nextRowId()});
+        }
+        stats.lsn = wal_ ? wal_->nextLsn() : 0;
+        cut = mvcc_.allocated();
+        // 之后替换的数据版本与压缩后的未压缩列块都要等本快照结束才释放
+        snapshot.emplace(mvcc_.snapshot());
+    }
+    if (wal_ && stats.lsn > 1) {
+        wal_->waitDurable(stats.lsn - 1);
+    }
+
+    std::string temp_path = path + ".tmp";
+    int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw_errno("无法创建检查点文件 " + temp_path);
+    }
+    try {
+        FileWriter writer(fd);
+        std::string meta;
+        RecordWriter meta_writer(meta);
+        meta_writer.put(static_cast<uint32_t>(captured.size()));
+        for (const Captured& table : captured) {
+            write_table(writer, meta_writer, *table.table, *table.data, table.rows, table.encoded_chunks,
+                        table.next_row_id, cut);
+            stats.rows += table.rows;
+        }
+        writer.align(COLUMN_ALIGNMENT);
+        CheckpointHeader header{};
+        header.magic = CHECKPOINT_MAGIC;
+        header.version = CHECKPOINT_VERSION;
+        header.meta_crc = crc32c(0, meta.data(), meta.size());
+        header.base = CHECKPOINT_BASE_ADDRESS;
+        header.lsn = stats.lsn;
+        header.meta_offset = writer.offset();
+        header.meta_bytes = meta.size();
+        header.file_bytes = header.meta_offset + meta.size();
+        writer.append(meta.data(), meta.size());
+        writer.flush();
+        if (pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+            throw_errno("写入检查点文件头失败");
+        }
+        if (fsync(fd) != 0) {
+            throw_errno("检查点文件刷盘失败");
+        }
+        stats.bytes = header.file_bytes;
+    } catch (...) {
+        close(fd);
+        unlink(temp_path.c_str());
+        throw;
+    }
+    close(fd);
+    snapshot.reset();
+    stats.tables = captured.size();
+
+    // 改名后新检查点才生效：崩溃时要么是旧检查点加完整的日志，要么是新检查点
+    if (rename(temp_path.c_str(), path.c_str()) != 0) {
+        int saved = errno;
+        unlink(temp_path.c_str());
+        errno = saved;
+        throw_errno("无法替换检查点文件 " + path);
+    }
+    int dir_fd = open(directory_of(path).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0 || fsync(dir_fd) != 0) {
+        int saved = errno;
+        if (dir_fd >= 0) {
+            close(dir_fd);
+        }
+        errno = saved;
+        throw_errno("无法同步检查点目录");
+    }
+    close(dir_fd);
+
+    if (wal_) {
+        stats.removed_segments = wal_->truncateBefore(stats.lsn);
+    }
+    return stats;
+}
+
+bool Catalog::loadCheckpoint(const std::string& path, CheckpointStats& stats) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return false;
+        }
+        throw_errno("无法打开检查点文件 " + path);
+    }
+    CheckpointHeader header{};
+    struct stat st{};
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || fstat(fd, &st) != 0 ||
+        header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||
+        header.file_bytes != static_cast<uint64_t>(st.st_size) || header.meta_offset < CHECKPOINT_HEADER_BYTES ||
+        header.meta_offset > header.file_bytes || header.meta_bytes != header.file_bytes - header.meta_offset) {
+        close(fd);
+        throw std::runtime_error("检查点文件 " + path + " 无效");
+    }
+
+    // 先尝试首选地址，这样 VARCHAR 的 StringRef 不用修正；不能覆盖已有的映射
+    int flags = MAP_PRIVATE;
+#ifdef MAP_FIXED_NOREPLACE
+    flags |= MAP_FIXED_NOREPLACE;
+#endif
+    void* hint = reinterpret_cast<void*>(header.base);
+    void* mapped = mmap(hint, header.file_bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (mapped == MAP_FAILED) {
+        mapped = mmap(nullptr, header.file_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    int saved = errno;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        errno = saved;
+        throw_errno("无法映射检查点文件 " + path);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!tables_.empty() || image_ || wal_) {
+        munmap(mapped, header.file_bytes);
+        throw std::runtime_error("只能在建表与挂接日志之前从检查点恢复");
+    }
+    image_ = std::make_unique<CheckpointImage>(static_cast<char*>(mapped), header.file_bytes);
+    uint64_t delta = reinterpret_cast<uint64_t>(mapped) - header.base;
+    try {
+        std::string_view meta(image_->data() + header.meta_offset, header.meta_bytes);
+        if (crc32c(0, meta.data(), meta.size()) != header.meta_crc) {
+            throw std::runtime_error("检查点文件 " + path + " 的元数据校验失败");
+        }
+        RecordReader reader(meta, "检查点元数据");
+        auto table_count = reader.get<uint32_t>();
+        for (uint32_t t = 0; t < table_count; ++t) {
+            std::string name(reader.getString());
+            auto column_count = reader.get<uint32_t>();
+            std::vector<ColumnDef> columns;
+            for (uint32_t i = 0; i < column_count; ++i) {
+                ColumnDef def;
+                def.name = reader.getString();
+                auto column_type = reader.get<uint8_t>();
+                if (column_type > static_cast<uint8_t>(ColumnType::VARCHAR)) {
+                    throw std::runtime_error("检查点文件损坏: 未知的列类型");
+                }
+                def.type = static_cast<ColumnType>(column_type);
+                def.width = reader.get<decltype(def.width)>();
+                columns.push_back(std::move(def));
+            }
+            auto rows = static_cast<size_t>(reader.get<uint64_t>());
+            auto next_row_id = reader.get<int64_t>();
+            auto encoded_chunks = static_cast<size_t>(reader.get<uint64_t>());
+            size_t chunks = (rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+            std::vector<int64_t> deletes(chunks);
+            for (int64_t& count : deletes) {
+                count = reader.get<int64_t>();
+            }
+
+            auto [it, inserted] = tables_.try_emplace(name);
+            if (!inserted) {
+                throw std::runtime_error("检查点文件损坏: 表 " + name + " 重复");
+            }
+            it->second = std::make_unique<Table>(name, std::move(columns));
+            Table& table = *it->second;
+            TableData& data = table.mutableData();
+            std::vector<Column*> targets;
+            for (auto& column : data.columns) {
+                targets.push_back(column.get());
+            }
+            targets.insert(targets.end(), {&data.row_ids, &data.begin_ts, &data.end_ts});
+            for (Column* column : targets) {
+                for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                    size_t count = std::min<size_t>(CHUNK_ROWS, rows - chunk * CHUNK_ROWS);
+                    attach_chunk(*column, *image_, get_layout(reader), count, header.meta_offset, delta);
+                }
+            }
+            table.restore(rows, deletes, std::min(encoded_chunks, rows / CHUNK_ROWS), next_row_id);
+            stats.rows += rows;
+        }
+        if (!reader.done()) {
+            throw std::runtime_error("检查点文件损坏: 元数据结尾有多余数据");
+        }
+    } catch (...) {
+        tables_.clear();
+        image_.reset();
+        throw;
+    }
+    stats.lsn = header.lsn;
+    stats.tables = tables_.size();
+    stats.bytes = header.file_bytes;
+    stats.relocated = delta != 0;
+    return true;
+}
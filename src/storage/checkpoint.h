@@ -0,0 +1,60 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define CHECKPOINT_FILE_NAME "checkpoint.snap"      // 检查点文件名，与日志段在同一目录
+#define CHECKPOINT_MAGIC 0x3154504b43424453ULL      // "SDBCKPT1"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_HEADER_BYTES 4096                // 文件头占一页，列块从第二页开始
+#define CHECKPOINT_BASE_ADDRESS 0x7e0000000000ULL   // 首选映射地址，VARCHAR 的 StringRef 按它写入
+
+// 检查点文件（写入与恢复见 Catalog::checkpoint() / Catalog::loadCheckpoint()）：
+//   文件头 | 各表各列的列块 | 元数据（表结构、行数、每个列块在文件中的位置）
+// 列块按内存中的格式原样存放：未压缩的块占满 CHUNK_ROWS 行并按页对齐，压缩块存放 EncodedChunk 的各数组。
+// 恢复时把整个文件以 MAP_PRIVATE 映射，列块直接指向映射，页面在第一次读到时才由内核载入，
+// 启动时间只与元数据的大小有关；追加到最后一块与删除行（改写 end_ts）时按页写时复制，不改动文件。
+// VARCHAR 的字符串存放在各自列块之前，StringRef 按映射在 CHECKPOINT_BASE_ADDRESS 时的地址写入；
+// 该地址已被占用时映射到别处，并逐个修正 VARCHAR 列块中的指针（只有这一步需要读这些页面）。
+// 文件中的行都已提交：开始时间戳统一为 1，检查点之前已删除的行结束时间戳为 1，其余为无穷大，
+// 与恢复后新建的 MvccManager（第一个提交时间戳为 2）一致。
+struct CheckpointHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t meta_crc;          // 元数据的 CRC-32C（列块数据不校验，校验需要读入整个文件）
+    uint64_t base;              // 写入 StringRef 时假定的映射地址
+    uint64_t lsn;               // 检查点包含 LSN 小于它的全部日志记录
+    uint64_t file_bytes;
+    uint64_t meta_offset;
+    uint64_t meta_bytes;
+};
+
+// 一次检查点的写入或恢复结果
+struct CheckpointStats {
+    uint64_t lsn = 0;               // 日志从该 LSN 起回放
+    size_t tables = 0;
+    size_t rows = 0;
+    size_t bytes = 0;               // 文件大小
+    size_t removed_segments = 0;    // 写入后删除的日志段数
+    bool relocated = false;         // 恢复时没能映射到首选地址，已修正字符串指针
+};
+
+// 检查点文件的只读映射（页面私有可写），来自它的列块都销毁之后才能解除映射
+class CheckpointImage {
+public:
+    CheckpointImage(char* data, size_t size) : data_(data), size_(size) {}
+    ~CheckpointImage();
+
+    CheckpointImage(const CheckpointImage&) = delete;
+    CheckpointImage& operator=(const CheckpointImage&) = delete;
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    char* data_;
+    size_t size_;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "storage/column.h"
+#include "storage/encoding.h"
+
+const char* column_type_name(ColumnType type) {
+    switch (type) {
+        case ColumnType::INT64:
+            return "BIGINT";
+        case ColumnType::DOUBLE:
+            return "DOUBLE";
+        case ColumnType::CHAR:
+            return "CHAR";
+        case ColumnType::VARCHAR:
+            return "VARCHAR";
+    }
+    return "UNKNOWN";
+}
+
+const char* encoding_name(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::PLAIN:
+            return "plain";
+        case Encoding::DICTIONARY:
+            return "dictionary";
+        case Encoding::RLE:
+            return "rle";
+        case Encoding::BITPACK:
+            return "bitpack";
+    }
+    return "unknown";
+}
+
+// ---------------------------------------------------------------------------
+// StringHeap
+
+StringHeap::~StringHeap() {
+    for (char* block : blocks_) {
+        ::operator delete(block);
+    }
+    for (char* block : large_) {
+        ::operator delete(block);
+    }
+}
+
+StringRef StringHeap::store(std::string_view text) {
+    bytes_ += text.size();
+    if (text.empty()) {
+        return StringRef{"", 0};
+    }
+
+    // 超过四分之一块的字符串单独分配，避免浪费当前块的剩余空间
+    if (text.size() > STRING_HEAP_BLOCK / 4) {
+        char* block = static_cast<char*>(::operator new(text.size()));
+        memcpy(block, text.data(), text.size());
+        large_.push_back(block);
+        return StringRef{block, static_cast<uint32_t>(text.size())};
+    }
+
+    if (used_ + text.size() > STRING_HEAP_BLOCK) {
+        blocks_.push_back(static_cast<char*>(::operator new(STRING_HEAP_BLOCK)));
+        used_ = 0;
+    }
+    char* p = blocks_.back() + used_;
+    memcpy(p, text.data(), text.size());
+    used_ += text.size();
+    return StringRef{p, static_cast<uint32_t>(text.size())};
+}
+
+// ---------------------------------------------------------------------------
+// Column
+
+static size_t value_size_of(const ColumnDef& def) {
+    switch (def.type) {
+        case ColumnType::INT64:
+            return sizeof(int64_t);
+        case ColumnType::DOUBLE:
+            return sizeof(double);
+        case ColumnType::CHAR:
+            return def.width;
+        case ColumnType::VARCHAR:
+            return sizeof(StringRef);
+    }
+    return 0;
+}
+
+Column::Column(ColumnDef def)
+    : def_(std::move(def)), value_size_(value_size_of(def_)) {}
+
+Column::~Column() {
+    size_t count = chunkCount();
+    ChunkEntry* directory = chunks_.load(std::memory_order_relaxed);
+    for (size_t i = attached_chunks_; i < count; ++i) {
+        if (char* data = directory[i].data.load(std::memory_order_relaxed)) {
+            ::operator delete(data, std::align_val_t{COLUMN_ALIGNMENT});
+        }
+    }
+}
+
+void Column::growDirectory() {
+    size_t count = chunk_count_.load(std::memory_order_relaxed);
+    if (count < chunk_capacity_) {
+        return;
+    }
+    // 读者可能仍在使用旧目录，复制到新目录后旧目录不释放
+    ChunkEntry* directory = chunks_.load(std::memory_order_relaxed);
+    chunk_capacity_ = std::max<size_t>(8, chunk_capacity_ * 2);
+    auto grown = std::make_unique<ChunkEntry[]>(chunk_capacity_);
+    for (size_t i = 0; i < count; ++i) {
+        grown[i].data.store(directory[i].data.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        grown[i].encoded.store(directory[i].encoded.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    chunks_.store(grown.get(), std::memory_order_release);
+    directories_.push_back(std::move(grown));
+}
+
+void Column::addChunk() {
+    growDirectory();
+    size_t count = chunk_count_.load(std::memory_order_relaxed);
+    chunks_.load(std::memory_order_relaxed)[count].data.store(
+        static_cast<char*>(::operator new(CHUNK_ROWS * value_size_, std::align_val_t{COLUMN_ALIGNMENT})),
+        std::memory_order_relaxed);
+    chunk_count_.store(count + 1, std::memory_order_release);
+}
+
+void Column::attachChunk(char* data, std::unique_ptr<EncodedChunk> encoded) {
+    growDirectory();
+    size_t count = chunk_count_.load(std::memory_order_relaxed);
+    ChunkEntry& entry = chunks_.load(std::memory_order_relaxed)[count];
+    entry.data.store(data, std::memory_order_relaxed);
+    entry.encoded.store(encoded.get(), std::memory_order_relaxed);
+    if (encoded) {
+        encoded_.push_back(std::move(encoded));
+    }
+    attached_chunks_ = count + 1;
+    chunk_count_.store(count + 1, std::memory_order_release);
+}
+
+void Column::set(size_t row, const Value& value) {
+    size_t chunk_index = row / CHUNK_ROWS;
+    while (chunkCount() <= chunk_index) {
+        addChunk();
+    }
+
+    char* p = mutableSlot(row);
+    switch (def_.type) {
+        case ColumnType::INT64:
+            memcpy(p, &value.integer, sizeof(int64_t));
+            break;
+        case ColumnType::DOUBLE:
+            memcpy(p, &value.real, sizeof(double));
+            break;
+        case ColumnType::CHAR:
+            memset(p, 0, value_size_);
+            memcpy(p, value.text.data(), std::min(value.text.size(), value_size_));
+            break;
+        case ColumnType::VARCHAR: {
+            StringRef ref = heap_.store(value.text);
+            memcpy(p, &ref, sizeof(ref));
+            break;
+        }
+    }
+}
+
+bool Column::encodeChunk(size_t index) {
+    ChunkEntry& entry = chunks_.load(std::memory_order_relaxed)[index];
+    if (entry.encoded.load(std::memory_order_relaxed) != nullptr) {
+        return false;
+    }
+    std::unique_ptr<EncodedChunk> encoded =
+        EncodedChunk::encode(def_, value_size_, entry.data.load(std::memory_order_relaxed), CHUNK_ROWS);
+    if (!encoded) {
+        return false;
+    }
+    entry.encoded.store(encoded.get(), std::memory_order_release);
+    encoded_.push_back(std::move(encoded));
+    return true;
+}
+
+void Column::releaseRaw(size_t index) {
+    ChunkEntry& entry = chunks_.load(std::memory_order_relaxed)[index];
+    if (entry.encoded.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+    char* data = entry.data.exchange(nullptr, std::memory_order_relaxed);
+    if (data && index >= attached_chunks_) {
+        ::operator delete(data, std::align_val_t{COLUMN_ALIGNMENT});
+    }
+}
+
+void Column::setRange(size_t row, const Value* values, size_t stride, size_t count) {
+    while (count > 0) {
+        while (chunkCount() <= row / CHUNK_ROWS) {
+            addChunk();
+        }
+        size_t n = std::min(count, CHUNK_ROWS - row % CHUNK_ROWS);
+        char* p = mutableSlot(row);
+        switch (def_.type) {
+            case ColumnType::INT64:
+                for (size_t k = 0; k < n; ++k) {
+                    memcpy(p + k * sizeof(int64_t), &values[k * stride].integer, sizeof(int64_t));
+                }
+                break;
+            case ColumnType::DOUBLE:
+                for (size_t k = 0; k < n; ++k) {
+                    memcpy(p + k * sizeof(double), &values[k * stride].real, sizeof(double));
+                }
+                break;
+            case ColumnType::CHAR:
+                memset(p, 0, n * value_size_);
+                for (size_t k = 0; k < n; ++k) {
+                    std::string_view text = values[k * stride].text;
+                    memcpy(p + k * value_size_, text.data(), std::min(text.size(), value_size_));
+                }
+                break;
+            case ColumnType::VARCHAR:
+                for (size_t k = 0; k < n; ++k) {
+                    StringRef ref = heap_.store(values[k * stride].text);
+                    memcpy(p + k * sizeof(StringRef), &ref, sizeof(ref));
+                }
+                break;
+        }
+        row += n;
+        values += n * stride;
+        count -= n;
+    }
+}
+
+void Column::fillIntegers(size_t row, size_t count, int64_t first, int64_t step) {
+    while (count > 0) {
+        while (chunkCount() <= row / CHUNK_ROWS) {
+            addChunk();
+        }
+        size_t n = std::min(count, CHUNK_ROWS - row % CHUNK_ROWS);
+        auto* p = reinterpret_cast<int64_t*>(mutableSlot(row));
+        for (size_t k = 0; k < n; ++k) {
+            p[k] = first;
+            first += step;
+        }
+        row += n;
+        count -= n;
+    }
+}
+
+const char* Column::slot(size_t row) const {
+    const ChunkEntry& entry = chunks_.load(std::memory_order_acquire)[row / CHUNK_ROWS];
+    if (const EncodedChunk* encoded = entry.encoded.load(std::memory_order_acquire)) {
+        return encoded->valueSlot(row % CHUNK_ROWS);
+    }
+    return entry.data.load(std::memory_order_acquire) + (row % CHUNK_ROWS) * value_size_;
+}
+
+int64_t Column::integerAt(size_t row) const {
+    const EncodedChunk* encoded = encodedChunk(row / CHUNK_ROWS);
+    if (encoded && encoded->encoding() == Encoding::BITPACK) {
+        return encoded->integerAt(row % CHUNK_ROWS);
+    }
+    int64_t value;
+    memcpy(&value, slot(row), sizeof(value));
+    return value;
+}
+
+double Column::realAt(size_t row) const {
+    double value;
+    memcpy(&value, slot(row), sizeof(value));
+    return value;
+}
+
+std::string_view Column::textAt(size_t row) const {
+    if (def_.type == ColumnType::CHAR) {
+        return trim_char_value(slot(row), value_size_);
+    }
+    StringRef ref;
+    memcpy(&ref, slot(row), sizeof(ref));
+    return ref.view();
+}
+
+Value Column::valueAt(size_t row) const {
+    Value value;
+    switch (def_.type) {
+        case ColumnType::INT64:
+            value.integer = integerAt(row);
+            break;
+        case ColumnType::DOUBLE:
+            value.real = realAt(row);
+            break;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            value.text = textAt(row);
+            break;
+    }
+    return value;
+}
+
+size_t Column::bytes() const {
+    return storage().bytes + heap_.bytes();
+}
+
+ColumnStorage Column::storage() const {
+    ColumnStorage storage;
+    size_t count = chunkCount();
+    const ChunkEntry* directory = chunks_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        const EncodedChunk* encoded = directory[i].encoded.load(std::memory_order_acquire);
+        ++storage.chunks[static_cast<size_t>(encoded ? encoded->encoding() : Encoding::PLAIN)];
+        if (encoded) {
+            storage.bytes += encoded->bytes();
+        }
+        if (directory[i].data.load(std::memory_order_acquire)) {
+            storage.bytes += CHUNK_ROWS * value_size_;
+        }
+    }
+    storage.plain_bytes = count * CHUNK_ROWS * value_size_;
+    return storage;
+}
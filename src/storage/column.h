@@ -0,0 +1,201 @@
+#ifndef COLUMN_H
+#define COLUMN_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define CHUNK_ROWS 65536            // 每个列块的行数，块内数据连续
+#define COLUMN_ALIGNMENT 64         // 列块按缓存行对齐
+#define STRING_HEAP_BLOCK (1 << 20) // 变长字符串堆的块大小
+
+// 列类型
+enum class ColumnType : uint8_t {
+    INT64,
+    DOUBLE,
+    CHAR,       // 定长字符串，按 width 字节内联存储，不足部分补 0
+    VARCHAR     // 变长字符串，列块中存 StringRef，内容在列的字符串堆中
+};
+
+const char* column_type_name(ColumnType type);
+
+// 列块的存储编码，写满的列块在提交后按数据特征选择（见 EncodedChunk）
+enum class Encoding : uint8_t {
+    PLAIN,          // 未压缩
+    DICTIONARY,     // 排序的字典 + 按位打包的编码（字符串列）
+    RLE,            // 游程：每段一个值与段的结束行
+    BITPACK         // 以块内最小值为基准，差值按位打包（整数列）
+};
+
+#define ENCODING_COUNT 4
+
+const char* encoding_name(Encoding encoding);
+
+// 列定义
+struct ColumnDef {
+    std::string name;
+    ColumnType type = ColumnType::INT64;
+    uint32_t width = 0;         // CHAR 的长度；VARCHAR 的最大长度，0 表示不限
+};
+
+// 变长字符串的引用，指向列的字符串堆
+struct StringRef {
+    const char* data;
+    uint32_t size;
+
+    std::string_view view() const { return std::string_view(data, size); }
+};
+
+class EncodedChunk;
+
+// 单个值，按所属列的类型取对应字段
+struct Value {
+    int64_t integer = 0;
+    double real = 0;
+    std::string_view text;
+};
+
+// 只追加的字符串堆：按块分配，字符串地址在表的生命周期内不变
+class StringHeap {
+public:
+    StringHeap() = default;
+    ~StringHeap();
+
+    StringHeap(const StringHeap&) = delete;
+    StringHeap& operator=(const StringHeap&) = delete;
+
+    StringRef store(std::string_view text);
+
+    size_t bytes() const { return bytes_; }
+
+private:
+    std::vector<char*> blocks_;
+    std::vector<char*> large_;          // 单独分配的大字符串
+    size_t used_ = STRING_HEAP_BLOCK;   // 当前块已用字节，初始时视为已满
+    size_t bytes_ = 0;
+};
+
+// 列的存储占用
+struct ColumnStorage {
+    size_t chunks[ENCODING_COUNT] = {};     // 按 Encoding 统计的列块数
+    size_t bytes = 0;                       // 实际占用的字节数（不含字符串堆）
+    size_t plain_bytes = 0;                 // 全部不压缩时的字节数
+};
+
+// 一列数据：按 CHUNK_ROWS 行分块，每块是一段对齐的连续数组，追加时地址不变
+// 只有一个写者（持有表的写锁）；块目录扩容时旧目录保留到列销毁，
+// 读者可以不加锁读取已发布的行（由表的行数以 release/acquire 发布）。
+// 写满的块可以压缩（encodeChunk）：先发布压缩形式，未压缩的数据等读者都不再使用后才释放（releaseRaw），
+// 读者先取压缩形式，为空时才读未压缩的数据。
+class Column {
+public:
+    explicit Column(ColumnDef def);
+    ~Column();
+
+    Column(const Column&) = delete;
+    Column& operator=(const Column&) = delete;
+
+    const ColumnDef& def() const { return def_; }
+    ColumnType type() const { return def_.type; }
+    size_t valueSize() const { return value_size_; }
+
+    size_t chunkCount() const { return chunk_count_.load(std::memory_order_acquire); }
+
+    // 第 index 块的数据，按列类型解释：INT64 为 int64_t，DOUBLE 为 double，
+    // CHAR 为 width 字节一组，VARCHAR 为 StringRef；块已压缩时先检查 encodedChunk()
+    const char* chunk(size_t index) const {
+        return chunks_.load(std::memory_order_acquire)[index].data.load(std::memory_order_acquire);
+    }
+
+    // 第 index 块的压缩形式，未压缩时返回 nullptr；在列销毁前有效
+    const EncodedChunk* encodedChunk(size_t index) const {
+        return chunks_.load(std::memory_order_acquire)[index].encoded.load(std::memory_order_acquire);
+    }
+
+    template<typename T>
+    const T* values(size_t index) const {
+        return reinterpret_cast<const T*>(chunk(index));
+    }
+
+    // 写入第 row 行的值，必要时分配新块（调用方持有表的写锁，且按行号顺序追加）
+    void set(size_t row, const Value& value);
+
+    // 从第 row 行起连续写入 count 个值，第 k 个值为 values[k * stride]；按块写入，类型分派在循环之外
+    void setRange(size_t row, const Value* values, size_t stride, size_t count);
+
+    // 从第 row 行起连续写入 count 个整数 first, first + step, ...（INT64 列，用于行号与版本时间戳）
+    void fillIntegers(size_t row, size_t count, int64_t first, int64_t step);
+
+    // 压缩已写满的第 index 块（调用方持有表的写锁），压缩形式更小时发布并返回 true
+    // 未压缩的数据保留，读者可能仍在读取
+    bool encodeChunk(size_t index);
+
+    // 释放已压缩的第 index 块的未压缩数据，调用方保证没有读者还在使用（见 Table::releaseRetired）
+    void releaseRaw(size_t index);
+
+    // 追加一个来自检查点映射的块（只在恢复时、追加任何行之前调用）：data 为 CHUNK_ROWS 行的可写区域，
+    // 只有压缩形式时为 nullptr；data 不归本列所有，列销毁与 releaseRaw() 时不释放
+    void attachChunk(char* data, std::unique_ptr<EncodedChunk> encoded);
+
+    // INT64 列上可与读者并发的就地修改与读取，用于行的版本时间戳
+    void storeInteger(size_t row, int64_t value) {
+        __atomic_store_n(reinterpret_cast<int64_t*>(mutableSlot(row)), value, __ATOMIC_RELAXED);
+    }
+    int64_t loadInteger(size_t row) const {
+        return __atomic_load_n(reinterpret_cast<const int64_t*>(slot(row)), __ATOMIC_RELAXED);
+    }
+
+    // 读取第 row 行
+    int64_t integerAt(size_t row) const;
+    double realAt(size_t row) const;
+    std::string_view textAt(size_t row) const;
+
+    // 第 row 行按列类型取出的值，字符串指向本列的数据
+    Value valueAt(size_t row) const;
+
+    // 列数据与字符串堆占用的字节数
+    size_t bytes() const;
+
+    ColumnStorage storage() const;
+
+private:
+    // 块目录项：未压缩的数据与压缩形式
+    struct ChunkEntry {
+        std::atomic<char*> data{nullptr};
+        std::atomic<const EncodedChunk*> encoded{nullptr};
+    };
+
+    ColumnDef def_;
+    size_t value_size_;
+    std::atomic<ChunkEntry*> chunks_{nullptr};
+    std::atomic<size_t> chunk_count_{0};
+    size_t chunk_capacity_ = 0;
+    std::vector<std::unique_ptr<ChunkEntry[]>> directories_;    // 当前与扩容前的块目录
+    std::vector<std::unique_ptr<EncodedChunk>> encoded_;        // 各块的压缩形式，列销毁时释放
+    size_t attached_chunks_ = 0;                                // 前若干块的数据来自检查点映射
+    StringHeap heap_;
+
+    // 未压缩块中第 row 行的位置，压缩块中返回取值的位置（BITPACK 块没有，调用方单独处理）
+    const char* slot(size_t row) const;
+    char* mutableSlot(size_t row) {
+        return chunks_.load(std::memory_order_relaxed)[row / CHUNK_ROWS].data.load(std::memory_order_relaxed) +
+               (row % CHUNK_ROWS) * value_size_;
+    }
+    void addChunk();
+    void growDirectory();
+};
+
+// 定长字符串去掉末尾补齐的 0
+inline std::string_view trim_char_value(const char* data, size_t width) {
+    size_t size = width;
+    while (size > 0 && data[size - 1] == '\0') {
+        --size;
+    }
+    return std::string_view(data, size);
+}
+
+#endif // COLUMN_H
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <bit>
+#include <string_view>
+#include <unordered_map>
+#include "storage/encoding.h"
+
+namespace {
+
+size_t packed_bytes(size_t count, unsigned bits) {
+    return (count * bits + 7) / 8 + PACKED_PADDING;
+}
+
+// 字符串值的内容：CHAR 去掉补齐的 0，VARCHAR 取堆中的字符串
+std::string_view text_of(ColumnType type, size_t value_size, const char* slot) {
+    if (type == ColumnType::CHAR) {
+        return trim_char_value(slot, value_size);
+    }
+    StringRef ref;
+    memcpy(&ref, slot, sizeof(ref));
+    return ref.view();
+}
+
+// 两个值是否相同：VARCHAR 比较内容，其余按字节比较（浮点数的 NaN 与 -0.0 按位区分）
+bool same_value(ColumnType type, size_t value_size, const char* left, const char* right) {
+    if (type == ColumnType::VARCHAR) {
+        return text_of(type, value_size, left) == text_of(type, value_size, right);
+    }
+    return memcmp(left, right, value_size) == 0;
+}
+
+} // namespace
+
+std::unique_ptr<EncodedChunk> EncodedChunk::encode(const ColumnDef& def, size_t value_size, const char* data,
+                                                   size_t rows) {
+    if (rows == 0) {
+        return nullptr;
+    }
+    auto slot = [data, value_size](size_t row) { return data + row * value_size; };
+    bool text = def.type == ColumnType::CHAR || def.type == ColumnType::VARCHAR;
+
+    size_t best = rows * value_size;
+    Encoding choice = Encoding::PLAIN;
+
+    size_t runs = 1;
+    for (size_t row = 1; row < rows; ++row) {
+        runs += same_value(def.type, value_size, slot(row - 1), slot(row)) ? 0u : 1u;
+    }
+    if (runs * (value_size + sizeof(uint32_t)) < best) {
+        best = runs * (value_size + sizeof(uint32_t));
+        choice = Encoding::RLE;
+    }
+
+    int64_t min = 0;
+    if (def.type == ColumnType::INT64) {
+        const auto* values = reinterpret_cast<const int64_t*>(data);
+        auto [low, high] = std::minmax_element(values, values + rows);
+        min = *low;
+        auto bits = static_cast<unsigned>(std::bit_width(static_cast<uint64_t>(*high) - static_cast<uint64_t>(*low)));
+        if (bits <= BITPACK_MAX_BITS && packed_bytes(rows, bits) < best) {
+            best = packed_bytes(rows, bits);
+            choice = Encoding::BITPACK;
+        }
+    }
+
+    // 不同的值超过行数的一半时字典不会明显更小，提前放弃
+    std::unordered_map<std::string_view, uint64_t> codes;
+    std::vector<const char*> distinct;
+    if (text) {
+        for (size_t row = 0; row < rows && distinct.size() <= rows / 2; ++row) {
+            if (codes.try_emplace(text_of(def.type, value_size, slot(row)), 0).second) {
+                distinct.push_back(slot(row));
+            }
+        }
+        size_t size = distinct.size() * value_size +
+                      packed_bytes(rows, static_cast<unsigned>(std::bit_width(distinct.size() - 1)));
+        if (distinct.size() <= rows / 2 && size < best) {
+            choice = Encoding::DICTIONARY;
+        }
+    }
+
+    if (choice == Encoding::PLAIN) {
+        return nullptr;
+    }
+    auto chunk = std::make_unique<EncodedChunk>();
+    chunk->encoding_ = choice;
+    chunk->value_size_ = value_size;
+    std::vector<uint64_t> packed(choice == Encoding::RLE ? 0 : rows);
+    switch (choice) {
+        case Encoding::RLE:
+            chunk->own_values_.insert(chunk->own_values_.end(), slot(0), slot(1));
+            for (size_t row = 1; row < rows; ++row) {
+                if (!same_value(def.type, value_size, slot(row - 1), slot(row))) {
+                    chunk->own_run_ends_.push_back(static_cast<uint32_t>(row));
+                    chunk->own_values_.insert(chunk->own_values_.end(), slot(row), slot(row + 1));
+                }
+            }
+            chunk->own_run_ends_.push_back(static_cast<uint32_t>(rows));
+            break;
+        case Encoding::BITPACK: {
+            chunk->base_ = min;
+            const auto* values = reinterpret_cast<const int64_t*>(data);
+            for (size_t row = 0; row < rows; ++row) {
+                packed[row] = static_cast<uint64_t>(values[row]) - static_cast<uint64_t>(min);
+            }
+            auto bits = static_cast<unsigned>(std::bit_width(*std::max_element(packed.begin(), packed.end())));
+            chunk->pack(packed, bits);
+            break;
+        }
+        case Encoding::DICTIONARY: {
+            std::sort(distinct.begin(), distinct.end(), [&def, value_size](const char* left, const char* right) {
+                return text_of(def.type, value_size, left) < text_of(def.type, value_size, right);
+            });
+            for (size_t code = 0; code < distinct.size(); ++code) {
+                codes[text_of(def.type, value_size, distinct[code])] = code;
+                chunk->own_values_.insert(chunk->own_values_.end(), distinct[code], distinct[code] + value_size);
+            }
+            for (size_t row = 0; row < rows; ++row) {
+                packed[row] = codes.find(text_of(def.type, value_size, slot(row)))->second;
+            }
+            chunk->pack(packed, static_cast<unsigned>(std::bit_width(distinct.size() - 1)));
+            break;
+        }
+        case Encoding::PLAIN:
+            break;
+    }
+    chunk->values_ = chunk->own_values_.data();
+    chunk->value_count_ = chunk->own_values_.size() / value_size;
+    chunk->packed_ = chunk->own_packed_.data();
+    chunk->packed_bytes_ = chunk->own_packed_.size();
+    chunk->run_ends_ = chunk->own_run_ends_.data();
+    chunk->run_count_ = chunk->own_run_ends_.size();
+    return chunk;
+}
+
+std::unique_ptr<EncodedChunk> EncodedChunk::attach(Encoding encoding, size_t value_size, unsigned bits, int64_t base,
+                                                   const char* values, size_t value_count, const uint8_t* packed,
+                                                   size_t packed_bytes, const uint32_t* run_ends, size_t run_count) {
+    auto chunk = std::make_unique<EncodedChunk>();
+    chunk->encoding_ = encoding;
+    chunk->value_size_ = value_size;
+    chunk->bits_ = bits;
+    chunk->base_ = base;
+    chunk->values_ = values;
+    chunk->value_count_ = value_count;
+    chunk->packed_ = packed;
+    chunk->packed_bytes_ = packed_bytes;
+    chunk->run_ends_ = run_ends;
+    chunk->run_count_ = run_count;
+    return chunk;
+}
+
+void EncodedChunk::pack(const std::vector<uint64_t>& codes, unsigned bits) {
+    bits_ = bits;
+    own_packed_.assign(packed_bytes(codes.size(), bits), 0);
+    for (size_t i = 0; i < codes.size(); ++i) {
+        size_t bit = i * bits;
+        uint64_t word;
+        memcpy(&word, own_packed_.data() + bit / 8, sizeof(word));
+        word |= codes[i] << (bit % 8);
+        memcpy(own_packed_.data() + bit / 8, &word, sizeof(word));
+    }
+}
+
+size_t EncodedChunk::runOf(size_t offset) const {
+    return static_cast<size_t>(std::upper_bound(run_ends_, run_ends_ + run_count_, offset) - run_ends_);
+}
+
+const char* EncodedChunk::valueSlot(size_t offset) const {
+    size_t index = encoding_ == Encoding::DICTIONARY ? unpack_bits(packed_, bits_, offset) : runOf(offset);
+    return values_ + index * value_size_;
+}
+
+int64_t EncodedChunk::integerAt(size_t offset) const {
+    if (encoding_ == Encoding::BITPACK) {
+        return static_cast<int64_t>(static_cast<uint64_t>(base_) + unpack_bits(packed_, bits_, offset));
+    }
+    int64_t value;
+    memcpy(&value, valueSlot(offset), sizeof(value));
+    return value;
+}
+
+size_t EncodedChunk::bytes() const {
+    return sizeof(*this) + value_count_ * value_size_ + packed_bytes_ + run_count_ * sizeof(uint32_t);
+}
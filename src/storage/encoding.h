@@ -0,0 +1,87 @@
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "storage/column.h"
+
+#define BITPACK_MAX_BITS 56         // 位打包的最大位宽：按 8 字节非对齐读取，加上字节内偏移不超过 64 位
+#define PACKED_PADDING 8            // 位打包数据尾部余量，读取最后一个值时可以越过有效长度
+
+// 位打包数据中的第 index 个值（bits 不超过 BITPACK_MAX_BITS）
+inline uint64_t unpack_bits(const uint8_t* packed, unsigned bits, size_t index) {
+    size_t bit = index * bits;
+    uint64_t word;
+    memcpy(&word, packed + bit / 8, sizeof(word));
+    return (word >> (bit % 8)) & ((uint64_t{1} << bits) - 1);
+}
+
+// 一个写满的列块的压缩形式，创建后只读
+// DICTIONARY 与 RLE 的取值按未压缩列块的格式存放（INT64/DOUBLE 为 8 字节，CHAR 补齐到 width，
+// VARCHAR 为指向列字符串堆的 StringRef），批执行可以像读取列块一样按编码或段号读取。
+// 各数组可以由本对象持有（encode()），也可以引用外部内存（attach()，如检查点文件的映射）。
+class EncodedChunk {
+public:
+    // 为 rows 行的列块数据选择占用最小的编码：整数列比较位打包与游程，字符串列比较字典与游程，
+    // 浮点列只尝试游程；都不比未压缩小时返回 nullptr
+    static std::unique_ptr<EncodedChunk> encode(const ColumnDef& def, size_t value_size, const char* data,
+                                                size_t rows);
+
+    // 引用外部内存中已编码的数组（格式与 encode() 的结果相同），外部内存须比返回的对象存活更久
+    static std::unique_ptr<EncodedChunk> attach(Encoding encoding, size_t value_size, unsigned bits, int64_t base,
+                                                const char* values, size_t value_count, const uint8_t* packed,
+                                                size_t packed_bytes, const uint32_t* run_ends, size_t run_count);
+
+    Encoding encoding() const { return encoding_; }
+    size_t valueSize() const { return value_size_; }
+
+    // DICTIONARY 的字典项（按值升序，字符串按去掉补齐后的内容比较）或 RLE 每段的值
+    const char* values() const { return values_; }
+    size_t valueCount() const { return value_count_; }
+
+    // DICTIONARY 的字典编码或 BITPACK 与 base() 的差值，每个值 bits() 位，共 packedBytes() 字节（含尾部余量）
+    const uint8_t* packed() const { return packed_; }
+    size_t packedBytes() const { return packed_bytes_; }
+    unsigned bits() const { return bits_; }
+    int64_t base() const { return base_; }
+
+    // RLE 每段的结束行（不含），严格递增，最后一项为块的行数
+    const uint32_t* runEnds() const { return run_ends_; }
+    size_t runCount() const { return run_count_; }
+
+    // 块内第 offset 行所在的段
+    size_t runOf(size_t offset) const;
+
+    // 块内第 offset 行的值在 values() 中的位置（DICTIONARY 与 RLE）
+    const char* valueSlot(size_t offset) const;
+
+    // 块内第 offset 行的整数值（INT64 列）
+    int64_t integerAt(size_t offset) const;
+
+    // 压缩后占用的字节数
+    size_t bytes() const;
+
+private:
+    Encoding encoding_ = Encoding::PLAIN;
+    size_t value_size_ = 0;
+    unsigned bits_ = 0;
+    int64_t base_ = 0;
+    const char* values_ = nullptr;
+    size_t value_count_ = 0;
+    const uint8_t* packed_ = nullptr;
+    size_t packed_bytes_ = 0;
+    const uint32_t* run_ends_ = nullptr;
+    size_t run_count_ = 0;
+
+    // encode() 生成的数组，attach() 创建的对象中为空
+    std::vector<char> own_values_;
+    std::vector<uint8_t> own_packed_;
+    std::vector<uint32_t> own_run_ends_;
+
+    void pack(const std::vector<uint64_t>& codes, unsigned bits);
+};
+
+#endif // ENCODING_H
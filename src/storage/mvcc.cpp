@@ -0,0 +1,69 @@
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include "storage/mvcc.h"
+
+MvccManager::MvccManager() : readers_(std::make_unique<ReaderSlot[]>(MVCC_MAX_READERS)) {}
+
+MvccManager::Snapshot::~Snapshot() {
+    if (slot_) {
+        slot_->store(0, std::memory_order_release);
+    }
+}
+
+MvccManager::Snapshot MvccManager::snapshot() {
+    // 从按线程散列的位置开始找空闲槽位，不同线程通常落在不同的缓存行上
+    thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+    int64_t ts = committed_.load();
+    for (size_t probe = 0; probe < MVCC_MAX_READERS; ++probe) {
+        auto& slot = readers_[(hint + probe) % MVCC_MAX_READERS].ts;
+        int64_t expected = 0;
+        if (slot.load(std::memory_order_relaxed) != 0 || !slot.compare_exchange_strong(expected, ts)) {
+            continue;
+        }
+        hint += probe;
+        // 登记之后再确认快照没有过期：horizon() 先读 committed_ 再扫描槽位，
+        // 若它没看到本槽位，它读到的 committed_ 不会大于这里确认的值
+        for (int64_t current = committed_.load(); current != ts; current = committed_.load()) {
+            ts = current;
+            slot.store(ts);
+        }
+        return Snapshot(&slot, ts);
+    }
+    throw std::runtime_error("同时进行的查询过多");
+}
+
+int64_t MvccManager::horizon() const {
+    int64_t oldest = committed_.load();
+    for (size_t i = 0; i < MVCC_MAX_READERS; ++i) {
+        int64_t ts = readers_[i].ts.load();
+        if (ts != 0 && ts < oldest) {
+            oldest = ts;
+        }
+    }
+    return oldest;
+}
+
+bool MvccManager::Commit::publish() {
+    if (published_) {
+        return true;
+    }
+    published_ = true;
+    // 按时间戳顺序发布：快照 s 可见的提交都已完成。更早的提交被放弃时永远等不到，随之停止
+    while (mvcc_.committed_.load(std::memory_order_acquire) != ts_ - 1) {
+        if (mvcc_.stopped()) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    if (mvcc_.stopped()) {
+        return false;
+    }
+    mvcc_.committed_.store(ts_, std::memory_order_release);
+    return true;
+}
+
+void MvccManager::Commit::abandon() {
+    published_ = true;
+    mvcc_.stopped_.store(true, std::memory_order_release);
+}
@@ -0,0 +1,95 @@
+#ifndef MVCC_H
+#define MVCC_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#define MVCC_INFINITY INT64_MAX     // 未删除行的结束时间戳
+#define MVCC_MAX_READERS 1024       // 同时持有的读快照上限
+#define MVCC_GC_MIN_ROWS 4096       // 表中旧版本少于此数时不压缩
+
+// 多版本并发控制的时间戳与读者登记
+// 每行带开始/结束时间戳，快照 s 可见的行满足 begin <= s < end。
+// 写语句持有表的写锁时分配提交时间戳，修改完成后按时间戳顺序发布；读者取已发布的最大时间戳为快照，
+// 不加表锁，因此长查询不阻塞写入，写入也不阻塞查询。
+// 读者登记在槽位中，所有槽位中最老的快照之前结束的版本对任何读者都不可见，可以回收（见 horizon()）。
+class MvccManager {
+public:
+    // 读快照：构造时登记，析构时注销；表数据须在取得快照之后读取
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept : slot_(other.slot_), ts_(other.ts_) { other.slot_ = nullptr; }
+        ~Snapshot();
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        int64_t ts() const { return ts_; }
+
+    private:
+        friend class MvccManager;
+
+        std::atomic<int64_t>* slot_;
+        int64_t ts_;
+
+        Snapshot(std::atomic<int64_t>* slot, int64_t ts) : slot_(slot), ts_(ts) {}
+    };
+
+    // 一次提交：构造时分配时间戳（调用方持有所修改表的写锁），
+    // publish() 等待更早的提交发布后发布本提交；未显式发布时析构函数发布。
+    // 修改没能持久化时调用 abandon()：本提交不发布并停止 MvccManager，之后的提交也都不再发布，
+    // 读者只看到停止之前已发布的数据
+    class Commit {
+    public:
+        explicit Commit(MvccManager& mvcc)
+            : mvcc_(mvcc), ts_(mvcc.next_.fetch_add(1, std::memory_order_relaxed)) {}
+        ~Commit() { publish(); }
+
+        Commit(const Commit&) = delete;
+        Commit& operator=(const Commit&) = delete;
+
+        int64_t ts() const { return ts_; }
+        // 已停止时不发布并返回 false
+        bool publish();
+        void abandon();
+
+    private:
+        MvccManager& mvcc_;
+        int64_t ts_;
+        bool published_ = false;
+    };
+
+    MvccManager();
+
+    MvccManager(const MvccManager&) = delete;
+    MvccManager& operator=(const MvccManager&) = delete;
+
+    // 取得当前快照，同时持有的快照超过 MVCC_MAX_READERS 时抛出 std::runtime_error
+    Snapshot snapshot();
+
+    // 已发布的最大提交时间戳
+    int64_t committed() const { return committed_.load(std::memory_order_acquire); }
+
+    // 已分配的最大提交时间戳（含尚未发布的提交）
+    int64_t allocated() const { return next_.load(std::memory_order_acquire) - 1; }
+
+    // 当前及以后的所有快照都不小于返回值：结束时间戳不大于它的版本可以回收
+    int64_t horizon() const;
+
+    // 有提交被放弃（日志刷盘失败），不再发布任何提交
+    bool stopped() const { return stopped_.load(std::memory_order_acquire); }
+
+private:
+    struct alignas(64) ReaderSlot {
+        std::atomic<int64_t> ts{0};     // 0 表示空闲
+    };
+
+    std::atomic<int64_t> next_{2};
+    std::atomic<int64_t> committed_{1};
+    std::atomic<bool> stopped_{false};
+    std::unique_ptr<ReaderSlot[]> readers_;
+};
+
+#endif // MVCC_H
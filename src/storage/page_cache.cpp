@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "storage/page_cache.h"
+
+#define PAGE_MAX_READAHEAD 255      // 一次 preadv 的 iovec 数不超过 IOV_MAX
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::runtime_error(what + ": " + strerror(errno));
+}
+
+uint64_t major_faults() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_majflt);
+}
+
+// 读满 iov 描述的全部字节，遇到文件末尾或错误时抛出异常
+void read_pages(int fd, iovec* iov, int count, off_t offset) {
+    while (count > 0) {
+        ssize_t n = preadv(fd, iov, count, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw_errno("读取数据页失败");
+        }
+        if (n == 0) {
+            throw std::runtime_error("读取数据页失败: 文件被截断");
+        }
+        offset += n;
+        auto done = static_cast<size_t>(n);
+        while (count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+}
+
+} // namespace
+
+PageRef& PageRef::operator=(PageRef&& other) noexcept {
+    if (this != &other) {
+        release();
+        frame_ = other.frame_;
+        mapped_pins_ = other.mapped_pins_;
+        data_ = other.data_;
+        id_ = other.id_;
+        other.frame_ = nullptr;
+        other.mapped_pins_ = nullptr;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+PageCache::PageCache(PageCacheOptions options)
+    : options_(std::move(options)), mode_(options_.mode) {
+    options_.readahead = std::min(options_.readahead, static_cast<unsigned>(PAGE_MAX_READAHEAD));
+    frame_count_ = std::max<size_t>(options_.frames, 1);
+
+    fd_ = open(options_.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw_errno("无法打开数据文件 " + options_.path);
+    }
+    struct stat st{};
+    if (fstat(fd_, &st) != 0 || st.st_size % PAGE_BYTES != 0) {
+        close(fd_);
+        throw std::runtime_error("数据文件 " + options_.path + " 的大小不是页大小的整数倍");
+    }
+    page_count_.store(static_cast<uint64_t>(st.st_size) / PAGE_BYTES);
+
+    frame_memory_ = static_cast<char*>(aligned_alloc(4096, frame_count_ * PAGE_BYTES));
+    if (!frame_memory_) {
+        close(fd_);
+        throw std::runtime_error("无法分配缓冲池内存");
+    }
+    frames_ = new PageFrame[frame_count_];
+    for (size_t i = 0; i < frame_count_; ++i) {
+        frames_[i].data = frame_memory_ + i * PAGE_BYTES;
+    }
+    page_table_ = new std::atomic<std::atomic<uint32_t>*>[PAGE_MAX_COUNT >> PAGE_TABLE_LEAF_BITS]();
+    extents_ = new std::atomic<char*>[PAGE_MAX_COUNT >> PAGE_EXTENT_BITS]();
+    faults_base_ = major_faults();
+}
+
+PageCache::~PageCache() {
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropCache();
+    } catch (const std::exception&) {
+        // 析构时无法报告写回失败，数据以最近一次成功的 flush() 为准
+    }
+    size_t bytes = static_cast<size_t>(PAGE_BYTES) << PAGE_EXTENT_BITS;
+    for (size_t e = 0; e < (PAGE_MAX_COUNT >> PAGE_EXTENT_BITS); ++e) {
+        if (char* base = extents_[e].load(std::memory_order_relaxed)) {
+            munmap(base, bytes);
+        }
+    }
+    for (size_t i = 0; i < (PAGE_MAX_COUNT >> PAGE_TABLE_LEAF_BITS); ++i) {
+        delete[] page_table_[i].load(std::memory_order_relaxed);
+    }
+    delete[] page_table_;
+    delete[] extents_;
+    delete[] frames_;
+    free(frame_memory_);
+    close(fd_);
+}
+
+uint32_t PageCache::lookup(uint64_t page) const {
+    std::atomic<uint32_t>* leaf = page_table_[page >> PAGE_TABLE_LEAF_BITS].load(std::memory_order_acquire);
+    if (!leaf) {
+        return 0;
+    }
+    return leaf[page & ((1u << PAGE_TABLE_LEAF_BITS) - 1)].load(std::memory_order_acquire);
+}
+
+void PageCache::setMapping(uint64_t page, uint32_t slot) {
+    auto& entry = page_table_[page >> PAGE_TABLE_LEAF_BITS];
+    std::atomic<uint32_t>* leaf = entry.load(std::memory_order_relaxed);
+    if (!leaf) {
+        leaf = new std::atomic<uint32_t>[1u << PAGE_TABLE_LEAF_BITS]();
+        entry.store(leaf, std::memory_order_release);
+    }
+    leaf[page & ((1u << PAGE_TABLE_LEAF_BITS) - 1)].store(slot, std::memory_order_release);
+}
+
+void PageCache::countHit() {
+    static std::atomic<unsigned> next_stripe{0};
+    thread_local unsigned stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % PAGE_COUNTER_STRIPES;
+    hits_[stripe].value.fetch_add(1, std::memory_order_relaxed);
+}
+
+PageRef PageCache::pin(uint64_t page) {
+    // 登记为进行中的固定；正在切换读写方式时撤销登记，等切换完成（释放 mutex_）后重试
+    for (;;) {
+        active_pins_.fetch_add(1);
+        if (!switching_.load()) {
+            break;
+        }
+        active_pins_.fetch_sub(1);
+        std::lock_guard<std::mutex> wait(mutex_);
+    }
+    try {
+        if (mode_.load(std::memory_order_acquire) == PageIoMode::MMAP) {
+            return pinMapped(page);
+        }
+        PageRef ref = pinFrame(page);
+        active_pins_.fetch_sub(1, std::memory_order_release);
+        return ref;
+    } catch (...) {
+        active_pins_.fetch_sub(1, std::memory_order_release);
+        throw;
+    }
+}
+
+PageRef PageCache::pinFrame(uint64_t page) {
+    for (;;) {
+        // 命中路径：无锁查表，固定后确认页框没有被换成别的页
+        if (uint32_t slot = lookup(page)) {
+            PageFrame& frame = frames_[slot - 1];
+            uint32_t pins = frame.pins.fetch_add(1, std::memory_order_acquire);
+            if ((pins & PageFrame::FRAME_LOCKED) == 0 && frame.page.load(std::memory_order_relaxed) == page) {
+                if (!frame.referenced.load(std::memory_order_relaxed)) {
+                    frame.referenced.store(true, std::memory_order_relaxed);
+                }
+                countHit();
+                return PageRef(&frame, frame.data, page);
+            }
+            frame.pins.fetch_sub(1, std::memory_order_release);
+        }
+        if (PageRef ref = load(page)) {
+            return ref;
+        }
+        std::this_thread::yield();
+    }
+}
+
+PageRef PageCache::pinMapped(uint64_t page) {
+    if (page >= pageCount()) {
+        throw std::runtime_error("页号越界: " + std::to_string(page));
+    }
+    size_t extent = page >> PAGE_EXTENT_BITS;
+    char* base = extents_[extent].load(std::memory_order_acquire);
+    if (!base) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        base = extents_[extent].load(std::memory_order_relaxed);
+        if (!base) {
+            // 映射范围可以超出文件末尾，之后 allocate() 扩展文件即可访问
+            size_t bytes = static_cast<size_t>(PAGE_BYTES) << PAGE_EXTENT_BITS;
+            void* addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                              static_cast<off_t>(extent * bytes));
+            if (addr == MAP_FAILED) {
+                throw_errno("无法映射数据文件");
+            }
+            madvise(addr, bytes, options_.readahead > 0 ? MADV_NORMAL : MADV_RANDOM);
+            base = static_cast<char*>(addr);
+            extents_[extent].store(base, std::memory_order_release);
+        }
+    }
+    countHit();
+    return PageRef(&active_pins_, base + (page & ((1u << PAGE_EXTENT_BITS) - 1)) * PAGE_BYTES, page);
+}
+
+PageRef PageCache::load(uint64_t page) {
+    // 调用方已登记在 active_pins_ 中，读写方式在返回前不会被切换
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t page_count = pageCount();
+    if (page >= page_count) {
+        throw std::runtime_error("页号越界: " + std::to_string(page));
+    }
+    if (lookup(page) != 0) {
+        // 其他线程刚装入或正在装入
+        return {};
+    }
+
+    uint64_t wanted = 1;
+    if (options_.readahead > 0 && page == sequential_next_) {
+        wanted = std::min<uint64_t>(1 + options_.readahead, page_count - page);
+    }
+    std::vector<size_t> slots;
+    slots.reserve(wanted);
+    try {
+        for (uint64_t i = 0; i < wanted; ++i) {
+            // 预读遇到已缓存的页就停止，保证一次 preadv 读的是连续区间
+            if (i > 0 && lookup(page + i) != 0) {
+                break;
+            }
+            long slot = evict();
+            if (slot < 0) {
+                if (i == 0) {
+                    throw std::runtime_error("缓冲池已满: 所有页框都被固定");
+                }
+                break;
+            }
+            PageFrame& frame = frames_[slot];
+            frame.page.store(page + i, std::memory_order_relaxed);
+            frame.dirty.store(false, std::memory_order_relaxed);
+            frame.referenced.store(i == 0, std::memory_order_relaxed);
+            setMapping(page + i, static_cast<uint32_t>(slot + 1));
+            slots.push_back(static_cast<size_t>(slot));
+        }
+    } catch (...) {
+        // 换出脏页写回失败：已占用的页框留在页表中会让固定这些页的线程一直重试
+        releaseClaimed(page, slots);
+        throw;
+    }
+    sequential_next_ = page + slots.size();
+    lock.unlock();
+
+    std::vector<iovec> iov(slots.size());
+    for (size_t i = 0; i < slots.size(); ++i) {
+        iov[i] = {frames_[slots[i]].data, PAGE_BYTES};
+    }
+    try {
+        read_pages(fd_, iov.data(), static_cast<int>(iov.size()), static_cast<off_t>(page * PAGE_BYTES));
+    } catch (...) {
+        lock.lock();
+        releaseClaimed(page, slots);
+        throw;
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    readahead_.fetch_add(slots.size() - 1, std::memory_order_relaxed);
+    read_bytes_.fetch_add(slots.size() * PAGE_BYTES, std::memory_order_relaxed);
+
+    // 解除 FRAME_LOCKED；用减法而不是直接赋值，保留其他线程尝试固定时暂时加上的计数
+    for (size_t i = 1; i < slots.size(); ++i) {
+        frames_[slots[i]].pins.fetch_sub(PageFrame::FRAME_LOCKED, std::memory_order_release);
+    }
+    PageFrame& frame = frames_[slots[0]];
+    frame.pins.fetch_sub(PageFrame::FRAME_LOCKED - 1, std::memory_order_release);
+    return PageRef(&frame, frame.data, page);
+}
+
+void PageCache::releaseClaimed(uint64_t page, const std::vector<size_t>& slots) {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        PageFrame& frame = frames_[slots[i]];
+        setMapping(page + i, 0);
+        frame.page.store(PageFrame::NO_PAGE, std::memory_order_relaxed);
+        frame.referenced.store(false, std::memory_order_relaxed);
+        frame.pins.fetch_sub(PageFrame::FRAME_LOCKED, std::memory_order_release);
+    }
+}
+
+long PageCache::evict() {
+    for (size_t step = 0; step < 2 * frame_count_ + 1; ++step) {
+        size_t slot = clock_hand_;
+        clock_hand_ = (clock_hand_ + 1) % frame_count_;
+        PageFrame& frame = frames_[slot];
+        if (frame.pins.load(std::memory_order_relaxed) != 0) {
+            continue;
+        }
+        // 访问位为 1 的页再给一次机会
+        if (frame.referenced.exchange(false, std::memory_order_relaxed)) {
+            continue;
+        }
+        uint32_t expected = 0;
+        if (!frame.pins.compare_exchange_strong(expected, PageFrame::FRAME_LOCKED, std::memory_order_acquire)) {
+            continue;
+        }
+        uint64_t old = frame.page.load(std::memory_order_relaxed);
+        if (old != PageFrame::NO_PAGE) {
+            // 先写回再移出页表，其他线程重新读入该页时文件中已是新内容
+            if (frame.dirty.load(std::memory_order_relaxed)) {
+                try {
+                    writePage(old, frame.data);
+                } catch (...) {
+                    frame.pins.fetch_sub(PageFrame::FRAME_LOCKED, std::memory_order_release);
+                    throw;
+                }
+            }
+            setMapping(old, 0);
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return static_cast<long>(slot);
+    }
+    return -1;
+}
+
+void PageCache::writePage(uint64_t page, const char* data) {
+    size_t done = 0;
+    while (done < PAGE_BYTES) {
+        ssize_t n = pwrite(fd_, data + done, PAGE_BYTES - done, static_cast<off_t>(page * PAGE_BYTES + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw_errno("写入数据页失败");
+        }
+        done += static_cast<size_t>(n);
+    }
+    write_bytes_.fetch_add(PAGE_BYTES, std::memory_order_relaxed);
+}
+
+uint64_t PageCache::allocate(uint64_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t first = pageCount();
+    if (n > PAGE_MAX_COUNT - first) {
+        throw std::runtime_error("数据文件超过最大页数");
+    }
+    if (ftruncate(fd_, static_cast<off_t>((first + n) * PAGE_BYTES)) != 0) {
+        throw_errno("无法扩展数据文件");
+    }
+    page_count_.store(first + n, std::memory_order_release);
+    return first;
+}
+
+void PageCache::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < frame_count_; ++i) {
+        PageFrame& frame = frames_[i];
+        uint64_t page = frame.page.load(std::memory_order_relaxed);
+        if (page != PageFrame::NO_PAGE && frame.dirty.exchange(false, std::memory_order_acquire)) {
+            writePage(page, frame.data);
+        }
+    }
+    size_t bytes = static_cast<size_t>(PAGE_BYTES) << PAGE_EXTENT_BITS;
+    for (size_t e = 0; e < (PAGE_MAX_COUNT >> PAGE_EXTENT_BITS); ++e) {
+        if (char* base = extents_[e].load(std::memory_order_relaxed)) {
+            msync(base, bytes, MS_ASYNC);
+        }
+    }
+    if (fdatasync(fd_) != 0) {
+        throw_errno("数据文件刷盘失败");
+    }
+}
+
+void PageCache::dropCache() {
+    for (size_t i = 0; i < frame_count_; ++i) {
+        PageFrame& frame = frames_[i];
+        uint64_t page = frame.page.load(std::memory_order_relaxed);
+        if (page == PageFrame::NO_PAGE) {
+            continue;
+        }
+        if (frame.dirty.exchange(false, std::memory_order_acquire)) {
+            writePage(page, frame.data);
+        }
+        setMapping(page, 0);
+        frame.page.store(PageFrame::NO_PAGE, std::memory_order_relaxed);
+        frame.referenced.store(false, std::memory_order_relaxed);
+    }
+    sequential_next_ = 0;
+}
+
+void PageCache::setIoMode(PageIoMode mode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode == mode_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // 先挡住新的固定再检查计数，见类注释
+    switching_.store(true);
+    bool pinned = active_pins_.load() != 0;
+    for (size_t i = 0; i < frame_count_ && !pinned; ++i) {
+        pinned = frames_[i].pins.load(std::memory_order_acquire) != 0;
+    }
+    if (pinned) {
+        switching_.store(false);
+        throw std::runtime_error("切换读写方式失败: 仍有页被固定");
+    }
+    try {
+        dropCache();
+    } catch (...) {
+        switching_.store(false);
+        throw;
+    }
+    mode_.store(mode, std::memory_order_release);
+    switching_.store(false);
+}
+
+PageCacheStats PageCache::stats() const {
+    PageCacheStats stats;
+    for (const auto& counter : hits_) {
+        stats.hits += counter.value.load(std::memory_order_relaxed);
+    }
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.readahead = readahead_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.read_bytes = read_bytes_.load(std::memory_order_relaxed);
+    stats.write_bytes = write_bytes_.load(std::memory_order_relaxed);
+    stats.major_faults = major_faults() - faults_base_;
+    return stats;
+}
+
+void PageCache::resetStats() {
+    for (auto& counter : hits_) {
+        counter.value.store(0, std::memory_order_relaxed);
+    }
+    misses_.store(0, std::memory_order_relaxed);
+    readahead_.store(0, std::memory_order_relaxed);
+    evictions_.store(0, std::memory_order_relaxed);
+    read_bytes_.store(0, std::memory_order_relaxed);
+    write_bytes_.store(0, std::memory_order_relaxed);
+    faults_base_ = major_faults();
+}
@@ -0,0 +1,202 @@
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define PAGE_BYTES 8192                     // 数据文件的页大小
+#define PAGE_MAX_COUNT (1ull << 28)         // 单个数据文件最多 2^28 页（2 TB）
+#define PAGE_TABLE_LEAF_BITS 16             // 页表每个叶子覆盖 2^16 页
+#define PAGE_EXTENT_BITS 13                 // mmap 模式下每次映射 2^13 页（64 MB）
+#define PAGE_DEFAULT_READAHEAD 16           // 顺序访问时一次预读的页数
+#define PAGE_COUNTER_STRIPES 16             // 命中计数分散到多个缓存行，避免命中路径争用
+
+// 页的读写方式，可在运行时切换以对比两者
+enum class PageIoMode {
+    PREAD,      // pread/pwrite 读写，由本缓冲池缓存页并负责淘汰
+    MMAP        // 把数据文件映射到内存，缓存与淘汰交给内核
+};
+
+struct PageCacheOptions {
+    std::string path;                           // 数据文件，不存在时创建
+    size_t frames = 4096;                       // PREAD 模式下缓冲池的页框数
+    unsigned readahead = PAGE_DEFAULT_READAHEAD; // 0 表示不预读
+    PageIoMode mode = PageIoMode::PREAD;
+};
+
+struct PageCacheStats {
+    uint64_t hits = 0;          // 固定页时已在缓冲池中（MMAP 模式下为全部固定次数）
+    uint64_t misses = 0;        // 需要从文件读入的页（不含预读）
+    uint64_t readahead = 0;     // 顺序访问时预读的页
+    uint64_t evictions = 0;
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+    uint64_t major_faults = 0;  // 进程的主缺页次数增量，MMAP 模式下代表从磁盘读入的页
+
+    double hitRatio() const {
+        uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0;
+    }
+};
+
+// 缓冲池中的一个页框
+// pins 为固定计数，最高位 FRAME_LOCKED 表示页框正被淘汰或装入，此时不能固定。
+// referenced 为 CLOCK 算法的访问位。
+struct PageFrame {
+    static constexpr uint32_t FRAME_LOCKED = 1u << 31;
+    static constexpr uint64_t NO_PAGE = ~0ull;
+
+    std::atomic<uint64_t> page{NO_PAGE};
+    std::atomic<uint32_t> pins{0};
+    std::atomic<bool> referenced{false};
+    std::atomic<bool> dirty{false};
+    char* data = nullptr;
+};
+
+// 固定的页，析构时解除固定
+// 页内容的并发读写由调用方协调，缓冲池只保证固定期间页不会被换出。
+// MMAP 模式下的页没有页框，固定计数记在缓冲池的 active_pins_ 上，切换读写方式时据此判断。
+class PageRef {
+public:
+    PageRef() = default;
+    PageRef(PageRef&& other) noexcept { *this = std::move(other); }
+    PageRef& operator=(PageRef&& other) noexcept;
+    ~PageRef() { release(); }
+
+    PageRef(const PageRef&) = delete;
+    PageRef& operator=(const PageRef&) = delete;
+
+    explicit operator bool() const { return data_ != nullptr; }
+    uint64_t id() const { return id_; }
+    char* data() const { return data_; }
+
+    // 修改页后调用，淘汰或 flush() 时写回文件（MMAP 模式下由内核写回）
+    void markDirty() {
+        if (frame_) {
+            frame_->dirty.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void release() {
+        if (frame_) {
+            frame_->pins.fetch_sub(1, std::memory_order_release);
+        } else if (mapped_pins_) {
+            mapped_pins_->fetch_sub(1, std::memory_order_release);
+        }
+        frame_ = nullptr;
+        mapped_pins_ = nullptr;
+        data_ = nullptr;
+    }
+
+private:
+    friend class PageCache;
+
+    PageFrame* frame_ = nullptr;
+    std::atomic<uint64_t>* mapped_pins_ = nullptr;  // MMAP 模式下的页：解除固定时减去的计数
+    char* data_ = nullptr;
+    uint64_t id_ = 0;
+
+    PageRef(PageFrame* frame, char* data, uint64_t id) : frame_(frame), data_(data), id_(id) {}
+    PageRef(std::atomic<uint64_t>* mapped_pins, char* data, uint64_t id)
+        : mapped_pins_(mapped_pins), data_(data), id_(id) {}
+};
+
+// 由定长页组成的数据文件及其缓冲池
+// PREAD 模式：
+// - 页表是两级基数树，页号到页框号，命中时只做一次无锁查表和一次原子加固定计数，
+//   固定后再校验页框仍装着该页；
+// - 未命中时在全局锁内用 CLOCK 选出未固定的页框并更新页表（脏页在锁内写回），
+//   锁外读入数据，装入期间页框带 FRAME_LOCKED，其他线程等待；
+// - 连续未命中的页号相邻时视为顺序扫描，一次 preadv 读入后续 readahead 页，
+//   预读的页不设访问位，未被访问时优先淘汰。
+// MMAP 模式：按 64 MB 分段映射文件，固定只是查表取地址，预读用 madvise 交给内核。
+// 分段映射后一直保留到析构，切换回 PREAD 模式也不解除（pwrite 与映射共用内核页缓存，内容一致）。
+// 切换读写方式与无锁的固定互斥：pin() 先登记到 active_pins_ 再检查 switching_，
+// setIoMode() 先置 switching_ 再检查 active_pins_，两边都是顺序一致的原子操作，
+// 因此要么 pin() 看到正在切换并等待，要么 setIoMode() 看到进行中的固定并拒绝切换。
+class PageCache {
+public:
+    // 打开（必要时创建）数据文件，失败时抛出 std::runtime_error
+    explicit PageCache(PageCacheOptions options);
+    // 写回脏页
+    ~PageCache();
+
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    // 固定第 page 页，页号越界或所有页框都被固定时抛出 std::runtime_error
+    PageRef pin(uint64_t page);
+
+    // 在文件末尾追加 n 个全零页，返回第一页的页号
+    uint64_t allocate(uint64_t n = 1);
+
+    uint64_t pageCount() const { return page_count_.load(std::memory_order_acquire); }
+
+    // 写回所有脏页并 fdatasync，调用方需保证此时没有线程在修改页
+    void flush();
+
+    // 切换读写方式：写回脏页并清空缓存；有页被固定或正在固定时抛出 std::runtime_error
+    void setIoMode(PageIoMode mode);
+    PageIoMode ioMode() const { return mode_.load(std::memory_order_acquire); }
+
+    PageCacheStats stats() const;
+    void resetStats();
+
+private:
+    struct alignas(64) HitCounter {
+        std::atomic<uint64_t> value{0};
+    };
+
+    PageCacheOptions options_;
+    int fd_ = -1;
+    std::atomic<uint64_t> page_count_{0};
+    std::atomic<PageIoMode> mode_;
+    std::atomic<uint64_t> active_pins_{0};  // 进行中的 pin() 与 MMAP 模式下仍被固定的页数
+    std::atomic<bool> switching_{false};    // setIoMode() 正在切换（持有 mutex_ 时修改）
+
+    PageFrame* frames_ = nullptr;
+    char* frame_memory_ = nullptr;
+    size_t frame_count_ = 0;
+    size_t clock_hand_ = 0;
+    uint64_t sequential_next_ = 0;          // 上次未命中读入的最后一页之后的页号
+
+    // 页表与 mmap 分段目录，叶子与分段只增不减，读者无锁访问
+    std::atomic<std::atomic<uint32_t>*>* page_table_ = nullptr;
+    std::atomic<char*>* extents_ = nullptr;
+
+    // 未命中、淘汰、分配与切换模式时持有
+    std::mutex mutex_;
+
+    HitCounter hits_[PAGE_COUNTER_STRIPES];
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> readahead_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> read_bytes_{0};
+    std::atomic<uint64_t> write_bytes_{0};
+    uint64_t faults_base_ = 0;
+
+    // 页表中第 page 页所在页框号加一，0 表示不在缓冲池中
+    uint32_t lookup(uint64_t page) const;
+    // 修改页表（持有 mutex_）
+    void setMapping(uint64_t page, uint32_t slot);
+
+    void countHit();
+    // PREAD 模式下固定页；MMAP 模式下映射并返回页，pin() 登记的计数转交给返回的页
+    PageRef pinFrame(uint64_t page);
+    PageRef pinMapped(uint64_t page);
+    // 未命中时装入 page（及预读的后续页），返回已固定的页；页正由其他线程装入时返回空
+    PageRef load(uint64_t page);
+    // 用 CLOCK 选出一个页框并加 FRAME_LOCKED，找不到时返回 -1（持有 mutex_）
+    long evict();
+    // 装入失败时撤销 load() 已占用的页框：移出页表、清空页号并解除 FRAME_LOCKED（持有 mutex_）
+    void releaseClaimed(uint64_t page, const std::vector<size_t>& slots);
+    void writePage(uint64_t page, const char* data);
+    // 写回脏页并清空缓冲池（持有 mutex_）
+    void dropCache();
+};
+
+#endif // PAGE_CACHE_H
@@ -0,0 +1,64 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// 日志记录与检查点元数据的编码：定长字段按本机字节序，字符串为 uint32 长度加内容
+class RecordWriter {
+public:
+    explicit RecordWriter(std::string& out) : out_(out) {}
+
+    template<typename T>
+    void put(T value) {
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(std::string_view text) {
+        put(static_cast<uint32_t>(text.size()));
+        out_.append(text);
+    }
+
+private:
+    std::string& out_;
+};
+
+// 数据不足时抛出 std::runtime_error，消息以 what 开头
+class RecordReader {
+public:
+    explicit RecordReader(std::string_view data, const char* what = "日志记录") : data_(data), what_(what) {}
+
+    template<typename T>
+    T get() {
+        T value;
+        memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string_view getString() {
+        auto size = get<uint32_t>();
+        return std::string_view(take(size), size);
+    }
+
+    bool done() const { return pos_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    const char* what_;
+    size_t pos_ = 0;
+
+    const char* take(size_t size) {
+        if (data_.size() - pos_ < size) {
+            throw std::runtime_error(std::string(what_) + "损坏: 长度不足");
+        }
+        const char* p = data_.data() + pos_;
+        pos_ += size;
+        return p;
+    }
+};
+
+#endif // RECORD_H
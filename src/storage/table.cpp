@@ -0,0 +1,226 @@
+#include <algorithm>
+#include "storage/table.h"
+
+namespace {
+
+Value integer_value(int64_t integer) {
+    Value value;
+    value.integer = integer;
+    return value;
+}
+
+} // namespace
+
+TableData::TableData(const std::vector<ColumnDef>& defs)
+    : row_ids(ColumnDef{"rowid", ColumnType::INT64, 0}),
+      begin_ts(ColumnDef{"begin_ts", ColumnType::INT64, 0}),
+      end_ts(ColumnDef{"end_ts", ColumnType::INT64, 0}),
+      chunk_deletes(ColumnDef{"chunk_deletes", ColumnType::INT64, 0}) {
+    columns.reserve(defs.size());
+    for (const auto& def : defs) {
+        columns.push_back(std::make_unique<Column>(def));
+    }
+}
+
+size_t TableData::visibleEnd(int64_t snapshot) const {
+    size_t count = rowCount();
+    if (count == 0 || begin_ts.integerAt(count - 1) <= snapshot) {
+        return count;
+    }
+    // 第一个开始时间戳大于快照的行
+    size_t low = 0;
+    size_t high = count - 1;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (begin_ts.integerAt(mid) <= snapshot) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+long TableData::find(int64_t row_id) const {
+    size_t low = 0;
+    size_t high = rowCount();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (row_ids.integerAt(mid) < row_id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < rowCount() && row_ids.integerAt(low) == row_id ? static_cast<long>(low) : -1;
+}
+
+Table::Table(std::string name, std::vector<ColumnDef> columns)
+    : name_(std::move(name)), defs_(std::move(columns)),
+      current_(std::make_unique<TableData>(defs_)), data_(current_.get()) {}
+
+int Table::findColumn(std::string_view name) const {
+    for (size_t i = 0; i < defs_.size(); ++i) {
+        if (defs_[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void Table::appendRow(const Value* values, int64_t ts) {
+    TableData& data = *current_;
+    size_t row = data.row_count.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < data.columns.size(); ++i) {
+        data.columns[i]->set(row, values[i]);
+    }
+    data.row_ids.set(row, integer_value(next_row_id_++));
+    data.begin_ts.set(row, integer_value(ts));
+    data.end_ts.set(row, integer_value(MVCC_INFINITY));
+    if (row % CHUNK_ROWS == 0) {
+        data.chunk_deletes.set(row / CHUNK_ROWS, integer_value(0));
+    }
+
+    // 所有列写完后才发布新行
+    data.row_count.store(row + 1, std::memory_order_release);
+}
+
+void Table::appendRows(const Value* values, size_t rows, int64_t ts) {
+    TableData& data = *current_;
+    size_t row = data.row_count.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < data.columns.size(); ++i) {
+        data.columns[i]->setRange(row, values + i, data.columns.size(), rows);
+    }
+    data.row_ids.fillIntegers(row, rows, next_row_id_, 1);
+    next_row_id_ += static_cast<int64_t>(rows);
+    data.begin_ts.fillIntegers(row, rows, ts, 0);
+    data.end_ts.fillIntegers(row, rows, MVCC_INFINITY, 0);
+    for (size_t chunk = (row + CHUNK_ROWS - 1) / CHUNK_ROWS; chunk * CHUNK_ROWS < row + rows; ++chunk) {
+        data.chunk_deletes.set(chunk, integer_value(0));
+    }
+
+    data.row_count.store(row + rows, std::memory_order_release);
+}
+
+void Table::deleteRow(size_t row, int64_t ts) {
+    TableData& data = *current_;
+    data.end_ts.storeInteger(row, ts);
+    size_t chunk = row / CHUNK_ROWS;
+    data.chunk_deletes.storeInteger(chunk, data.chunk_deletes.loadInteger(chunk) + 1);
+    ++data.deleted;
+}
+
+bool Table::needsCompaction() const {
+    return current_->deleted >= compact_threshold_ && current_->deleted * 4 >= current_->rowCount();
+}
+
+void Table::compact(int64_t horizon, MvccManager& mvcc) {
+    const TableData& old = *current_;
+    auto fresh = std::make_unique<TableData>(defs_);
+    size_t count = old.rowCount();
+    size_t kept = 0;
+    std::vector<Value> values(defs_.size());
+    for (size_t row = 0; row < count; ++row) {
+        int64_t end = old.end_ts.loadInteger(row);
+        if (end <= horizon) {
+            continue;
+        }
+        // 仍可能被某个快照看到的版本原样复制，保持行号与时间戳
+        for (size_t i = 0; i < defs_.size(); ++i) {
+            fresh->columns[i]->set(kept, old.column(i).valueAt(row));
+        }
+        fresh->row_ids.set(kept, integer_value(old.row_ids.integerAt(row)));
+        fresh->begin_ts.set(kept, integer_value(old.begin_ts.integerAt(row)));
+        fresh->end_ts.set(kept, integer_value(end));
+        size_t chunk = kept / CHUNK_ROWS;
+        if (kept % CHUNK_ROWS == 0) {
+            fresh->chunk_deletes.set(chunk, integer_value(0));
+        }
+        if (end != MVCC_INFINITY) {
+            fresh->chunk_deletes.storeInteger(chunk, fresh->chunk_deletes.loadInteger(chunk) + 1);
+            ++fresh->deleted;
+        }
+        ++kept;
+    }
+    fresh->row_count.store(kept, std::memory_order_release);
+
+    // 旧版本的列块随旧版本一起释放
+    retired_chunks_.clear();
+    retired_.emplace_back(0, std::move(current_));
+    current_ = std::move(fresh);
+    data_.store(current_.get(), std::memory_order_release);
+
+    // 取得不小于该时间戳的快照的读者一定读到新版本；更早的快照全部结束后旧版本才可释放
+    MvccManager::Commit retire(mvcc);
+    retire.publish();
+    retired_.back().first = retire.ts();
+    compact_threshold_ = std::max<size_t>(MVCC_GC_MIN_ROWS, current_->deleted * 2);
+}
+
+void Table::releaseRetired(int64_t horizon) {
+    std::erase_if(retired_chunks_, [this, horizon](const RetiredChunks& retired) {
+        if (retired.ts > horizon) {
+            return false;
+        }
+        for (auto& column : current_->columns) {
+            for (size_t chunk = retired.begin; chunk < retired.end; ++chunk) {
+                column->releaseRaw(chunk);
+            }
+        }
+        return true;
+    });
+    std::erase_if(retired_, [horizon](const auto& entry) { return entry.first <= horizon; });
+}
+
+void Table::encodeChunks(MvccManager& mvcc) {
+    TableData& data = *current_;
+    size_t begin = data.encoded_chunks;
+    size_t end = data.rowCount() / CHUNK_ROWS;
+    if (begin >= end) {
+        return;
+    }
+    bool encoded = false;
+    for (auto& column : data.columns) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            encoded = column->encodeChunk(chunk) || encoded;
+        }
+    }
+    data.encoded_chunks = end;
+    if (!encoded) {
+        return;
+    }
+
+    // 取得不小于该时间戳的快照的读者一定看到压缩形式
+    MvccManager::Commit retire(mvcc);
+    retire.publish();
+    retired_chunks_.push_back({retire.ts(), begin, end});
+}
+
+void Table::restore(size_t rows, const std::vector<int64_t>& chunk_deletes, size_t encoded_chunks,
+                    int64_t next_row_id) {
+    TableData& data = *current_;
+    for (size_t chunk = 0; chunk < chunk_deletes.size(); ++chunk) {
+        data.chunk_deletes.set(chunk, integer_value(chunk_deletes[chunk]));
+        data.deleted += static_cast<size_t>(chunk_deletes[chunk]);
+    }
+    data.encoded_chunks = encoded_chunks;
+    next_row_id_ = next_row_id;
+    data.row_count.store(rows, std::memory_order_release);
+}
+
+std::vector<ColumnStorage> Table::storage() const {
+    std::vector<ColumnStorage> result;
+    for (const auto& column : current_->columns) {
+        result.push_back(column->storage());
+    }
+    return result;
+}
+
+size_t Table::bytes() const {
+    const TableData& data = *current_;
+    size_t total = data.row_ids.bytes() + data.begin_ts.bytes() + data.end_ts.bytes();
+    for (const auto& column : data.columns) {
+        total += column->bytes();
+    }
+    return total;
+}
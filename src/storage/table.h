@@ -0,0 +1,132 @@
+#ifndef TABLE_H
+#define TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "storage/column.h"
+#include "storage/mvcc.h"
+
+// 表数据的一个版本：各列、行号与每行的开始/结束时间戳
+// 行按提交时间戳顺序追加，因此 begin_ts 随行号单调不减；删除只修改 end_ts。
+// 垃圾回收时整体替换为去掉旧版本的新 TableData。
+struct TableData {
+    explicit TableData(const std::vector<ColumnDef>& defs);
+
+    std::vector<std::unique_ptr<Column>> columns;
+    Column row_ids;
+    Column begin_ts;
+    Column end_ts;
+    Column chunk_deletes;               // 按块号存放块内已删除的行数，为 0 的块扫描时不必检查 end_ts
+    std::atomic<size_t> row_count{0};
+    size_t deleted = 0;                 // 已删除的版本数（写者维护）
+    size_t encoded_chunks = 0;          // 已尝试压缩的写满的块数（写者维护）
+
+    const Column& column(size_t index) const { return *columns[index]; }
+
+    // 已发布的行数（含已删除的版本）
+    size_t rowCount() const { return row_count.load(std::memory_order_acquire); }
+
+    // 快照 snapshot 可见的行都在 [0, visibleEnd(snapshot)) 中
+    size_t visibleEnd(int64_t snapshot) const;
+
+    bool chunkHasDeletes(size_t chunk) const { return chunk_deletes.loadInteger(chunk) != 0; }
+
+    bool visible(size_t row, int64_t snapshot) const {
+        return begin_ts.integerAt(row) <= snapshot && snapshot < end_ts.loadInteger(row);
+    }
+
+    // 按行号二分查找行的位置，找不到返回 -1
+    long find(int64_t row_id) const;
+};
+
+// 内存列存表，多版本存储
+// 写语句持有写锁（latch()），在锁内分配提交时间戳并修改；读者不加锁，
+// 取得快照后读取 data()，按时间戳判断每行是否可见。
+class Table {
+public:
+    Table(std::string name, std::vector<ColumnDef> columns);
+
+    Table(const Table&) = delete;
+    Table& operator=(const Table&) = delete;
+
+    const std::string& name() const { return name_; }
+
+    size_t columnCount() const { return defs_.size(); }
+    const ColumnDef& columnDef(size_t index) const { return defs_[index]; }
+
+    // 按名称查找列，找不到返回 -1
+    int findColumn(std::string_view name) const;
+
+    // 当前数据版本：读者须持有快照（垃圾回收在所有更早的快照结束后才释放旧版本），写者须持有写锁
+    const TableData& data() const { return *data_.load(std::memory_order_acquire); }
+
+    // 以下修改均要求调用方持有写锁
+    std::mutex& latch() const { return latch_; }
+
+    // 追加一行，values 按列顺序给出且已转换为列类型
+    void appendRow(const Value* values, int64_t ts);
+
+    // 追加 rows 行，values 为按行排列的 rows * columnCount() 个值；逐列写入后一起发布
+    void appendRows(const Value* values, size_t rows, int64_t ts);
+
+    // 删除第 row 行（当前数据版本中的位置），其结束时间戳设为 ts
+    void deleteRow(size_t row, int64_t ts);
+
+    // 已删除的版本是否多到值得压缩
+    bool needsCompaction() const;
+
+    // 去掉结束时间戳不大于 horizon 的版本，替换数据版本后发布一个时间戳，
+    // 旧版本在所有更早的快照结束后由 releaseRetired() 释放
+    void compact(int64_t horizon, MvccManager& mvcc);
+
+    // 释放 horizon 之前替换下来的数据版本与压缩后不再使用的未压缩列块
+    void releaseRetired(int64_t horizon);
+
+    // 是否有写满但还没有压缩的列块
+    bool needsEncoding() const { return current_->rowCount() / CHUNK_ROWS > current_->encoded_chunks; }
+
+    // 压缩写满的列块，每列每块按数据选择编码；发布一个时间戳，
+    // 未压缩的数据在所有更早的快照结束后由 releaseRetired() 释放
+    void encodeChunks(MvccManager& mvcc);
+
+    // 下一个分配的行号（调用方持有写锁）
+    int64_t nextRowId() const { return next_row_id_; }
+
+    // 从检查点恢复空表：先通过 mutableData() 的各列 Column::attachChunk() 装入列块，
+    // 再设置行数、各块已删除的行数、已尝试压缩的块数与下一个行号并发布
+    TableData& mutableData() { return *current_; }
+    void restore(size_t rows, const std::vector<int64_t>& chunk_deletes, size_t encoded_chunks, int64_t next_row_id);
+
+    // 各列的存储占用（调用方持有写锁）
+    std::vector<ColumnStorage> storage() const;
+
+    // 列数据占用的总字节数（调用方持有写锁）
+    size_t bytes() const;
+
+private:
+    std::string name_;
+    std::vector<ColumnDef> defs_;
+    std::unique_ptr<TableData> current_;
+    std::atomic<TableData*> data_;
+    std::vector<std::pair<int64_t, std::unique_ptr<TableData>>> retired_;  // 替换时发布的时间戳与旧版本
+
+    // 当前数据版本中已压缩、未压缩数据待释放的列块 [begin, end)
+    struct RetiredChunks {
+        int64_t ts;
+        size_t begin;
+        size_t end;
+    };
+    std::vector<RetiredChunks> retired_chunks_;
+    int64_t next_row_id_ = 1;
+    size_t compact_threshold_ = MVCC_GC_MIN_ROWS;
+    mutable std::mutex latch_;
+};
+
+#endif // TABLE_H
@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "common/crc32c.h"
+#include "storage/wal.h"
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::runtime_error(what + ": " + strerror(errno));
+}
+
+// 段文件名：wal-<16 位十六进制的首条 LSN>.log，按字典序即按 LSN 排序
+std::string segment_name(uint64_t first_lsn) {
+    char name[32];
+    snprintf(name, sizeof(name), "wal-%016llx.log", static_cast<unsigned long long>(first_lsn));
+    return name;
+}
+
+bool is_segment_name(const char* name) {
+    size_t length = strlen(name);
+    return length == 24 && strncmp(name, "wal-", 4) == 0 && strcmp(name + 20, ".log") == 0;
+}
+
+uint64_t segment_first_lsn(const std::string& name) {
+    return strtoull(name.c_str() + 4, nullptr, 16);
+}
+
+std::string read_file(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw_errno("无法打开日志段 " + path);
+    }
+    std::string data;
+    char chunk[65536];
+    for (;;) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            close(fd);
+            throw_errno("读取日志段失败 " + path);
+        }
+        if (n == 0) {
+            break;
+        }
+        data.append(chunk, static_cast<size_t>(n));
+    }
+    close(fd);
+    return data;
+}
+
+void write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw_errno("写入日志失败");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+template<typename T>
+T load(const char* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog(WalOptions options, const WalReplayFn& replay_fn)
+    : options_(std::move(options)) {
+    const std::string& dir = options_.directory;
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw_errno("无法创建日志目录 " + dir);
+    }
+    dir_fd_ = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd_ < 0) {
+        throw_errno("无法打开日志目录 " + dir);
+    }
+    try {
+        replay(replay_fn);
+        openSegment(next_lsn_);
+    } catch (...) {
+        if (segment_fd_ >= 0) {
+            close(segment_fd_);
+        }
+        close(dir_fd_);
+        throw;
+    }
+    durable_lsn_.store(next_lsn_ - 1, std::memory_order_release);
+    if (options_.sync == WalSyncMode::GROUP) {
+        flusher_ = std::thread(&WriteAheadLog::flushLoop, this);
+    }
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    flush_cond_.notify_one();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    close(segment_fd_);
+    close(dir_fd_);
+}
+
+// 按 LSN 排序的段文件名
+std::vector<std::string> WriteAheadLog::listSegments() const {
+    std::vector<std::string> segments;
+    DIR* dir = opendir(options_.directory.c_str());
+    if (!dir) {
+        throw_errno("无法读取日志目录 " + options_.directory);
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (is_segment_name(entry->d_name)) {
+            segments.emplace_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// 依次回放各段；最后一段末尾的残缺记录截掉，中间段损坏则拒绝启动
+// 检查点之前的记录只校验不回放，检查点之后的记录必须从 start_lsn 起连续
+void WriteAheadLog::replay(const WalReplayFn& fn) {
+    std::vector<std::string> segments = listSegments();
+    bool first = true;
+    for (size_t s = 0; s < segments.size(); ++s) {
+        std::string path = options_.directory + "/" + segments[s];
+        std::string data = read_file(path);
+        size_t offset = 0;
+        while (offset + WAL_RECORD_HEADER <= data.size()) {
+            const char* record = data.data() + offset;
+            auto crc = load<uint32_t>(record);
+            auto size = load<uint32_t>(record + 4);
+            auto lsn = load<uint64_t>(record + 8);
+            auto type = static_cast<uint8_t>(record[16]);
+            if (data.size() - offset - WAL_RECORD_HEADER < size ||
+                crc32c(0, record + 4, WAL_RECORD_HEADER - 4 + size) != crc ||
+                (!first && lsn != next_lsn_)) {
+                break;
+            }
+            if (lsn < options_.start_lsn) {
+                ++stats_.skipped;
+            } else {
+                if (stats_.replayed == 0 && options_.start_lsn > 0 && lsn != options_.start_lsn) {
+                    throw std::runtime_error("日志缺少检查点之后的记录: 应从 LSN " +
+                                             std::to_string(options_.start_lsn) + " 开始，实际为 " +
+                                             std::to_string(lsn));
+                }
+                fn(type, std::string_view(record + WAL_RECORD_HEADER, size));
+                ++stats_.replayed;
+            }
+            first = false;
+            next_lsn_ = lsn + 1;
+            offset += WAL_RECORD_HEADER + size;
+        }
+
+        if (offset < data.size()) {
+            if (s + 1 != segments.size()) {
+                throw std::runtime_error("日志段 " + path + " 在偏移 " + std::to_string(offset) + " 处损坏");
+            }
+            // 崩溃时未写完的组：截掉，之后从新段继续
+            if (truncate(path.c_str(), static_cast<off_t>(offset)) != 0) {
+                throw_errno("无法截断日志段 " + path);
+            }
+        }
+    }
+    // 检查点之后还没有写过日志：新记录从检查点记录的 LSN 继续，不能重用更早的 LSN
+    next_lsn_ = std::max(next_lsn_, options_.start_lsn);
+}
+
+void WriteAheadLog::encode(uint64_t lsn, uint8_t type, std::string_view payload, std::string& out) const {
+    char header[WAL_RECORD_HEADER];
+    auto size = static_cast<uint32_t>(payload.size());
+    memcpy(header + 4, &size, sizeof(size));
+    memcpy(header + 8, &lsn, sizeof(lsn));
+    header[16] = static_cast<char>(type);
+    uint32_t crc = crc32c(0, header + 4, WAL_RECORD_HEADER - 4);
+    crc = crc32c(crc, payload.data(), payload.size());
+    memcpy(header, &crc, sizeof(crc));
+    out.append(header, sizeof(header));
+    out.append(payload);
+}
+
+void WriteAheadLog::openSegment(uint64_t first_lsn) {
+    std::string path = options_.directory + "/" + segment_name(first_lsn);
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw_errno("无法创建日志段 " + path);
+    }
+    // 新文件的目录项也需要持久化
+    if (fsync(dir_fd_) != 0) {
+        close(fd);
+        throw_errno("无法同步日志目录");
+    }
+    if (segment_fd_ >= 0) {
+        close(segment_fd_);
+    }
+    segment_fd_ = fd;
+    segment_size_ = 0;
+}
+
+void WriteAheadLog::writeGroup(const std::string& data, uint64_t first_lsn, bool rotate) {
+    if (segment_size_ > 0 && (rotate || segment_size_ + data.size() > options_.segment_bytes)) {
+        openSegment(first_lsn);
+    }
+    write_all(segment_fd_, data.data(), data.size());
+    if (fdatasync(segment_fd_) != 0) {
+        throw_errno("日志刷盘失败");
+    }
+    segment_size_ += data.size();
+}
+
+uint64_t WriteAheadLog::append(uint8_t type, std::string_view payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_.empty()) {
+        throw std::runtime_error(error_);
+    }
+    uint64_t lsn = next_lsn_++;
+    ++stats_.records;
+
+    if (options_.sync == WalSyncMode::EACH) {
+        flushing_.clear();
+        encode(lsn, type, payload, flushing_);
+        try {
+            writeGroup(flushing_, lsn, std::exchange(rotate_, false));
+        } catch (const std::exception& e) {
+            error_ = e.what();
+            throw;
+        }
+        ++stats_.syncs;
+        stats_.bytes += flushing_.size();
+        durable_lsn_.store(lsn, std::memory_order_release);
+        return lsn;
+    }
+
+    // 只有组内第一条记录或组已满时才唤醒刷盘线程，避免等待期间的无效唤醒
+    bool was_empty = buffer_.empty();
+    if (was_empty) {
+        buffer_first_lsn_ = lsn;
+    }
+    encode(lsn, type, payload, buffer_);
+    if (was_empty || buffer_.size() >= options_.group_bytes) {
+        flush_cond_.notify_one();
+    }
+    return lsn;
+}
+
+void WriteAheadLog::waitDurable(uint64_t lsn) {
+    if (durable_lsn_.load(std::memory_order_acquire) >= lsn) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    durable_cond_.wait(lock, [&]() {
+        return durable_lsn_.load(std::memory_order_relaxed) >= lsn || !error_.empty();
+    });
+    if (durable_lsn_.load(std::memory_order_relaxed) < lsn) {
+        throw std::runtime_error(error_);
+    }
+}
+
+WalStats WriteAheadLog::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+uint64_t WriteAheadLog::nextLsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_lsn_;
+}
+
+size_t WriteAheadLog::truncateBefore(uint64_t lsn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rotate_ = true;
+    }
+    // 段内记录都小于下一段的首条 LSN；最后一段是正在写的段，没有下一段，不会被删除
+    std::vector<std::string> segments = listSegments();
+    size_t removed = 0;
+    for (size_t s = 0; s + 1 < segments.size() && segment_first_lsn(segments[s + 1]) <= lsn; ++s) {
+        std::string path = options_.directory + "/" + segments[s];
+        if (unlink(path.c_str()) != 0) {
+            throw_errno("无法删除日志段 " + path);
+        }
+        ++removed;
+    }
+    if (removed > 0 && fsync(dir_fd_) != 0) {
+        throw_errno("无法同步日志目录");
+    }
+    return removed;
+}
+
+// 刷盘线程：取走当前组后释放锁写盘，期间到达的提交进入下一组
+void WriteAheadLog::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        flush_cond_.wait(lock, [this]() { return stopping_ || !buffer_.empty(); });
+        if (buffer_.empty()) {
+            break;
+        }
+        if (options_.group_delay_us > 0 && !stopping_ && buffer_.size() < options_.group_bytes) {
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::microseconds(options_.group_delay_us);
+            flush_cond_.wait_until(lock, deadline, [this]() {
+                return stopping_ || buffer_.size() >= options_.group_bytes;
+            });
+        }
+
+        flushing_.swap(buffer_);
+        uint64_t first_lsn = buffer_first_lsn_;
+        uint64_t last_lsn = next_lsn_ - 1;
+        bool rotate = std::exchange(rotate_, false);
+        lock.unlock();
+
+        std::string error;
+        try {
+            writeGroup(flushing_, first_lsn, rotate);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        lock.lock();
+        stats_.bytes += flushing_.size();
+        flushing_.clear();
+        if (!error.empty()) {
+            error_ = error;
+            durable_cond_.notify_all();
+            break;
+        }
+        ++stats_.syncs;
+        durable_lsn_.store(last_lsn, std::memory_order_release);
+        durable_cond_.notify_all();
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#define WAL_DEFAULT_SEGMENT_BYTES (64u << 20)
+#define WAL_DEFAULT_GROUP_BYTES (1u << 20)
+#define WAL_RECORD_HEADER 17            // crc(4) + size(4) + lsn(8) + type(1)
+
+// 提交的持久化方式
+enum class WalSyncMode {
+    GROUP,      // 刷盘线程把并发提交合成一组，每组一次 fdatasync
+    EACH        // 每次提交各自写入并 fdatasync（对照用）
+};
+
+struct WalOptions {
+    std::string directory;
+    size_t segment_bytes = WAL_DEFAULT_SEGMENT_BYTES;   // 段文件超过此大小后切换到新段
+    size_t group_bytes = WAL_DEFAULT_GROUP_BYTES;       // 一组累积到此大小时立即刷盘
+    uint32_t group_delay_us = 0;    // 刷盘前最多等待更多提交加入本组的时间，0 表示有数据即刷
+    WalSyncMode sync = WalSyncMode::GROUP;
+    uint64_t start_lsn = 0;         // 检查点之后的第一条 LSN：更早的记录已在检查点中，回放时跳过
+};
+
+struct WalStats {
+    uint64_t records = 0;       // 本次启动后写入的记录数
+    uint64_t syncs = 0;         // fdatasync 次数
+    uint64_t bytes = 0;
+    uint64_t replayed = 0;      // 启动时回放的记录数
+    uint64_t skipped = 0;       // 启动时因已在检查点中而跳过的记录数
+};
+
+// 回放回调，按 LSN 顺序逐条调用；抛出的异常使打开失败
+using WalReplayFn = std::function<void(uint8_t type, std::string_view payload)>;
+
+// 预写日志：只追加的段文件，文件名为段内第一条记录的 LSN
+// 每条记录带 CRC-32C；启动时依次回放各段，最后一段末尾不完整的记录视为崩溃时未完成的写入并截掉。
+// append() 只把记录放入当前组，waitDurable() 等待刷盘线程写入并 fdatasync 该组，
+// 多个线程的提交因此共享一次刷盘。
+class WriteAheadLog {
+public:
+    // 打开（必要时创建）目录并回放已有日志，失败时抛出 std::runtime_error
+    WriteAheadLog(WalOptions options, const WalReplayFn& replay);
+    // 刷完已追加的记录后停止刷盘线程
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // 追加一条记录并返回其 LSN，不等待持久化
+    uint64_t append(uint8_t type, std::string_view payload);
+
+    // 等待 lsn 及之前的记录持久化，写入或刷盘失败时抛出 std::runtime_error
+    void waitDurable(uint64_t lsn);
+
+    uint64_t commit(uint8_t type, std::string_view payload) {
+        uint64_t lsn = append(type, payload);
+        waitDurable(lsn);
+        return lsn;
+    }
+
+    uint64_t durableLsn() const { return durable_lsn_.load(std::memory_order_acquire); }
+    WalStats stats() const;
+
+    // 下一条记录将分配的 LSN
+    uint64_t nextLsn() const;
+
+    // 检查点已覆盖 lsn 之前的记录：删除全部记录都小于 lsn 的段，返回删除的段数；
+    // 当前段之后的写入切换到新段，下一次截断时当前段也可以删除
+    size_t truncateBefore(uint64_t lsn);
+
+private:
+    WalOptions options_;
+    int dir_fd_ = -1;
+    int segment_fd_ = -1;
+    size_t segment_size_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable flush_cond_;        // 唤醒刷盘线程
+    std::condition_variable durable_cond_;      // 唤醒等待提交的线程
+    std::string buffer_;                        // 正在累积的组
+    std::string flushing_;                      // 刷盘线程正在写出的组
+    uint64_t buffer_first_lsn_ = 0;             // 当前组第一条记录的 LSN
+    uint64_t next_lsn_ = 1;
+    std::atomic<uint64_t> durable_lsn_{0};
+    std::string error_;
+    bool stopping_ = false;
+    bool rotate_ = false;                       // 下一组写入新段（见 truncateBefore）
+    WalStats stats_;
+    std::thread flusher_;
+
+    void replay(const WalReplayFn& fn);
+    void encode(uint64_t lsn, uint8_t type, std::string_view payload, std::string& out) const;
+    void openSegment(uint64_t first_lsn);
+    // 把 data 写入当前段并 fdatasync，当前段已满或 rotate 为 true 时先切换段；失败时抛出 std::runtime_error
+    void writeGroup(const std::string& data, uint64_t first_lsn, bool rotate);
+    std::vector<std::string> listSegments() const;
+    void flushLoop();
+};
+
+#endif // WAL_H